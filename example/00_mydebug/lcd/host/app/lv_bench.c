@@ -0,0 +1,136 @@
+/**
+ * @file lv_bench.c
+ * Run the render benchmark suite on the headless host port and write the results as CSV.
+ *
+ * Usage: lv_bench [-n frames] [-o file.csv] [scene ...]
+ *        lv_bench -l    list the scenes
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lv_port_host.h"
+#include "lv_examples/lv_apps/benchmark/benchmark_suite.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEF_FRAMES  50
+
+/*Second region of `lv_mem_alloc` like the SDRAM pool of the board (main.c).
+ *The tab view and the deep nesting don't fit in the built-in pool on 64-bit.*/
+#define MEM_POOL_SIZE   (512U * 1024U)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t time_us(void);
+static void print_line(const char * line);
+static int find_scene(const char * name);
+static void print_summary(const benchmark_suite_res_t * res);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static FILE * csv;
+static uint32_t mem_pool[MEM_POOL_SIZE / sizeof(uint32_t)];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char ** argv)
+{
+    uint32_t frames   = DEF_FRAMES;
+    const char * path = NULL;
+    int first_scene   = argc;
+    int i;
+
+    lv_port_host_init();
+    lv_mem_add_pool(mem_pool, sizeof(mem_pool));
+    benchmark_suite_init(time_us, print_line);
+
+    for(i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-l") == 0) {
+            uint16_t s;
+            for(s = 0; s < benchmark_suite_get_scene_cnt(); s++) printf("%s\n", benchmark_suite_get_scene_name(s));
+            return 0;
+        } else if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frames = strtoul(argv[++i], NULL, 0);
+        } else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            first_scene = i;
+            break;
+        }
+    }
+
+    csv = path ? fopen(path, "w") : stdout;
+    if(csv == NULL) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+
+    print_line(BENCHMARK_SUITE_CSV_HEADER);
+
+    /*All scenes if none is given*/
+    int scene_num = first_scene < argc ? argc - first_scene : benchmark_suite_get_scene_cnt();
+    for(i = 0; i < scene_num; i++) {
+        int id = i;
+        if(first_scene < argc) {
+            id = find_scene(argv[first_scene + i]);
+            if(id < 0) {
+                fprintf(stderr, "unknown scene: %s\n", argv[first_scene + i]);
+                return 1;
+            }
+        }
+
+        benchmark_suite_res_t res;
+        benchmark_suite_run_scene(id, frames, &res);
+        print_summary(&res);
+    }
+
+    if(csv != stdout) fclose(csv);
+
+    return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+static void print_line(const char * line)
+{
+    fprintf(csv, "%s\n", line);
+}
+
+static int find_scene(const char * name)
+{
+    uint16_t s;
+    for(s = 0; s < benchmark_suite_get_scene_cnt(); s++) {
+        if(strcmp(benchmark_suite_get_scene_name(s), name) == 0) return s;
+    }
+
+    return -1;
+}
+
+/*The summary goes to stderr to keep the CSV clean when it's written to stdout*/
+static void print_summary(const benchmark_suite_res_t * res)
+{
+    uint32_t avg    = res->frame_cnt ? res->time_sum / res->frame_cnt : 0;
+    uint32_t update = res->frame_cnt ? res->update_sum / res->frame_cnt : 0;
+    fprintf(stderr, "%-28s avg %6u us  min %6u us  max %6u us  px %8u  inv %4u  mem peak %6u  search %6u  update %5u us\n",
+            res->name, avg, res->time_min, res->time_max, res->px_sum, res->inv_sum, res->mem_peak, res->search_sum,
+            update);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file lv_host.c
+ * Run a demo or test scene of `lv_examples` on the headless host port.
+ *
+ * Usage: lv_host [-n frames] [-o file.ppm] <scene>
+ *        lv_host -l    list the scenes
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lv_port_host.h"
+#include "lv_examples/lv_apps/demo/demo.h"
+#include "lv_examples/lv_apps/benchmark/benchmark.h"
+#include "lv_examples/lv_tests/lv_test.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEF_FRAMES  100
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const char * name;
+    void (*create)(void);
+} scene_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void test_chart_2(void);
+static void test_chart_3(void);
+static void test_group_1(void);
+static const scene_t * find_scene(const char * name);
+static void print_usage(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const scene_t scenes[] = {
+    {"demo", demo_create},
+    {"benchmark", benchmark_create},
+    {"lv_test_object_1", lv_test_object_1},
+    {"lv_test_stress_1", lv_test_stress_1},
+    {"lv_test_group_1", test_group_1},
+    {"lv_test_arc_1", lv_test_arc_1},
+    {"lv_test_bar_1", lv_test_bar_1},
+    {"lv_test_btn_1", lv_test_btn_1},
+    {"lv_test_btnm_1", lv_test_btnm_1},
+    {"lv_test_cb_1", lv_test_cb_1},
+    {"lv_test_canvas_1", lv_test_canvas_1},
+    {"lv_test_chart_1", lv_test_chart_1},
+    {"lv_test_chart_2", test_chart_2},
+    {"lv_test_chart_3", test_chart_3},
+    {"lv_test_cont_1", lv_test_cont_1},
+    {"lv_test_cont_2", lv_test_cont_2},
+    {"lv_test_ddlist_1", lv_test_ddlist_1},
+    {"lv_test_gauge_1", lv_test_gauge_1},
+    {"lv_test_img_1", lv_test_img_1},
+    {"lv_test_imgbtn_1", lv_test_imgbtn_1},
+    {"lv_test_kb_1", lv_test_kb_1},
+    {"lv_test_kb_2", lv_test_kb_2},
+    {"lv_test_label_1", lv_test_label_1},
+    {"lv_test_label_2", lv_test_label_2},
+    {"lv_test_label_3", lv_test_label_3},
+    {"lv_test_label_4", lv_test_label_4},
+    {"lv_test_led_1", lv_test_led_1},
+    {"lv_test_line_1", lv_test_line_1},
+    {"lv_test_list_1", lv_test_list_1},
+    {"lv_test_lmeter_1", lv_test_lmeter_1},
+    {"lv_test_mbox_1", lv_test_mbox_1},
+    {"lv_test_page_1", lv_test_page_1},
+    {"lv_test_page_2", lv_test_page_2},
+    {"lv_test_preload_1", lv_test_preload_1},
+    {"lv_test_roller_1", lv_test_roller_1},
+    {"lv_test_slider_1", lv_test_slider_1},
+    {"lv_test_sw_1", lv_test_sw_1},
+    {"lv_test_ta_1", lv_test_ta_1},
+    {"lv_test_ta_2", lv_test_ta_2},
+    {"lv_test_table_1", lv_test_table_1},
+    {"lv_test_table_2", lv_test_table_2},
+    {"lv_test_tabview_1", lv_test_tabview_1},
+    {"lv_test_tabview_2", lv_test_tabview_2},
+    {"lv_test_tileview_1", lv_test_tileview_1},
+    {"lv_test_win_1", lv_test_win_1},
+    {NULL, NULL},
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char ** argv)
+{
+    uint32_t frames     = DEF_FRAMES;
+    const char * ppm    = NULL;
+    const scene_t * scn = NULL;
+    int i;
+
+    for(i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-l") == 0) {
+            const scene_t * s;
+            for(s = scenes; s->name; s++) printf("%s\n", s->name);
+            return 0;
+        } else if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            frames = strtoul(argv[++i], NULL, 0);
+        } else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            ppm = argv[++i];
+        } else if(scn == NULL) {
+            scn = find_scene(argv[i]);
+            if(scn == NULL) {
+                fprintf(stderr, "unknown scene: %s\n", argv[i]);
+                return 1;
+            }
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if(scn == NULL) {
+        print_usage();
+        return 1;
+    }
+
+    lv_port_host_init();
+    scn->create();
+    lv_port_host_run(frames);
+
+    lv_port_host_stat_t stat;
+    lv_port_host_get_stat(&stat);
+    printf("%s: %u frames, %u refreshes, %u px, crc %08x\n", scn->name, frames, stat.refr_cnt, stat.refr_px,
+           lv_port_host_get_fb_crc());
+
+    if(ppm && lv_port_host_save_ppm(ppm) != LV_RES_OK) {
+        fprintf(stderr, "can't write %s\n", ppm);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_chart_2(void)
+{
+    lv_test_chart_2(0);
+}
+
+static void test_chart_3(void)
+{
+    lv_test_chart_3(LV_CHART_TYPE_LINE);
+}
+
+/*There is no keypad so the group is only created and drawn*/
+static void test_group_1(void)
+{
+    lv_test_group_1();
+}
+
+static const scene_t * find_scene(const char * name)
+{
+    const scene_t * s;
+    for(s = scenes; s->name; s++) {
+        if(strcmp(s->name, name) == 0) return s;
+    }
+
+    return NULL;
+}
+
+static void print_usage(void)
+{
+    fprintf(stderr, "usage: lv_host [-n frames] [-o file.ppm] <scene>\n"
+                    "       lv_host -l\n");
+}
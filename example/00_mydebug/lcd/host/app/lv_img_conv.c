@@ -0,0 +1,366 @@
+/**
+ * @file lv_img_conv.c
+ * Convert an RGB565 image to a line indexed compressed image (QLI, see lv_img_qli.h).
+ * The output is a blob to program into the (QSPI) flash or a C source with an `lv_img_dsc_t`.
+ *
+ * Usage: lv_img_conv [options] input output
+ *   input: binary PPM (P6), a C source with an RGB565 array or raw little endian RGB565 pixels
+ *   -a name        array of the C source (default: the first array)
+ *   -W w -H h      size of a C array or raw input (a C array is a square of its length if not given)
+ *   -k bytes       skip this many bytes at the beginning of the pixels (e.g. a header)
+ *   -s             the RGB565 pixels are big endian
+ *   -c name        write a C source with an `lv_img_dsc_t` called `name` instead of a blob
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define C_BYTES_PER_LINE    16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const char * array;
+    long w;
+    long h;
+    long skip;
+    bool swap;
+    const char * c_name;
+} conv_opt_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint8_t * read_file(const char * path, size_t * size);
+static uint16_t * load_ppm(const uint8_t * file, size_t size, long * w, long * h);
+static uint8_t * load_c_array(const char * text, const char * name, size_t * size);
+static bool verify(const lv_img_dsc_t * dsc, const uint16_t * px);
+static int write_blob(const char * path, const lv_img_dsc_t * dsc);
+static int write_c(const char * path, const char * name, const lv_img_dsc_t * dsc);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char ** argv)
+{
+    conv_opt_t opt;
+    memset(&opt, 0, sizeof(opt));
+
+    int i;
+    for(i = 1; i < argc - 2; i++) {
+        if(strcmp(argv[i], "-a") == 0) opt.array = argv[++i];
+        else if(strcmp(argv[i], "-W") == 0) opt.w = strtol(argv[++i], NULL, 0);
+        else if(strcmp(argv[i], "-H") == 0) opt.h = strtol(argv[++i], NULL, 0);
+        else if(strcmp(argv[i], "-k") == 0) opt.skip = strtol(argv[++i], NULL, 0);
+        else if(strcmp(argv[i], "-s") == 0) opt.swap = true;
+        else if(strcmp(argv[i], "-c") == 0) opt.c_name = argv[++i];
+        else break;
+    }
+
+    if(i != argc - 2) {
+        fprintf(stderr, "usage: lv_img_conv [-a array] [-W w -H h] [-k bytes] [-s] [-c name] input output\n");
+        return 1;
+    }
+
+    const char * in_path  = argv[argc - 2];
+    const char * out_path = argv[argc - 1];
+
+    size_t size;
+    uint8_t * file = read_file(in_path, &size);
+    if(file == NULL) {
+        fprintf(stderr, "can't read %s\n", in_path);
+        return 1;
+    }
+
+    /*Get the RGB565 pixels*/
+    uint16_t * px = NULL;
+    long w        = opt.w;
+    long h        = opt.h;
+    if(size > 2 && file[0] == 'P' && file[1] == '6') {
+        px = load_ppm(file, size, &w, &h);
+    } else {
+        uint8_t * bytes = file;
+        const char * ext = strrchr(in_path, '.');
+        if(ext && (strcmp(ext, ".c") == 0 || strcmp(ext, ".h") == 0)) {
+            bytes = load_c_array((const char *)file, opt.array, &size);
+            free(file);
+            file = bytes;
+        }
+
+        if(bytes == NULL || (size_t)opt.skip > size) {
+            fprintf(stderr, "no pixels in %s\n", in_path);
+            return 1;
+        }
+
+        size_t px_cnt = (size - opt.skip) / 2;
+        if(w == 0 && h == 0) {
+            for(w = 1; (size_t)(w * w) < px_cnt; w++);
+            h = w;
+        }
+
+        if(w <= 0 || h <= 0 || (size_t)(w * h) > px_cnt) {
+            fprintf(stderr, "%s has %lu pixels instead of %ldx%ld\n", in_path, (unsigned long)px_cnt, w, h);
+            return 1;
+        }
+
+        px = malloc(w * h * sizeof(uint16_t));
+        long p;
+        for(p = 0; px && p < w * h; p++) {
+            const uint8_t * b = &bytes[opt.skip + p * 2];
+            px[p] = opt.swap ? (uint16_t)((b[0] << 8) | b[1]) : (uint16_t)(b[0] | (b[1] << 8));
+        }
+    }
+
+    free(file);
+    if(px == NULL || w > 2047 || h > 2047) {
+        fprintf(stderr, "can't load %s\n", in_path);
+        return 1;
+    }
+
+    /*Code the image and check it by decoding every line*/
+    uint32_t max_size = LV_IMG_QLI_MAX_SIZE(w, h);
+    uint8_t * data    = malloc(max_size);
+    lv_img_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.header.cf = LV_IMG_CF_QLI;
+    dsc.header.w  = w;
+    dsc.header.h  = h;
+    dsc.data_size = data ? lv_img_qli_encode(px, w, h, data, max_size) : 0;
+    dsc.data      = data;
+
+    if(dsc.data_size == 0 || verify(&dsc, px) == false) {
+        fprintf(stderr, "can't code %s\n", in_path);
+        return 1;
+    }
+
+    uint32_t raw_size = w * h * 2;
+    printf("%s: %ldx%ld, %u -> %u bytes (%u %%)\n", in_path, w, h, raw_size, dsc.data_size,
+           dsc.data_size * 100 / raw_size);
+
+    int res = opt.c_name ? write_c(out_path, opt.c_name, &dsc) : write_blob(out_path, &dsc);
+
+    free(px);
+    free(data);
+
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint8_t * read_file(const char * path, size_t * size)
+{
+    FILE * f = fopen(path, "rb");
+    if(f == NULL) return NULL;
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    /*Zero terminated to parse it as a text too*/
+    uint8_t * buf = malloc(len + 1);
+    if(buf && fread(buf, 1, len, f) != (size_t)len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+
+    if(buf) {
+        buf[len] = '\0';
+        *size    = len;
+    }
+
+    return buf;
+}
+
+/*Binary PPM with 8 bit channels*/
+static uint16_t * load_ppm(const uint8_t * file, size_t size, long * w, long * h)
+{
+    const char * p = (const char *)file + 2;
+    long v[3];
+    int n;
+    for(n = 0; n < 3; n++) {
+        while(isspace((unsigned char)*p) || *p == '#') {
+            if(*p == '#') while(*p != '\n' && *p != '\0') p++;
+            else p++;
+        }
+        char * end;
+        v[n] = strtol(p, &end, 10);
+        p    = end;
+    }
+    p++; /*The single white space before the pixels*/
+
+    *w = v[0];
+    *h = v[1];
+    const uint8_t * rgb = (const uint8_t *)p;
+    if(v[2] != 255 || *w <= 0 || *h <= 0 || rgb + *w * *h * 3 > file + size) return NULL;
+
+    uint16_t * px = malloc(*w * *h * sizeof(uint16_t));
+    long i;
+    for(i = 0; px && i < *w * *h; i++) {
+        px[i] = (uint16_t)(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+        rgb += 3;
+    }
+
+    return px;
+}
+
+/*The elements of a C array of 8 or 16 bit numbers as little endian bytes*/
+static uint8_t * load_c_array(const char * text, const char * name, size_t * size)
+{
+    const char * start = text;
+    const char * p;
+    for(p = strchr(text, '['); p; p = strchr(p + 1, '[')) {
+        /*The name before the bracket*/
+        const char * n = p;
+        while(n > text && (isalnum((unsigned char)n[-1]) || n[-1] == '_')) n--;
+        if(name == NULL || ((size_t)(p - n) == strlen(name) && strncmp(n, name, p - n) == 0)) break;
+        start = p;
+    }
+    if(p == NULL) return NULL;
+
+    /*The type is between the previous statement and the name*/
+    const char * decl = p;
+    while(decl > start && decl[-1] != ';' && decl[-1] != '}' && decl[-1] != '\n') decl--;
+    char type[128];
+    size_t type_len = LV_MATH_MIN((size_t)(p - decl), sizeof(type) - 1);
+    memcpy(type, decl, type_len);
+    type[type_len] = '\0';
+    int elem_size = (strstr(type, "16") || strstr(type, "short")) ? 2 : 1;
+
+    p = strchr(p, '{');
+    const char * end = p ? strchr(p, '}') : NULL;
+    if(end == NULL) return NULL;
+
+    uint8_t * bytes = malloc((end - p) * 2);
+    size_t len = 0;
+    uint32_t skip = 0; /*Number of the skipped `#if` blocks around `p`*/
+    p++;
+    while(bytes && p < end) {
+        if(p[0] == '#') {
+            /*Only `#if <number>`, `#else` and `#endif` are expected in the data of an image*/
+            const char * d = p + 1;
+            while(*d == ' ') d++;
+            if(strncmp(d, "if", 2) == 0 && d[2] != 'd' && d[2] != 'n') {
+                if(skip || strtol(d + 2, NULL, 0) == 0) skip++;
+            } else if(strncmp(d, "else", 4) == 0) {
+                if(skip <= 1) skip = !skip;
+            } else if(strncmp(d, "endif", 5) == 0) {
+                if(skip) skip--;
+            }
+            p = strchr(p, '\n');
+            if(p == NULL) break;
+        } else if(skip) {
+            p++;
+        } else if(isxdigit((unsigned char)*p)) {
+            char * num_end;
+            unsigned long v = strtoul(p, &num_end, 0);
+            p = num_end == p ? p + 1 : num_end;
+            bytes[len++] = (uint8_t)v;
+            if(elem_size == 2) bytes[len++] = (uint8_t)(v >> 8);
+        } else if(p[0] == '/' && p[1] == '*') {
+            p = strstr(p, "*/");
+            if(p == NULL) break;
+            p += 2;
+        } else {
+            p++;
+        }
+    }
+
+    *size = len;
+    return bytes;
+}
+
+static bool verify(const lv_img_dsc_t * dsc, const uint16_t * px)
+{
+    lv_color_t * line = malloc(dsc->header.w * sizeof(lv_color_t));
+    bool ok = line != NULL;
+
+    lv_coord_t y;
+    for(y = 0; ok && y < dsc->header.h; y++) {
+        if(lv_img_qli_read_line(dsc, 0, y, dsc->header.w, line) != LV_RES_OK) ok = false;
+
+        lv_coord_t x;
+        for(x = 0; ok && x < dsc->header.w; x++) {
+            lv_color_t c = line[x];
+#if LV_COLOR_DEPTH == 16
+            uint16_t c565 = (uint16_t)((LV_COLOR_GET_R(c) << 11) | (LV_COLOR_GET_G(c) << 5) | LV_COLOR_GET_B(c));
+#else
+            uint16_t c565 = (uint16_t)(((LV_COLOR_GET_R(c) >> 3) << 11) | ((LV_COLOR_GET_G(c) >> 2) << 5) |
+                                       (LV_COLOR_GET_B(c) >> 3));
+#endif
+            if(c565 != px[y * dsc->header.w + x]) ok = false;
+        }
+    }
+
+    free(line);
+    return ok;
+}
+
+static int write_blob(const char * path, const lv_img_dsc_t * dsc)
+{
+    FILE * f = fopen(path, "wb");
+    if(f == NULL) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+
+    uint8_t head[LV_IMG_QLI_BLOB_HEADER_SIZE];
+    memcpy(head, &dsc->header, sizeof(lv_img_header_t));
+    head[4] = (uint8_t)dsc->data_size;
+    head[5] = (uint8_t)(dsc->data_size >> 8);
+    head[6] = (uint8_t)(dsc->data_size >> 16);
+    head[7] = (uint8_t)(dsc->data_size >> 24);
+
+    fwrite(head, 1, sizeof(head), f);
+    fwrite(dsc->data, 1, dsc->data_size, f);
+    fclose(f);
+
+    return 0;
+}
+
+static int write_c(const char * path, const char * name, const lv_img_dsc_t * dsc)
+{
+    FILE * f = fopen(path, "w");
+    if(f == NULL) {
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+
+    fprintf(f, "#include \"lvgl/lvgl.h\"\n\n");
+    fprintf(f, "#ifndef LV_ATTRIBUTE_MEM_ALIGN\n#define LV_ATTRIBUTE_MEM_ALIGN\n#endif\n\n");
+    fprintf(f, "/*Line indexed compressed image (QLI) of %dx%d RGB565 pixels*/\n", dsc->header.w, dsc->header.h);
+    fprintf(f, "const LV_ATTRIBUTE_MEM_ALIGN uint8_t %s_map[] = {\n", name);
+
+    uint32_t i;
+    for(i = 0; i < dsc->data_size; i++) {
+        fprintf(f, "%s0x%02x,%s", i % C_BYTES_PER_LINE ? "" : "  ", dsc->data[i],
+                (i % C_BYTES_PER_LINE == C_BYTES_PER_LINE - 1 || i == dsc->data_size - 1) ? "\n" : " ");
+    }
+
+    fprintf(f, "};\n\n");
+    fprintf(f, "const lv_img_dsc_t %s = {\n", name);
+    fprintf(f, "  .header.always_zero = 0,\n");
+    fprintf(f, "  .header.w = %d,\n", dsc->header.w);
+    fprintf(f, "  .header.h = %d,\n", dsc->header.h);
+    fprintf(f, "  .data_size = %u,\n", dsc->data_size);
+    fprintf(f, "  .header.cf = LV_IMG_CF_QLI,\n");
+    fprintf(f, "  .data = %s_map,\n", name);
+    fprintf(f, "};\n");
+    fclose(f);
+
+    return 0;
+}
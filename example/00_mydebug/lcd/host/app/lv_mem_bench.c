@@ -0,0 +1,427 @@
+/**
+ * @file lv_mem_bench.c
+ * Stress benchmark of `lv_mem`: record the allocations of `lv_test_stress_1` and replay them with timing.
+ *
+ * Usage: lv_mem_bench [-n frames] [-x passes] [-p bytes] [-w trace.txt | -r trace.txt]
+ *        lv_mem_bench -d count
+ *   -n frames      record this many frames of `lv_test_stress_1` (default 2000)
+ *   -x passes      replay the trace this many times (default 20)
+ *   -p bytes       add a second pool of this size before replaying
+ *   -w trace.txt   write the recorded trace
+ *   -r trace.txt   replay this trace instead of recording one
+ *   -d count       create and delete the screen of `demo_create` this many times and measure it
+ *
+ * Trace lines: `a <id> <size>` alloc, `f <id>` free, `r <old id> <id> <size>` realloc.
+ * The ids number the allocations, -1 is NULL or a 0 size allocation.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lv_port_host.h"
+#include "lv_examples/lv_tests/lv_test_stress/lv_test_stress.h"
+#include "lv_examples/lv_apps/demo/demo.h"
+#include "lvgl/src/lv_misc/lv_gc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEF_FRAMES  2000
+#define DEF_PASSES  20
+#define NO_ID       (-1)
+#define TASK_MAX    32
+
+/*Check the fragmentation after this many operations (`lv_mem_monitor` walks the blocks)*/
+#define MON_PERIOD  64
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    char op;        /*'a', 'f' or 'r'*/
+    int32_t old_id; /*Freed or reallocated memory*/
+    int32_t id;     /*Allocated memory*/
+    uint32_t size;
+} trace_op_t;
+
+typedef struct
+{
+    uint32_t cnt;
+    uint64_t sum_ns;
+    uint32_t max_ns;
+} op_time_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void trace_cb(lv_mem_trace_op_t op, const void * old_p, const void * new_p, size_t size);
+static int32_t ptr_to_id(const void * p, bool remove);
+static void trace_add(char op, int32_t old_id, int32_t id, uint32_t size);
+static int trace_write(const char * path);
+static int trace_read(const char * path);
+static void replay(uint32_t passes);
+static void demo_bench(uint32_t cnt);
+static bool task_is_known(const lv_task_t * task, lv_task_t * const * tasks, uint32_t task_cnt);
+static uint64_t time_ns(void);
+static void print_time(const char * name, const op_time_t * t);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static trace_op_t * trace;
+static uint32_t trace_cnt;
+static uint32_t trace_cap;
+static int32_t id_cnt;
+
+/*Live allocations of the recording: pointer and id*/
+static const void ** live_ptr;
+static int32_t * live_id;
+static uint32_t live_cnt;
+static uint32_t live_cap;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char ** argv)
+{
+    uint32_t frames     = DEF_FRAMES;
+    uint32_t passes     = DEF_PASSES;
+    size_t pool_size    = 0;
+    uint32_t demo_cnt   = 0;
+    const char * w_path = NULL;
+    const char * r_path = NULL;
+    int i;
+
+    for(i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-n") == 0 && i + 1 < argc) frames = strtoul(argv[++i], NULL, 0);
+        else if(strcmp(argv[i], "-x") == 0 && i + 1 < argc) passes = strtoul(argv[++i], NULL, 0);
+        else if(strcmp(argv[i], "-p") == 0 && i + 1 < argc) pool_size = strtoul(argv[++i], NULL, 0);
+        else if(strcmp(argv[i], "-w") == 0 && i + 1 < argc) w_path = argv[++i];
+        else if(strcmp(argv[i], "-r") == 0 && i + 1 < argc) r_path = argv[++i];
+        else if(strcmp(argv[i], "-d") == 0 && i + 1 < argc) demo_cnt = strtoul(argv[++i], NULL, 0);
+        else {
+            fprintf(stderr, "usage: lv_mem_bench [-n frames] [-x passes] [-p bytes] [-w trace.txt | -r trace.txt]\n"
+                            "       lv_mem_bench -d count\n");
+            return 1;
+        }
+    }
+
+    if(demo_cnt) {
+        demo_bench(demo_cnt);
+        return 0;
+    }
+
+    if(r_path) {
+        if(trace_read(r_path) != 0) {
+            fprintf(stderr, "can't read %s\n", r_path);
+            return 1;
+        }
+        lv_mem_init();
+    } else {
+        /*Record from the first allocation of `lv_init`*/
+        lv_mem_set_trace_cb(trace_cb);
+        lv_port_host_init();
+        lv_test_stress_1();
+        lv_port_host_run(frames);
+        lv_mem_set_trace_cb(NULL);
+
+        lv_mem_monitor_t mon;
+        lv_mem_monitor(&mon);
+        printf("recorded %u frames: %u operations, %d allocations, max used %u, frag %u %%\n", frames, trace_cnt,
+               id_cnt, mon.max_used, mon.frag_pct);
+
+        if(w_path && trace_write(w_path) != 0) {
+            fprintf(stderr, "can't write %s\n", w_path);
+            return 1;
+        }
+
+        /*LVGL is not used from here, only the allocator*/
+        lv_mem_deinit();
+    }
+
+    static uint8_t * pool;
+    if(pool_size) {
+        pool = malloc(pool_size);
+        if(pool == NULL || lv_mem_add_pool(pool, pool_size) != LV_RES_OK) {
+            fprintf(stderr, "can't add a pool of %lu bytes\n", (unsigned long)pool_size);
+            return 1;
+        }
+    }
+
+    replay(passes);
+
+    free(pool);
+    free(trace);
+    free(live_ptr);
+    free(live_id);
+
+    return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void trace_cb(lv_mem_trace_op_t op, const void * old_p, const void * new_p, size_t size)
+{
+    if(op == LV_MEM_TRACE_FREE) {
+        int32_t old_id = ptr_to_id(old_p, true);
+        if(old_id != NO_ID) trace_add('f', old_id, NO_ID, 0);
+        return;
+    }
+
+    int32_t old_id = op == LV_MEM_TRACE_REALLOC ? ptr_to_id(old_p, true) : NO_ID;
+    int32_t id     = NO_ID;
+
+    /*The failed allocations get an id too: they might succeed in the replay*/
+    if(size != 0) id = id_cnt++;
+
+    if(new_p && id != NO_ID) {
+        if(live_cnt == live_cap) {
+            live_cap = live_cap ? live_cap * 2 : 256;
+            live_ptr = realloc(live_ptr, live_cap * sizeof(live_ptr[0]));
+            live_id  = realloc(live_id, live_cap * sizeof(live_id[0]));
+        }
+        live_ptr[live_cnt] = new_p;
+        live_id[live_cnt]  = id;
+        live_cnt++;
+    }
+
+    trace_add(op == LV_MEM_TRACE_REALLOC ? 'r' : 'a', old_id, id, (uint32_t)size);
+}
+
+/*Find the id of a live allocation. The 0 size allocations share one address so they are not tracked.*/
+static int32_t ptr_to_id(const void * p, bool remove)
+{
+    uint32_t i;
+    for(i = live_cnt; i > 0; i--) {
+        if(live_ptr[i - 1] == p) {
+            int32_t id = live_id[i - 1];
+            if(remove) {
+                live_cnt--;
+                live_ptr[i - 1] = live_ptr[live_cnt];
+                live_id[i - 1]  = live_id[live_cnt];
+            }
+            return id;
+        }
+    }
+
+    return NO_ID;
+}
+
+static void trace_add(char op, int32_t old_id, int32_t id, uint32_t size)
+{
+    if(trace_cnt == trace_cap) {
+        trace_cap = trace_cap ? trace_cap * 2 : 4096;
+        trace     = realloc(trace, trace_cap * sizeof(trace[0]));
+    }
+
+    trace[trace_cnt].op     = op;
+    trace[trace_cnt].old_id = old_id;
+    trace[trace_cnt].id     = id;
+    trace[trace_cnt].size   = size;
+    trace_cnt++;
+}
+
+static int trace_write(const char * path)
+{
+    FILE * f = fopen(path, "w");
+    if(f == NULL) return 1;
+
+    uint32_t i;
+    for(i = 0; i < trace_cnt; i++) {
+        const trace_op_t * t = &trace[i];
+        if(t->op == 'a') fprintf(f, "a %d %u\n", t->id, t->size);
+        else if(t->op == 'f') fprintf(f, "f %d\n", t->old_id);
+        else fprintf(f, "r %d %d %u\n", t->old_id, t->id, t->size);
+    }
+
+    fclose(f);
+    return 0;
+}
+
+static int trace_read(const char * path)
+{
+    FILE * f = fopen(path, "r");
+    if(f == NULL) return 1;
+
+    char line[64];
+    while(fgets(line, sizeof(line), f)) {
+        int32_t old_id = NO_ID;
+        int32_t id     = NO_ID;
+        uint32_t size  = 0;
+        if(line[0] == 'a' && sscanf(line, "a %d %u", &id, &size) == 2) trace_add('a', NO_ID, id, size);
+        else if(line[0] == 'f' && sscanf(line, "f %d", &old_id) == 1) trace_add('f', old_id, NO_ID, 0);
+        else if(line[0] == 'r' && sscanf(line, "r %d %d %u", &old_id, &id, &size) == 3) trace_add('r', old_id, id, size);
+        else continue;
+
+        if(id >= id_cnt) id_cnt = id + 1;
+    }
+
+    fclose(f);
+    return 0;
+}
+
+/*Run the trace `passes` times. Everything is freed at the end of every pass.*/
+static void replay(uint32_t passes)
+{
+    void ** ptrs = calloc(id_cnt ? id_cnt : 1, sizeof(void *));
+    op_time_t t_alloc;
+    op_time_t t_free;
+    op_time_t t_realloc;
+    memset(&t_alloc, 0, sizeof(t_alloc));
+    memset(&t_free, 0, sizeof(t_free));
+    memset(&t_realloc, 0, sizeof(t_realloc));
+    uint32_t fail_cnt = 0;
+    uint8_t frag_max  = 0;
+    lv_mem_monitor_t mon;
+
+    uint32_t p;
+    for(p = 0; p < passes; p++) {
+        uint32_t i;
+        for(i = 0; i < trace_cnt; i++) {
+            const trace_op_t * t = &trace[i];
+            void * old_p         = t->old_id != NO_ID ? ptrs[t->old_id] : NULL;
+            op_time_t * tm;
+            void * new_p = NULL;
+
+            uint64_t start = time_ns();
+            if(t->op == 'a') {
+                new_p = lv_mem_alloc(t->size);
+                tm    = &t_alloc;
+            } else if(t->op == 'f') {
+                lv_mem_free(old_p);
+                tm = &t_free;
+            } else {
+                new_p = lv_mem_realloc(old_p, t->size);
+                tm    = &t_realloc;
+            }
+            uint32_t ns = (uint32_t)(time_ns() - start);
+
+            tm->cnt++;
+            tm->sum_ns += ns;
+            if(ns > tm->max_ns) tm->max_ns = ns;
+
+            /*The memory of a failed realloc is still allocated*/
+            if(t->old_id != NO_ID && (t->op == 'f' || new_p != NULL)) ptrs[t->old_id] = NULL;
+            if(t->id != NO_ID) {
+                ptrs[t->id] = new_p;
+                if(new_p == NULL) fail_cnt++;
+            }
+
+            if(i % MON_PERIOD == 0) {
+                lv_mem_monitor(&mon);
+                if(mon.frag_pct > frag_max) frag_max = mon.frag_pct;
+            }
+        }
+
+        /*Free what the trace left allocated*/
+        int32_t id;
+        for(id = 0; id < id_cnt; id++) {
+            lv_mem_free(ptrs[id]);
+            ptrs[id] = NULL;
+        }
+    }
+
+    lv_mem_monitor(&mon);
+    printf("replayed %u x %u operations on %u bytes\n", passes, trace_cnt, mon.total_size);
+    print_time("alloc", &t_alloc);
+    print_time("free", &t_free);
+    print_time("realloc", &t_realloc);
+    printf("failed allocations: %u, max used: %u, max frag: %u %%, free blocks at the end: %u\n", fail_cnt,
+           mon.max_used, frag_max, mon.free_cnt);
+
+    free(ptrs);
+}
+
+/*Create the demo on a new screen and delete it again `cnt` times*/
+static void demo_bench(uint32_t cnt)
+{
+    lv_port_host_init();
+
+    lv_obj_t * scr_ori = lv_disp_get_scr_act(NULL);
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t used_start = mon.total_size - mon.free_size;
+    uint32_t used_demo  = 0;
+    uint8_t frag_demo   = 0;
+    op_time_t t_create;
+    op_time_t t_del;
+    memset(&t_create, 0, sizeof(t_create));
+    memset(&t_del, 0, sizeof(t_del));
+
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        /*The demo creates a task for the tab view: delete it with the screen*/
+        lv_task_t * tasks[TASK_MAX];
+        uint32_t task_cnt = 0;
+        lv_task_t * task;
+        LV_LL_READ(LV_GC_ROOT(_lv_task_ll), task) {
+            if(task_cnt < TASK_MAX) tasks[task_cnt++] = task;
+        }
+
+        uint64_t start = time_ns();
+        lv_obj_t * scr = lv_obj_create(NULL, NULL);
+        lv_disp_load_scr(scr);
+        demo_create();
+        uint32_t ns = (uint32_t)(time_ns() - start);
+        t_create.cnt++;
+        t_create.sum_ns += ns;
+        if(ns > t_create.max_ns) t_create.max_ns = ns;
+
+        lv_mem_monitor(&mon);
+        used_demo = mon.total_size - mon.free_size - used_start;
+        frag_demo = mon.frag_pct;
+
+        start = time_ns();
+        lv_disp_load_scr(scr_ori);
+        lv_obj_del(scr);
+        ns = (uint32_t)(time_ns() - start);
+        t_del.cnt++;
+        t_del.sum_ns += ns;
+        if(ns > t_del.max_ns) t_del.max_ns = ns;
+
+        lv_task_t * task_next;
+        for(task = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll)); task != NULL; task = task_next) {
+            task_next = lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), task);
+            if(!task_is_known(task, tasks, task_cnt)) lv_task_del(task);
+        }
+    }
+
+    lv_mem_monitor(&mon);
+    printf("demo_create %u times\n", cnt);
+    print_time("create", &t_create);
+    print_time("delete", &t_del);
+    printf("heap of the demo: %u, frag: %u %%, max used: %u, frag after delete: %u %%\n", used_demo, frag_demo,
+           mon.max_used, mon.frag_pct);
+}
+
+static bool task_is_known(const lv_task_t * task, lv_task_t * const * tasks, uint32_t task_cnt)
+{
+    uint32_t i;
+    for(i = 0; i < task_cnt; i++) {
+        if(tasks[i] == task) return true;
+    }
+
+    return false;
+}
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void print_time(const char * name, const op_time_t * t)
+{
+    printf("%-8s %8u ops, avg %5u ns, max %6u ns\n", name, t->cnt,
+           t->cnt ? (uint32_t)(t->sum_ns / t->cnt) : 0, t->max_ns);
+}
@@ -0,0 +1,224 @@
+/**
+ * @file lv_port_host.c
+ * Headless port of LVGL for Linux: RAM frame buffer display,
+ * deterministic tick and a pointer controlled by the application
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <string.h>
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FB_PX   ((uint32_t)LV_HOR_RES_MAX * LV_VER_RES_MAX)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+static void disp_monitor(lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px);
+static bool indev_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data);
+static void indev_monitor(lv_indev_drv_t * indev_drv, uint32_t time, uint32_t obj_cnt);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_color_t fb[FB_PX];
+static lv_color_t buf_1[LV_HOR_RES_MAX * LV_PORT_HOST_BUF_ROWS];
+static lv_color_t buf_2[LV_HOR_RES_MAX * LV_PORT_HOST_BUF_ROWS];
+static uint32_t img_cache_mem[LV_PORT_HOST_IMG_CACHE_SIZE / sizeof(uint32_t)];
+static lv_disp_buf_t disp_buf;
+static lv_port_host_stat_t stat;
+static lv_point_t pointer_point;
+static bool pointer_pressed;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize LVGL, register the RAM frame buffer display, the pointer
+ * and the memory of the image cache
+ */
+void lv_port_host_init(void)
+{
+    lv_init();
+
+    lv_disp_buf_init(&disp_buf, buf_1, buf_2, LV_HOR_RES_MAX * LV_PORT_HOST_BUF_ROWS);
+
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res    = LV_HOR_RES_MAX;
+    disp_drv.ver_res    = LV_VER_RES_MAX;
+    disp_drv.flush_cb   = disp_flush;
+    disp_drv.monitor_cb = disp_monitor;
+    disp_drv.buffer     = &disp_buf;
+    lv_disp_drv_register(&disp_drv);
+
+    /*A pointer released on (0;0) until `lv_port_host_set_pointer` presses it*/
+    lv_indev_drv_t indev_drv;
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type       = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb    = indev_read;
+    indev_drv.monitor_cb = indev_monitor;
+    lv_indev_drv_register(&indev_drv);
+
+    pointer_point.x = 0;
+    pointer_point.y = 0;
+    pointer_pressed = false;
+
+    lv_img_cache_set_mem(img_cache_mem, sizeof(img_cache_mem));
+
+    memset(fb, 0, sizeof(fb));
+    lv_port_host_reset_stat();
+}
+
+/**
+ * Advance the time and run the LVGL tasks once.
+ * The time is only advanced by this function so the runs are reproducible.
+ * @param ms elapsed milliseconds
+ */
+void lv_port_host_step(uint32_t ms)
+{
+    lv_tick_inc(ms);
+    lv_task_handler();
+}
+
+/**
+ * Run `frames` refresh periods (`LV_DISP_DEF_REFR_PERIOD` ms each)
+ * @param frames number of refresh periods
+ */
+void lv_port_host_run(uint32_t frames)
+{
+    uint32_t i;
+    for(i = 0; i < frames; i++) {
+        lv_port_host_step(LV_DISP_DEF_REFR_PERIOD);
+    }
+}
+
+/**
+ * Get the frame buffer. It's `LV_HOR_RES_MAX` x `LV_VER_RES_MAX` pixels.
+ * @return pointer to the first pixel
+ */
+lv_color_t * lv_port_host_get_fb(void)
+{
+    return fb;
+}
+
+/**
+ * Get a checksum of the frame buffer to compare renderings
+ * @return CRC-32 of the frame buffer
+ */
+uint32_t lv_port_host_get_fb_crc(void)
+{
+    const uint8_t * p = (const uint8_t *)fb;
+    uint32_t crc      = 0xFFFFFFFF;
+    uint32_t i;
+    uint8_t b;
+
+    for(i = 0; i < sizeof(fb); i++) {
+        crc ^= p[i];
+        for(b = 0; b < 8; b++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+
+    return ~crc;
+}
+
+/**
+ * Write the frame buffer into a binary PPM file
+ * @param path path of the file
+ * @return LV_RES_OK: the file is written; LV_RES_INV: the file can't be opened
+ */
+lv_res_t lv_port_host_save_ppm(const char * path)
+{
+    FILE * f = fopen(path, "wb");
+    if(f == NULL) return LV_RES_INV;
+
+    fprintf(f, "P6\n%d %d\n255\n", LV_HOR_RES_MAX, LV_VER_RES_MAX);
+
+    uint32_t i;
+    for(i = 0; i < FB_PX; i++) {
+        uint32_t c32 = lv_color_to32(fb[i]);
+        uint8_t rgb[3];
+        rgb[0] = (c32 >> 16) & 0xFF;
+        rgb[1] = (c32 >> 8) & 0xFF;
+        rgb[2] = c32 & 0xFF;
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+
+    fclose(f);
+    return LV_RES_OK;
+}
+
+/**
+ * Set the state of the pointer. It's read in the next run of the LVGL tasks.
+ * @param point pointer to the point to press. NULL: release the pointer on its last point.
+ */
+void lv_port_host_set_pointer(const lv_point_t * point)
+{
+    if(point) pointer_point = *point;
+    pointer_pressed = point != NULL;
+}
+
+/**
+ * Get the counters of the display and input device drivers
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_port_host_get_stat(lv_port_host_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**
+ * Clear the counters of the display and input device drivers
+ */
+void lv_port_host_reset_stat(void)
+{
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Copy the rendered area to the frame buffer*/
+static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    lv_coord_t w = lv_area_get_width(area);
+    lv_coord_t y;
+
+    for(y = area->y1; y <= area->y2; y++) {
+        memcpy(&fb[(uint32_t)y * LV_HOR_RES_MAX + area->x1], color_p, w * sizeof(lv_color_t));
+        color_p += w;
+    }
+
+    stat.flush_cnt++;
+    stat.flush_px += lv_area_get_size(area);
+
+    lv_disp_flush_ready(disp_drv);
+}
+
+static void disp_monitor(lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px)
+{
+    stat.refr_cnt++;
+    stat.refr_px += px;
+}
+
+static bool indev_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data)
+{
+    data->point = pointer_point;
+    data->state = pointer_pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+
+    return false;
+}
+
+static void indev_monitor(lv_indev_drv_t * indev_drv, uint32_t time, uint32_t obj_cnt)
+{
+    stat.indev_read_cnt++;
+    stat.indev_obj_cnt += obj_cnt;
+    if(obj_cnt > stat.indev_obj_max) stat.indev_obj_max = obj_cnt;
+}
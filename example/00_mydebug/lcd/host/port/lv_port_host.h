@@ -0,0 +1,108 @@
+/**
+ * @file lv_port_host.h
+ * Headless port of LVGL for Linux: RAM frame buffer display,
+ * deterministic tick and a pointer controlled by the application
+ */
+
+#ifndef LV_PORT_HOST_H
+#define LV_PORT_HOST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Rows of a draw buffer. Same as on the board to render in the same strips.*/
+#define LV_PORT_HOST_BUF_ROWS   10
+
+/*Memory of the decoded images of the image cache. It stands for the board's SDRAM.*/
+#define LV_PORT_HOST_IMG_CACHE_SIZE (512U * 1024U)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/**
+ * Counters of the display and input device drivers
+ */
+typedef struct
+{
+    uint32_t refr_cnt;      /**< Refreshes reported by `monitor_cb`*/
+    uint32_t refr_px;       /**< Sum of the refreshed pixels reported by `monitor_cb`*/
+    uint32_t flush_cnt;     /**< Calls of `flush_cb`*/
+    uint32_t flush_px;      /**< Pixels copied to the frame buffer*/
+    uint32_t indev_read_cnt;    /**< Reads of the pointer reported by its `monitor_cb`*/
+    uint32_t indev_obj_cnt;     /**< Sum of the objects tested to find the pressed one*/
+    uint32_t indev_obj_max;     /**< Most objects tested in one read*/
+} lv_port_host_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize LVGL, register the RAM frame buffer display, the pointer
+ * and the memory of the image cache
+ */
+void lv_port_host_init(void);
+
+/**
+ * Advance the time and run the LVGL tasks once.
+ * The time is only advanced by this function so the runs are reproducible.
+ * @param ms elapsed milliseconds
+ */
+void lv_port_host_step(uint32_t ms);
+
+/**
+ * Run `frames` refresh periods (`LV_DISP_DEF_REFR_PERIOD` ms each)
+ * @param frames number of refresh periods
+ */
+void lv_port_host_run(uint32_t frames);
+
+/**
+ * Get the frame buffer. It's `LV_HOR_RES_MAX` x `LV_VER_RES_MAX` pixels.
+ * @return pointer to the first pixel
+ */
+lv_color_t * lv_port_host_get_fb(void);
+
+/**
+ * Get a checksum of the frame buffer to compare renderings
+ * @return CRC-32 of the frame buffer
+ */
+uint32_t lv_port_host_get_fb_crc(void);
+
+/**
+ * Write the frame buffer into a binary PPM file
+ * @param path path of the file
+ * @return LV_RES_OK: the file is written; LV_RES_INV: the file can't be opened
+ */
+lv_res_t lv_port_host_save_ppm(const char * path);
+
+/**
+ * Set the state of the pointer. It's read in the next run of the LVGL tasks.
+ * @param point pointer to the point to press. NULL: release the pointer on its last point.
+ */
+void lv_port_host_set_pointer(const lv_point_t * point);
+
+/**
+ * Get the counters of the display and input device drivers
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_port_host_get_stat(lv_port_host_stat_t * stat);
+
+/**
+ * Clear the counters of the display and input device drivers
+ */
+void lv_port_host_reset_stat(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PORT_HOST_H*/
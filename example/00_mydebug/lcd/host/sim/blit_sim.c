@@ -0,0 +1,72 @@
+/**
+ * @file blit_sim.c
+ * The DMA interface of `lv_port_blit` on the simulated DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "blit_sim.h"
+#include "dma_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void dma_xfer(const lv_port_blit_dma_t * xfer);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_port_blit_hw_t sim_hw = {
+    .dma_xfer = dma_xfer,
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize `lv_port_blit` with the simulated DMA.
+ * The other channels of the DMA are not touched.
+ */
+void blit_sim_init(void)
+{
+    dma_sim_ch_t * ch = dma_sim_get_ch(BLIT_SIM_DMA_CH);
+    ch->en    = false;
+    ch->tc_cb = NULL;
+
+    lv_port_blit_init(&sim_hw);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Set the registers like the board does and let every block trigger the next one*/
+static void dma_xfer(const lv_port_blit_dma_t * xfer)
+{
+    dma_sim_ch_t * ch = dma_sim_get_ch(BLIT_SIM_DMA_CH);
+    ch->sar     = xfer->src;
+    ch->dar     = xfer->dest;
+    ch->width   = xfer->width;
+    ch->blksize = xfer->blk_size == DMA_SIM_BLK_MAX ? 0 : xfer->blk_size;
+    ch->cnt     = xfer->blk_cnt;
+    ch->sinc    = xfer->src_fix ? DMA_SIM_ADDR_FIX : DMA_SIM_ADDR_INC;
+    ch->dinc    = DMA_SIM_ADDR_INC;
+    ch->srpt_en = xfer->src_rpt != 0;
+    ch->srpt    = xfer->src_rpt == DMA_SIM_RPT_MAX ? 0 : xfer->src_rpt;
+    ch->drpt_en = false;
+    ch->sns_en  = xfer->src_ns_cnt != 0;
+    ch->snscnt  = xfer->src_ns_cnt;
+    ch->snsofs  = xfer->src_ns_ofs;
+    ch->dns_en  = xfer->dest_ns_cnt != 0;
+    ch->dnscnt  = xfer->dest_ns_cnt;
+    ch->dnsofs  = xfer->dest_ns_ofs;
+    ch->en      = true;
+
+    dma_sim_run(BLIT_SIM_DMA_CH, 0);
+}
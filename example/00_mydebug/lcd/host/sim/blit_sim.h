@@ -0,0 +1,38 @@
+/**
+ * @file blit_sim.h
+ * The DMA interface of `lv_port_blit` on the simulated DMA
+ */
+
+#ifndef BLIT_SIM_H
+#define BLIT_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/porting/lv_port_blit.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The DMA channel of the blits*/
+#define BLIT_SIM_DMA_CH     3
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize `lv_port_blit` with the simulated DMA.
+ * The other channels of the DMA are not touched.
+ */
+void blit_sim_init(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*BLIT_SIM_H*/
@@ -0,0 +1,232 @@
+/**
+ * @file dma_sim.c
+ * Model of the HC32F4A0 DMA channels for host tests
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "dma_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uintptr_t addr;
+    void (*write_cb)(uint32_t data);
+} port_t;
+
+/*Internal state of a channel which is not visible in the registers*/
+typedef struct
+{
+    uintptr_t sar_start;    /*Reload value of the source address in repeat mode*/
+    uintptr_t dar_start;    /*Reload value of the destination address in repeat mode*/
+    uint32_t sunit_cnt;     /*Source units since the start of the transfer*/
+    uint32_t dunit_cnt;     /*Destination units since the start of the transfer*/
+    bool run;               /*The transfer is started*/
+} ch_state_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t read_unit(uintptr_t addr, uint8_t width);
+static void write_unit(uintptr_t addr, uint8_t width, uint32_t data);
+static uintptr_t step_addr(uintptr_t addr, dma_sim_addr_mode_t mode, uint8_t width);
+static uintptr_t next_addr(uintptr_t addr, uintptr_t start, uint32_t unit_cnt, dma_sim_addr_mode_t mode,
+                           uint8_t width, bool rpt_en, uint16_t rpt, bool ns_en, uint16_t nscnt, uint32_t nsofs);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static dma_sim_ch_t chs[DMA_SIM_CH_NUM];
+static ch_state_t ch_states[DMA_SIM_CH_NUM];
+static port_t ports[DMA_SIM_PORT_NUM];
+static dma_sim_stat_t stat;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Disable all channels, remove the ports and clear the counters
+ */
+void dma_sim_init(void)
+{
+    memset(chs, 0, sizeof(chs));
+    memset(ch_states, 0, sizeof(ch_states));
+    memset(ports, 0, sizeof(ports));
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**
+ * Map a peripheral register (e.g. the LCD data register) to an address.
+ * Writes of the DMA to this address call `write_cb` instead of writing memory.
+ * @param addr the address of the register
+ * @param write_cb called with every unit written to the register
+ */
+void dma_sim_map_port(uintptr_t addr, void (*write_cb)(uint32_t data))
+{
+    uint32_t i;
+    for(i = 0; i < DMA_SIM_PORT_NUM; i++) {
+        if(ports[i].write_cb == NULL || ports[i].addr == addr) {
+            ports[i].addr     = addr;
+            ports[i].write_cb = write_cb;
+            return;
+        }
+    }
+}
+
+/**
+ * Get a channel to set its registers
+ * @param ch index of the channel
+ * @return pointer to the channel
+ */
+dma_sim_ch_t * dma_sim_get_ch(uint8_t ch)
+{
+    return &chs[ch];
+}
+
+/**
+ * Serve one transfer request of a channel: move one block
+ * @param ch index of the channel
+ * @return true: a block was moved; false: the channel is disabled
+ */
+bool dma_sim_request(uint8_t ch)
+{
+    dma_sim_ch_t * c = &chs[ch];
+    ch_state_t * st  = &ch_states[ch];
+    if(c->en == false || c->cnt == 0) return false;
+
+    /*The first request latches the start addresses for the repeat mode*/
+    if(st->run == false) {
+        st->sar_start = c->sar;
+        st->dar_start = c->dar;
+        st->sunit_cnt = 0;
+        st->dunit_cnt = 0;
+        st->run       = true;
+    }
+
+    uint32_t units = c->blksize == 0 ? DMA_SIM_BLK_MAX : c->blksize;
+    uint32_t i;
+    for(i = 0; i < units; i++) {
+        write_unit(c->dar, c->width, read_unit(c->sar, c->width));
+        st->sunit_cnt++;
+        st->dunit_cnt++;
+        c->sar = next_addr(c->sar, st->sar_start, st->sunit_cnt, c->sinc, c->width, c->srpt_en, c->srpt, c->sns_en,
+                           c->snscnt, c->snsofs);
+        c->dar = next_addr(c->dar, st->dar_start, st->dunit_cnt, c->dinc, c->width, c->drpt_en, c->drpt, c->dns_en,
+                           c->dnscnt, c->dnsofs);
+    }
+
+    stat.req_cnt++;
+    stat.unit_cnt += units;
+    stat.bytes += units * c->width;
+
+    c->cnt--;
+    if(c->cnt == 0) {
+        /*The channel is disabled by the hardware at the end of the transfer*/
+        c->en   = false;
+        st->run = false;
+        if(c->tc_cb) c->tc_cb();
+    }
+
+    return true;
+}
+
+/**
+ * Serve requests of a channel as if every block triggered the next one
+ * @param ch index of the channel
+ * @param max_blk move at most this many blocks (0: until the transfer is complete)
+ * @return number of moved blocks
+ */
+uint32_t dma_sim_run(uint8_t ch, uint32_t max_blk)
+{
+    uint32_t n = 0;
+    while(max_blk == 0 || n < max_blk) {
+        if(dma_sim_request(ch) == false) break;
+        n++;
+    }
+
+    return n;
+}
+
+/**
+ * Get the counters of the DMA
+ * @param stat_p pointer to a variable to store the counters
+ */
+void dma_sim_get_stat(dma_sim_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t read_unit(uintptr_t addr, uint8_t width)
+{
+    switch(width) {
+        case 1: return *(const uint8_t *)addr;
+        case 2: return *(const uint16_t *)addr;
+        default: return *(const uint32_t *)addr;
+    }
+}
+
+static void write_unit(uintptr_t addr, uint8_t width, uint32_t data)
+{
+    uint32_t i;
+    for(i = 0; i < DMA_SIM_PORT_NUM; i++) {
+        if(ports[i].write_cb && ports[i].addr == addr) {
+            ports[i].write_cb(data);
+            return;
+        }
+    }
+
+    switch(width) {
+        case 1: *(uint8_t *)addr = (uint8_t)data; break;
+        case 2: *(uint16_t *)addr = (uint16_t)data; break;
+        default: *(uint32_t *)addr = data; break;
+    }
+}
+
+static uintptr_t step_addr(uintptr_t addr, dma_sim_addr_mode_t mode, uint8_t width)
+{
+    if(mode == DMA_SIM_ADDR_INC) return addr + width;
+    if(mode == DMA_SIM_ADDR_DEC) return addr - width;
+    return addr;
+}
+
+/**
+ * Get the address of the next unit
+ * @param addr address of the last unit
+ * @param start address at the start of the transfer
+ * @param unit_cnt units moved since the start of the transfer
+ * @param mode address mode
+ * @param width size of a unit in bytes
+ * @param rpt_en repeat mode is enabled
+ * @param rpt repeat size in units (0: 1024)
+ * @param ns_en non-sequential mode is enabled
+ * @param nscnt units between two jumps
+ * @param nsofs size of a jump in units
+ * @return the next address
+ */
+static uintptr_t next_addr(uintptr_t addr, uintptr_t start, uint32_t unit_cnt, dma_sim_addr_mode_t mode,
+                           uint8_t width, bool rpt_en, uint16_t rpt, bool ns_en, uint16_t nscnt, uint32_t nsofs)
+{
+    if(rpt_en) {
+        uint32_t rpt_size = rpt == 0 ? DMA_SIM_RPT_MAX : rpt;
+        if(unit_cnt % rpt_size == 0) return start;
+    } else if(ns_en && nscnt != 0 && unit_cnt % nscnt == 0) {
+        if(mode == DMA_SIM_ADDR_INC) return addr + (uintptr_t)nsofs * width;
+        if(mode == DMA_SIM_ADDR_DEC) return addr - (uintptr_t)nsofs * width;
+        return addr;
+    }
+
+    return step_addr(addr, mode, width);
+}
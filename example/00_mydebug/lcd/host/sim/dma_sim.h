@@ -0,0 +1,137 @@
+/**
+ * @file dma_sim.h
+ * Model of the HC32F4A0 DMA channels for host tests.
+ * The fields follow the channel registers (SAR, DAR, DTCTL, RPT, SNSEQCTL, DNSEQCTL, CHCTL),
+ * but the addresses are host pointers.
+ *
+ * Repeat: after every `rpt` units the address is reloaded with its value at the start of the transfer.
+ * Non-sequential: after every `nscnt` units the address jumps `nsofs` units from the address of the
+ * last unit (in the direction of the address mode) instead of stepping one unit.
+ * Repeat and non-sequential mode exclude each other on the same side, repeat wins like in CHCTL.
+ */
+
+#ifndef DMA_SIM_H
+#define DMA_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DMA_SIM_CH_NUM      8
+#define DMA_SIM_PORT_NUM    4
+
+/*Block size of 0 means 1024 units like in DTCTL.BLKSIZE*/
+#define DMA_SIM_BLK_MAX     1024U
+
+/*Repeat size of 0 means 1024 units like in RPT.SRPT/DRPT*/
+#define DMA_SIM_RPT_MAX     1024U
+
+/*Limits of the non-sequential count and offset (SNSCNT/DNSCNT, SOFFSET/DOFFSET)*/
+#define DMA_SIM_NS_CNT_MAX  4096U
+#define DMA_SIM_NS_OFS_MAX  0xFFFFFU
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+enum {
+    DMA_SIM_ADDR_FIX = 0,
+    DMA_SIM_ADDR_INC,
+    DMA_SIM_ADDR_DEC,
+};
+typedef uint8_t dma_sim_addr_mode_t;
+
+/**
+ * One channel
+ */
+typedef struct
+{
+    uintptr_t sar;              /**< Source address*/
+    uintptr_t dar;              /**< Destination address*/
+    uint16_t blksize;           /**< Units in a block (0: 1024)*/
+    uint16_t cnt;               /**< Remaining blocks*/
+    uint8_t width;              /**< Size of a unit in bytes: 1, 2 or 4*/
+    dma_sim_addr_mode_t sinc;   /**< Source address mode*/
+    dma_sim_addr_mode_t dinc;   /**< Destination address mode*/
+    bool srpt_en;               /**< Source repeat is enabled (CHCTL.SRPTEN)*/
+    bool drpt_en;               /**< Destination repeat is enabled (CHCTL.DRPTEN)*/
+    uint16_t srpt;              /**< Source repeat size in units (0: 1024)*/
+    uint16_t drpt;              /**< Destination repeat size in units (0: 1024)*/
+    bool sns_en;                /**< Source non-sequential mode is enabled (CHCTL.SNSEQEN)*/
+    bool dns_en;                /**< Destination non-sequential mode is enabled (CHCTL.DNSEQEN)*/
+    uint16_t snscnt;            /**< Units between two jumps of the source address*/
+    uint16_t dnscnt;            /**< Units between two jumps of the destination address*/
+    uint32_t snsofs;            /**< Jump of the source address in units*/
+    uint32_t dnsofs;            /**< Jump of the destination address in units*/
+    bool en;                    /**< The channel is enabled*/
+    void (*tc_cb)(void);        /**< Called on transfer complete (the TC interrupt)*/
+} dma_sim_ch_t;
+
+/**
+ * Counters of the DMA
+ */
+typedef struct
+{
+    uint32_t req_cnt;   /**< Served requests (blocks)*/
+    uint32_t unit_cnt;  /**< Moved units*/
+    uint32_t bytes;     /**< Moved bytes*/
+} dma_sim_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Disable all channels, remove the ports and clear the counters
+ */
+void dma_sim_init(void);
+
+/**
+ * Map a peripheral register (e.g. the LCD data register) to an address.
+ * Writes of the DMA to this address call `write_cb` instead of writing memory.
+ * @param addr the address of the register
+ * @param write_cb called with every unit written to the register
+ */
+void dma_sim_map_port(uintptr_t addr, void (*write_cb)(uint32_t data));
+
+/**
+ * Get a channel to set its registers
+ * @param ch index of the channel
+ * @return pointer to the channel
+ */
+dma_sim_ch_t * dma_sim_get_ch(uint8_t ch);
+
+/**
+ * Serve one transfer request of a channel: move one block
+ * @param ch index of the channel
+ * @return true: a block was moved; false: the channel is disabled
+ */
+bool dma_sim_request(uint8_t ch);
+
+/**
+ * Serve requests of a channel as if every block triggered the next one
+ * @param ch index of the channel
+ * @param max_blk move at most this many blocks (0: until the transfer is complete)
+ * @return number of moved blocks
+ */
+uint32_t dma_sim_run(uint8_t ch, uint32_t max_blk);
+
+/**
+ * Get the counters of the DMA
+ * @param stat pointer to a variable to store the counters
+ */
+void dma_sim_get_stat(dma_sim_stat_t * stat);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*DMA_SIM_H*/
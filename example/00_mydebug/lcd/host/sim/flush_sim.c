@@ -0,0 +1,145 @@
+/**
+ * @file flush_sim.c
+ * The bus and DMA interface of `lv_port_flush` on the simulated LCD and DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "flush_sim.h"
+#include "lcd_sim.h"
+#include "dma_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Address of the LCD data register on the EXMC*/
+#define LCD_DATA_ADDR   0x60002000UL
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void lcd_port_write(uint32_t data);
+static void dma_start(const lv_color_t * src, uint16_t blk_size, uint16_t blk_cnt);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_port_flush_hw_t sim_hw = {
+    .write_reg = lcd_sim_write_reg,
+    .write_cmd = lcd_sim_write_cmd,
+    .dma_start = dma_start,
+    .bus_wait  = NULL,
+    .time_us   = lcd_sim_get_time_us,
+    .wait_us   = flush_sim_wait_us,
+};
+
+static uint32_t bus_px_ns;
+static uint32_t blk_elaps_ns;   /*Time already spent on the current block*/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Reset the simulated LCD and DMA and initialize `lv_port_flush` with them
+ */
+void flush_sim_init(void)
+{
+    lcd_sim_init();
+    dma_sim_init();
+    dma_sim_map_port(LCD_DATA_ADDR, lcd_port_write);
+
+    dma_sim_ch_t * ch = dma_sim_get_ch(FLUSH_SIM_DMA_CH);
+    ch->dar   = LCD_DATA_ADDR;
+    ch->width = sizeof(lv_color_t);
+    ch->sinc  = DMA_SIM_ADDR_INC;
+    ch->dinc  = DMA_SIM_ADDR_FIX;
+    ch->tc_cb = lv_port_flush_dma_isr;
+
+    bus_px_ns    = 0;
+    blk_elaps_ns = 0;
+
+    lv_port_flush_init(&sim_hw);
+}
+
+/**
+ * Let the DMA send the pending pixels (as the hardware would do in the background)
+ * @param max_blk send at most this many blocks (0: until the transfer is complete)
+ * @return number of sent blocks
+ */
+uint32_t flush_sim_run(uint32_t max_blk)
+{
+    uint32_t n = 0;
+
+    /*The TC interrupt can start the next part of the area so run until the channel stops*/
+    while(max_blk == 0 || n < max_blk) {
+        uint32_t moved = dma_sim_run(FLUSH_SIM_DMA_CH, max_blk == 0 ? 0 : max_blk - n);
+        if(moved == 0) break;
+        n += moved;
+    }
+
+    return n;
+}
+
+/**
+ * Set the bus time of a pixel. With a non zero time the DMA sends the pixels
+ * only while the virtual time passes in `flush_sim_wait_us()`.
+ * @param px_ns bus time of a pixel [ns] (0: the DMA is moved only by `flush_sim_run()`)
+ */
+void flush_sim_set_timing(uint32_t px_ns)
+{
+    bus_px_ns    = px_ns;
+    blk_elaps_ns = 0;
+}
+
+/**
+ * Let the virtual time pass: the DMA sends the pixels in the background and the panel scans
+ * (the `wait_us` of the interface)
+ * @param us time to wait [us]
+ */
+void flush_sim_wait_us(uint32_t us)
+{
+    dma_sim_ch_t * ch = dma_sim_get_ch(FLUSH_SIM_DMA_CH);
+    uint32_t left_ns  = us * 1000;
+
+    /*A block (line) appears on the panel when its time is over*/
+    while(left_ns != 0) {
+        if(ch->en == false || bus_px_ns == 0) {
+            lcd_sim_advance(left_ns);
+            break;
+        }
+
+        uint32_t blk_ns = (ch->blksize == 0 ? DMA_SIM_BLK_MAX : ch->blksize) * bus_px_ns;
+        uint32_t step   = blk_ns - blk_elaps_ns;
+        if(step > left_ns) {
+            lcd_sim_advance(left_ns);
+            blk_elaps_ns += left_ns;
+            break;
+        }
+
+        lcd_sim_advance(step);
+        left_ns -= step;
+        blk_elaps_ns = 0;
+        dma_sim_run(FLUSH_SIM_DMA_CH, 1);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void lcd_port_write(uint32_t data)
+{
+    lcd_sim_write_data((uint16_t)data);
+}
+
+static void dma_start(const lv_color_t * src, uint16_t blk_size, uint16_t blk_cnt)
+{
+    dma_sim_ch_t * ch = dma_sim_get_ch(FLUSH_SIM_DMA_CH);
+    ch->sar     = (uintptr_t)src;
+    ch->dar     = LCD_DATA_ADDR;
+    ch->blksize = blk_size == DMA_SIM_BLK_MAX ? 0 : blk_size;
+    ch->cnt     = blk_cnt;
+    ch->en      = true;
+}
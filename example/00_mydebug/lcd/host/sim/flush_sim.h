@@ -0,0 +1,58 @@
+/**
+ * @file flush_sim.h
+ * The bus and DMA interface of `lv_port_flush` on the simulated LCD and DMA
+ */
+
+#ifndef FLUSH_SIM_H
+#define FLUSH_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/porting/lv_port_flush.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The DMA channel sending the pixels*/
+#define FLUSH_SIM_DMA_CH    2
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Reset the simulated LCD and DMA and initialize `lv_port_flush` with them
+ */
+void flush_sim_init(void);
+
+/**
+ * Let the DMA send the pending pixels (as the hardware would do in the background)
+ * @param max_blk send at most this many blocks (0: until the transfer is complete)
+ * @return number of sent blocks
+ */
+uint32_t flush_sim_run(uint32_t max_blk);
+
+/**
+ * Set the bus time of a pixel. With a non zero time the DMA sends the pixels
+ * only while the virtual time passes in `flush_sim_wait_us()`.
+ * @param px_ns bus time of a pixel [ns] (0: the DMA is moved only by `flush_sim_run()`)
+ */
+void flush_sim_set_timing(uint32_t px_ns);
+
+/**
+ * Let the virtual time pass: the DMA sends the pixels in the background and the panel scans
+ * (the `wait_us` of the interface)
+ * @param us time to wait [us]
+ */
+void flush_sim_wait_us(uint32_t us);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*FLUSH_SIM_H*/
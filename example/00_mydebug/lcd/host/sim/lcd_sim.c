@@ -0,0 +1,311 @@
+/**
+ * @file lcd_sim.c
+ * Model of the NT35510 on the 16 bit 8080 bus (EXMC) for host tests
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lcd_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CMD_CASET   0x2A00
+#define CMD_RASET   0x2B00
+#define CMD_RAMWR   0x2C00
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*A RAM write (the rows of its window) to check for tearing*/
+typedef struct
+{
+    uint32_t id;
+    int32_t y1;
+    int32_t y2;
+    bool done;  /*Shown completely*/
+} wr_area_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void set_param_byte(int32_t * start, int32_t * end, uint16_t idx, uint16_t data);
+static void scan_line(void);
+static void frame_end(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint16_t gram[LCD_SIM_HOR_RES * LCD_SIM_VER_RES];
+static lcd_sim_stat_t stat;
+static uint16_t cmd_act;
+static bool ram_wr;
+static int32_t xs, xe, ys, ye;
+static int32_t cur_x, cur_y;
+
+static uint64_t time_ns;
+static uint32_t scan_line_ns;
+static uint16_t scan_blank;
+static void (*scan_te_cb)(void);
+static uint64_t scan_next_ns;   /*Time of the next row (or blanking line)*/
+static int32_t scan_y;          /*The next row. Negative in the blanking.*/
+
+static uint32_t wr_id;                          /*ID of the last RAM write*/
+static uint32_t row_wr[LCD_SIM_VER_RES];        /*The last RAM write which wrote the row*/
+static uint32_t row_shown[LCD_SIM_VER_RES];     /*The RAM write shown by the last scan of the row*/
+static wr_area_t wr_hist[LCD_SIM_WR_HIST];
+static uint32_t wr_hist_idx;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Reset the panel: clear the GRAM, the counters and set the full window
+ */
+void lcd_sim_init(void)
+{
+    memset(gram, 0, sizeof(gram));
+    lcd_sim_reset_stat();
+    cmd_act = 0;
+    ram_wr  = false;
+    xs      = 0;
+    xe      = LCD_SIM_HOR_RES - 1;
+    ys      = 0;
+    ye      = LCD_SIM_VER_RES - 1;
+    cur_x   = 0;
+    cur_y   = 0;
+
+    time_ns = 0;
+    wr_id   = 0;
+    memset(row_wr, 0, sizeof(row_wr));
+    memset(row_shown, 0, sizeof(row_shown));
+    memset(wr_hist, 0, sizeof(wr_hist));
+    wr_hist_idx = 0;
+    lcd_sim_scan_init(0, 0, NULL);
+}
+
+/**
+ * A write to the command register (`LCD->REG`)
+ * @param cmd the command
+ */
+void lcd_sim_write_cmd(uint16_t cmd)
+{
+    stat.cmd_cnt++;
+    cmd_act = cmd;
+    ram_wr  = false;
+
+    /*The memory write always starts at the top left corner of the window*/
+    if(cmd == CMD_RAMWR) {
+        ram_wr = true;
+        cur_x  = xs;
+        cur_y  = ys;
+
+        wr_id++;
+        wr_area_t * wr = &wr_hist[wr_hist_idx];
+        wr_hist_idx    = (wr_hist_idx + 1) % LCD_SIM_WR_HIST;
+        wr->id         = wr_id;
+        wr->y1         = ys;
+        wr->y2         = ye;
+        wr->done       = false;
+    }
+}
+
+/**
+ * A write to the data register (`LCD->RAM`)
+ * @param data a parameter of the last command or a pixel after RAMWR
+ */
+void lcd_sim_write_data(uint16_t data)
+{
+    stat.data_cnt++;
+
+    if(ram_wr) {
+        if(cur_x >= 0 && cur_x < LCD_SIM_HOR_RES && cur_y >= 0 && cur_y < LCD_SIM_VER_RES) {
+            gram[cur_y * LCD_SIM_HOR_RES + cur_x] = data;
+            row_wr[cur_y] = wr_id;
+            stat.px_cnt++;
+        } else {
+            stat.oob_cnt++;
+        }
+
+        /*Wrap inside the window*/
+        cur_x++;
+        if(cur_x > xe) {
+            cur_x = xs;
+            cur_y++;
+            if(cur_y > ye) cur_y = ys;
+        }
+        return;
+    }
+
+    /*In 16 bit command mode the low byte of the command is the parameter index*/
+    if((cmd_act & 0xFF00) == CMD_CASET) set_param_byte(&xs, &xe, cmd_act & 0xFF, data);
+    else if((cmd_act & 0xFF00) == CMD_RASET) set_param_byte(&ys, &ye, cmd_act & 0xFF, data);
+}
+
+/**
+ * Write a command with one parameter like `NT35510_WriteReg`
+ * @param reg the command
+ * @param data the parameter
+ */
+void lcd_sim_write_reg(uint16_t reg, uint16_t data)
+{
+    lcd_sim_write_cmd(reg);
+    lcd_sim_write_data(data);
+}
+
+/**
+ * Start the scan of the GRAM to the glass. It runs in a virtual time moved by `lcd_sim_advance()`.
+ * A frame is the vertical blanking (the TE pulse is at its start) and the scan of the rows from the top.
+ * @param line_ns time of one row [ns] (0: stop the scan)
+ * @param blank_lines length of the vertical blanking in rows
+ * @param te_cb called on the TE pulse (can be NULL)
+ */
+void lcd_sim_scan_init(uint32_t line_ns, uint16_t blank_lines, void (*te_cb)(void))
+{
+    scan_line_ns = line_ns;
+    scan_blank   = blank_lines;
+    scan_te_cb   = te_cb;
+    scan_next_ns = time_ns;
+    scan_y       = -(int32_t)blank_lines;
+}
+
+/**
+ * Let the virtual time pass: scan the rows and send the TE pulses
+ * @param ns elapsed time [ns]
+ */
+void lcd_sim_advance(uint32_t ns)
+{
+    uint64_t end = time_ns + ns;
+
+    while(scan_line_ns != 0 && scan_next_ns <= end) {
+        time_ns = scan_next_ns;
+        scan_next_ns += scan_line_ns;
+        scan_line();
+    }
+
+    time_ns = end;
+}
+
+/**
+ * Get the virtual time
+ * @return the elapsed time since `lcd_sim_init()` [us]
+ */
+uint32_t lcd_sim_get_time_us(void)
+{
+    return (uint32_t)(time_ns / 1000);
+}
+
+/**
+ * Get a pixel of the GRAM
+ * @param x x coordinate
+ * @param y y coordinate
+ * @return the RGB565 color
+ */
+uint16_t lcd_sim_get_px(int32_t x, int32_t y)
+{
+    return gram[y * LCD_SIM_HOR_RES + x];
+}
+
+/**
+ * Get the GRAM. It's `LCD_SIM_HOR_RES` x `LCD_SIM_VER_RES` pixels.
+ * @return pointer to the first pixel
+ */
+uint16_t * lcd_sim_get_gram(void)
+{
+    return gram;
+}
+
+/**
+ * Get the counters of the bus
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lcd_sim_get_stat(lcd_sim_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**
+ * Get the bytes moved on the bus since the last reset of the counters
+ * @return number of bytes
+ */
+uint32_t lcd_sim_get_bus_bytes(void)
+{
+    return (stat.cmd_cnt + stat.data_cnt) * LCD_SIM_CYCLE_BYTES;
+}
+
+/**
+ * Clear the counters of the bus
+ */
+void lcd_sim_reset_stat(void)
+{
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Handle a parameter of CASET or RASET
+ * @param start start coordinate to modify
+ * @param end end coordinate to modify
+ * @param idx parameter index: 0: start high byte, 1: start low byte, 2: end high byte, 3: end low byte
+ * @param data the parameter (only the low byte is used)
+ */
+static void set_param_byte(int32_t * start, int32_t * end, uint16_t idx, uint16_t data)
+{
+    data &= 0xFF;
+    switch(idx) {
+        case 0: *start = (*start & 0x00FF) | (data << 8); break;
+        case 1: *start = (*start & 0xFF00) | data; break;
+        case 2: *end = (*end & 0x00FF) | (data << 8); break;
+        case 3: *end = (*end & 0xFF00) | data; break;
+        default: break;
+    }
+}
+
+/**
+ * Scan the next row to the glass (or a line of the blanking)
+ */
+static void scan_line(void)
+{
+    if(scan_y == -(int32_t)scan_blank && scan_te_cb) scan_te_cb();
+
+    if(scan_y >= 0) row_shown[scan_y] = row_wr[scan_y];
+
+    scan_y++;
+    if(scan_y == LCD_SIM_VER_RES) {
+        frame_end();
+        scan_y = -(int32_t)scan_blank;
+    }
+}
+
+/**
+ * Check the recent RAM writes on a scanned frame.
+ * Rows shown from the write (or a later one) are new, the others are old.
+ * A write shown with both new and old rows was torn.
+ */
+static void frame_end(void)
+{
+    uint32_t i;
+    for(i = 0; i < LCD_SIM_WR_HIST; i++) {
+        wr_area_t * wr = &wr_hist[i];
+        if(wr->id == 0 || wr->done) continue;
+
+        uint32_t new_cnt = 0;
+        uint32_t old_cnt = 0;
+        int32_t y;
+        for(y = wr->y1; y <= wr->y2 && y < LCD_SIM_VER_RES; y++) {
+            if(row_shown[y] >= wr->id) new_cnt++;
+            else old_cnt++;
+        }
+
+        if(new_cnt != 0 && old_cnt != 0) stat.tear_cnt++;
+        if(old_cnt == 0) wr->done = true;
+    }
+
+    stat.frame_cnt++;
+}
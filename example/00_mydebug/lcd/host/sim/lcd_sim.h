@@ -0,0 +1,128 @@
+/**
+ * @file lcd_sim.h
+ * Model of the NT35510 on the 16 bit 8080 bus (EXMC) for host tests
+ */
+
+#ifndef LCD_SIM_H
+#define LCD_SIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LCD_SIM_HOR_RES     480
+#define LCD_SIM_VER_RES     800
+
+/*Bytes moved by one bus cycle (16 bit bus)*/
+#define LCD_SIM_CYCLE_BYTES 2U
+
+/*Number of the last RAM writes checked for tearing*/
+#define LCD_SIM_WR_HIST     256
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t cmd_cnt;   /**< Command (RS = 0) cycles*/
+    uint32_t data_cnt;  /**< Data (RS = 1) cycles: parameters and pixels*/
+    uint32_t px_cnt;    /**< Pixels written into the GRAM*/
+    uint32_t oob_cnt;   /**< Pixels written outside of the GRAM*/
+    uint32_t frame_cnt; /**< Frames scanned out to the glass*/
+    uint32_t tear_cnt;  /**< Torn areas: a RAM write shown with new and old rows in the same frame*/
+} lcd_sim_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Reset the panel: clear the GRAM, the counters and set the full window
+ */
+void lcd_sim_init(void);
+
+/**
+ * A write to the command register (`LCD->REG`)
+ * @param cmd the command
+ */
+void lcd_sim_write_cmd(uint16_t cmd);
+
+/**
+ * A write to the data register (`LCD->RAM`)
+ * @param data a parameter of the last command or a pixel after RAMWR
+ */
+void lcd_sim_write_data(uint16_t data);
+
+/**
+ * Write a command with one parameter like `NT35510_WriteReg`
+ * @param reg the command
+ * @param data the parameter
+ */
+void lcd_sim_write_reg(uint16_t reg, uint16_t data);
+
+/**
+ * Start the scan of the GRAM to the glass. It runs in a virtual time moved by `lcd_sim_advance()`.
+ * A frame is the vertical blanking (the TE pulse is at its start) and the scan of the rows from the top.
+ * @param line_ns time of one row [ns] (0: stop the scan)
+ * @param blank_lines length of the vertical blanking in rows
+ * @param te_cb called on the TE pulse (can be NULL)
+ */
+void lcd_sim_scan_init(uint32_t line_ns, uint16_t blank_lines, void (*te_cb)(void));
+
+/**
+ * Let the virtual time pass: scan the rows and send the TE pulses
+ * @param ns elapsed time [ns]
+ */
+void lcd_sim_advance(uint32_t ns);
+
+/**
+ * Get the virtual time
+ * @return the elapsed time since `lcd_sim_init()` [us]
+ */
+uint32_t lcd_sim_get_time_us(void);
+
+/**
+ * Get a pixel of the GRAM
+ * @param x x coordinate
+ * @param y y coordinate
+ * @return the RGB565 color
+ */
+uint16_t lcd_sim_get_px(int32_t x, int32_t y);
+
+/**
+ * Get the GRAM. It's `LCD_SIM_HOR_RES` x `LCD_SIM_VER_RES` pixels.
+ * @return pointer to the first pixel
+ */
+uint16_t * lcd_sim_get_gram(void);
+
+/**
+ * Get the counters of the bus
+ * @param stat pointer to a variable to store the counters
+ */
+void lcd_sim_get_stat(lcd_sim_stat_t * stat);
+
+/**
+ * Get the bytes moved on the bus since the last reset of the counters
+ * @return number of bytes
+ */
+uint32_t lcd_sim_get_bus_bytes(void);
+
+/**
+ * Clear the counters of the bus
+ */
+void lcd_sim_reset_stat(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LCD_SIM_H*/
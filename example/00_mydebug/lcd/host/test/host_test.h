@@ -0,0 +1,61 @@
+/**
+ * @file host_test.h
+ * Minimal assertion helpers of the host tests
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TEST_ASSERT(cond)                                                                                              \
+    do {                                                                                                               \
+        test_assert_cnt++;                                                                                             \
+        if(!(cond)) {                                                                                                  \
+            printf("%s:%d: FAIL: %s\n", __FILE__, __LINE__, #cond);                                                    \
+            test_fail_cnt++;                                                                                           \
+        }                                                                                                              \
+    } while(0)
+
+#define TEST_ASSERT_EQUAL(exp, act)                                                                                    \
+    do {                                                                                                               \
+        long long test_exp_ = (long long)(exp);                                                                        \
+        long long test_act_ = (long long)(act);                                                                        \
+        test_assert_cnt++;                                                                                             \
+        if(test_exp_ != test_act_) {                                                                                   \
+            printf("%s:%d: FAIL: %s == %s (%lld != %lld)\n", __FILE__, __LINE__, #exp, #act, test_exp_, test_act_);    \
+            test_fail_cnt++;                                                                                           \
+        }                                                                                                              \
+    } while(0)
+
+#define TEST_RUN(fn)                                                                                                   \
+    do {                                                                                                               \
+        printf("  %s\n", #fn);                                                                                         \
+        fn();                                                                                                          \
+    } while(0)
+
+/*Print the summary and give the exit code of the test program*/
+#define TEST_RESULT()                                                                                                  \
+    (printf("%s: %u assertions, %u failed\n", __FILE__, test_assert_cnt, test_fail_cnt), test_fail_cnt ? 1 : 0)
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static unsigned int test_assert_cnt;
+static unsigned int test_fail_cnt;
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*HOST_TEST_H*/
@@ -0,0 +1,120 @@
+/**
+ * @file mask_cache_test.h
+ * Common checks of the tests of the drawing with cached masks (test_shadow_cache, test_corner_cache)
+ */
+
+#ifndef MASK_CACHE_TEST_H
+#define MASK_CACHE_TEST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SCR_W   LV_HOR_RES_MAX
+#define SCR_H   LV_VER_RES_MAX
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static inline void refr_full(void)
+{
+    lv_obj_invalidate(lv_disp_get_scr_act(NULL));
+    lv_refr_now(NULL);
+}
+
+/*Clear the frame buffer and redraw the screen in `tile` x `tile` areas to clip the masks in every way*/
+static inline void refr_tiles(lv_coord_t tile)
+{
+    memset(lv_port_host_get_fb(), 0, SCR_W * SCR_H * sizeof(lv_color_t));
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < SCR_H; y += tile) {
+        for(x = 0; x < SCR_W; x += tile) {
+            lv_area_t a;
+            lv_area_set(&a, x, y, LV_MATH_MIN(x + tile, SCR_W) - 1, LV_MATH_MIN(y + tile, SCR_H) - 1);
+            lv_inv_area(NULL, &a);
+            lv_refr_now(NULL);
+        }
+    }
+}
+
+/*Compare the frame buffer with its horizontally or vertically mirrored image*/
+static inline bool is_mirrored(bool hor)
+{
+    const lv_color_t * fb = lv_port_host_get_fb();
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < SCR_H; y++) {
+        for(x = 0; x < SCR_W; x++) {
+            lv_coord_t xm = hor ? SCR_W - 1 - x : x;
+            lv_coord_t ym = hor ? y : SCR_H - 1 - y;
+            if(fb[y * SCR_W + x].full != fb[ym * SCR_W + xm].full) return false;
+        }
+    }
+
+    return true;
+}
+
+/*Draw the screen twice from an empty cache: only the first draw calculates the `mask_cnt` masks*/
+static inline void check_redraw_hits(lv_mask_cache_t * cache, uint32_t mask_cnt)
+{
+    lv_mask_cache_stat_t stat;
+    lv_mask_cache_clear(cache);
+    lv_mask_cache_reset_stat(cache);
+    refr_full();
+    uint32_t crc = lv_port_host_get_fb_crc();
+
+    lv_mask_cache_get_stat(cache, &stat);
+    TEST_ASSERT_EQUAL(mask_cnt, stat.miss_cnt);
+    TEST_ASSERT(stat.hit_cnt >= mask_cnt);
+    TEST_ASSERT_EQUAL(mask_cnt, stat.entry_cnt);
+
+    refr_full();
+    lv_mask_cache_get_stat(cache, &stat);
+    TEST_ASSERT_EQUAL(mask_cnt, stat.miss_cnt);
+    TEST_ASSERT_EQUAL(crc, lv_port_host_get_fb_crc());
+}
+
+/*Draw the screen with every radius of `radii` (each needs other masks) and check the budget of the cache*/
+static inline void check_budget(lv_mask_cache_t * cache, lv_obj_t * obj, lv_style_t * style, const lv_coord_t * radii,
+                                uint32_t radius_cnt)
+{
+    lv_mask_cache_stat_t stat;
+    lv_mask_cache_clear(cache);
+    lv_mask_cache_reset_stat(cache);
+
+    uint32_t i;
+    for(i = 0; i < radius_cnt; i++) {
+        style->body.radius = radii[i];
+        lv_obj_refresh_style(obj);
+        refr_full();
+
+        lv_mask_cache_get_stat(cache, &stat);
+        TEST_ASSERT(stat.used <= cache->size && stat.entry_cnt <= cache->entry_num);
+    }
+
+    TEST_ASSERT_EQUAL(radius_cnt, stat.miss_cnt);
+    TEST_ASSERT(stat.evict_cnt >= radius_cnt - cache->entry_num);
+
+    lv_mask_cache_clear(cache);
+    lv_mask_cache_get_stat(cache, &stat);
+    TEST_ASSERT_EQUAL(0, stat.used);
+    TEST_ASSERT_EQUAL(0, stat.entry_cnt);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*MASK_CACHE_TEST_H*/
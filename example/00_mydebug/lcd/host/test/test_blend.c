@@ -0,0 +1,205 @@
+/**
+ * @file test_blend.c
+ * Tests of the fill and blend kernels (lv_draw_blend): compare them with the per pixel
+ * implementation of lv_draw_basic on random inputs
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lvgl/lvgl.h"
+#include "lvgl/src/lv_draw/lv_draw_blend.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MEM_W       64
+#define MEM_H       8
+#define RND_RUNS    2000
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void ref_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+static void ref_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area, lv_color_t color,
+                           lv_opa_t opa);
+static void fill_rnd(lv_color_t * buf, uint32_t len);
+static uint32_t rnd_next(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t rnd_seed = 1;
+
+/*Aligned buffers with a spare pixel to test unaligned starts*/
+static lv_color_t mem_exp[MEM_W * MEM_H + 1];
+static lv_color_t mem_act[MEM_W * MEM_H + 1];
+static lv_color_t src[MEM_W + 1];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_packed_kernels_are_used(void)
+{
+    TEST_ASSERT_EQUAL(1, LV_DRAW_BLEND_PACKED);
+}
+
+static void test_blend_every_opa(void)
+{
+    uint32_t opa;
+    uint32_t ok = 0;
+
+    for(opa = 0; opa <= 255; opa++) {
+        fill_rnd(mem_exp, MEM_W);
+        fill_rnd(src, MEM_W);
+        memcpy(mem_act, mem_exp, sizeof(lv_color_t) * MEM_W);
+
+        ref_mem_blend(mem_exp, src, MEM_W, opa);
+        lv_draw_blend_map(mem_act, src, MEM_W, opa);
+        if(memcmp(mem_exp, mem_act, sizeof(lv_color_t) * MEM_W) == 0) ok++;
+    }
+
+    TEST_ASSERT_EQUAL(256, ok);
+}
+
+static void test_blend_rnd(void)
+{
+    uint32_t i;
+    uint32_t ok = 0;
+
+    for(i = 0; i < RND_RUNS; i++) {
+        uint32_t dest_ofs = rnd_next() % 2;
+        uint32_t src_ofs  = rnd_next() % 2;
+        uint32_t len      = rnd_next() % (MEM_W - 1);
+        lv_opa_t opa      = rnd_next() & 0xFF;
+
+        fill_rnd(mem_exp, MEM_W + 1);
+        fill_rnd(src, MEM_W + 1);
+        memcpy(mem_act, mem_exp, sizeof(lv_color_t) * (MEM_W + 1));
+
+        ref_mem_blend(&mem_exp[dest_ofs], &src[src_ofs], len, opa);
+        lv_draw_blend_map(&mem_act[dest_ofs], &src[src_ofs], len, opa);
+        if(memcmp(mem_exp, mem_act, sizeof(lv_color_t) * (MEM_W + 1)) == 0) ok++;
+    }
+
+    TEST_ASSERT_EQUAL(RND_RUNS, ok);
+}
+
+static void test_fill_rnd(void)
+{
+    uint32_t i;
+    uint32_t ok = 0;
+
+    for(i = 0; i < RND_RUNS; i++) {
+        lv_area_t area;
+        lv_color_t color;
+        lv_opa_t opa;
+        lv_coord_t mem_w = MEM_W - (rnd_next() % 4);
+
+        area.x1    = rnd_next() % mem_w;
+        area.x2    = area.x1 + rnd_next() % (mem_w - area.x1);
+        area.y1    = rnd_next() % MEM_H;
+        area.y2    = area.y1 + rnd_next() % (MEM_H - area.y1);
+        color.full = rnd_next();
+        opa        = (i % 4) == 0 ? LV_OPA_COVER : rnd_next() & 0xFF;
+
+        /*A plain background sometimes to use the saved results*/
+        fill_rnd(mem_exp, MEM_W * MEM_H + 1);
+        if(i % 3 == 0) {
+            uint32_t p;
+            for(p = 0; p < MEM_W * MEM_H + 1; p++) mem_exp[p] = mem_exp[0];
+        }
+        memcpy(mem_act, mem_exp, sizeof(mem_exp));
+
+        ref_color_fill(mem_exp, mem_w, &area, color, opa);
+        lv_draw_blend_fill(mem_act, mem_w, &area, color, opa);
+        if(memcmp(mem_exp, mem_act, sizeof(mem_exp)) == 0) ok++;
+    }
+
+    TEST_ASSERT_EQUAL(RND_RUNS, ok);
+}
+
+/*`sw_mem_blend` of lv_draw_basic.c before the packed kernels*/
+static void ref_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    if(opa == LV_OPA_COVER) {
+        memcpy(dest, src, length * sizeof(lv_color_t));
+    } else {
+        uint32_t col;
+        for(col = 0; col < length; col++) {
+            dest[col] = lv_color_mix(src[col], dest[col], opa);
+        }
+    }
+}
+
+/*`sw_color_fill` of lv_draw_basic.c before the packed kernels (without `set_px_cb`)*/
+static void ref_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area, lv_color_t color,
+                           lv_opa_t opa)
+{
+    lv_coord_t row;
+    lv_coord_t col;
+
+    mem += fill_area->y1 * mem_width;
+
+    if(opa == LV_OPA_COVER) {
+        for(col = fill_area->x1; col <= fill_area->x2; col++) {
+            mem[col] = color;
+        }
+
+        lv_color_t * mem_first = &mem[fill_area->x1];
+        lv_coord_t copy_size   = (fill_area->x2 - fill_area->x1 + 1) * sizeof(lv_color_t);
+        mem += mem_width;
+
+        for(row = fill_area->y1 + 1; row <= fill_area->y2; row++) {
+            memcpy(&mem[fill_area->x1], mem_first, copy_size);
+            mem += mem_width;
+        }
+    } else {
+        lv_color_t bg_tmp  = LV_COLOR_BLACK;
+        lv_color_t opa_tmp = lv_color_mix(color, bg_tmp, opa);
+        for(row = fill_area->y1; row <= fill_area->y2; row++) {
+            for(col = fill_area->x1; col <= fill_area->x2; col++) {
+                if(mem[col].full != bg_tmp.full) {
+                    bg_tmp  = mem[col];
+                    opa_tmp = lv_color_mix(color, bg_tmp, opa);
+                }
+
+                mem[col] = opa_tmp;
+            }
+            mem += mem_width;
+        }
+    }
+}
+
+static void fill_rnd(lv_color_t * buf, uint32_t len)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) buf[i].full = rnd_next();
+}
+
+static uint32_t rnd_next(void)
+{
+    /*xorshift32: all the bits are random, the pixels get every value*/
+    rnd_seed ^= rnd_seed << 13;
+    rnd_seed ^= rnd_seed >> 17;
+    rnd_seed ^= rnd_seed << 5;
+    return rnd_seed;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    TEST_RUN(test_packed_kernels_are_used);
+    TEST_RUN(test_blend_every_opa);
+    TEST_RUN(test_blend_rnd);
+    TEST_RUN(test_fill_rnd);
+
+    return TEST_RESULT();
+}
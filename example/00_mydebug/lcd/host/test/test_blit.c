@@ -0,0 +1,319 @@
+/**
+ * @file test_blit.c
+ * Tests of the 2D blit service (lv_port_blit) on the simulated DMA:
+ * the repeat and non-sequential addressing and the results against plain loops
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+#include "blit_sim.h"
+#include "dma_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MEM_W       160
+#define MEM_H       64
+#define RND_RUNS    500
+#define IMG_W       100
+#define IMG_H       60
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void rnd_rect(lv_coord_t * x, lv_coord_t * y, lv_coord_t * w, lv_coord_t * h);
+static void fill_rnd(lv_color_t * buf, uint32_t len);
+static uint32_t rnd_next(void);
+static uint32_t refr_crc(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t rnd_seed = 7;
+
+/*Spare pixels to test unaligned starts*/
+static lv_color_t mem_exp[MEM_W * MEM_H + 1];
+static lv_color_t mem_act[MEM_W * MEM_H + 1];
+static lv_color_t src[MEM_W * MEM_H + 1];
+
+static lv_color_t img_px[IMG_W * IMG_H];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_sim_non_sequential(void)
+{
+    uint16_t s[12];
+    uint16_t d[20];
+    uint32_t i;
+
+    for(i = 0; i < 12; i++) s[i] = i + 1;
+    memset(d, 0, sizeof(d));
+
+    /*3 units, skip 2, 3 units...: the jump is counted from the last unit*/
+    dma_sim_init();
+    dma_sim_ch_t * ch = dma_sim_get_ch(0);
+    ch->sar     = (uintptr_t)s;
+    ch->dar     = (uintptr_t)d;
+    ch->width   = 2;
+    ch->blksize = 3;
+    ch->cnt     = 4;
+    ch->sinc    = DMA_SIM_ADDR_INC;
+    ch->dinc    = DMA_SIM_ADDR_INC;
+    ch->dns_en  = true;
+    ch->dnscnt  = 3;
+    ch->dnsofs  = 3;
+    ch->en      = true;
+    TEST_ASSERT_EQUAL(4, dma_sim_run(0, 0));
+
+    static const uint16_t d_exp[20] = {1, 2, 3, 0, 0, 4, 5, 6, 0, 0, 7, 8, 9, 0, 0, 10, 11, 12, 0, 0};
+    TEST_ASSERT(memcmp(d, d_exp, sizeof(d)) == 0);
+}
+
+static void test_sim_repeat(void)
+{
+    uint16_t s[4] = {1, 2, 3, 4};
+    uint16_t d[12];
+
+    /*The source is reloaded after every 4 units*/
+    dma_sim_init();
+    dma_sim_ch_t * ch = dma_sim_get_ch(0);
+    ch->sar     = (uintptr_t)s;
+    ch->dar     = (uintptr_t)d;
+    ch->width   = 2;
+    ch->blksize = 6;
+    ch->cnt     = 2;
+    ch->sinc    = DMA_SIM_ADDR_INC;
+    ch->dinc    = DMA_SIM_ADDR_INC;
+    ch->srpt_en = true;
+    ch->srpt    = 4;
+    ch->en      = true;
+    TEST_ASSERT_EQUAL(2, dma_sim_run(0, 0));
+
+    static const uint16_t d_exp[12] = {1, 2, 3, 4, 1, 2, 3, 4, 1, 2, 3, 4};
+    TEST_ASSERT(memcmp(d, d_exp, sizeof(d)) == 0);
+}
+
+static void test_fill_rnd(void)
+{
+    lv_port_blit_stat_t stat;
+    uint32_t i;
+    uint32_t ok = 0;
+
+    dma_sim_init();
+    blit_sim_init();
+
+    for(i = 0; i < RND_RUNS; i++) {
+        lv_coord_t x, y, w, h;
+        lv_coord_t stride = MEM_W - (rnd_next() % 3);
+        uint32_t ofs      = rnd_next() % 2;
+        lv_color_t color;
+        color.full = rnd_next();
+        rnd_rect(&x, &y, &w, &h);
+        if(x + w > stride) w = stride - x;
+
+        fill_rnd(mem_exp, MEM_W * MEM_H + 1);
+        memcpy(mem_act, mem_exp, sizeof(mem_exp));
+
+        lv_coord_t row, col;
+        for(row = y; row < y + h; row++) {
+            for(col = x; col < x + w; col++) mem_exp[ofs + row * stride + col] = color;
+        }
+
+        lv_port_blit_fill(&mem_act[ofs + y * stride + x], stride, w, h, color);
+        if(memcmp(mem_exp, mem_act, sizeof(mem_exp)) == 0) ok++;
+    }
+
+    TEST_ASSERT_EQUAL(RND_RUNS, ok);
+
+    /*Both paths are tested*/
+    lv_port_blit_get_stat(&stat);
+    TEST_ASSERT_EQUAL(RND_RUNS, stat.fill_cnt);
+    TEST_ASSERT(stat.dma_cnt > RND_RUNS / 10);
+    TEST_ASSERT(stat.dma_cnt < RND_RUNS);
+}
+
+static void test_copy_rnd(void)
+{
+    lv_port_blit_stat_t stat;
+    uint32_t i;
+    uint32_t ok = 0;
+
+    dma_sim_init();
+    blit_sim_init();
+
+    for(i = 0; i < RND_RUNS; i++) {
+        lv_coord_t x, y, w, h;
+        lv_coord_t stride     = MEM_W - (rnd_next() % 3);
+        lv_coord_t src_stride = (i % 5) == 0 ? 0 : stride - (rnd_next() % 3);
+        uint32_t ofs          = rnd_next() % 2;
+        uint32_t src_ofs      = rnd_next() % 2;
+        rnd_rect(&x, &y, &w, &h);
+        if(x + w > stride) w = stride - x;
+        if(src_stride && x + w > src_stride) w = src_stride - x;
+
+        fill_rnd(mem_exp, MEM_W * MEM_H + 1);
+        fill_rnd(src, MEM_W * MEM_H + 1);
+        memcpy(mem_act, mem_exp, sizeof(mem_exp));
+
+        const lv_color_t * s = &src[src_ofs + y * src_stride + x];
+        lv_coord_t row, col;
+        for(row = 0; row < h; row++) {
+            for(col = 0; col < w; col++) {
+                mem_exp[ofs + (y + row) * stride + x + col] = s[row * src_stride + col];
+            }
+        }
+
+        lv_port_blit_copy(&mem_act[ofs + y * stride + x], stride, s, src_stride, w, h);
+        if(memcmp(mem_exp, mem_act, sizeof(mem_exp)) == 0) ok++;
+    }
+
+    TEST_ASSERT_EQUAL(RND_RUNS, ok);
+
+    lv_port_blit_get_stat(&stat);
+    TEST_ASSERT_EQUAL(RND_RUNS, stat.copy_cnt);
+    TEST_ASSERT(stat.dma_cnt > RND_RUNS / 10);
+    TEST_ASSERT(stat.dma_cnt < RND_RUNS);
+}
+
+static void test_words_are_used_on_aligned_rows(void)
+{
+    dma_sim_stat_t dma_stat;
+    lv_color_t color = LV_COLOR_RED;
+
+    dma_sim_init();
+    blit_sim_init();
+
+    /*Even start, width and stride: two pixels in a unit*/
+    lv_port_blit_fill(&mem_act[2 * MEM_W], MEM_W, 64, 40, color);
+    dma_sim_get_stat(&dma_stat);
+    TEST_ASSERT_EQUAL(40, dma_stat.req_cnt);
+    TEST_ASSERT_EQUAL(32 * 40, dma_stat.unit_cnt);
+    TEST_ASSERT_EQUAL(64 * 40 * sizeof(lv_color_t), dma_stat.bytes);
+
+    /*Odd start: one pixel in a unit*/
+    dma_sim_init();
+    lv_port_blit_fill(&mem_act[2 * MEM_W + 1], MEM_W, 64, 40, color);
+    dma_sim_get_stat(&dma_stat);
+    TEST_ASSERT_EQUAL(64 * 40, dma_stat.unit_cnt);
+}
+
+static void test_small_areas_use_cpu(void)
+{
+    lv_port_blit_stat_t stat;
+    dma_sim_stat_t dma_stat;
+
+    dma_sim_init();
+    blit_sim_init();
+
+    lv_port_blit_fill(mem_act, MEM_W, 10, 10, LV_COLOR_BLUE);
+    lv_port_blit_fill(mem_act, MEM_W, LV_PORT_BLIT_DMA_MIN_W - 1, MEM_H, LV_COLOR_BLUE);
+    lv_port_blit_copy(mem_act, MEM_W, src, MEM_W, 20, 20);
+
+    lv_port_blit_get_stat(&stat);
+    dma_sim_get_stat(&dma_stat);
+    TEST_ASSERT_EQUAL(0, stat.dma_cnt);
+    TEST_ASSERT_EQUAL(0, dma_stat.req_cnt);
+    TEST_ASSERT_EQUAL(10 * 10 + (LV_PORT_BLIT_DMA_MIN_W - 1) * MEM_H + 20 * 20, stat.cpu_px);
+}
+
+static void test_same_image_with_dma(void)
+{
+    lv_port_blit_stat_t stat;
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_obj_t * scr   = lv_disp_get_scr_act(NULL);
+
+    static lv_img_dsc_t img_dsc;
+    fill_rnd(img_px, IMG_W * IMG_H);
+    img_dsc.header.always_zero = 0;
+    img_dsc.header.cf          = LV_IMG_CF_TRUE_COLOR;
+    img_dsc.header.w           = IMG_W;
+    img_dsc.header.h           = IMG_H;
+    img_dsc.data_size          = sizeof(img_px);
+    img_dsc.data               = (const uint8_t *)img_px;
+
+    lv_obj_t * cont = lv_cont_create(scr, NULL);
+    lv_obj_set_pos(cont, 13, 7);
+    lv_obj_set_size(cont, 300, 200);
+    lv_obj_t * btn = lv_btn_create(cont, NULL);
+    lv_obj_set_pos(btn, 20, 20);
+    lv_obj_set_size(btn, 150, 80);
+    lv_obj_t * img = lv_img_create(scr, NULL);
+    lv_img_set_src(img, &img_dsc);
+    lv_obj_set_pos(img, 331, 211);
+
+    dma_sim_init();
+    blit_sim_init();
+
+    uint32_t crc_cpu = refr_crc();
+
+    disp->driver.gpu_fill_cb = lv_port_blit_gpu_fill_cb;
+    disp->driver.gpu_copy_cb = lv_port_blit_gpu_copy_cb;
+    uint32_t crc_dma = refr_crc();
+    disp->driver.gpu_fill_cb = NULL;
+    disp->driver.gpu_copy_cb = NULL;
+
+    lv_port_blit_get_stat(&stat);
+    TEST_ASSERT(stat.copy_cnt > 0);
+    TEST_ASSERT(stat.dma_px > 0);
+    TEST_ASSERT_EQUAL(crc_cpu, crc_dma);
+
+    lv_obj_clean(scr);
+    refr_crc();
+}
+
+/*Redraw the whole screen*/
+static uint32_t refr_crc(void)
+{
+    lv_obj_invalidate(lv_disp_get_scr_act(NULL));
+    lv_refr_now(NULL);
+    return lv_port_host_get_fb_crc();
+}
+
+/*A random rectangle in MEM_W x MEM_H, often big enough for the DMA*/
+static void rnd_rect(lv_coord_t * x, lv_coord_t * y, lv_coord_t * w, lv_coord_t * h)
+{
+    *x = rnd_next() % (MEM_W / 4);
+    *y = rnd_next() % (MEM_H / 4);
+    *w = 1 + rnd_next() % (MEM_W - *x - 2);
+    *h = 1 + rnd_next() % (MEM_H - *y);
+}
+
+static void fill_rnd(lv_color_t * buf, uint32_t len)
+{
+    uint32_t i;
+    for(i = 0; i < len; i++) buf[i].full = rnd_next();
+}
+
+static uint32_t rnd_next(void)
+{
+    rnd_seed ^= rnd_seed << 13;
+    rnd_seed ^= rnd_seed >> 17;
+    rnd_seed ^= rnd_seed << 5;
+    return rnd_seed;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    TEST_RUN(test_sim_non_sequential);
+    TEST_RUN(test_sim_repeat);
+    TEST_RUN(test_fill_rnd);
+    TEST_RUN(test_copy_rnd);
+    TEST_RUN(test_words_are_used_on_aligned_rows);
+    TEST_RUN(test_small_areas_use_cpu);
+    TEST_RUN(test_same_image_with_dma);
+
+    return TEST_RESULT();
+}
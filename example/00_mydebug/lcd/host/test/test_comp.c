@@ -0,0 +1,457 @@
+/**
+ * @file test_comp.c
+ * Tests of the compositor of the camera video and the GUI (lv_port_comp) on the simulated LCD and DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "flush_sim.h"
+#include "blit_sim.h"
+#include "lcd_sim.h"
+#include "lvgl/porting/lv_port_pipe.h"
+#include "lvgl/porting/lv_port_comp.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HOR_RES     LV_HOR_RES_MAX
+#define VER_RES     LV_VER_RES_MAX
+#define PX_NS       30
+#define BUF_ROWS    10
+#define RND_OBJ_NUM 24
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool capture_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode);
+static lv_obj_t * rect_create(lv_style_t * style, lv_color_t color, lv_coord_t x, lv_coord_t y, lv_coord_t w,
+                              lv_coord_t h);
+static void rect_paint(lv_obj_t * obj, lv_color_t color);
+static void capture(uint16_t seed);
+static uint32_t irq_lock(void);
+static void irq_unlock(uint32_t state);
+static void refr(void);
+static void ref_compose(lv_opa_t opa);
+static bool gram_matches(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_t * disp;
+static uint8_t strip_mem[2 * HOR_RES * BUF_ROWS * sizeof(lv_color_t)];
+static lv_color_t cam1[HOR_RES * VER_RES];
+static lv_color_t cam2[HOR_RES * VER_RES];
+static lv_style_t scr_style;
+static lv_style_t bar_style;
+static lv_style_t rnd_styles[RND_OBJ_NUM + 4];
+static lv_design_cb_t ancestor_design;
+
+static lv_color_t gui[HOR_RES * VER_RES];   /*The expected GUI layer*/
+static lv_color_t ref[HOR_RES * VER_RES];   /*The expected content of the panel*/
+static const lv_color_t * cam_shown;
+static lv_color_t * cam_captured[2];        /*Surfaces given to the camera by `capture_design`*/
+
+/*The simulated frame end interrupt*/
+static bool irq_masked;
+static bool irq_pend_on_lock;               /*A frame ends while the interrupt is masked*/
+static bool irq_pending;
+static uint32_t irq_lock_cnt;
+static uint32_t irq_unlock_cnt;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_video_under_the_key(void)
+{
+    lv_port_comp_stat_t stat;
+    lv_port_blit_stat_t blit_stat;
+
+    /*A status bar and a crosshair over the video*/
+    lv_obj_t * bar = rect_create(&bar_style, LV_COLOR_NAVY, 0, 0, HOR_RES, 30);
+    rect_create(&rnd_styles[0], LV_COLOR_RED, HOR_RES / 2 - 100, VER_RES / 2 - 1, 200, 3);
+    rect_create(&rnd_styles[1], LV_COLOR_RED, HOR_RES / 2 - 1, VER_RES / 2 - 100, 3, 200);
+
+    lv_port_comp_enable(true);
+    capture(1);
+    TEST_ASSERT(lv_port_comp_frame_pending());
+    lv_port_comp_handler();
+    TEST_ASSERT(lv_port_comp_frame_pending() == false);
+
+    lv_port_blit_reset_stat();
+    refr();
+    ref_compose(LV_OPA_COVER);
+    TEST_ASSERT(gram_matches());
+
+    /*The video is copied by DMA in rectangles*/
+    lv_port_comp_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.frame_cnt);
+    TEST_ASSERT_EQUAL(HOR_RES * VER_RES - HOR_RES * 30 - 200 * 3 * 2 + 3 * 3, stat.video_px);
+    TEST_ASSERT_EQUAL(0, stat.blend_px);
+    TEST_ASSERT(stat.rect_cnt > 0);
+
+    lv_port_blit_get_stat(&blit_stat);
+    TEST_ASSERT(blit_stat.dma_px > stat.video_px / 2);
+
+    /*A new frame is shown*/
+    capture(2);
+    lv_port_comp_handler();
+    refr();
+    ref_compose(LV_OPA_COVER);
+    TEST_ASSERT(gram_matches());
+
+    lv_port_comp_get_stat(&stat);
+    TEST_ASSERT_EQUAL(2, stat.frame_cnt);
+    TEST_ASSERT_EQUAL(2, stat.cam_cnt);
+    TEST_ASSERT_EQUAL(0, stat.drop_cnt);
+
+    /*No new frame: nothing to refresh*/
+    lv_port_comp_handler();
+    uint32_t bus_bytes = lcd_sim_get_bus_bytes();
+    lv_refr_now(disp);
+    TEST_ASSERT_EQUAL(bus_bytes, lcd_sim_get_bus_bytes());
+
+    /*The GUI changes on the same frame*/
+    rect_paint(bar, LV_COLOR_GREEN);
+    refr();
+    ref_compose(LV_OPA_COVER);
+    TEST_ASSERT(gram_matches());
+    lv_port_comp_get_stat(&stat);
+    TEST_ASSERT_EQUAL(2, stat.frame_cnt);
+
+    lv_obj_clean(lv_disp_get_scr_act(disp));
+}
+
+static void test_gui_opacity(void)
+{
+    lv_port_comp_stat_t stat;
+
+    rect_create(&bar_style, LV_COLOR_NAVY, 0, VER_RES - 31, HOR_RES, 31);
+    rect_create(&rnd_styles[0], LV_COLOR_YELLOW, 17, 33, 45, 21);
+
+    lv_port_comp_set_opa(LV_OPA_60);
+    capture(3);
+    lv_port_comp_handler();
+    refr();
+    ref_compose(LV_OPA_60);
+    TEST_ASSERT(gram_matches());
+
+    lv_port_comp_get_stat(&stat);
+    TEST_ASSERT_EQUAL(HOR_RES * 31 + 45 * 21, stat.blend_px);
+
+    /*The GUI disappears*/
+    lv_port_comp_set_opa(LV_OPA_TRANSP);
+    refr();
+    ref_compose(LV_OPA_TRANSP);
+    TEST_ASSERT(gram_matches());
+    TEST_ASSERT(memcmp(lcd_sim_get_gram(), cam_shown, sizeof(ref)) == 0);
+
+    lv_port_comp_set_opa(LV_OPA_COVER);
+    lv_obj_clean(lv_disp_get_scr_act(disp));
+}
+
+static void test_video_area_and_disable(void)
+{
+    lv_area_t area = {101, 51, 300, 250};
+
+    /*The key stays outside of the area*/
+    lv_port_comp_set_area(&area);
+    capture(4);
+    lv_port_comp_handler();
+    refr();
+    ref_compose(LV_OPA_COVER);
+
+    lv_coord_t x, y;
+    for(y = 0; y < VER_RES; y++) {
+        for(x = 0; x < HOR_RES; x++) {
+            lv_point_t p = {x, y};
+            if(!lv_area_is_point_on(&area, &p)) ref[y * HOR_RES + x] = lv_port_comp_get_key();
+        }
+    }
+    TEST_ASSERT(gram_matches());
+
+    area.x1 = 0;
+    area.y1 = 0;
+    area.x2 = HOR_RES - 1;
+    area.y2 = VER_RES - 1;
+    lv_port_comp_set_area(&area);
+
+    /*Disabled: the frames are not shown*/
+    lv_port_comp_enable(false);
+    capture(5);
+    TEST_ASSERT(lv_port_comp_frame_pending() == false);
+    refr();
+    TEST_ASSERT_EQUAL(lv_port_comp_get_key().full, lcd_sim_get_gram()[0]);
+
+    lv_port_comp_enable(true);
+    TEST_ASSERT(lv_port_comp_frame_pending());
+}
+
+static void test_capture_avoids_the_shown_surface(void)
+{
+    lv_port_comp_stat_t stat;
+    lv_port_comp_get_stat(&stat);
+    uint32_t drop_cnt = stat.drop_cnt;
+
+    /*The next refresh shows the last frame*/
+    capture(6);
+    const lv_color_t * shown = cam_shown;
+    lv_port_comp_handler();
+
+    /*Two frames end while the screen is drawn: both go to the other surface*/
+    lv_obj_t * scr  = lv_disp_get_scr_act(disp);
+    ancestor_design = lv_obj_get_design_cb(scr);
+    lv_obj_set_design_cb(scr, capture_design);
+    memset(cam_captured, 0, sizeof(cam_captured));
+    lv_refr_now(disp);
+    while(lv_port_flush_is_busy()) flush_sim_wait_us(1);
+    lv_obj_set_design_cb(scr, ancestor_design);
+
+    TEST_ASSERT(cam_captured[0] != NULL && cam_captured[0] != shown);
+    TEST_ASSERT(cam_captured[1] != NULL && cam_captured[1] != shown);
+    lv_port_comp_get_stat(&stat);
+    TEST_ASSERT(stat.drop_cnt >= drop_cnt + 2);
+    TEST_ASSERT(memcmp(lcd_sim_get_gram(), shown, sizeof(ref)) == 0);
+
+    /*After the refresh the camera can switch*/
+    TEST_ASSERT(lv_port_comp_get_cam_buf() != shown);
+    TEST_ASSERT(lv_port_comp_cam_frame_end() == shown);
+}
+
+static void test_frame_end_waits_for_the_render_start(void)
+{
+    lv_port_comp_stat_t stat;
+    lv_port_comp_get_stat(&stat);
+    uint32_t frame_cnt = stat.frame_cnt;
+
+    capture(9);
+    const lv_color_t * shown = cam_shown;
+    lv_port_comp_handler();
+
+    /*A frame ends while the start of the refresh takes the last one: it's handled after the unmasking*/
+    lv_port_comp_set_irq_lock(irq_lock, irq_unlock);
+    irq_lock_cnt     = 0;
+    irq_unlock_cnt   = 0;
+    irq_pend_on_lock = true;
+    memset(cam_captured, 0, sizeof(cam_captured));
+    refr();
+    lv_port_comp_set_irq_lock(NULL, NULL);
+
+    TEST_ASSERT(irq_lock_cnt >= 1);
+    TEST_ASSERT_EQUAL(irq_lock_cnt, irq_unlock_cnt);
+    TEST_ASSERT(irq_masked == false);
+
+    /*The frame being shown is not given to the camera*/
+    TEST_ASSERT(cam_captured[0] != NULL && cam_captured[0] != shown);
+    TEST_ASSERT(memcmp(lcd_sim_get_gram(), shown, sizeof(ref)) == 0);
+
+    lv_port_comp_get_stat(&stat);
+    TEST_ASSERT_EQUAL(frame_cnt + 1, stat.frame_cnt);
+}
+
+static void test_random_gui_matches(void)
+{
+    uint32_t i;
+
+    srand(1);
+    for(i = 0; i < RND_OBJ_NUM; i++) {
+        /*Some objects have the key: the video shows through them*/
+        lv_color_t c;
+        c.full = (rand() % 4 == 0) ? lv_port_comp_get_key().full : (uint16_t)rand();
+        lv_coord_t w = 1 + rand() % (HOR_RES / 2);
+        lv_coord_t h = 1 + rand() % (VER_RES / 2);
+        rect_create(&rnd_styles[i], c, rand() % HOR_RES - w / 2, rand() % VER_RES - h / 2, w, h);
+    }
+
+    /*Single key pixels between GUI pixels on both halves of the words*/
+    for(i = 0; i < 4; i++) rect_create(&rnd_styles[RND_OBJ_NUM + i], LV_COLOR_ORANGE, 200 + i * 5, 5, 4, 3);
+
+    capture(7);
+    lv_port_comp_handler();
+    refr();
+    ref_compose(LV_OPA_COVER);
+    TEST_ASSERT(gram_matches());
+
+    lv_port_comp_set_opa(LV_OPA_30);
+    capture(8);
+    lv_port_comp_handler();
+    refr();
+    ref_compose(LV_OPA_30);
+    TEST_ASSERT(gram_matches());
+
+    lv_port_comp_set_opa(LV_OPA_COVER);
+    lv_obj_clean(lv_disp_get_scr_act(disp));
+}
+
+/*Frames of the camera end while the screen is drawn*/
+static bool capture_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    if(mode == LV_DESIGN_DRAW_MAIN && cam_captured[1] == NULL) {
+        cam_captured[cam_captured[0] ? 1 : 0] = lv_port_comp_cam_frame_end();
+    }
+
+    return ancestor_design(obj, mask, mode);
+}
+
+static lv_obj_t * rect_create(lv_style_t * style, lv_color_t color, lv_coord_t x, lv_coord_t y, lv_coord_t w,
+                              lv_coord_t h)
+{
+    lv_obj_t * obj = lv_obj_create(lv_disp_get_scr_act(disp), NULL);
+    lv_style_copy(style, &lv_style_plain);
+    lv_obj_set_style(obj, style);
+    lv_obj_set_pos(obj, x, y);
+    lv_obj_set_size(obj, w, h);
+    rect_paint(obj, color);
+
+    return obj;
+}
+
+static void rect_paint(lv_obj_t * obj, lv_color_t color)
+{
+    lv_style_t * style      = (lv_style_t *)lv_obj_get_style(obj);
+    style->body.main_color  = color;
+    style->body.grad_color  = color;
+    lv_obj_refresh_style(obj);
+}
+
+/*Mask the simulated frame end interrupt*/
+static uint32_t irq_lock(void)
+{
+    uint32_t state = irq_masked ? 1 : 0;
+    irq_masked     = true;
+    irq_lock_cnt++;
+
+    if(irq_pend_on_lock) {
+        irq_pend_on_lock = false;
+        irq_pending      = true;
+    }
+
+    return state;
+}
+
+/*Restore the mask and run the frame end if it came meanwhile*/
+static void irq_unlock(uint32_t state)
+{
+    irq_masked = state != 0;
+    irq_unlock_cnt++;
+
+    if(irq_pending && !irq_masked) {
+        irq_pending     = false;
+        cam_captured[0] = lv_port_comp_cam_frame_end();
+    }
+}
+
+/*The camera writes a frame with a pattern*/
+static void capture(uint16_t seed)
+{
+    lv_color_t * surf = lv_port_comp_get_cam_buf();
+    uint32_t i;
+    for(i = 0; i < HOR_RES * VER_RES; i++) {
+        surf[i].full = (uint16_t)(i * 13 + seed * 977);
+        if(surf[i].full == lv_port_comp_get_key().full) surf[i].full++;
+    }
+
+    lv_port_comp_cam_frame_end();
+    cam_shown = surf;
+}
+
+/*Redraw the whole screen and let the DMA finish*/
+static void refr(void)
+{
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    lv_refr_now(disp);
+    while(lv_port_flush_is_busy()) flush_sim_wait_us(1);
+}
+
+/*The expected content of the panel: the children of the screen over the key, then the video under it*/
+static void ref_compose(lv_opa_t opa)
+{
+    lv_obj_t * scr   = lv_disp_get_scr_act(disp);
+    lv_color_t key   = lv_port_comp_get_key();
+    lv_obj_t * child = NULL;
+    uint32_t i;
+
+    for(i = 0; i < HOR_RES * VER_RES; i++) gui[i] = key;
+
+    /*The oldest child is at the end of the list and is drawn first*/
+    lv_obj_t * last = NULL;
+    while(last != lv_obj_get_child(scr, NULL)) {
+        child = NULL;
+        lv_obj_t * c = lv_obj_get_child(scr, NULL);
+        while(c != last) {
+            child = c;
+            c     = lv_obj_get_child(scr, c);
+        }
+        last = child;
+
+        lv_area_t area;
+        lv_area_t scr_area = {0, 0, HOR_RES - 1, VER_RES - 1};
+        lv_obj_get_coords(child, &area);
+        if(!lv_area_intersect(&area, &area, &scr_area)) continue;
+
+        lv_color_t color = lv_obj_get_style(child)->body.main_color;
+        lv_coord_t x, y;
+        for(y = area.y1; y <= area.y2; y++) {
+            for(x = area.x1; x <= area.x2; x++) gui[y * HOR_RES + x] = color;
+        }
+    }
+
+    for(i = 0; i < HOR_RES * VER_RES; i++) {
+        if(gui[i].full == key.full || opa == LV_OPA_TRANSP) ref[i] = cam_shown[i];
+        else if(opa < LV_OPA_COVER) ref[i] = lv_color_mix(cam_shown[i], gui[i], LV_OPA_COVER - opa);
+        else ref[i] = gui[i];
+    }
+}
+
+static bool gram_matches(void)
+{
+    const uint16_t * gram = lcd_sim_get_gram();
+    uint32_t i;
+    for(i = 0; i < HOR_RES * VER_RES; i++) {
+        if(gram[i] != ref[i].full) return false;
+    }
+
+    return true;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_init();
+    flush_sim_init();
+    flush_sim_set_timing(PX_NS);
+    blit_sim_init();
+
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res  = HOR_RES;
+    disp_drv.ver_res  = VER_RES;
+    disp_drv.flush_cb = lv_port_flush_cb;
+    lv_port_pipe_init(&disp_drv, strip_mem, sizeof(strip_mem), lcd_sim_get_time_us);
+    lv_port_comp_init(&disp_drv, cam1, cam2, lcd_sim_get_time_us);
+    disp = lv_disp_drv_register(&disp_drv);
+
+    /*The screen has the key: the video is behind it*/
+    lv_style_copy(&scr_style, &lv_style_scr);
+    scr_style.body.main_color = lv_port_comp_get_key();
+    scr_style.body.grad_color = lv_port_comp_get_key();
+    lv_obj_set_style(lv_disp_get_scr_act(disp), &scr_style);
+    lv_refr_now(disp);
+    while(lv_port_flush_is_busy()) flush_sim_wait_us(1);
+
+    TEST_RUN(test_video_under_the_key);
+    TEST_RUN(test_gui_opacity);
+    TEST_RUN(test_video_area_and_disable);
+    TEST_RUN(test_capture_avoids_the_shown_surface);
+    TEST_RUN(test_frame_end_waits_for_the_render_start);
+    TEST_RUN(test_random_gui_matches);
+
+    return TEST_RESULT();
+}
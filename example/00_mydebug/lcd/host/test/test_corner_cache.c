@@ -0,0 +1,143 @@
+/**
+ * @file test_corner_cache.c
+ * Tests of the cache of the corner masks (lv_corner_cache) and the rounded rectangles drawn from it
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "mask_cache_test.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TILE    7
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_obj_t * rect_obj_create(lv_style_t * style, lv_coord_t w, lv_coord_t h, lv_coord_t radius,
+                                  lv_coord_t bwidth);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_style_t styles[4];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_redraw_hits(void)
+{
+    lv_obj_t * obj1 = rect_obj_create(&styles[0], 100, 60, 10, 3);
+    lv_obj_t * obj2 = lv_obj_create(lv_disp_get_scr_act(NULL), obj1);
+    lv_obj_set_pos(obj2, 20, 20);
+
+    /*The mask of the body and the two masks of the border are shared by the two objects*/
+    check_redraw_hits(&lv_corner_cache, 3);
+
+    lv_obj_del(obj1);
+    lv_obj_del(obj2);
+}
+
+static void test_clipped_corners_same_image(void)
+{
+    /*Gradient and translucent body with a translucent border*/
+    lv_obj_t * obj = rect_obj_create(&styles[1], 120, 80, 20, 4);
+    styles[1].body.grad_color  = LV_COLOR_MAROON;
+    styles[1].body.opa         = LV_OPA_70;
+    styles[1].body.border.opa  = LV_OPA_50;
+    lv_obj_refresh_style(obj);
+    refr_full();
+    uint32_t crc = lv_port_host_get_fb_crc();
+
+    refr_tiles(TILE);
+    TEST_ASSERT_EQUAL(crc, lv_port_host_get_fb_crc());
+    lv_obj_del(obj);
+}
+
+static void test_mirrored_corners(void)
+{
+    /*The corners of a centered object are the mirrors of each other*/
+    static const lv_coord_t bwidths[] = {0, 1, 2, 5};
+    uint32_t i;
+    for(i = 0; i < sizeof(bwidths) / sizeof(bwidths[0]); i++) {
+        lv_obj_t * obj = rect_obj_create(&styles[2], 150, 100, 25, bwidths[i]);
+        refr_full();
+        TEST_ASSERT(is_mirrored(true));
+        TEST_ASSERT(is_mirrored(false));
+        lv_obj_del(obj);
+    }
+}
+
+static void test_budget(void)
+{
+    lv_obj_t * obj = rect_obj_create(&styles[3], 100, 100, 0, 0);
+
+    /*Every radius needs an other mask*/
+    lv_coord_t radii[2 * LV_CORNER_CACHE_ENTRY_NUM];
+    uint32_t i;
+    for(i = 0; i < sizeof(radii) / sizeof(radii[0]); i++) radii[i] = i + 1;
+    check_budget(&lv_corner_cache, obj, &styles[3], radii, sizeof(radii) / sizeof(radii[0]));
+
+    lv_obj_del(obj);
+}
+
+static void test_fallback(void)
+{
+    lv_mask_cache_stat_t stat;
+
+    /*The mask of a too large corner is not cached*/
+    lv_mask_cache_clear(&lv_corner_cache);
+    lv_obj_t * obj = rect_obj_create(&styles[0], 200, 200, 60, 0);
+    refr_full();
+    lv_mask_cache_get_stat(&lv_corner_cache, &stat);
+    TEST_ASSERT_EQUAL(0, stat.entry_cnt);
+    lv_obj_del(obj);
+
+    /*The anti-aliased corners of a 2 px wide object overlap and are drawn without the cache*/
+    lv_mask_cache_reset_stat(&lv_corner_cache);
+    obj = rect_obj_create(&styles[0], 2, 40, 10, 1);
+    refr_full();
+    lv_mask_cache_get_stat(&lv_corner_cache, &stat);
+    TEST_ASSERT_EQUAL(0, stat.hit_cnt + stat.miss_cnt);
+    lv_obj_del(obj);
+}
+
+/*Create a centered object with rounded corners and a border*/
+static lv_obj_t * rect_obj_create(lv_style_t * style, lv_coord_t w, lv_coord_t h, lv_coord_t radius,
+                                  lv_coord_t bwidth)
+{
+    lv_style_copy(style, &lv_style_plain);
+    style->body.main_color   = LV_COLOR_SILVER;
+    style->body.grad_color   = LV_COLOR_SILVER;
+    style->body.radius       = radius;
+    style->body.border.width = bwidth;
+    style->body.border.color = LV_COLOR_NAVY;
+    style->body.border.opa   = LV_OPA_COVER;
+
+    lv_obj_t * obj = lv_obj_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_obj_set_style(obj, style);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_align(obj, NULL, LV_ALIGN_CENTER, 0, 0);
+
+    return obj;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    TEST_RUN(test_redraw_hits);
+    TEST_RUN(test_clipped_corners_same_image);
+    TEST_RUN(test_mirrored_corners);
+    TEST_RUN(test_budget);
+    TEST_RUN(test_fallback);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,333 @@
+/**
+ * @file test_diff.c
+ * Tests of the differential flush of lv_port_flush (shadow of the panel) on the simulated LCD bus and DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "flush_sim.h"
+#include "lcd_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HOR_RES     LCD_SIM_HOR_RES
+#define VER_RES     LCD_SIM_VER_RES
+#define BUF_ROWS    10
+
+/*The bytes of a full strip: window, RAMWR and the pixels*/
+#define STRIP_BYTES (8 * 2 * 2 + 2 + HOR_RES * BUF_ROWS * 2)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void drv_init(void);
+static void flush(const lv_area_t * area);
+static void strip_fill(lv_coord_t y1, uint16_t seed);
+static void buf_set(const lv_area_t * area, lv_coord_t x, lv_coord_t y, uint16_t c);
+static bool gram_matches(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_buf_t disp_buf;
+static lv_disp_drv_t disp_drv;
+static lv_color_t buf[HOR_RES * BUF_ROWS];
+static lv_color_t shadow[HOR_RES * VER_RES];
+static uint16_t ref[HOR_RES * VER_RES];     /*The expected content of the panel*/
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_unchanged_strip_is_not_sent(void)
+{
+    lv_area_t area = {0, 100, HOR_RES - 1, 100 + BUF_ROWS - 1};
+    lv_port_flush_stat_t stat;
+
+    drv_init();
+
+    /*The rows are unknown: sent in full*/
+    strip_fill(area.y1, 1);
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(HOR_RES * BUF_ROWS, stat.px_cnt);
+    TEST_ASSERT_EQUAL(0, stat.saved_bytes);
+
+    /*The same again: ready without using the bus*/
+    lv_port_flush_reset_stat();
+    uint32_t bus_bytes = lcd_sim_get_bus_bytes();
+    disp_buf.flushing = 1;
+    lv_port_flush_cb(&disp_drv, &area, buf);
+    TEST_ASSERT_EQUAL(0, disp_buf.flushing);
+    TEST_ASSERT(lv_port_flush_is_busy() == false);
+    TEST_ASSERT_EQUAL(bus_bytes, lcd_sim_get_bus_bytes());
+
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(STRIP_BYTES, stat.saved_bytes);
+    TEST_ASSERT(gram_matches());
+}
+
+static void test_blinking_cursor_is_one_window(void)
+{
+    lv_area_t area = {0, 200, HOR_RES - 1, 200 + BUF_ROWS - 1};
+    lv_port_flush_stat_t stat;
+    lv_coord_t y;
+
+    drv_init();
+    strip_fill(area.y1, 2);
+    flush(&area);
+
+    /*A 2 px wide cursor on 8 rows*/
+    for(y = 1; y < 9; y++) {
+        buf_set(&area, 101, area.y1 + y, 0xFFFF);
+        buf_set(&area, 102, area.y1 + y, 0xFFFF);
+    }
+
+    lv_port_flush_reset_stat();
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.diff_cnt);
+    TEST_ASSERT_EQUAL(1, stat.win_cnt);
+    TEST_ASSERT_EQUAL(2 * 8, stat.px_cnt);
+    TEST_ASSERT_EQUAL(8, stat.dma_cnt);
+    TEST_ASSERT_EQUAL(stat.bus_bytes + stat.saved_bytes, STRIP_BYTES);
+    TEST_ASSERT(gram_matches());
+}
+
+static void test_spans_are_joined_when_cheaper(void)
+{
+    lv_area_t area = {0, 300, HOR_RES - 1, 300 + BUF_ROWS - 1};
+    lv_port_flush_stat_t stat;
+
+    /*Two changes close to each other: one window with the gap*/
+    drv_init();
+    strip_fill(area.y1, 3);
+    flush(&area);
+    buf_set(&area, 40, area.y1 + 4, 0x1234);
+    buf_set(&area, 50, area.y1 + 4, 0x4321);
+    lv_port_flush_reset_stat();
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.win_cnt);
+    TEST_ASSERT_EQUAL(11, stat.px_cnt);
+    TEST_ASSERT(gram_matches());
+
+    /*Far from each other: two windows*/
+    buf_set(&area, 40, area.y1 + 4, 0x1111);
+    buf_set(&area, 400, area.y1 + 4, 0x2222);
+    lv_port_flush_reset_stat();
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(2, stat.win_cnt);
+    TEST_ASSERT_EQUAL(2, stat.px_cnt);
+    TEST_ASSERT(gram_matches());
+
+    /*The changes of the next row extend the rectangle*/
+    buf_set(&area, 41, area.y1 + 5, 0x3333);
+    buf_set(&area, 42, area.y1 + 6, 0x3333);
+    lv_port_flush_reset_stat();
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.win_cnt);
+    TEST_ASSERT_EQUAL(2 * 2, stat.px_cnt);
+    TEST_ASSERT(gram_matches());
+}
+
+static void test_dense_changes_are_sent_in_full(void)
+{
+    lv_area_t area = {0, 400, HOR_RES - 1, 400 + BUF_ROWS - 1};
+    lv_port_flush_stat_t stat;
+
+    drv_init();
+    strip_fill(area.y1, 4);
+    flush(&area);
+
+    /*Almost everything changes*/
+    strip_fill(area.y1, 5);
+    buf_set(&area, 0, area.y1, ref[area.y1 * HOR_RES]);
+    lv_port_flush_reset_stat();
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.diff_cnt);
+    TEST_ASSERT_EQUAL(1, stat.dense_cnt);
+    TEST_ASSERT_EQUAL(1, stat.win_cnt);
+    TEST_ASSERT_EQUAL(HOR_RES * BUF_ROWS, stat.px_cnt);
+    TEST_ASSERT_EQUAL(0, stat.saved_bytes);
+    TEST_ASSERT(gram_matches());
+}
+
+static void test_too_many_rects_are_sent_in_full(void)
+{
+    lv_area_t area = {0, 500, HOR_RES - 1, 500 + BUF_ROWS - 1};
+    lv_port_flush_stat_t stat;
+    lv_coord_t y;
+
+    drv_init();
+    strip_fill(area.y1, 6);
+    flush(&area);
+
+    /*Isolated pixels on every 2nd row: more rectangles than LV_PORT_FLUSH_DIFF_RECT_MAX but cheap ones*/
+    for(y = 0; y < BUF_ROWS; y += 2) {
+        lv_coord_t i;
+        for(i = 0; i < 8; i++) buf_set(&area, 20 + i * 55 + y, area.y1 + y, (uint16_t)(0x1000 + i + y));
+    }
+    TEST_ASSERT(BUF_ROWS / 2 * 8 > LV_PORT_FLUSH_DIFF_RECT_MAX);
+
+    uint32_t bus_bytes = lcd_sim_get_bus_bytes();
+    lv_port_flush_reset_stat();
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.diff_cnt);
+    TEST_ASSERT_EQUAL(1, stat.dense_cnt);
+    TEST_ASSERT_EQUAL(1, stat.win_cnt);
+    TEST_ASSERT_EQUAL(HOR_RES * BUF_ROWS, stat.px_cnt);
+    TEST_ASSERT_EQUAL(STRIP_BYTES, stat.bus_bytes);
+    TEST_ASSERT_EQUAL(STRIP_BYTES, lcd_sim_get_bus_bytes() - bus_bytes);
+    TEST_ASSERT(gram_matches());
+}
+
+static void test_invalidated_rows_are_sent_in_full(void)
+{
+    lv_area_t area = {0, 500, HOR_RES - 1, 500 + BUF_ROWS - 1};
+    lv_area_t part = {8, 500, 207, 500 + BUF_ROWS - 1};
+    lv_port_flush_stat_t stat;
+
+    drv_init();
+    strip_fill(area.y1, 6);
+    flush(&area);
+
+    /*Something else wrote the panel*/
+    lv_port_flush_shadow_invalidate();
+    lv_port_flush_reset_stat();
+    flush(&area);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(HOR_RES * BUF_ROWS, stat.px_cnt);
+
+    /*A part of the width doesn't make the rows known again*/
+    lv_port_flush_shadow_invalidate();
+    lv_port_flush_reset_stat();
+    memset(buf, 0, sizeof(buf));
+    flush(&part);
+    flush(&part);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(2 * lv_area_get_size(&part), stat.px_cnt);
+    TEST_ASSERT(gram_matches());
+}
+
+static void test_random_changes_match_the_panel(void)
+{
+    lv_port_flush_stat_t stat;
+    uint32_t i;
+
+    drv_init();
+    srand(1);
+
+    /*Known content on the whole panel*/
+    lv_area_t area = {0, 0, HOR_RES - 1, BUF_ROWS - 1};
+    for(area.y1 = 0; area.y1 < VER_RES; area.y1 += BUF_ROWS) {
+        area.y2 = area.y1 + BUF_ROWS - 1;
+        strip_fill(area.y1, 7);
+        flush(&area);
+    }
+
+    /*Areas of any position and width (also odd ones, not aligned to words) with a few changes*/
+    lv_port_flush_reset_stat();
+    for(i = 0; i < 300; i++) {
+        lv_coord_t w = 1 + rand() % HOR_RES;
+        lv_coord_t h = 1 + rand() % BUF_ROWS;
+        area.x1 = rand() % (HOR_RES - w + 1);
+        area.y1 = rand() % (VER_RES - h + 1);
+        area.x2 = area.x1 + w - 1;
+        area.y2 = area.y1 + h - 1;
+
+        /*Start from the panel's content like the rendering of an invalidated area*/
+        lv_coord_t x, y;
+        for(y = area.y1; y <= area.y2; y++) {
+            for(x = area.x1; x <= area.x2; x++) buf_set(&area, x, y, ref[y * HOR_RES + x]);
+        }
+
+        uint32_t chg = rand() % 8;
+        while(chg--) {
+            buf_set(&area, area.x1 + rand() % w, area.y1 + rand() % h, (uint16_t)rand());
+        }
+
+        flush(&area);
+    }
+
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT(gram_matches());
+    TEST_ASSERT(stat.diff_cnt > 200);
+    TEST_ASSERT(stat.saved_bytes > 4 * stat.bus_bytes);
+    TEST_ASSERT_EQUAL(stat.bus_bytes, lcd_sim_get_bus_bytes() - (uint32_t)VER_RES / BUF_ROWS * STRIP_BYTES);
+}
+
+static void drv_init(void)
+{
+    flush_sim_init();
+
+    /*The content of the shadow doesn't matter*/
+    memset(shadow, 0x5A, sizeof(shadow));
+    lv_port_flush_shadow_init(shadow, HOR_RES, VER_RES);
+    memset(ref, 0, sizeof(ref));
+
+    lv_disp_buf_init(&disp_buf, buf, NULL, HOR_RES * BUF_ROWS);
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.buffer   = &disp_buf;
+    disp_drv.flush_cb = lv_port_flush_cb;
+}
+
+/*Flush the area from `buf` like LVGL and let the DMA finish*/
+static void flush(const lv_area_t * area)
+{
+    disp_buf.flushing = 1;
+    lv_port_flush_cb(&disp_drv, area, buf);
+    flush_sim_run(0);
+    TEST_ASSERT_EQUAL(0, disp_buf.flushing);
+
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lv_coord_t x;
+        for(x = area->x1; x <= area->x2; x++) {
+            ref[y * HOR_RES + x] = buf[(y - area->y1) * lv_area_get_width(area) + x - area->x1].full;
+        }
+    }
+}
+
+/*Fill a full width strip with a pattern*/
+static void strip_fill(lv_coord_t y1, uint16_t seed)
+{
+    uint32_t i;
+    for(i = 0; i < HOR_RES * BUF_ROWS; i++) buf[i].full = (uint16_t)(i * 7 + seed * 131 + y1);
+}
+
+static void buf_set(const lv_area_t * area, lv_coord_t x, lv_coord_t y, uint16_t c)
+{
+    buf[(y - area->y1) * lv_area_get_width(area) + x - area->x1].full = c;
+}
+
+static bool gram_matches(void)
+{
+    return memcmp(lcd_sim_get_gram(), ref, sizeof(ref)) == 0;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    TEST_RUN(test_unchanged_strip_is_not_sent);
+    TEST_RUN(test_blinking_cursor_is_one_window);
+    TEST_RUN(test_spans_are_joined_when_cheaper);
+    TEST_RUN(test_dense_changes_are_sent_in_full);
+    TEST_RUN(test_too_many_rects_are_sent_in_full);
+    TEST_RUN(test_invalidated_rows_are_sent_in_full);
+    TEST_RUN(test_random_changes_match_the_panel);
+
+    return TEST_RESULT();
+}
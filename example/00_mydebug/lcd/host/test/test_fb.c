@@ -0,0 +1,211 @@
+/**
+ * @file test_fb.c
+ * Tests of the true double buffering with frame buffers (lv_port_fb) on the simulated LCD and DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "flush_sim.h"
+#include "blit_sim.h"
+#include "lcd_sim.h"
+#include "lvgl/porting/lv_port_fb.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HOR_RES     LV_HOR_RES_MAX
+#define VER_RES     LV_VER_RES_MAX
+#define PX_NS       30
+#define FRAME_NUM   6
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool cost_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode);
+static void refr(void);
+static void wait_feed(void);
+static bool gram_matches(const lv_color_t * fb);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_t * disp;
+static lv_color_t fb1[HOR_RES * VER_RES];
+static lv_color_t fb2[HOR_RES * VER_RES];
+static lv_design_cb_t ancestor_design;
+static uint32_t render_us;      /*Simulated rendering time of the screen*/
+static uint32_t busy_px_ns;     /*Bus time of a pixel while the rendering runs*/
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_true_double_buffering(void)
+{
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+
+    TEST_ASSERT(lv_disp_is_true_double_buf(disp));
+    TEST_ASSERT(vdb->buf1 == fb1);
+    TEST_ASSERT(vdb->buf2 == fb2);
+}
+
+static void test_panel_is_fed_in_background(void)
+{
+    lv_obj_t * scr = lv_disp_get_scr_act(disp);
+    lv_port_blit_stat_t blit_stat;
+    lv_port_fb_stat_t stat;
+
+    lv_obj_t * label = lv_label_create(scr, NULL);
+    lv_label_set_text(label, "Frame buffer");
+    lv_obj_set_pos(label, 100, 150);
+    refr();
+    wait_feed();
+
+    /*Only the label is changed*/
+    lv_port_blit_reset_stat();
+    lv_label_set_text(label, "Frame buffer 2");
+    lv_refr_now(disp);
+
+    /*LVGL doesn't wait: the panel gets the pixels while the CPU can go on*/
+    TEST_ASSERT(lv_port_flush_is_busy());
+    TEST_ASSERT_EQUAL(0, lv_disp_get_buf(disp)->flushing);
+
+    lv_port_fb_get_stat(&stat);
+    TEST_ASSERT(stat.copy_px > 0);
+    TEST_ASSERT(stat.copy_px < HOR_RES * VER_RES / 10);
+
+    /*The areas are copied to the other buffer: the small ones by the CPU*/
+    lv_port_blit_get_stat(&blit_stat);
+    TEST_ASSERT(blit_stat.copy_cnt > 0);
+    TEST_ASSERT_EQUAL(stat.copy_px, blit_stat.dma_px + blit_stat.cpu_px);
+    TEST_ASSERT(memcmp(fb1, fb2, sizeof(fb1)) == 0);
+
+    wait_feed();
+    TEST_ASSERT(gram_matches(fb1));
+
+    /*The whole screen is copied by DMA*/
+    lv_obj_del(label);
+    lv_port_blit_reset_stat();
+    refr();
+    lv_port_blit_get_stat(&blit_stat);
+    TEST_ASSERT_EQUAL(HOR_RES * VER_RES, blit_stat.dma_px);
+    TEST_ASSERT_EQUAL(0, blit_stat.cpu_px);
+
+    wait_feed();
+    TEST_ASSERT(gram_matches(fb1));
+    TEST_ASSERT(memcmp(fb1, fb2, sizeof(fb1)) == 0);
+}
+
+static void test_contention_is_measured(void)
+{
+    lv_port_fb_stat_t stat;
+    uint32_t i;
+
+    /*The feed runs alone: its speed is the bus speed*/
+    render_us  = 0;
+    busy_px_ns = PX_NS;
+    for(i = 0; i < FRAME_NUM; i++) {
+        refr();
+        wait_feed();
+    }
+
+    lv_port_fb_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.overlap_us);
+    TEST_ASSERT_EQUAL(HOR_RES * VER_RES, stat.feed_px);
+    TEST_ASSERT(stat.quiet_px_ns >= PX_NS && stat.quiet_px_ns <= PX_NS + 1);
+
+    /*The frames are rendered while the previous one is sent, which is slowed down to half speed by the rendering*/
+    render_us  = 2000;
+    busy_px_ns = 2 * PX_NS;
+    for(i = 0; i < FRAME_NUM; i++) refr();
+
+    lv_port_fb_get_stat(&stat);
+    TEST_ASSERT(stat.render_us >= render_us);
+    TEST_ASSERT(stat.overlap_us >= render_us);
+    TEST_ASSERT(stat.feed_us > HOR_RES * VER_RES * PX_NS / 1000 + render_us / 2);
+    TEST_ASSERT(stat.contention >= 80 && stat.contention <= 120);
+
+    /*No slow down by the rendering*/
+    busy_px_ns = PX_NS;
+    for(i = 0; i < 2 * FRAME_NUM; i++) refr();
+
+    lv_port_fb_get_stat(&stat);
+    TEST_ASSERT(stat.overlap_us >= render_us);
+    TEST_ASSERT(stat.contention <= 10);
+
+    wait_feed();
+    TEST_ASSERT(gram_matches(lv_disp_get_buf(disp)->buf_act));
+}
+
+/*Let the simulated time pass while the screen is drawn. The feed of the panel is slower meanwhile.*/
+static bool cost_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    if(mode == LV_DESIGN_DRAW_MAIN && render_us) {
+        flush_sim_set_timing(busy_px_ns);
+        flush_sim_wait_us(render_us);
+        flush_sim_set_timing(PX_NS);
+    }
+
+    return ancestor_design(obj, mask, mode);
+}
+
+/*Redraw the whole screen*/
+static void refr(void)
+{
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    lv_refr_now(disp);
+}
+
+static void wait_feed(void)
+{
+    while(lv_port_flush_is_busy()) flush_sim_wait_us(1);
+}
+
+static bool gram_matches(const lv_color_t * fb)
+{
+    const uint16_t * gram = lcd_sim_get_gram();
+    uint32_t i;
+    for(i = 0; i < HOR_RES * VER_RES; i++) {
+        if(gram[i] != fb[i].full) return false;
+    }
+
+    return true;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_init();
+    flush_sim_init();
+    flush_sim_set_timing(PX_NS);
+    blit_sim_init();
+
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = HOR_RES;
+    disp_drv.ver_res = VER_RES;
+    lv_port_fb_init(&disp_drv, fb1, fb2, lcd_sim_get_time_us);
+    disp = lv_disp_drv_register(&disp_drv);
+
+    /*The screen's drawing has the simulated cost*/
+    lv_obj_t * scr  = lv_disp_get_scr_act(disp);
+    ancestor_design = lv_obj_get_design_cb(scr);
+    lv_obj_set_design_cb(scr, cost_design);
+
+    /*The first refresh draws the whole screen*/
+    lv_refr_now(disp);
+    wait_feed();
+
+    TEST_RUN(test_true_double_buffering);
+    TEST_RUN(test_panel_is_fed_in_background);
+    TEST_RUN(test_contention_is_measured);
+
+    return TEST_RESULT();
+}
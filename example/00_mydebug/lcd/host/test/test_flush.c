@@ -0,0 +1,193 @@
+/**
+ * @file test_flush.c
+ * Tests of the DMA flush engine (lv_port_flush) on the simulated LCD bus and DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "flush_sim.h"
+#include "lcd_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HOR_RES     480
+#define VER_RES     320
+#define BUF_ROWS    10
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void drv_init(void);
+static void fill_pattern(lv_color_t * buf, const lv_area_t * area, uint16_t seed);
+static bool gram_matches(const lv_color_t * buf, const lv_area_t * area);
+static void legacy_flush(const lv_area_t * area, const lv_color_t * color_p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_buf_t disp_buf;
+static lv_disp_drv_t disp_drv;
+static lv_color_t buf1[HOR_RES * BUF_ROWS];
+static lv_color_t buf2[HOR_RES * BUF_ROWS];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_area_is_sent_in_background(void)
+{
+    lv_area_t area = {10, 20, 109, 29};
+    lcd_sim_stat_t lcd_stat;
+
+    drv_init();
+    fill_pattern(buf1, &area, 1);
+
+    disp_buf.flushing = 1;
+    lv_port_flush_cb(&disp_drv, &area, buf1);
+
+    /*Only the window and RAMWR are sent by the CPU*/
+    lcd_sim_get_stat(&lcd_stat);
+    TEST_ASSERT(lv_port_flush_is_busy());
+    TEST_ASSERT_EQUAL(1, disp_buf.flushing);
+    TEST_ASSERT_EQUAL(0, lcd_stat.px_cnt);
+    TEST_ASSERT_EQUAL(9, lcd_stat.cmd_cnt);
+
+    /*One DMA block is one line*/
+    TEST_ASSERT_EQUAL(10, flush_sim_run(0));
+
+    lcd_sim_get_stat(&lcd_stat);
+    TEST_ASSERT(lv_port_flush_is_busy() == false);
+    TEST_ASSERT_EQUAL(0, disp_buf.flushing);
+    TEST_ASSERT_EQUAL(lv_area_get_size(&area), lcd_stat.px_cnt);
+    TEST_ASSERT_EQUAL(0, lcd_stat.oob_cnt);
+    TEST_ASSERT(gram_matches(buf1, &area));
+}
+
+static void test_draw_while_flushing(void)
+{
+    lv_area_t area1 = {0, 0, HOR_RES - 1, BUF_ROWS - 1};
+    lv_area_t area2 = {0, BUF_ROWS, HOR_RES - 1, 2 * BUF_ROWS - 1};
+
+    drv_init();
+    fill_pattern(buf1, &area1, 2);
+    lv_port_flush_cb(&disp_drv, &area1, buf1);
+
+    /*Send only a part, then render the next strip into the other buffer meanwhile*/
+    flush_sim_run(3);
+    TEST_ASSERT(lv_port_flush_is_busy());
+    fill_pattern(buf2, &area2, 3);
+    flush_sim_run(0);
+    TEST_ASSERT(lv_port_flush_is_busy() == false);
+
+    lv_port_flush_cb(&disp_drv, &area2, buf2);
+    flush_sim_run(0);
+
+    TEST_ASSERT(gram_matches(buf1, &area1));
+    TEST_ASSERT(gram_matches(buf2, &area2));
+}
+
+static void test_bytes_per_frame(void)
+{
+    lv_area_t strip;
+    lv_port_flush_stat_t stat;
+    uint16_t * gram_legacy = malloc(sizeof(uint16_t) * LCD_SIM_HOR_RES * LCD_SIM_VER_RES);
+    uint32_t bytes_legacy;
+    uint32_t bytes_engine;
+    lv_coord_t y;
+
+    /*The old row by row CPU flush*/
+    drv_init();
+    for(y = 0; y < VER_RES; y += BUF_ROWS) {
+        lv_area_set(&strip, 0, y, HOR_RES - 1, y + BUF_ROWS - 1);
+        fill_pattern(buf1, &strip, y);
+        legacy_flush(&strip, buf1);
+    }
+    bytes_legacy = lcd_sim_get_bus_bytes();
+    memcpy(gram_legacy, lcd_sim_get_gram(), sizeof(uint16_t) * LCD_SIM_HOR_RES * LCD_SIM_VER_RES);
+
+    /*The same frame with the flush engine*/
+    drv_init();
+    for(y = 0; y < VER_RES; y += BUF_ROWS) {
+        lv_area_set(&strip, 0, y, HOR_RES - 1, y + BUF_ROWS - 1);
+        fill_pattern(buf1, &strip, y);
+        lv_port_flush_cb(&disp_drv, &strip, buf1);
+        flush_sim_run(0);
+    }
+    bytes_engine = lcd_sim_get_bus_bytes();
+    lv_port_flush_get_stat(&stat);
+
+    printf("    bytes per %dx%d frame: row by row %u, flush engine %u\n", HOR_RES, VER_RES, bytes_legacy,
+           bytes_engine);
+
+    TEST_ASSERT(memcmp(gram_legacy, lcd_sim_get_gram(), sizeof(uint16_t) * LCD_SIM_HOR_RES * LCD_SIM_VER_RES) == 0);
+    TEST_ASSERT_EQUAL(bytes_engine, stat.bus_bytes);
+    TEST_ASSERT_EQUAL(VER_RES / BUF_ROWS, stat.win_cnt);
+    TEST_ASSERT_EQUAL(VER_RES / BUF_ROWS, stat.dma_cnt);
+    TEST_ASSERT_EQUAL(HOR_RES * VER_RES, stat.px_cnt);
+    TEST_ASSERT(bytes_engine < bytes_legacy);
+
+    free(gram_legacy);
+}
+
+static void drv_init(void)
+{
+    flush_sim_init();
+    lv_disp_buf_init(&disp_buf, buf1, buf2, HOR_RES * BUF_ROWS);
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.buffer   = &disp_buf;
+    disp_drv.flush_cb = lv_port_flush_cb;
+}
+
+static void fill_pattern(lv_color_t * buf, const lv_area_t * area, uint16_t seed)
+{
+    uint32_t i;
+    uint32_t size = lv_area_get_size(area);
+    for(i = 0; i < size; i++) buf[i].full = (uint16_t)(i * 31 + seed * 7);
+}
+
+static bool gram_matches(const lv_color_t * buf, const lv_area_t * area)
+{
+    lv_coord_t x, y;
+    for(y = area->y1; y <= area->y2; y++) {
+        for(x = area->x1; x <= area->x2; x++) {
+            if(lcd_sim_get_px(x, y) != buf->full) return false;
+            buf++;
+        }
+    }
+    return true;
+}
+
+/*The flush of the port before the flush engine: set the cursor and write the pixels for every row*/
+static void legacy_flush(const lv_area_t * area, const lv_color_t * color_p)
+{
+    lv_coord_t x, y;
+    for(y = area->y1; y <= area->y2; y++) {
+        lcd_sim_write_reg(0x2A00, (uint16_t)area->x1 >> 8);
+        lcd_sim_write_reg(0x2A01, (uint16_t)area->x1 & 0xFF);
+        lcd_sim_write_reg(0x2B00, (uint16_t)y >> 8);
+        lcd_sim_write_reg(0x2B01, (uint16_t)y & 0xFF);
+        lcd_sim_write_cmd(0x2C00);
+        for(x = area->x1; x <= area->x2; x++) {
+            lcd_sim_write_data(color_p->full);
+            color_p++;
+        }
+    }
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    TEST_RUN(test_area_is_sent_in_background);
+    TEST_RUN(test_draw_while_flushing);
+    TEST_RUN(test_bytes_per_frame);
+
+    return TEST_RESULT();
+}
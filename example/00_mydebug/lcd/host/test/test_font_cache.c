@@ -0,0 +1,166 @@
+/**
+ * @file test_font_cache.c
+ * Tests of the cache of decompressed glyph bitmaps (lv_font_cache) with a compressed font
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FONT        (&lv_font_roboto_28_compressed)
+#define ASCII_FIRST 0x21
+#define ASCII_LAST  0x7E
+#define ICON_FIRST  0xF001
+#define ICON_LAST   0xF8A2
+#define BMP_MAX     1024
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t get_bitmap_size(uint32_t letter);
+static uint32_t next_letter(uint32_t letter);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+LV_FONT_DECLARE(lv_font_roboto_28_compressed)
+
+static uint8_t bmp_ref[ASCII_LAST + 1][BMP_MAX];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_cached_bitmaps_are_kept(void)
+{
+    lv_font_cache_stat_t stat;
+    uint32_t letter;
+    uint32_t ok = 0;
+
+    lv_font_cache_clear();
+    lv_font_cache_reset_stat();
+
+    /*The first get decompresses the bitmap*/
+    for(letter = ASCII_FIRST; letter <= ASCII_LAST; letter++) {
+        const uint8_t * bmp = lv_font_get_glyph_bitmap(FONT, letter);
+        memcpy(bmp_ref[letter], bmp, get_bitmap_size(letter));
+    }
+
+    lv_font_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(ASCII_LAST - ASCII_FIRST + 1, stat.miss_cnt);
+    TEST_ASSERT_EQUAL(0, stat.hit_cnt);
+    TEST_ASSERT_EQUAL(0, stat.evict_cnt);
+
+    /*The bitmaps added later don't overwrite the earlier ones*/
+    for(letter = ASCII_FIRST; letter <= ASCII_LAST; letter++) {
+        const uint8_t * bmp = lv_font_get_glyph_bitmap(FONT, letter);
+        if(memcmp(bmp_ref[letter], bmp, get_bitmap_size(letter)) == 0) ok++;
+    }
+
+    lv_font_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(ASCII_LAST - ASCII_FIRST + 1, ok);
+    TEST_ASSERT_EQUAL(ASCII_LAST - ASCII_FIRST + 1, stat.hit_cnt);
+    TEST_ASSERT_EQUAL(ASCII_LAST - ASCII_FIRST + 1, stat.entry_cnt);
+}
+
+static void test_lru_is_evicted(void)
+{
+    lv_font_cache_stat_t stat;
+    uint32_t letter = ASCII_FIRST;
+    uint32_t added  = 0;
+
+    lv_font_cache_clear();
+    lv_font_cache_reset_stat();
+
+    /*Keep 'A' the most recently used while the cache overflows*/
+    lv_font_get_glyph_bitmap(FONT, 'A');
+    do {
+        letter = next_letter(letter);
+        if(letter == 'A') continue;
+        if(lv_font_get_glyph_bitmap(FONT, letter)) added++;
+        lv_font_get_glyph_bitmap(FONT, 'A');
+        lv_font_cache_get_stat(&stat);
+    } while(stat.evict_cnt < 20 && letter < ICON_LAST);
+
+    TEST_ASSERT(stat.evict_cnt >= 20);
+    TEST_ASSERT(stat.used <= LV_FONT_CACHE_SIZE);
+    TEST_ASSERT_EQUAL(1, stat.miss_cnt - added);
+
+    /*'A' is still there, the first added letter is not*/
+    lv_font_cache_reset_stat();
+    TEST_ASSERT(memcmp(bmp_ref['A'], lv_font_get_glyph_bitmap(FONT, 'A'), get_bitmap_size('A')) == 0);
+    lv_font_get_glyph_bitmap(FONT, ASCII_FIRST + 1);
+    lv_font_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.hit_cnt);
+    TEST_ASSERT_EQUAL(1, stat.miss_cnt);
+}
+
+static void test_redraw_hits(void)
+{
+    lv_font_cache_stat_t stat;
+    static lv_style_t style;
+    lv_obj_t * scr = lv_disp_get_scr_act(NULL);
+
+    lv_style_copy(&style, &lv_style_plain);
+    style.text.font = FONT;
+    lv_obj_t * label = lv_label_create(scr, NULL);
+    lv_label_set_style(label, LV_LABEL_STYLE_MAIN, &style);
+    lv_label_set_text(label, "Hello compressed world");
+
+    lv_font_cache_clear();
+    lv_font_cache_reset_stat();
+    lv_refr_now(NULL);
+    uint32_t crc = lv_port_host_get_fb_crc();
+    lv_font_cache_get_stat(&stat);
+    uint32_t miss_first = stat.miss_cnt;
+
+    /*"Helocmprsdw" are the different letters, the space has no bitmap*/
+    TEST_ASSERT_EQUAL(11, miss_first);
+
+    lv_obj_invalidate(label);
+    lv_refr_now(NULL);
+    lv_font_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(miss_first, stat.miss_cnt);
+    TEST_ASSERT(stat.hit_cnt > 0);
+    TEST_ASSERT_EQUAL(crc, lv_port_host_get_fb_crc());
+
+    lv_obj_del(label);
+    lv_refr_now(NULL);
+}
+
+/*Size of a decompressed bitmap (3 bpp is stored as 4 bpp)*/
+static uint32_t get_bitmap_size(uint32_t letter)
+{
+    lv_font_glyph_dsc_t g;
+    if(lv_font_get_glyph_dsc(FONT, &g, letter, 0) == false) return 0;
+
+    return ((uint32_t)g.box_w * g.box_h + 1) / 2;
+}
+
+static uint32_t next_letter(uint32_t letter)
+{
+    if(letter == ASCII_LAST) return ICON_FIRST;
+    return letter + 1;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    TEST_RUN(test_cached_bitmaps_are_kept);
+    TEST_RUN(test_lru_is_evicted);
+    TEST_RUN(test_redraw_hits);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_font_lookup.c
+ * Tests of the glyph id tables and the kerning memo of lv_font_fmt_txt
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "host_test.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*More fonts than tables to reuse the tables*/
+#define FONT_NUM    (LV_FONT_FMT_TXT_LUT_NUM + 2)
+#define GLYPH_NUM   26
+
+/*A sparse range above the tables*/
+#define SPARSE_START    0x2000
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fonts_init(void);
+static int32_t get_exp_adv_w(uint32_t font_id, uint32_t letter);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+LV_FONT_DECLARE(lv_font_roboto_16)
+
+/* Font `i` maps 'A' + i... to the glyphs 1..26 and 3 sparse letters to 27..29.
+ * The glyph `n` is `n` px wide so the advance width tells the glyph id.*/
+static lv_font_fmt_txt_glyph_dsc_t glyph_dsc[GLYPH_NUM + 4];
+static const uint16_t sparse_list[] = {0, 0x10, 0x100};
+static lv_font_fmt_txt_cmap_t cmaps[FONT_NUM][2];
+static lv_font_fmt_txt_dsc_t font_dsc[FONT_NUM];
+static lv_font_t fonts[FONT_NUM];
+
+/*Sorted by the left then the right glyph id: (A, V), (T, A), (V, A) of the first font*/
+static const uint8_t kern_pair_ids[] = {1, 22, 20, 1, 22, 1};
+static const int8_t kern_pair_values[] = {-16, -16, 16};
+static const lv_font_fmt_txt_kern_pair_t kern_pairs = {
+    .glyph_ids = kern_pair_ids,
+    .values = kern_pair_values,
+    .pair_cnt = 3,
+    .glyph_ids_size = 0,
+};
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_glyph_ids(void)
+{
+    lv_font_glyph_dsc_t g;
+    uint32_t ok  = 0;
+    uint32_t cnt = 0;
+    uint32_t f;
+    uint32_t letter;
+
+    lv_font_fmt_txt_clear_lookup();
+
+    /*Switch the font at every letter to reuse the tables all the time*/
+    for(letter = 1; letter < 256; letter++) {
+        for(f = 0; f < FONT_NUM; f++) {
+            int32_t exp = get_exp_adv_w(f, letter);
+            bool found  = lv_font_get_glyph_dsc(&fonts[f], &g, letter, 0);
+            if((exp == 0 && !found) || (found && g.adv_w == exp)) ok++;
+            cnt++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL(cnt, ok);
+
+    /*Letters above the tables*/
+    ok  = 0;
+    cnt = 0;
+    for(f = 0; f < FONT_NUM; f++) {
+        for(letter = SPARSE_START; letter < SPARSE_START + 0x110; letter++) {
+            int32_t exp = get_exp_adv_w(f, letter);
+            bool found  = lv_font_get_glyph_dsc(&fonts[f], &g, letter, 0);
+            if((exp == 0 && !found) || (found && g.adv_w == exp)) ok++;
+            cnt++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL(cnt, ok);
+}
+
+static void test_tables_are_reused(void)
+{
+    static const char txt[] = "The quick brown fox jumps over the lazy dog. 0123456789 \xE4\xF6\xFC";
+    lv_font_fmt_txt_stat_t stat;
+    lv_font_glyph_dsc_t g;
+    uint32_t i;
+
+    lv_font_fmt_txt_clear_lookup();
+    lv_font_fmt_txt_reset_stat();
+
+    for(i = 0; txt[i]; i++) lv_font_get_glyph_dsc(&lv_font_roboto_16, &g, (uint8_t)txt[i], (uint8_t)txt[i + 1]);
+
+    /*Every letter is searched only once*/
+    lv_font_fmt_txt_get_stat(&stat);
+    uint32_t search_first = stat.glyph_search_cnt;
+    TEST_ASSERT(search_first < sizeof(txt));
+
+    for(i = 0; txt[i]; i++) lv_font_get_glyph_dsc(&lv_font_roboto_16, &g, (uint8_t)txt[i], (uint8_t)txt[i + 1]);
+
+    lv_font_fmt_txt_get_stat(&stat);
+    TEST_ASSERT_EQUAL(search_first, stat.glyph_search_cnt);
+    TEST_ASSERT(stat.lut_hit_cnt > 0);
+
+    /*The symbols are remembered as the last letters of the font*/
+    for(i = 0; i < 3; i++) {
+        lv_font_get_glyph_dsc(&lv_font_roboto_16, &g, 0xF001, 0);
+        lv_font_get_glyph_dsc(&lv_font_roboto_16, &g, 0xF00C, 0);
+        lv_font_get_glyph_dsc(&lv_font_roboto_16, &g, 0xF1EB, 0);
+    }
+    lv_font_fmt_txt_get_stat(&stat);
+    TEST_ASSERT_EQUAL(search_first + 3, stat.glyph_search_cnt);
+    TEST_ASSERT_EQUAL(6, stat.last_hit_cnt);
+}
+
+static void test_kern_memo(void)
+{
+    lv_font_fmt_txt_stat_t stat;
+    lv_font_glyph_dsc_t g;
+    uint32_t round;
+    uint32_t ok = 0;
+
+    lv_font_fmt_txt_clear_lookup();
+    lv_font_fmt_txt_reset_stat();
+
+    for(round = 0; round < 2; round++) {
+        /*A = 1 px, T = 20 px, V = 22 px; the kerning is +-1 px*/
+        lv_font_get_glyph_dsc(&fonts[0], &g, 'A', 'V');
+        if(g.adv_w == 0) ok++;
+        lv_font_get_glyph_dsc(&fonts[0], &g, 'T', 'A');
+        if(g.adv_w == 19) ok++;
+        lv_font_get_glyph_dsc(&fonts[0], &g, 'V', 'A');
+        if(g.adv_w == 23) ok++;
+        lv_font_get_glyph_dsc(&fonts[0], &g, 'A', 'T');
+        if(g.adv_w == 1) ok++;
+    }
+
+    lv_font_fmt_txt_get_stat(&stat);
+    TEST_ASSERT_EQUAL(8, ok);
+    TEST_ASSERT_EQUAL(4, stat.kern_search_cnt);
+    TEST_ASSERT_EQUAL(4, stat.kern_hit_cnt);
+}
+
+static void fonts_init(void)
+{
+    uint32_t i;
+    for(i = 1; i < sizeof(glyph_dsc) / sizeof(glyph_dsc[0]); i++) {
+        glyph_dsc[i].adv_w = i * 16;
+    }
+
+    for(i = 0; i < FONT_NUM; i++) {
+        cmaps[i][0].range_start    = 'A' + i;
+        cmaps[i][0].range_length   = GLYPH_NUM - 1;   /*The search includes `range_length` too*/
+        cmaps[i][0].glyph_id_start = 1;
+        cmaps[i][0].type           = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY;
+
+        cmaps[i][1].range_start    = SPARSE_START + i;
+        cmaps[i][1].range_length   = 0x100;
+        cmaps[i][1].glyph_id_start = GLYPH_NUM + 1;
+        cmaps[i][1].unicode_list   = sparse_list;
+        cmaps[i][1].list_length    = sizeof(sparse_list) / sizeof(sparse_list[0]);
+        cmaps[i][1].type           = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY;
+
+        font_dsc[i].glyph_dsc     = glyph_dsc;
+        font_dsc[i].cmaps         = cmaps[i];
+        font_dsc[i].cmap_num      = 2;
+        font_dsc[i].bpp           = 1;
+        font_dsc[i].kern_dsc      = &kern_pairs;
+        font_dsc[i].kern_scale    = 16;
+        font_dsc[i].kern_classes  = 0;
+
+        fonts[i].get_glyph_dsc    = lv_font_get_glyph_dsc_fmt_txt;
+        fonts[i].get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+        fonts[i].line_height      = 16;
+        fonts[i].dsc              = &font_dsc[i];
+    }
+}
+
+/*Advance width of a letter without kerning, 0 if the letter is not in the font*/
+static int32_t get_exp_adv_w(uint32_t font_id, uint32_t letter)
+{
+    uint32_t first = 'A' + font_id;
+    if(letter >= first && letter < first + GLYPH_NUM) return letter - first + 1;
+
+    uint32_t i;
+    for(i = 0; i < sizeof(sparse_list) / sizeof(sparse_list[0]); i++) {
+        if(letter == SPARSE_START + font_id + sparse_list[i]) return GLYPH_NUM + 1 + i;
+    }
+
+    return 0;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_init();
+    fonts_init();
+
+    TEST_RUN(test_glyph_ids);
+    TEST_RUN(test_tables_are_reused);
+    TEST_RUN(test_kern_memo);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,276 @@
+/**
+ * @file test_img_cache.c
+ * Tests of the image cache (lv_img_cache): hash lookup, decoded surfaces, byte budget and weighted LRU
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMG_SIZE        32
+#define SLOW_OPEN_TIME  100
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_res_t test_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t test_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t test_decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                       lv_coord_t y, lv_coord_t len, uint8_t * buf);
+static lv_obj_t * img_create(const void * src);
+static void gen_img_init(void);
+static void refr_full(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t img_mem[LV_PORT_HOST_IMG_CACHE_SIZE / sizeof(uint32_t)];
+static uint32_t read_line_cnt;
+static lv_img_dsc_t img_indexed;
+static uint8_t img_indexed_map[16 * sizeof(lv_color32_t) + IMG_SIZE * IMG_SIZE / 2];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_surface_same_image(void)
+{
+    lv_img_cache_stat_t stat;
+    lv_obj_t * img = img_create(&img_indexed);
+
+    /*Line-by-line drawing*/
+    lv_img_cache_set_mem(NULL, 0);
+    refr_full();
+    uint32_t crc = lv_port_host_get_fb_crc();
+
+    /*Drawing from the surface*/
+    lv_img_cache_set_mem(img_mem, sizeof(img_mem));
+    lv_img_cache_reset_stat();
+    refr_full();
+    TEST_ASSERT_EQUAL(crc, lv_port_host_get_fb_crc());
+
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.miss_cnt);
+    TEST_ASSERT_EQUAL(IMG_SIZE * IMG_SIZE * LV_IMG_PX_SIZE_ALPHA_BYTE, stat.used);
+
+    /*The file is read only once and the next frames hit the cache*/
+    read_line_cnt = 0;
+    lv_img_set_src(img, "H:fast_0");
+    refr_full();
+    TEST_ASSERT_EQUAL(IMG_SIZE, read_line_cnt);
+    refr_full();
+    TEST_ASSERT_EQUAL(IMG_SIZE, read_line_cnt);
+
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(2, stat.miss_cnt);
+    TEST_ASSERT(stat.hit_cnt >= 2);
+
+    lv_obj_del(img);
+}
+
+static void test_no_thrash(void)
+{
+    lv_img_cache_stat_t stat;
+    lv_img_cache_set_mem(img_mem, sizeof(img_mem));
+
+    /*Two images drawn alternately stay in the cache*/
+    lv_obj_t * img1 = img_create("H:fast_1");
+    lv_obj_t * img2 = img_create("H:fast_2");
+    lv_obj_set_x(img2, IMG_SIZE);
+
+    lv_img_cache_reset_stat();
+    uint32_t i;
+    for(i = 0; i < 10; i++) refr_full();
+
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(2, stat.miss_cnt);
+    TEST_ASSERT_EQUAL(0, stat.evict_cnt);
+    TEST_ASSERT_EQUAL(2, stat.entry_cnt);
+
+    lv_obj_del(img1);
+    lv_obj_del(img2);
+}
+
+static void test_budget(void)
+{
+    lv_img_cache_stat_t stat;
+    uint32_t surface_size = IMG_SIZE * IMG_SIZE * sizeof(lv_color_t);
+
+    /*Room for 2.5 surfaces*/
+    lv_img_cache_set_mem(img_mem, surface_size * 5 / 2);
+    lv_img_cache_reset_stat();
+
+    static const char * srcs[] = {"H:fast_a", "H:fast_b", "H:fast_c", "H:fast_d", "H:fast_e"};
+    lv_obj_t * img = img_create(srcs[0]);
+    uint32_t i;
+    for(i = 0; i < sizeof(srcs) / sizeof(srcs[0]); i++) {
+        lv_img_set_src(img, srcs[i]);
+        refr_full();
+        lv_img_cache_get_stat(&stat);
+        TEST_ASSERT(stat.used <= surface_size * 5 / 2);
+    }
+
+    TEST_ASSERT_EQUAL(2 * surface_size, stat.used);
+    TEST_ASSERT_EQUAL(3, stat.evict_cnt);
+
+    lv_obj_del(img);
+    lv_img_cache_set_mem(img_mem, sizeof(img_mem));
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.used);
+    TEST_ASSERT_EQUAL(0, stat.entry_cnt);
+}
+
+static void test_invalidate(void)
+{
+    lv_img_cache_stat_t stat;
+    lv_obj_t * img = img_create("H:fast_3");
+    refr_full();
+
+    /*The path of a file matches the copy in the cache*/
+    char path[16];
+    strcpy(path, "H:fast_3");
+    lv_img_cache_invalidate_src(path);
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.entry_cnt);
+    TEST_ASSERT_EQUAL(0, stat.used);
+
+    lv_img_cache_reset_stat();
+    refr_full();
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.miss_cnt);
+
+    lv_obj_del(img);
+}
+
+static void test_cost_weighting(void)
+{
+    lv_img_cache_stat_t stat;
+    lv_img_cache_set_size(2);
+    lv_img_cache_set_mem(img_mem, sizeof(img_mem));
+
+    /*The slow image is older than the fast one but the fast one is closed*/
+    lv_obj_t * img = img_create("H:slow_0");
+    refr_full();
+    lv_img_set_src(img, "H:fast_4");
+    refr_full();
+    lv_img_set_src(img, "H:fast_5");
+    refr_full();
+
+    lv_img_cache_reset_stat();
+    lv_img_set_src(img, "H:slow_0");
+    refr_full();
+    lv_img_cache_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.miss_cnt);
+
+    lv_obj_del(img);
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+}
+
+/*An image file decoder of generated true color images. "H:slow_*" images are slow to open.*/
+static lv_res_t test_decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    (void)decoder; /*Unused*/
+
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_FILE || strncmp(src, "H:", 2) != 0) return LV_RES_INV;
+
+    header->always_zero = 0;
+    header->w           = IMG_SIZE;
+    header->h           = IMG_SIZE;
+    header->cf          = LV_IMG_CF_TRUE_COLOR;
+
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    (void)decoder; /*Unused*/
+
+    dsc->time_to_open = strncmp(dsc->src, "H:slow", 6) == 0 ? SLOW_OPEN_TIME : 1;
+
+    return LV_RES_OK;
+}
+
+static lv_res_t test_decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                       lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    (void)decoder; /*Unused*/
+
+    uint8_t seed = ((const uint8_t *)dsc->src)[strlen(dsc->src) - 1];
+    lv_color_t * px = (lv_color_t *)buf;
+    lv_coord_t i;
+    for(i = 0; i < len; i++) {
+        px[i] = LV_COLOR_MAKE((x + i) * 8, y * 8, seed);
+    }
+
+    read_line_cnt++;
+
+    return LV_RES_OK;
+}
+
+static lv_obj_t * img_create(const void * src)
+{
+    lv_obj_t * img = lv_img_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_img_set_src(img, src);
+
+    return img;
+}
+
+/*A 4 bit indexed image with a gradient palette*/
+static void gen_img_init(void)
+{
+    lv_color32_t * palette = (lv_color32_t *)img_indexed_map;
+    uint32_t i;
+    for(i = 0; i < 16; i++) {
+        palette[i].ch.red   = i * 16;
+        palette[i].ch.green = 255 - i * 16;
+        palette[i].ch.blue  = i * 8;
+        palette[i].ch.alpha = 0xFF;
+    }
+
+    uint8_t * px = &img_indexed_map[16 * sizeof(lv_color32_t)];
+    for(i = 0; i < IMG_SIZE * IMG_SIZE / 2; i++) {
+        px[i] = (uint8_t)(((i % 16) << 4) | ((i / 16) % 16));
+    }
+
+    img_indexed.header.always_zero = 0;
+    img_indexed.header.w           = IMG_SIZE;
+    img_indexed.header.h           = IMG_SIZE;
+    img_indexed.header.cf          = LV_IMG_CF_INDEXED_4BIT;
+    img_indexed.data_size          = sizeof(img_indexed_map);
+    img_indexed.data               = img_indexed_map;
+}
+
+static void refr_full(void)
+{
+    lv_obj_invalidate(lv_disp_get_scr_act(NULL));
+    lv_refr_now(NULL);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    lv_img_decoder_t * decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, test_decoder_info);
+    lv_img_decoder_set_open_cb(decoder, test_decoder_open);
+    lv_img_decoder_set_read_line_cb(decoder, test_decoder_read_line);
+    gen_img_init();
+
+    TEST_RUN(test_surface_same_image);
+    TEST_RUN(test_no_thrash);
+    TEST_RUN(test_budget);
+    TEST_RUN(test_invalidate);
+    TEST_RUN(test_cost_weighting);
+
+    return TEST_RESULT();
+}
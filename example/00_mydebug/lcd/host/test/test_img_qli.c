@@ -0,0 +1,248 @@
+/**
+ * @file test_img_qli.c
+ * Tests of the line indexed compressed images (lv_img_qli): coding, random access to the lines and drawing
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+#include "RGB565_480x272.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PHOTO_W     480
+#define PHOTO_H     272
+#define CROP_SIZE   64
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool encode(const uint16_t * px, lv_coord_t w, lv_coord_t h, lv_img_dsc_t * dsc);
+static bool line_equal(const lv_img_dsc_t * dsc, const uint16_t * px, lv_coord_t x, lv_coord_t y, lv_coord_t len);
+static void refr_full(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_img_dsc_t photo;
+static uint32_t img_mem[LV_PORT_HOST_IMG_CACHE_SIZE / sizeof(uint32_t)];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_photo(void)
+{
+    /*Every line of a real photo is decoded as it was*/
+    TEST_ASSERT(encode(RGB565_480x272, PHOTO_W, PHOTO_H, &photo));
+    TEST_ASSERT(photo.data_size < sizeof(RGB565_480x272));
+
+    lv_coord_t y;
+    uint32_t bad_cnt = 0;
+    for(y = 0; y < PHOTO_H; y++) {
+        if(!line_equal(&photo, RGB565_480x272, 0, y, PHOTO_W)) bad_cnt++;
+    }
+    TEST_ASSERT_EQUAL(0, bad_cnt);
+}
+
+static void test_random_access(void)
+{
+    /*Parts of the lines in random order*/
+    uint32_t i;
+    uint32_t bad_cnt = 0;
+    srand(14);
+    for(i = 0; i < 1000; i++) {
+        lv_coord_t y   = rand() % PHOTO_H;
+        lv_coord_t x   = rand() % PHOTO_W;
+        lv_coord_t len = 1 + rand() % (PHOTO_W - x);
+        if(!line_equal(&photo, RGB565_480x272, x, y, len)) bad_cnt++;
+    }
+    TEST_ASSERT_EQUAL(0, bad_cnt);
+
+    /*Only the requested line is read*/
+    lv_img_qli_stat_t stat;
+    lv_img_qli_reset_stat();
+    TEST_ASSERT(line_equal(&photo, RGB565_480x272, 0, PHOTO_H - 1, PHOTO_W));
+    lv_img_qli_get_stat(&stat);
+    TEST_ASSERT_EQUAL(1, stat.line_cnt);
+    TEST_ASSERT(stat.src_size < photo.data_size / PHOTO_H * 4);
+}
+
+static void test_runs(void)
+{
+    /*Runs longer than a code, broken by single pixels and cut by the decoded part*/
+    static uint16_t px[2][300];
+    lv_coord_t x;
+    for(x = 0; x < 300; x++) {
+        px[0][x] = x % 100 == 99 ? 0xF800 : 0x07E0;
+        px[1][x] = 0;
+    }
+
+    lv_img_dsc_t dsc;
+    TEST_ASSERT(encode(&px[0][0], 300, 2, &dsc));
+    TEST_ASSERT(dsc.data_size < LV_IMG_QLI_TABLE_SIZE(2) + 30);
+    TEST_ASSERT(line_equal(&dsc, &px[0][0], 0, 0, 300));
+    TEST_ASSERT(line_equal(&dsc, &px[0][0], 70, 0, 150));
+    TEST_ASSERT(line_equal(&dsc, &px[0][0], 99, 0, 1));
+    TEST_ASSERT(line_equal(&dsc, &px[0][0], 0, 1, 300));
+
+    free((void *)dsc.data);
+}
+
+static void test_invalid(void)
+{
+    lv_color_t buf[PHOTO_W];
+    lv_img_dsc_t dsc = photo;
+
+    /*Out of the image*/
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_qli_read_line(&dsc, 0, PHOTO_H, 1, buf));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_qli_read_line(&dsc, PHOTO_W - 1, 0, 2, buf));
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_qli_read_line(&dsc, -1, 0, 1, buf));
+
+    /*Truncated data: the last line is missing*/
+    dsc.data_size -= 1;
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_qli_read_line(&dsc, 0, PHOTO_H - 1, PHOTO_W, buf));
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_qli_read_line(&dsc, 0, 0, PHOTO_W, buf));
+
+    /*Too small buffer of the coder*/
+    uint8_t out[64];
+    TEST_ASSERT_EQUAL(0, lv_img_qli_encode(RGB565_480x272, PHOTO_W, PHOTO_H, out, sizeof(out)));
+}
+
+static void test_blob(void)
+{
+    /*A blob as stored in the QSPI flash*/
+    uint32_t blob_size = LV_IMG_QLI_BLOB_HEADER_SIZE + photo.data_size;
+    uint8_t * blob = malloc(blob_size);
+    memcpy(blob, &photo.header, sizeof(lv_img_header_t));
+    blob[4] = (uint8_t)photo.data_size;
+    blob[5] = (uint8_t)(photo.data_size >> 8);
+    blob[6] = (uint8_t)(photo.data_size >> 16);
+    blob[7] = (uint8_t)(photo.data_size >> 24);
+    memcpy(&blob[LV_IMG_QLI_BLOB_HEADER_SIZE], photo.data, photo.data_size);
+
+    lv_img_dsc_t dsc;
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_img_qli_parse_blob(blob, &dsc));
+    TEST_ASSERT_EQUAL(PHOTO_W, dsc.header.w);
+    TEST_ASSERT_EQUAL(PHOTO_H, dsc.header.h);
+    TEST_ASSERT_EQUAL(photo.data_size, dsc.data_size);
+    TEST_ASSERT(line_equal(&dsc, RGB565_480x272, 0, PHOTO_H / 2, PHOTO_W));
+
+    /*An erased flash*/
+    memset(blob, 0xFF, LV_IMG_QLI_BLOB_HEADER_SIZE);
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_img_qli_parse_blob(blob, &dsc));
+
+    free(blob);
+}
+
+static void test_draw(void)
+{
+    /*A part of the photo as true color and as QLI image*/
+    static uint16_t crop[CROP_SIZE * CROP_SIZE];
+    lv_coord_t y;
+    for(y = 0; y < CROP_SIZE; y++) {
+        memcpy(&crop[y * CROP_SIZE], &RGB565_480x272[(y + 100) * PHOTO_W + 200], CROP_SIZE * sizeof(uint16_t));
+    }
+
+    lv_img_dsc_t true_color;
+    true_color.header.always_zero = 0;
+    true_color.header.w           = CROP_SIZE;
+    true_color.header.h           = CROP_SIZE;
+    true_color.header.cf          = LV_IMG_CF_TRUE_COLOR;
+    true_color.data_size          = sizeof(crop);
+    true_color.data               = (const uint8_t *)crop;
+
+    lv_img_dsc_t qli;
+    TEST_ASSERT(encode(crop, CROP_SIZE, CROP_SIZE, &qli));
+
+    lv_obj_t * img = lv_img_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_obj_set_pos(img, 10, 20);
+    lv_img_set_src(img, &true_color);
+    refr_full();
+    uint32_t crc = lv_port_host_get_fb_crc();
+
+    /*Line by line*/
+    lv_img_cache_set_mem(NULL, 0);
+    lv_img_qli_reset_stat();
+    lv_img_set_src(img, &qli);
+    refr_full();
+    TEST_ASSERT_EQUAL(crc, lv_port_host_get_fb_crc());
+
+    lv_img_qli_stat_t stat;
+    lv_img_qli_get_stat(&stat);
+    TEST_ASSERT_EQUAL(CROP_SIZE * CROP_SIZE, stat.px_cnt);
+
+    /*From a decoded surface: the lines are decoded only once*/
+    lv_img_cache_set_mem(img_mem, sizeof(img_mem));
+    refr_full();
+    lv_img_qli_reset_stat();
+    refr_full();
+    TEST_ASSERT_EQUAL(crc, lv_port_host_get_fb_crc());
+    lv_img_qli_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.line_cnt);
+
+    lv_obj_del(img);
+    lv_img_cache_invalidate_src(&qli);
+    free((void *)qli.data);
+}
+
+static bool encode(const uint16_t * px, lv_coord_t w, lv_coord_t h, lv_img_dsc_t * dsc)
+{
+    uint32_t max_size = LV_IMG_QLI_MAX_SIZE(w, h);
+    uint8_t * data = malloc(max_size);
+    if(data == NULL) return false;
+
+    dsc->header.always_zero = 0;
+    dsc->header.w           = w;
+    dsc->header.h           = h;
+    dsc->header.cf          = LV_IMG_CF_QLI;
+    dsc->data_size          = lv_img_qli_encode(px, w, h, data, max_size);
+    dsc->data               = data;
+
+    return dsc->data_size != 0;
+}
+
+static bool line_equal(const lv_img_dsc_t * dsc, const uint16_t * px, lv_coord_t x, lv_coord_t y, lv_coord_t len)
+{
+    lv_color_t buf[PHOTO_W];
+    if(lv_img_qli_read_line(dsc, x, y, len, buf) != LV_RES_OK) return false;
+
+    const uint16_t * line = &px[y * dsc->header.w + x];
+    lv_coord_t i;
+    for(i = 0; i < len; i++) {
+        if(buf[i].full != line[i]) return false;
+    }
+
+    return true;
+}
+
+static void refr_full(void)
+{
+    lv_obj_invalidate(lv_disp_get_scr_act(NULL));
+    lv_refr_now(NULL);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    TEST_RUN(test_photo);
+    TEST_RUN(test_random_access);
+    TEST_RUN(test_runs);
+    TEST_RUN(test_invalid);
+    TEST_RUN(test_blob);
+    TEST_RUN(test_draw);
+
+    free((void *)photo.data);
+
+    return TEST_RESULT();
+}
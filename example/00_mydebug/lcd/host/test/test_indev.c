@@ -0,0 +1,203 @@
+/**
+ * @file test_indev.c
+ * Tests of the pointer's hit-testing (lv_indev_search_obj) and its grid index
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define RND_OBJ_NUM     200
+#define RND_POINT_NUM   2000
+#define LIST_BTN_NUM    300
+
+/*The objects don't fit in the built-in pool on 64-bit: a second one like the board's SDRAM pool*/
+#define MEM_POOL_SIZE   (256U * 1024U)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_obj_t * ref_search(const lv_point_t * point, lv_obj_t * obj);
+static uint32_t cmp_search(uint32_t point_num);
+static void btn_event_cb(lv_obj_t * btn, lv_event_t event);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_obj_t * clicked;
+static uint32_t mem_pool[MEM_POOL_SIZE / sizeof(uint32_t)];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_same_as_linear_search(void)
+{
+    /*Overlapping objects in more levels, some hidden or not clickable*/
+    lv_obj_t * scr = lv_disp_get_scr_act(NULL);
+    lv_obj_t * objs[RND_OBJ_NUM];
+    uint32_t i;
+    srand(19);
+    for(i = 0; i < RND_OBJ_NUM; i++) {
+        lv_obj_t * par = (i < 20 || rand() % 2) ? scr : objs[rand() % i];
+        objs[i] = lv_obj_create(par, NULL);
+        lv_obj_set_pos(objs[i], rand() % LV_HOR_RES_MAX - 20, rand() % LV_VER_RES_MAX - 20);
+        lv_obj_set_size(objs[i], 1 + rand() % 120, 1 + rand() % 120);
+        if(rand() % 8 == 0) lv_obj_set_click(objs[i], false);
+        if(rand() % 16 == 0) lv_obj_set_hidden(objs[i], true);
+    }
+
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    /*Changed after indexing*/
+    for(i = 0; i < RND_OBJ_NUM; i += 7) lv_obj_set_pos(objs[i], rand() % LV_HOR_RES_MAX, rand() % LV_VER_RES_MAX);
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    for(i = 1; i < RND_OBJ_NUM; i += 7) lv_obj_set_size(objs[i], 1 + rand() % 200, 1 + rand() % 200);
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    for(i = 2; i < RND_OBJ_NUM; i += 5) lv_obj_set_hidden(objs[i], !lv_obj_get_hidden(objs[i]));
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    for(i = 3; i < RND_OBJ_NUM; i += 11) lv_obj_move_foreground(objs[i]);
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    /*A full screen object on the top*/
+    lv_obj_t * cover = lv_obj_create(scr, NULL);
+    lv_obj_set_size(cover, LV_HOR_RES_MAX, LV_VER_RES_MAX);
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+    lv_point_t p = {LV_HOR_RES_MAX / 2, LV_VER_RES_MAX / 2};
+    TEST_ASSERT(lv_indev_search_obj(NULL, &p) == cover);
+
+    lv_obj_del(cover);
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    lv_obj_clean(scr);
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+}
+
+static void test_long_list(void)
+{
+    lv_port_host_stat_t stat;
+    lv_obj_t * list = lv_list_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_obj_set_size(list, LV_HOR_RES_MAX / 2, LV_VER_RES_MAX);
+
+    uint32_t i;
+    char txt[16];
+    for(i = 0; i < LIST_BTN_NUM; i++) {
+        sprintf(txt, "Item %lu", (unsigned long)i);
+        lv_obj_t * btn = lv_list_add_btn(list, NULL, txt);
+        lv_obj_set_event_cb(btn, btn_event_cb);
+    }
+    lv_port_host_run(1);
+
+    /*Click a button: only a few objects are tested in the reads*/
+    lv_obj_t * btn = lv_list_get_next_btn(list, NULL);
+    btn            = lv_list_get_next_btn(list, btn);
+    lv_point_t p   = {btn->coords.x1 + 10, btn->coords.y1 + 5};
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    clicked = NULL;
+    lv_port_host_reset_stat();
+    lv_port_host_set_pointer(&p);
+    lv_port_host_run(5);
+    lv_port_host_set_pointer(NULL);
+    lv_port_host_run(2);
+    lv_port_host_get_stat(&stat);
+    TEST_ASSERT(clicked == btn);
+    TEST_ASSERT(stat.indev_read_cnt > 0);
+    TEST_ASSERT(stat.indev_obj_max < 20);
+
+    /*Scrolled: the index moves with the list*/
+    lv_list_focus(lv_list_get_prev_btn(list, NULL), LV_ANIM_OFF);
+    lv_port_host_run(1);
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    lv_port_host_reset_stat();
+    lv_port_host_set_pointer(&p);
+    lv_port_host_run(2);
+    lv_port_host_set_pointer(NULL);
+    lv_port_host_run(2);
+    lv_port_host_get_stat(&stat);
+    TEST_ASSERT(stat.indev_obj_max < 20);
+
+    /*Deleted buttons are not found*/
+    btn = lv_list_get_next_btn(list, NULL);
+    while(btn) {
+        lv_obj_t * next = lv_list_get_next_btn(list, btn);
+        if(rand() % 2) lv_obj_del(btn);
+        btn = next;
+    }
+    TEST_ASSERT_EQUAL(0, cmp_search(RND_POINT_NUM));
+
+    lv_obj_del(list);
+    lv_port_host_run(1);
+}
+
+/*The original recursive search*/
+static lv_obj_t * ref_search(const lv_point_t * point, lv_obj_t * obj)
+{
+    if(!lv_area_is_point_on(&obj->coords, point)) return NULL;
+
+    lv_obj_t * child;
+    LV_LL_READ(obj->child_ll, child)
+    {
+        lv_obj_t * found = ref_search(point, child);
+        if(found) return found;
+    }
+
+    if(lv_obj_get_click(obj) == false) return NULL;
+
+    lv_obj_t * i;
+    for(i = obj; i != NULL; i = lv_obj_get_parent(i)) {
+        if(lv_obj_get_hidden(i)) return NULL;
+    }
+
+    return obj;
+}
+
+/*Compare the search on random points with the original. Return the number of differences.*/
+static uint32_t cmp_search(uint32_t point_num)
+{
+    lv_disp_t * disp   = lv_disp_get_default();
+    uint32_t diff_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < point_num; i++) {
+        lv_point_t p = {rand() % LV_HOR_RES_MAX, rand() % LV_VER_RES_MAX};
+        lv_obj_t * ref = ref_search(&p, lv_disp_get_layer_sys(disp));
+        if(ref == NULL) ref = ref_search(&p, lv_disp_get_layer_top(disp));
+        if(ref == NULL) ref = ref_search(&p, lv_disp_get_scr_act(disp));
+
+        if(lv_indev_search_obj(disp, &p) != ref) diff_cnt++;
+    }
+
+    return diff_cnt;
+}
+
+static void btn_event_cb(lv_obj_t * btn, lv_event_t event)
+{
+    if(event == LV_EVENT_CLICKED) clicked = btn;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+    lv_mem_add_pool(mem_pool, sizeof(mem_pool));
+
+    TEST_RUN(test_same_as_linear_search);
+    TEST_RUN(test_long_list);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,235 @@
+/**
+ * @file test_inv.c
+ * Tests of the tile based invalidation (lv_inv_area) and its batches on the headless host port
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SCR_PX      ((uint32_t)LV_HOR_RES_MAX * LV_VER_RES_MAX)
+#define LED_NUM     60
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void refr(lv_port_host_stat_t * stat);
+static void inv(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_near_areas_are_joined(void)
+{
+    lv_port_host_stat_t stat;
+
+    /*A small gap is cheaper to redraw than to flush one more area*/
+    inv(0, 0, 3, 3);
+    inv(6, 0, 9, 3);
+    refr(&stat);
+
+    TEST_ASSERT_EQUAL(1, stat.flush_cnt);
+    TEST_ASSERT_EQUAL(10 * 4, stat.refr_px);
+}
+
+static void test_far_areas_are_not_joined(void)
+{
+    lv_port_host_stat_t stat;
+
+    inv(0, 0, 9, 9);
+    inv(LV_HOR_RES_MAX - 10, LV_VER_RES_MAX - 10, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+    refr(&stat);
+
+    TEST_ASSERT_EQUAL(2, stat.flush_cnt);
+    TEST_ASSERT_EQUAL(2 * 10 * 10, stat.refr_px);
+}
+
+static void test_many_areas_dont_redraw_the_screen(void)
+{
+    lv_port_host_stat_t stat;
+    lv_coord_t x;
+    lv_coord_t y;
+    uint32_t cnt = 0;
+
+    /*Far more areas than the old 32 element buffer could hold*/
+    for(y = 0; y < LV_VER_RES_MAX; y += 40) {
+        for(x = 0; x < LV_HOR_RES_MAX; x += 40) {
+            inv(x, y, x + 3, y + 3);
+            cnt++;
+        }
+    }
+    refr(&stat);
+
+    /*Neighbours in a row are joined but the rows are far from each other*/
+    TEST_ASSERT(cnt > 32);
+    TEST_ASSERT(stat.refr_px >= cnt * 4 * 4);
+    TEST_ASSERT(stat.refr_px < SCR_PX / 10);
+}
+
+static void test_pop_restores_clean_state(void)
+{
+    lv_port_host_stat_t stat;
+    lv_disp_t * disp = lv_disp_get_default();
+
+    inv(100, 100, 120, 120);
+    inv(200, 100, 220, 120);
+    TEST_ASSERT_EQUAL(2, lv_disp_get_inv_buf_size(disp));
+
+    lv_disp_pop_from_inv_buf(disp, 2);
+    TEST_ASSERT_EQUAL(0, lv_disp_get_inv_buf_size(disp));
+    refr(&stat);
+    TEST_ASSERT_EQUAL(0, stat.refr_cnt);
+
+    /*Areas invalidated before can't be separated on the tile map so they are kept*/
+    inv(100, 100, 120, 120);
+    inv(200, 100, 220, 120);
+    lv_disp_pop_from_inv_buf(disp, 1);
+    TEST_ASSERT_EQUAL(1, lv_disp_get_inv_buf_size(disp));
+    refr(&stat);
+    TEST_ASSERT_EQUAL(1, stat.refr_cnt);
+}
+
+static void test_batch(void)
+{
+    lv_port_host_stat_t stat;
+    lv_disp_t * disp = lv_disp_get_default();
+
+    /*Overlapping areas are joined, the far ones are kept separately until the end*/
+    lv_inv_batch_start();
+    inv(100, 100, 140, 140);
+    inv(104, 100, 144, 140);
+    lv_inv_batch_start();
+    inv(300, 200, 310, 210);
+    lv_inv_batch_end();
+    TEST_ASSERT_EQUAL(0, lv_disp_get_inv_buf_size(disp));
+    lv_inv_batch_end();
+    TEST_ASSERT_EQUAL(2, lv_disp_get_inv_buf_size(disp));
+
+    refr(&stat);
+    TEST_ASSERT_EQUAL(45 * 41 + 11 * 11, stat.refr_px);
+
+    /*Refreshed inside a batch: the collected areas are drawn*/
+    lv_inv_batch_start();
+    inv(0, 0, 9, 9);
+    refr(&stat);
+    lv_inv_batch_end();
+    TEST_ASSERT_EQUAL(10 * 10, stat.refr_px);
+    TEST_ASSERT_EQUAL(0, lv_disp_get_inv_buf_size(disp));
+}
+
+static void test_anim_moves_are_batched(void)
+{
+    lv_port_host_stat_t stat;
+    lv_obj_t * scr = lv_disp_get_scr_act(NULL);
+    lv_obj_t * obj = lv_obj_create(scr, NULL);
+    lv_obj_set_size(obj, 60, 60);
+    refr(&stat);
+
+    /*Moved by 2 animations in the same time: one area in every step*/
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_exec_cb(&a, obj, (lv_anim_exec_xcb_t)lv_obj_set_x);
+    lv_anim_set_time(&a, 300, 0);
+    lv_anim_set_values(&a, 0, 100);
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
+    lv_anim_create(&a);
+    lv_anim_set_exec_cb(&a, obj, (lv_anim_exec_xcb_t)lv_obj_set_y);
+    lv_anim_set_path_cb(&a, lv_anim_path_overshoot);
+    lv_anim_create(&a);
+
+    uint32_t bad_cnt = 0;
+    uint32_t t;
+    for(t = 0; t < 300; t += 30) {
+        lv_tick_inc(30);
+        lv_anim_refr_now();
+        if(lv_disp_get_inv_buf_size(lv_disp_get_default()) != 1) bad_cnt++;
+        refr(&stat);
+    }
+    TEST_ASSERT_EQUAL(0, bad_cnt);
+
+    /*The eased paths end exactly on the end value*/
+    TEST_ASSERT_EQUAL(0, lv_anim_count_running());
+    TEST_ASSERT_EQUAL(100, lv_obj_get_x(obj));
+    TEST_ASSERT_EQUAL(100, lv_obj_get_y(obj));
+
+    lv_obj_del(obj);
+    refr(&stat);
+}
+
+static void test_same_image_as_full_redraw(void)
+{
+    lv_port_host_stat_t stat;
+    lv_obj_t * scr = lv_disp_get_scr_act(NULL);
+    lv_obj_t * leds[LED_NUM];
+    uint32_t i;
+
+    for(i = 0; i < LED_NUM; i++) {
+        leds[i] = lv_led_create(scr, NULL);
+        lv_obj_set_size(leds[i], 20, 20);
+        lv_obj_set_pos(leds[i], (i % 12) * 40 + 7, (i / 12) * 60 + 13);
+    }
+    refr(&stat);
+
+    for(i = 0; i < LED_NUM; i += 3) lv_led_toggle(leds[i]);
+    refr(&stat);
+    uint32_t crc_partial = lv_port_host_get_fb_crc();
+
+    TEST_ASSERT(stat.refr_px < SCR_PX / 4);
+
+    lv_obj_invalidate(scr);
+    refr(&stat);
+    TEST_ASSERT_EQUAL(SCR_PX, stat.refr_px);
+    TEST_ASSERT_EQUAL(crc_partial, lv_port_host_get_fb_crc());
+
+    lv_obj_clean(scr);
+    refr(&stat);
+}
+
+/*Refresh now and get the counters of this refresh only*/
+static void refr(lv_port_host_stat_t * stat)
+{
+    lv_port_host_reset_stat();
+    lv_refr_now(NULL);
+    lv_port_host_get_stat(stat);
+}
+
+static void inv(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+    lv_area_t area;
+    lv_area_set(&area, x1, y1, x2, y2);
+    lv_inv_area(NULL, &area);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_stat_t stat;
+
+    lv_port_host_init();
+    refr(&stat);
+
+    TEST_RUN(test_near_areas_are_joined);
+    TEST_RUN(test_far_areas_are_not_joined);
+    TEST_RUN(test_many_areas_dont_redraw_the_screen);
+    TEST_RUN(test_pop_restores_clean_state);
+    TEST_RUN(test_batch);
+    TEST_RUN(test_anim_moves_are_batched);
+    TEST_RUN(test_same_image_as_full_redraw);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_mask_cache.c
+ * Tests of the least recently used mask cache (lv_mask_cache) on an instance of the test
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ENTRY_NUM   4
+#define CACHE_SIZE  1000
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint16_t id;
+    uint8_t type;
+} test_key_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static test_key_t key_make(uint16_t id, uint8_t type);
+static bool add(uint16_t id, uint32_t size);
+static bool cached(uint16_t id);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_mask_cache_entry_t entries[ENTRY_NUM];
+static test_key_t keys[ENTRY_NUM];
+static lv_mask_cache_t cache = {entries, keys, sizeof(test_key_t), ENTRY_NUM, CACHE_SIZE};
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_get_add(void)
+{
+    lv_mask_cache_stat_t stat;
+    lv_mask_cache_clear(&cache);
+    lv_mask_cache_reset_stat(&cache);
+
+    test_key_t k = key_make(1, 0);
+    TEST_ASSERT(lv_mask_cache_get(&cache, &k) == NULL);
+    uint8_t * data = lv_mask_cache_add(&cache, &k, 100);
+    TEST_ASSERT(data != NULL);
+    memset(data, 0xA5, 100);
+
+    /*Every field of the key counts*/
+    k = key_make(1, 1);
+    TEST_ASSERT(lv_mask_cache_get(&cache, &k) == NULL);
+    k = key_make(1, 0);
+    TEST_ASSERT(lv_mask_cache_get(&cache, &k) == data);
+    TEST_ASSERT_EQUAL(0xA5, data[99]);
+
+    lv_mask_cache_get_stat(&cache, &stat);
+    TEST_ASSERT_EQUAL(1, stat.hit_cnt);
+    TEST_ASSERT_EQUAL(2, stat.miss_cnt);
+    TEST_ASSERT_EQUAL(100, stat.used);
+    TEST_ASSERT_EQUAL(1, stat.entry_cnt);
+}
+
+static void test_lru_order(void)
+{
+    lv_mask_cache_stat_t stat;
+    lv_mask_cache_clear(&cache);
+    lv_mask_cache_reset_stat(&cache);
+
+    uint16_t id;
+    for(id = 0; id < ENTRY_NUM; id++) TEST_ASSERT(add(id, 10));
+
+    /*The oldest one is used again: the second oldest one is dropped for a new mask*/
+    TEST_ASSERT(cached(0));
+    TEST_ASSERT(add(ENTRY_NUM, 10));
+    TEST_ASSERT(cached(0));
+    TEST_ASSERT(cached(1) == false);
+    TEST_ASSERT(cached(2));
+
+    lv_mask_cache_get_stat(&cache, &stat);
+    TEST_ASSERT_EQUAL(1, stat.evict_cnt);
+    TEST_ASSERT_EQUAL(ENTRY_NUM, stat.entry_cnt);
+}
+
+static void test_budget(void)
+{
+    lv_mask_cache_stat_t stat;
+    lv_mask_cache_clear(&cache);
+    lv_mask_cache_reset_stat(&cache);
+
+    /*A mask larger than the half of the cache is not cached and doesn't drop the others*/
+    TEST_ASSERT(add(0, 300));
+    TEST_ASSERT(add(1, CACHE_SIZE / 2 + 1) == false);
+    TEST_ASSERT(add(2, 0) == false);
+    TEST_ASSERT(cached(0));
+
+    /*The least recently used masks are dropped until the new one fits*/
+    TEST_ASSERT(add(3, 300));
+    TEST_ASSERT(add(4, 500));
+    lv_mask_cache_get_stat(&cache, &stat);
+    TEST_ASSERT(cached(0) == false);
+    TEST_ASSERT(cached(3));
+    TEST_ASSERT(cached(4));
+    TEST_ASSERT_EQUAL(800, stat.used);
+    TEST_ASSERT_EQUAL(2, stat.entry_cnt);
+    TEST_ASSERT_EQUAL(1, stat.evict_cnt);
+}
+
+static void test_clear(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mask_cache_stat_t stat;
+    lv_mask_cache_clear(&cache);
+    lv_mem_monitor(&mon);
+    uint32_t free_size = mon.free_size;
+
+    uint16_t id;
+    for(id = 0; id < ENTRY_NUM; id++) TEST_ASSERT(add(id, 100 + id));
+
+    /*The masks are returned to lv_mem and the counters of the uses are kept*/
+    lv_mask_cache_reset_stat(&cache);
+    TEST_ASSERT(cached(0));
+    lv_mask_cache_clear(&cache);
+    lv_mask_cache_get_stat(&cache, &stat);
+    TEST_ASSERT_EQUAL(0, stat.used);
+    TEST_ASSERT_EQUAL(0, stat.entry_cnt);
+    TEST_ASSERT_EQUAL(0, stat.evict_cnt);
+    TEST_ASSERT_EQUAL(1, stat.hit_cnt);
+    TEST_ASSERT(cached(0) == false);
+
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(free_size, mon.free_size);
+}
+
+/*Make a key with cleared padding*/
+static test_key_t key_make(uint16_t id, uint8_t type)
+{
+    test_key_t k;
+    memset(&k, 0, sizeof(k));
+    k.id   = id;
+    k.type = type;
+    return k;
+}
+
+static bool add(uint16_t id, uint32_t size)
+{
+    test_key_t k = key_make(id, 0);
+    return lv_mask_cache_add(&cache, &k, size) != NULL;
+}
+
+static bool cached(uint16_t id)
+{
+    test_key_t k = key_make(id, 0);
+    return lv_mask_cache_get(&cache, &k) != NULL;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    TEST_RUN(test_get_add);
+    TEST_RUN(test_lru_order);
+    TEST_RUN(test_budget);
+    TEST_RUN(test_clear);
+
+    return TEST_RESULT();
+}
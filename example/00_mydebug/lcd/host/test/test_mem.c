@@ -0,0 +1,229 @@
+/**
+ * @file test_mem.c
+ * Tests of the built-in allocator (lv_mem): coalescing, reallocation in place, more pools and a random stress
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define STRESS_SLOTS    64
+#define STRESS_OPS      20000
+#define EXTRA_POOL_SIZE (64U * 1024U)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fill(void * p, uint32_t size, uint8_t seed);
+static bool check(const void * p, uint32_t size, uint8_t seed);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t extra_pool[EXTRA_POOL_SIZE / sizeof(uint32_t)];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_coalesce(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(1, mon.free_cnt);
+    TEST_ASSERT_EQUAL(0, mon.used_cnt);
+    TEST_ASSERT_EQUAL(0, mon.frag_pct);
+    uint32_t free_size = mon.free_size;
+
+    void * p[8];
+    uint32_t i;
+    for(i = 0; i < 8; i++) {
+        p[i] = lv_mem_alloc(100 + i * 10);
+        TEST_ASSERT(p[i] != NULL);
+        TEST_ASSERT(lv_mem_get_size(p[i]) >= 100 + i * 10);
+    }
+
+    /*Every second block is free: fragmented*/
+    for(i = 0; i < 8; i += 2) lv_mem_free(p[i]);
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(4, mon.used_cnt);
+    TEST_ASSERT_EQUAL(5, mon.free_cnt);
+    TEST_ASSERT(mon.frag_pct > 0);
+
+    /*Freeing the others joins everything to one block again*/
+    for(i = 1; i < 8; i += 2) lv_mem_free(p[i]);
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(1, mon.free_cnt);
+    TEST_ASSERT_EQUAL(free_size, mon.free_size);
+    TEST_ASSERT_EQUAL(0, mon.frag_pct);
+    TEST_ASSERT(mon.max_used > 8 * 100);
+}
+
+static void test_realloc(void)
+{
+    uint8_t * p = lv_mem_alloc(200);
+    fill(p, 200, 1);
+
+    /*Shrink and grow again in place: nothing is behind it*/
+    TEST_ASSERT(lv_mem_realloc(p, 64) == p);
+    TEST_ASSERT(check(p, 64, 1));
+    TEST_ASSERT(lv_mem_realloc(p, 400) == p);
+    TEST_ASSERT(check(p, 64, 1));
+    TEST_ASSERT(lv_mem_get_size(p) >= 400);
+
+    /*Blocked by an other allocation: moved with the content*/
+    uint8_t * q = lv_mem_alloc(16);
+    fill(p, 400, 2);
+    uint8_t * p2 = lv_mem_realloc(p, 800);
+    TEST_ASSERT(p2 != NULL && p2 != p);
+    TEST_ASSERT(check(p2, 400, 2));
+
+    /*NULL and 0 size*/
+    void * z = lv_mem_alloc(0);
+    TEST_ASSERT(z != NULL);
+    TEST_ASSERT_EQUAL(0, lv_mem_get_size(z));
+    lv_mem_free(z);
+    uint8_t * r = lv_mem_realloc(NULL, 32);
+    TEST_ASSERT(r != NULL);
+
+    lv_mem_free(r);
+    lv_mem_free(q);
+    lv_mem_free(p2);
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(1, mon.free_cnt);
+    TEST_ASSERT_EQUAL(0, mon.used_cnt);
+}
+
+static void test_pool(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    uint32_t total_size = mon.total_size;
+
+    /*Larger than the built-in pool*/
+    TEST_ASSERT(lv_mem_alloc(LV_MEM_SIZE) == NULL);
+
+    TEST_ASSERT_EQUAL(LV_RES_OK, lv_mem_add_pool(extra_pool, sizeof(extra_pool)));
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(total_size + sizeof(extra_pool), mon.total_size);
+    TEST_ASSERT_EQUAL(2, mon.free_cnt);
+
+    uint8_t * p = lv_mem_alloc(LV_MEM_SIZE);
+    TEST_ASSERT(p >= (uint8_t *)extra_pool && p < (uint8_t *)extra_pool + sizeof(extra_pool));
+    fill(p, LV_MEM_SIZE, 3);
+    TEST_ASSERT(check(p, LV_MEM_SIZE, 3));
+    lv_mem_free(p);
+
+    /*Too small region*/
+    static uint8_t tiny[8];
+    TEST_ASSERT_EQUAL(LV_RES_INV, lv_mem_add_pool(tiny, sizeof(tiny)));
+}
+
+static void test_stress(void)
+{
+    void * p[STRESS_SLOTS];
+    uint32_t size[STRESS_SLOTS];
+    memset(p, 0, sizeof(p));
+
+    uint32_t i;
+    uint32_t bad_cnt  = 0;
+    uint32_t fail_cnt = 0;
+    srand(15);
+    for(i = 0; i < STRESS_OPS; i++) {
+        uint32_t s = rand() % STRESS_SLOTS;
+        if(p[s] && !check(p[s], size[s], (uint8_t)s)) bad_cnt++;
+
+        uint32_t new_size = 1 + rand() % (rand() % 8 == 0 ? 4096 : 128);
+        switch(rand() % 3) {
+            case 0:
+                lv_mem_free(p[s]);
+                p[s] = NULL;
+                break;
+            case 1:
+                lv_mem_free(p[s]);
+                p[s] = lv_mem_alloc(new_size);
+                if(p[s] == NULL) fail_cnt++;
+                break;
+            default:
+                if(p[s] == NULL) break;
+                void * r = lv_mem_realloc(p[s], new_size);
+                if(r == NULL) break;
+                p[s] = r;
+                if(!check(p[s], LV_MATH_MIN(size[s], new_size), (uint8_t)s)) bad_cnt++;
+                break;
+        }
+
+        if(p[s]) {
+            size[s] = new_size;
+            fill(p[s], size[s], (uint8_t)s);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, bad_cnt);
+    TEST_ASSERT(fail_cnt < STRESS_OPS / 10);
+
+    for(i = 0; i < STRESS_SLOTS; i++) lv_mem_free(p[i]);
+
+    /*Both pools are one free block again*/
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(2, mon.free_cnt);
+    TEST_ASSERT_EQUAL(0, mon.used_cnt);
+}
+
+static void test_deinit(void)
+{
+    lv_mem_alloc(100);
+    lv_mem_deinit();
+
+    /*Only the built-in pool remains*/
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    TEST_ASSERT_EQUAL(LV_MEM_SIZE, mon.total_size);
+    TEST_ASSERT_EQUAL(1, mon.free_cnt);
+    TEST_ASSERT_EQUAL(0, mon.max_used);
+}
+
+static void fill(void * p, uint32_t size, uint8_t seed)
+{
+    uint8_t * d = p;
+    uint32_t i;
+    for(i = 0; i < size; i++) d[i] = (uint8_t)(seed + i);
+}
+
+static bool check(const void * p, uint32_t size, uint8_t seed)
+{
+    const uint8_t * d = p;
+    uint32_t i;
+    for(i = 0; i < size; i++) {
+        if(d[i] != (uint8_t)(seed + i)) return false;
+    }
+
+    return true;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    /*Only the allocator: nothing else is allocated from it*/
+    lv_mem_init();
+
+    TEST_RUN(test_coalesce);
+    TEST_RUN(test_realloc);
+    TEST_RUN(test_pool);
+    TEST_RUN(test_stress);
+    TEST_RUN(test_deinit);
+
+    return TEST_RESULT();
+}
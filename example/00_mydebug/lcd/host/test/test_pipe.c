@@ -0,0 +1,190 @@
+/**
+ * @file test_pipe.c
+ * Tests of the pipelined strip rendering (lv_port_pipe) with the flush engine on the simulated LCD and DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "flush_sim.h"
+#include "lcd_sim.h"
+#include "lvgl/porting/lv_port_pipe.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HOR_RES     LV_HOR_RES_MAX
+#define VER_RES     LV_VER_RES_MAX
+#define PX_NS       30
+#define MEM_SIZE    (64U * 1024U)
+#define FRAME_NUM   8
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool cost_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode);
+static void refr(lv_port_pipe_stat_t * stat);
+static uint32_t gram_crc(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_t * disp;
+static uint8_t strip_mem[MEM_SIZE];
+static lv_design_cb_t ancestor_design;
+static uint32_t render_ps;  /*Simulated rendering time of a pixel [ps]*/
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_buffers_from_memory(void)
+{
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+    lv_coord_t rows     = MEM_SIZE / 2 / sizeof(lv_color_t) / HOR_RES;
+
+    TEST_ASSERT_EQUAL(rows, lv_port_pipe_get_rows_max());
+    TEST_ASSERT((uint8_t *)vdb->buf1 == strip_mem);
+    TEST_ASSERT((uint8_t *)vdb->buf2 == strip_mem + rows * HOR_RES * sizeof(lv_color_t));
+    TEST_ASSERT(lv_disp_is_double_buf(disp));
+    TEST_ASSERT(lv_disp_is_true_double_buf(disp) == false);
+
+    /*The whole screen in strips of the max. height*/
+    lv_port_pipe_stat_t stat;
+    lv_port_flush_stat_t flush_stat;
+    lv_port_pipe_set_rows(rows);
+    lv_port_flush_reset_stat();
+    refr(&stat);
+    lv_port_flush_get_stat(&flush_stat);
+    TEST_ASSERT_EQUAL((VER_RES + rows - 1) / rows, flush_stat.flush_cnt);
+    TEST_ASSERT_EQUAL(rows, stat.rows);
+}
+
+static void test_balanced_costs_overlap(void)
+{
+    lv_port_pipe_stat_t stat;
+    uint32_t i;
+
+    /*Rendering a pixel costs as much as sending it: short strips*/
+    render_ps = PX_NS * 1000;
+    lv_port_pipe_set_rows(0);
+    for(i = 0; i < FRAME_NUM; i++) refr(&stat);
+
+    /*Both are about a full screen of pixels (up to the rounding of the us)*/
+    uint32_t render_us = (uint32_t)HOR_RES * VER_RES * PX_NS / 1000;
+    TEST_ASSERT(stat.rows < lv_port_pipe_get_rows_max() / 2);
+    TEST_ASSERT(stat.render_us >= render_us * 98 / 100);
+    TEST_ASSERT(stat.flush_us >= render_us * 98 / 100);
+    TEST_ASSERT(stat.overlap >= 80);
+    TEST_ASSERT(stat.frame_us < stat.render_us + stat.flush_us / 2);
+    TEST_ASSERT(stat.frame_us >= stat.render_us + stat.wait_us);
+}
+
+static void test_unbalanced_costs_use_tall_strips(void)
+{
+    lv_port_pipe_stat_t stat;
+    uint32_t i;
+
+    /*Cheap rendering: the sending dominates*/
+    render_ps = PX_NS * 100;
+    lv_port_pipe_set_rows(0);
+    for(i = 0; i < FRAME_NUM; i++) refr(&stat);
+
+    TEST_ASSERT(stat.rows > lv_port_pipe_get_rows_max() * 3 / 4);
+    TEST_ASSERT(stat.flush_us > 5 * stat.render_us);
+    TEST_ASSERT(stat.wait_us > stat.render_us);
+
+    /*The frame isn't shorter than the sending*/
+    TEST_ASSERT(stat.frame_us >= stat.flush_us);
+}
+
+static void test_same_image_with_any_height(void)
+{
+    lv_port_pipe_stat_t stat;
+    lv_obj_t * scr = lv_disp_get_scr_act(disp);
+    uint32_t i;
+
+    render_ps = 0;
+    for(i = 0; i < 12; i++) {
+        lv_obj_t * btn = lv_btn_create(scr, NULL);
+        lv_obj_set_pos(btn, (i % 4) * 115 + 10, (i / 4) * 100 + 15);
+        lv_obj_t * label = lv_label_create(btn, NULL);
+        lv_label_set_text(label, "Pipe");
+    }
+
+    lv_port_pipe_set_rows(lv_port_pipe_get_rows_max());
+    refr(&stat);
+    uint32_t crc_tall = gram_crc();
+
+    lv_port_pipe_set_rows(LV_PORT_PIPE_ROWS_MIN);
+    refr(&stat);
+    TEST_ASSERT_EQUAL(LV_PORT_PIPE_ROWS_MIN, stat.rows);
+    TEST_ASSERT_EQUAL(crc_tall, gram_crc());
+
+    lv_port_pipe_set_rows(0);
+    lv_obj_clean(scr);
+}
+
+/*Let the simulated time pass while the object is drawn*/
+static bool cost_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    if(mode == LV_DESIGN_DRAW_MAIN) {
+        flush_sim_wait_us((uint32_t)((uint64_t)lv_area_get_size(mask) * render_ps / 1000000));
+    }
+
+    return ancestor_design(obj, mask, mode);
+}
+
+/*Redraw the screen and wait for the last strip*/
+static void refr(lv_port_pipe_stat_t * stat)
+{
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    lv_refr_now(disp);
+    while(lv_port_flush_is_busy()) flush_sim_wait_us(1);
+
+    lv_port_pipe_get_stat(stat);
+}
+
+static uint32_t gram_crc(void)
+{
+    const uint16_t * gram = lcd_sim_get_gram();
+    uint32_t crc = 0;
+    uint32_t i;
+    for(i = 0; i < LCD_SIM_HOR_RES * VER_RES; i++) crc = crc * 31 + gram[i];
+
+    return crc;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_init();
+    flush_sim_init();
+    flush_sim_set_timing(PX_NS);
+
+    static lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res  = HOR_RES;
+    disp_drv.ver_res  = VER_RES;
+    disp_drv.flush_cb = lv_port_flush_cb;
+    lv_port_pipe_init(&disp_drv, strip_mem, sizeof(strip_mem), lcd_sim_get_time_us);
+    disp = lv_disp_drv_register(&disp_drv);
+
+    /*The screen's drawing has the simulated cost*/
+    lv_obj_t * scr  = lv_disp_get_scr_act(disp);
+    ancestor_design = lv_obj_get_design_cb(scr);
+    lv_obj_set_design_cb(scr, cost_design);
+
+    TEST_RUN(test_buffers_from_memory);
+    TEST_RUN(test_balanced_costs_overlap);
+    TEST_RUN(test_unbalanced_costs_use_tall_strips);
+    TEST_RUN(test_same_image_with_any_height);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,143 @@
+/**
+ * @file test_shadow_cache.c
+ * Tests of the cache of the shadow masks (lv_shadow_cache) and the shadows drawn from it
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "mask_cache_test.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TILE    23
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_obj_t * shadow_obj_create(lv_style_t * style, lv_coord_t w, lv_coord_t h, lv_coord_t radius,
+                                    lv_coord_t swidth, lv_shadow_type_t type);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_style_t styles[4];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_redraw_hits(void)
+{
+    lv_obj_t * obj1 = shadow_obj_create(&styles[0], 100, 60, 10, 12, LV_SHADOW_FULL);
+    lv_obj_t * obj2 = lv_obj_create(lv_disp_get_scr_act(NULL), obj1);
+    lv_obj_set_pos(obj2, 20, 20);
+
+    /*The two shadows are drawn from the same mask*/
+    check_redraw_hits(&lv_shadow_cache, 1);
+
+    lv_obj_del(obj1);
+    lv_obj_del(obj2);
+}
+
+static void test_clipped_corners_same_image(void)
+{
+    static const lv_shadow_type_t types[] = {LV_SHADOW_FULL, LV_SHADOW_BOTTOM};
+    uint32_t t;
+    for(t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        lv_obj_t * obj = shadow_obj_create(&styles[1], 120, 80, 20, 15, types[t]);
+        refr_full();
+        uint32_t crc = lv_port_host_get_fb_crc();
+
+        refr_tiles(TILE);
+        TEST_ASSERT_EQUAL(crc, lv_port_host_get_fb_crc());
+        lv_obj_del(obj);
+    }
+}
+
+static void test_mirrored_corners(void)
+{
+    /*The corners of a centered object are the mirrors of each other*/
+    lv_obj_t * obj = shadow_obj_create(&styles[2], 150, 100, 25, 20, LV_SHADOW_FULL);
+    refr_full();
+    TEST_ASSERT(is_mirrored(true));
+    TEST_ASSERT(is_mirrored(false));
+    lv_obj_del(obj);
+
+    obj = shadow_obj_create(&styles[2], 150, 100, 25, 20, LV_SHADOW_BOTTOM);
+    refr_full();
+    TEST_ASSERT(is_mirrored(true));
+    lv_obj_del(obj);
+}
+
+static void test_budget(void)
+{
+    lv_obj_t * obj = shadow_obj_create(&styles[3], 100, 100, 0, 10, LV_SHADOW_FULL);
+
+    /*Every radius needs an other mask*/
+    lv_coord_t radii[2 * LV_SHADOW_CACHE_ENTRY_NUM];
+    uint32_t i;
+    for(i = 0; i < sizeof(radii) / sizeof(radii[0]); i++) radii[i] = i * 2;
+    check_budget(&lv_shadow_cache, obj, &styles[3], radii, sizeof(radii) / sizeof(radii[0]));
+
+    lv_obj_del(obj);
+}
+
+static void test_fallback(void)
+{
+    lv_mask_cache_stat_t stat;
+
+    /*The mask of a too wide shadow is not cached*/
+    lv_mask_cache_clear(&lv_shadow_cache);
+    lv_obj_t * obj = shadow_obj_create(&styles[0], 200, 200, 60, 60, LV_SHADOW_FULL);
+    refr_full();
+    lv_mask_cache_get_stat(&lv_shadow_cache, &stat);
+    TEST_ASSERT_EQUAL(0, stat.entry_cnt);
+    lv_obj_del(obj);
+
+    /*The anti-aliased corners of a 1 px wide object overlap and are drawn without the cache*/
+    lv_mask_cache_reset_stat(&lv_shadow_cache);
+    obj = shadow_obj_create(&styles[0], 1, 50, 0, 5, LV_SHADOW_FULL);
+    refr_full();
+    lv_mask_cache_get_stat(&lv_shadow_cache, &stat);
+    TEST_ASSERT_EQUAL(0, stat.hit_cnt + stat.miss_cnt);
+    lv_obj_del(obj);
+}
+
+/*Create a centered object with a shadow*/
+static lv_obj_t * shadow_obj_create(lv_style_t * style, lv_coord_t w, lv_coord_t h, lv_coord_t radius,
+                                    lv_coord_t swidth, lv_shadow_type_t type)
+{
+    lv_style_copy(style, &lv_style_plain);
+    style->body.main_color   = LV_COLOR_WHITE;
+    style->body.grad_color   = LV_COLOR_WHITE;
+    style->body.radius       = radius;
+    style->body.shadow.width = swidth;
+    style->body.shadow.type  = type;
+    style->body.shadow.color = LV_COLOR_NAVY;
+
+    lv_obj_t * obj = lv_obj_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_obj_set_style(obj, style);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_align(obj, NULL, LV_ALIGN_CENTER, 0, 0);
+
+    return obj;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    TEST_RUN(test_redraw_hits);
+    TEST_RUN(test_clipped_corners_same_image);
+    TEST_RUN(test_mirrored_corners);
+    TEST_RUN(test_budget);
+    TEST_RUN(test_fallback);
+
+    return TEST_RESULT();
+}
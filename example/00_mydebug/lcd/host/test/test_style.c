@@ -0,0 +1,186 @@
+/**
+ * @file test_style.c
+ * Tests of the style inheritance (lv_obj_get_style) with the cached inherited styles
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define RND_OBJ_NUM     120
+#define RND_STEP_NUM    400
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const lv_style_t * ref_get_style(const lv_obj_t * obj);
+static uint32_t cmp_style(lv_obj_t ** objs, uint32_t obj_num);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_style_t style_glass;
+static lv_style_t style_a;
+static lv_style_t style_b;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_inherit(void)
+{
+    lv_obj_t * scr  = lv_disp_get_scr_act(NULL);
+    lv_obj_t * par  = lv_obj_create(scr, NULL);
+    lv_obj_t * mid  = lv_obj_create(par, NULL);
+    lv_obj_t * leaf = lv_label_create(mid, NULL);
+    lv_obj_set_style(par, &style_a);
+    lv_obj_set_style(mid, &style_glass);
+
+    /*Through the glass parent*/
+    TEST_ASSERT(lv_obj_get_style(leaf) == &style_a);
+    TEST_ASSERT(lv_obj_get_style(leaf) == &style_a);
+
+    lv_obj_set_style(par, &style_b);
+    TEST_ASSERT(lv_obj_get_style(leaf) == &style_b);
+
+    /*Not glass anymore: reported as modified*/
+    style_glass.glass = 0;
+    lv_obj_report_style_mod(&style_glass);
+    TEST_ASSERT(lv_obj_get_style(leaf) == &style_glass);
+    style_glass.glass = 1;
+    lv_obj_report_style_mod(&style_glass);
+    TEST_ASSERT(lv_obj_get_style(leaf) == &style_b);
+
+    /*New parent*/
+    lv_obj_t * other = lv_obj_create(scr, NULL);
+    lv_obj_set_style(other, &style_a);
+    lv_obj_set_parent(leaf, other);
+    TEST_ASSERT(lv_obj_get_style(leaf) == &style_a);
+
+    /*Inherit from the screen*/
+    lv_obj_set_parent(leaf, scr);
+    TEST_ASSERT(lv_obj_get_style(leaf) == lv_obj_get_style(scr));
+
+    lv_obj_clean(scr);
+}
+
+static void test_focused_parent(void)
+{
+    lv_obj_t * scr  = lv_disp_get_scr_act(NULL);
+    lv_obj_t * btn1 = lv_btn_create(scr, NULL);
+    lv_obj_t * btn2 = lv_btn_create(scr, NULL);
+    lv_obj_t * label = lv_label_create(btn2, NULL);
+    lv_btn_set_style(btn2, LV_BTN_STYLE_REL, &style_a);
+
+    TEST_ASSERT(lv_obj_get_style(label) == &style_a);
+
+    /*Added to a group later: the focused style is used*/
+    lv_group_t * g = lv_group_create();
+    lv_group_add_obj(g, btn1);
+    lv_group_add_obj(g, btn2);
+    TEST_ASSERT(lv_obj_get_style(label) == &style_a);
+
+    lv_group_focus_obj(btn2);
+    const lv_style_t * focused = lv_obj_get_style(label);
+    TEST_ASSERT(focused != &style_a);
+    TEST_ASSERT(focused->body.main_color.full != style_a.body.main_color.full ||
+                focused->body.border.color.full != style_a.body.border.color.full);
+
+    lv_group_focus_obj(btn1);
+    TEST_ASSERT(lv_obj_get_style(label) == &style_a);
+
+    lv_group_del(g);
+    lv_obj_clean(scr);
+}
+
+static void test_same_as_uncached(void)
+{
+    static const lv_style_t * styles[] = {NULL, &style_glass, &style_a, &style_b, &lv_style_transp};
+    lv_obj_t * scr = lv_disp_get_scr_act(NULL);
+    lv_obj_t * objs[RND_OBJ_NUM];
+    uint32_t i;
+    srand(20);
+    for(i = 0; i < RND_OBJ_NUM; i++) {
+        lv_obj_t * par = (i < 4 || rand() % 4 == 0) ? scr : objs[rand() % i];
+        objs[i] = lv_obj_create(par, NULL);
+        lv_obj_set_style(objs[i], styles[rand() % 5]);
+    }
+    TEST_ASSERT_EQUAL(0, cmp_style(objs, RND_OBJ_NUM));
+
+    /*Random changes and lookups in between*/
+    uint32_t bad_cnt = 0;
+    for(i = 0; i < RND_STEP_NUM; i++) {
+        lv_obj_t * obj = objs[rand() % RND_OBJ_NUM];
+        switch(rand() % 3) {
+            case 0:
+                lv_obj_set_style(obj, styles[rand() % 5]);
+                break;
+            case 1:
+                style_a.glass = rand() % 2;
+                lv_obj_report_style_mod(&style_a);
+                break;
+            default:
+                /*The first ones are always on the screen to not create a loop*/
+                obj = objs[4 + rand() % (RND_OBJ_NUM - 4)];
+                if(lv_obj_get_parent(obj) == scr) lv_obj_set_parent(obj, objs[rand() % 4]);
+                else lv_obj_set_parent(obj, scr);
+                break;
+        }
+        bad_cnt += cmp_style(objs, RND_OBJ_NUM);
+    }
+    TEST_ASSERT_EQUAL(0, bad_cnt);
+
+    style_a.glass = 0;
+    lv_obj_clean(scr);
+}
+
+/*The inheritance without the cache (no groups)*/
+static const lv_style_t * ref_get_style(const lv_obj_t * obj)
+{
+    if(obj->style_p) return obj->style_p;
+
+    const lv_obj_t * par;
+    for(par = obj->par; par != NULL; par = par->par) {
+        if(par->style_p && par->style_p->glass == 0) return par->style_p;
+    }
+
+    return &lv_style_plain;
+}
+
+/*Compare the style of every object with the uncached one. Return the number of differences.*/
+static uint32_t cmp_style(lv_obj_t ** objs, uint32_t obj_num)
+{
+    uint32_t diff_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < obj_num; i++) {
+        if(lv_obj_get_style(objs[i]) != ref_get_style(objs[i])) diff_cnt++;
+    }
+
+    return diff_cnt;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    lv_style_copy(&style_glass, &lv_style_transp);
+    lv_style_copy(&style_a, &lv_style_plain_color);
+    lv_style_copy(&style_b, &lv_style_pretty);
+
+    TEST_RUN(test_inherit);
+    TEST_RUN(test_focused_parent);
+    TEST_RUN(test_same_as_uncached);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,231 @@
+/**
+ * @file test_task.c
+ * Tests of the task scheduler (lv_task): order of the due tasks, time of the next run, periods and idle time
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+#include "lvgl/src/lv_misc/lv_gc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LOG_MAX         16
+#define PERIOD_TASKS    40
+#define PERIOD_TIME     1000
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void log_cb(lv_task_t * task);
+static void count_cb(lv_task_t * task);
+static void del_cb(lv_task_t * task);
+static void create_cb(lv_task_t * task);
+static void busy_cb(lv_task_t * task);
+static void del_all(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static char run_log[LOG_MAX + 1];
+static uint32_t run_cnt;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_order(void)
+{
+    /*The due tasks run from the highest priority, the newer first on equal priorities*/
+    lv_task_create(log_cb, 10, LV_TASK_PRIO_LOW, "l");
+    lv_task_create(log_cb, 10, LV_TASK_PRIO_HIGH, "h");
+    lv_task_create(log_cb, 10, LV_TASK_PRIO_MID, "a");
+    lv_task_create(log_cb, 10, LV_TASK_PRIO_MID, "b");
+    lv_task_t * off = lv_task_create(log_cb, 10, LV_TASK_PRIO_OFF, "o");
+
+    lv_tick_inc(9);
+    TEST_ASSERT_EQUAL(1, lv_task_handler());
+    TEST_ASSERT_EQUAL(0, strlen(run_log));
+
+    lv_tick_inc(1);
+    TEST_ASSERT_EQUAL(10, lv_task_handler());
+    TEST_ASSERT(strcmp(run_log, "hbal") == 0);
+
+    /*Turned on again*/
+    run_log[0] = '\0';
+    lv_task_set_prio(off, LV_TASK_PRIO_HIGHEST);
+    lv_tick_inc(10);
+    lv_task_handler();
+    TEST_ASSERT(strcmp(run_log, "ohbal") == 0);
+
+    del_all();
+}
+
+static void test_next_run(void)
+{
+    TEST_ASSERT_EQUAL(LV_NO_TASK_READY, lv_task_handler());
+
+    lv_task_t * task = lv_task_create(count_cb, 50, LV_TASK_PRIO_MID, NULL);
+    lv_task_create(count_cb, 5, LV_TASK_PRIO_OFF, NULL);
+    lv_tick_inc(20);
+    TEST_ASSERT_EQUAL(30, lv_task_handler());
+
+    lv_task_set_period(task, 30);
+    TEST_ASSERT_EQUAL(10, lv_task_get_next_run());
+    lv_task_reset(task);
+    TEST_ASSERT_EQUAL(30, lv_task_get_next_run());
+    lv_task_ready(task);
+    TEST_ASSERT_EQUAL(0, lv_task_get_next_run());
+
+    run_cnt = 0;
+    TEST_ASSERT_EQUAL(30, lv_task_handler());
+    TEST_ASSERT_EQUAL(1, run_cnt);
+
+    /*Suspended handling: nothing runs but the time is still reported*/
+    lv_task_enable(false);
+    lv_tick_inc(30);
+    TEST_ASSERT_EQUAL(0, lv_task_handler());
+    TEST_ASSERT_EQUAL(1, run_cnt);
+    lv_task_enable(true);
+
+    del_all();
+}
+
+static void test_create_del(void)
+{
+    /*One shot task*/
+    run_cnt = 0;
+    lv_task_t * once = lv_task_create(count_cb, 0, LV_TASK_PRIO_MID, NULL);
+    lv_task_once(once);
+    TEST_ASSERT_EQUAL(LV_NO_TASK_READY, lv_task_handler());
+    TEST_ASSERT_EQUAL(1, run_cnt);
+
+    /*Period 0: once in every call*/
+    lv_task_create(count_cb, 0, LV_TASK_PRIO_HIGHEST, NULL);
+    run_cnt = 0;
+    TEST_ASSERT_EQUAL(0, lv_task_handler());
+    TEST_ASSERT_EQUAL(1, run_cnt);
+    del_all();
+
+    /*A due task deleted by an other one doesn't run*/
+    lv_task_t * victim = lv_task_create(count_cb, 10, LV_TASK_PRIO_LOW, NULL);
+    lv_task_create(del_cb, 10, LV_TASK_PRIO_HIGH, victim);
+    run_cnt = 0;
+    lv_tick_inc(10);
+    lv_task_handler();
+    TEST_ASSERT_EQUAL(0, run_cnt);
+    del_all();
+
+    /*A created task which is due runs in the same call*/
+    lv_task_create(create_cb, 10, LV_TASK_PRIO_MID, NULL);
+    run_cnt = 0;
+    lv_tick_inc(10);
+    lv_task_handler();
+    TEST_ASSERT_EQUAL(1, run_cnt);
+    del_all();
+}
+
+static void test_periods(void)
+{
+    /*Every task runs according to its period in 1 ms steps*/
+    static uint32_t cnt[PERIOD_TASKS];
+    memset(cnt, 0, sizeof(cnt));
+
+    uint32_t i;
+    srand(17);
+    for(i = 0; i < PERIOD_TASKS; i++) {
+        lv_task_create(count_cb, 1 + rand() % 50, 1 + rand() % (_LV_TASK_PRIO_NUM - 1), &cnt[i]);
+    }
+
+    for(i = 0; i < PERIOD_TIME; i++) {
+        lv_tick_inc(1);
+        lv_task_handler();
+    }
+
+    uint32_t bad_cnt = 0;
+    lv_task_t * task;
+    LV_LL_READ(LV_GC_ROOT(_lv_task_ll), task) {
+        uint32_t * c = task->user_data;
+        if(*c != PERIOD_TIME / task->period) bad_cnt++;
+    }
+    TEST_ASSERT_EQUAL(0, bad_cnt);
+
+    del_all();
+}
+
+static void test_idle(void)
+{
+    /*5 ms work in every 20 ms and sleep until the next run*/
+    lv_task_create(busy_cb, 20, LV_TASK_PRIO_MID, NULL);
+
+    uint32_t t;
+    for(t = 0; t < 2000;) {
+        uint32_t wait = lv_task_handler();
+        TEST_ASSERT(wait <= 20);
+        lv_tick_inc(wait);
+        t += wait;
+    }
+
+    TEST_ASSERT_EQUAL(75, lv_task_get_idle());
+
+    del_all();
+}
+
+static void log_cb(lv_task_t * task)
+{
+    strncat(run_log, task->user_data, LOG_MAX - strlen(run_log));
+}
+
+static void count_cb(lv_task_t * task)
+{
+    if(task->user_data) (*(uint32_t *)task->user_data)++;
+    else run_cnt++;
+}
+
+static void del_cb(lv_task_t * task)
+{
+    lv_task_del(task->user_data);
+}
+
+static void create_cb(lv_task_t * task)
+{
+    lv_task_t * new_task = lv_task_create(count_cb, 0, LV_TASK_PRIO_LOWEST, NULL);
+    lv_task_once(new_task);
+}
+
+static void busy_cb(lv_task_t * task)
+{
+    lv_tick_inc(5);
+}
+
+static void del_all(void)
+{
+    lv_task_t * task;
+    while((task = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll))) != NULL) lv_task_del(task);
+
+    run_log[0] = '\0';
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    /*Only the tasks: the time is advanced by the tests*/
+    lv_mem_init();
+    lv_task_core_init();
+
+    TEST_RUN(test_order);
+    TEST_RUN(test_next_run);
+    TEST_RUN(test_create_del);
+    TEST_RUN(test_periods);
+    TEST_RUN(test_idle);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,256 @@
+/**
+ * @file test_te.c
+ * Tests of the TE (tearing effect) pacing of the flush engine on the scanning LCD model
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "host_test.h"
+#include "flush_sim.h"
+#include "lcd_sim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HOR_RES     LCD_SIM_HOR_RES
+#define VER_RES     LCD_SIM_VER_RES
+#define BUF_ROWS    10
+
+/*About 61 Hz: (800 + 16) rows in 16.32 ms*/
+#define LINE_NS     20000
+#define BLANK_LINES 16
+#define FRAME_US    ((VER_RES + BLANK_LINES) * LINE_NS / 1000)
+#define PX_NS       30
+
+#define FRAME_NUM   20
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void drv_init(bool te);
+static void refr(uint32_t render_us, uint16_t seed);
+static void wait_te(void);
+static void wait_flush(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_buf_t disp_buf;
+static lv_disp_drv_t disp_drv;
+static lv_color_t buf1[HOR_RES * BUF_ROWS];
+static lv_color_t buf2[HOR_RES * BUF_ROWS];
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_unpaced_strips_tear(void)
+{
+    lcd_sim_stat_t lcd_stat;
+    uint32_t i;
+
+    /*Refreshed by the task's period which is not in sync with the panel*/
+    drv_init(false);
+    for(i = 0; i < FRAME_NUM; i++) {
+        uint32_t start = lcd_sim_get_time_us();
+        refr(100, i);
+        flush_sim_wait_us(LV_DISP_DEF_REFR_PERIOD * 1000 - (lcd_sim_get_time_us() - start));
+    }
+
+    lcd_sim_get_stat(&lcd_stat);
+    TEST_ASSERT(lcd_stat.frame_cnt > FRAME_NUM);
+    TEST_ASSERT(lcd_stat.tear_cnt > 0);
+}
+
+static void test_paced_strips_dont_tear(void)
+{
+    lcd_sim_stat_t lcd_stat;
+    lv_port_flush_stat_t stat;
+    uint32_t i;
+
+    drv_init(true);
+    for(i = 0; i < FRAME_NUM; i++) {
+        wait_te();
+        refr(100, i);
+    }
+
+    lcd_sim_get_stat(&lcd_stat);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, lcd_stat.tear_cnt);
+    TEST_ASSERT_EQUAL(FRAME_NUM, stat.refr_cnt);
+    TEST_ASSERT(stat.te_cnt >= FRAME_NUM);
+    TEST_ASSERT_EQUAL(0, stat.miss_cnt);
+    TEST_ASSERT_EQUAL(0, stat.late_cnt);
+    TEST_ASSERT_EQUAL(FRAME_US, stat.te_period);
+
+    /*The strips are rendered faster than the panel scans, so they stay ahead of it without waiting*/
+    TEST_ASSERT_EQUAL(0, stat.wait_us);
+    TEST_ASSERT(stat.lat_us_max >= HOR_RES * BUF_ROWS * PX_NS / 1000);
+    TEST_ASSERT(stat.lat_us_sum >= stat.lat_us_max * (VER_RES / BUF_ROWS));
+}
+
+static void test_slow_render_waits_for_the_scan(void)
+{
+    lcd_sim_stat_t lcd_stat;
+    lv_port_flush_stat_t stat;
+    uint32_t i;
+
+    /*The scan overtakes the strips: they are sent behind it*/
+    drv_init(true);
+    for(i = 0; i < FRAME_NUM; i++) {
+        wait_te();
+        refr(240, i);
+    }
+
+    lcd_sim_get_stat(&lcd_stat);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, lcd_stat.tear_cnt);
+    TEST_ASSERT_EQUAL(0, stat.late_cnt);
+    TEST_ASSERT(stat.wait_us > 0);
+
+    /*A refresh is longer than 2 frames: vsyncs are missed but still no tearing*/
+    drv_init(true);
+    for(i = 0; i < FRAME_NUM / 4; i++) {
+        wait_te();
+        refr(500, i);
+    }
+
+    lcd_sim_get_stat(&lcd_stat);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, lcd_stat.tear_cnt);
+    TEST_ASSERT_EQUAL(0, stat.late_cnt);
+    TEST_ASSERT(stat.miss_cnt > 0);
+}
+
+static void test_lost_te_doesnt_block(void)
+{
+    lv_port_flush_stat_t stat;
+
+    drv_init(true);
+    wait_te();
+
+    /*No more pulses: the flushes are not paced*/
+    lcd_sim_scan_init(0, 0, NULL);
+    flush_sim_wait_us(3 * FRAME_US);
+    lv_port_flush_reset_stat();
+    refr(100, 0);
+
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(VER_RES / BUF_ROWS, stat.flush_cnt);
+    TEST_ASSERT_EQUAL(0, stat.wait_us);
+}
+
+static void test_te_noise_is_ignored(void)
+{
+    lv_port_flush_stat_t stat;
+    uint32_t i;
+
+    drv_init(true);
+
+    /*The pin picks up a burst of spikes instead of the pulses of the panel*/
+    lcd_sim_scan_init(0, 0, NULL);
+    flush_sim_wait_us(3 * FRAME_US);
+    lv_port_flush_reset_stat();
+    for(i = 0; i < FRAME_NUM; i++) {
+        flush_sim_wait_us(LV_PORT_FLUSH_TE_PERIOD_MIN / (2 * FRAME_NUM));
+        lv_port_flush_te_isr();
+    }
+
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(FRAME_NUM - 1, stat.te_noise_cnt);
+    TEST_ASSERT_EQUAL(0, stat.te_period);
+    TEST_ASSERT(lv_port_flush_te_pending() == false);
+
+    /*Pulses too far apart don't give a period either*/
+    for(i = 0; i < 3; i++) {
+        flush_sim_wait_us(LV_PORT_FLUSH_TE_PERIOD_MAX + 1000);
+        lv_port_flush_te_isr();
+    }
+
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.te_period);
+    TEST_ASSERT(lv_port_flush_te_pending() == false);
+
+    /*The flushes are not paced by the noise*/
+    refr(100, 0);
+    lv_port_flush_get_stat(&stat);
+    TEST_ASSERT_EQUAL(0, stat.wait_us);
+}
+
+static void drv_init(bool te)
+{
+    flush_sim_init();
+    flush_sim_set_timing(PX_NS);
+    lcd_sim_scan_init(LINE_NS, BLANK_LINES, te ? lv_port_flush_te_isr : NULL);
+
+    lv_disp_buf_init(&disp_buf, buf1, buf2, HOR_RES * BUF_ROWS);
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.buffer   = &disp_buf;
+    disp_drv.flush_cb = lv_port_flush_cb;
+
+    if(te) {
+        lv_port_flush_te_cfg_t cfg;
+        cfg.line_num    = VER_RES;
+        cfg.blank_lines = BLANK_LINES;
+        cfg.px_ns       = PX_NS;
+        cfg.refr_div    = 1;
+        lv_port_flush_te_init(NULL, &cfg);
+
+        /*The frame time is measured on the first pulses*/
+        wait_te();
+        wait_te();
+        lv_port_flush_reset_stat();
+        lcd_sim_reset_stat();
+    }
+}
+
+/*Draw the screen in strips like LVGL with 2 buffers: a strip is rendered while the previous one is sent*/
+static void refr(uint32_t render_us, uint16_t seed)
+{
+    lv_coord_t y;
+    for(y = 0; y < VER_RES; y += BUF_ROWS) {
+        lv_area_t area = {0, y, HOR_RES - 1, y + BUF_ROWS - 1};
+        lv_color_t * buf = (y / BUF_ROWS) % 2 ? buf2 : buf1;
+
+        flush_sim_wait_us(render_us);
+        wait_flush();
+
+        uint32_t i;
+        for(i = 0; i < HOR_RES * BUF_ROWS; i++) buf[i].full = (uint16_t)(i + seed * 7 + y);
+
+        disp_buf.flushing = 1;
+        lv_port_flush_cb(&disp_drv, &area, buf);
+    }
+
+    wait_flush();
+}
+
+/*Wait for a TE pulse and start the refresh like the main loop*/
+static void wait_te(void)
+{
+    while(lv_port_flush_te_pending() == false) flush_sim_wait_us(10);
+    lv_port_flush_te_handler();
+}
+
+static void wait_flush(void)
+{
+    while(lv_port_flush_is_busy()) flush_sim_wait_us(1);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    TEST_RUN(test_unpaced_strips_tear);
+    TEST_RUN(test_paced_strips_dont_tear);
+    TEST_RUN(test_slow_render_waits_for_the_scan);
+    TEST_RUN(test_lost_te_doesnt_block);
+    TEST_RUN(test_te_noise_is_ignored);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,215 @@
+/**
+ * @file test_txt_layout.c
+ * Tests of the cached line breaks of the texts (lv_txt_layout) and their use in lv_label
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "host_test.h"
+#include "lv_port_host.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FONT        (&lv_font_roboto_16)
+#define LETTER_SPACE 1
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool lines_match(lv_txt_layout_t * layout, const char * txt, lv_coord_t max_w, lv_txt_flag_t flag);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+LV_FONT_DECLARE(lv_font_roboto_16)
+
+static const char * txts[] = {
+    "",
+    "Short",
+    "Two\nlines",
+    "Trailing new line\n",
+    "A #ff0000 recolored# text which is long enough to be broken into more lines at the narrow widths.\n\n"
+    "Empty line above, then UTF-8: \xC3\xA1rv\xC3\xADzt\xC5\xB1r\xC5\x91 t\xC3\xBCk\xC3\xB6rf\xC3\xBAr\xC3\xB3g\xC3\xA9p",
+};
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void test_lines_match_lv_txt(void)
+{
+    static const lv_coord_t widths[] = {40, 100, 300, LV_COORD_MAX};
+    static const lv_txt_flag_t flags[] = {LV_TXT_FLAG_NONE, LV_TXT_FLAG_RECOLOR, LV_TXT_FLAG_EXPAND};
+    lv_txt_layout_t layout;
+    uint32_t ok  = 0;
+    uint32_t cnt = 0;
+    uint32_t t, w, f;
+
+    lv_txt_layout_init(&layout);
+    for(t = 0; t < sizeof(txts) / sizeof(txts[0]); t++) {
+        for(w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+            for(f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+                lv_txt_layout_set(&layout, txts[t], FONT, LETTER_SPACE, widths[w], flags[f]);
+                if(lines_match(&layout, txts[t], widths[w], flags[f])) ok++;
+
+                lv_point_t size_ref;
+                lv_point_t size;
+                lv_txt_get_size(&size_ref, txts[t], FONT, LETTER_SPACE, 3, widths[w], flags[f]);
+                lv_txt_layout_get_size(&layout, &size, 3);
+                if(size.x == size_ref.x && size.y == size_ref.y) ok++;
+                cnt += 2;
+            }
+        }
+    }
+    lv_txt_layout_free(&layout);
+
+    TEST_ASSERT_EQUAL(cnt, ok);
+}
+
+static void test_find_line(void)
+{
+    const char * txt = txts[4];
+    lv_txt_layout_t layout;
+    uint32_t start;
+    uint32_t end;
+    uint32_t line_id = 0;
+    uint32_t ok      = 0;
+    uint32_t i;
+
+    lv_txt_layout_init(&layout);
+    lv_txt_layout_set(&layout, txt, FONT, LETTER_SPACE, 100, LV_TXT_FLAG_RECOLOR);
+
+    for(i = 0; txt[i] != '\0'; i++) {
+        lv_txt_layout_get_line(&layout, line_id, &start, &end, NULL);
+        if(i == end) line_id++;
+        if(lv_txt_layout_find_line(&layout, i) == line_id) ok++;
+    }
+
+    TEST_ASSERT_EQUAL(strlen(txt), ok);
+    TEST_ASSERT_EQUAL(layout.line_cnt - 1, lv_txt_layout_find_line(&layout, strlen(txt)));
+
+    /*Only the lines before the changed one are kept*/
+    uint32_t line_cnt = layout.line_cnt;
+    lv_txt_layout_invalidate(&layout, txt, strlen(txt) - 1);
+    TEST_ASSERT_EQUAL(line_cnt - 2, layout.line_cnt);
+    lv_txt_layout_invalidate(&layout, txt, 0);
+    TEST_ASSERT_EQUAL(0, layout.line_cnt);
+
+    lv_txt_layout_free(&layout);
+}
+
+static void test_label_edit(void)
+{
+    static const char * ins[] = {"Lorem ipsum ", "dolor\nsit ", "amet, consectetur adipiscing elit ", "x"};
+    lv_obj_t * label = lv_label_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_BREAK);
+    lv_obj_set_width(label, 120);
+    lv_label_set_text(label, "");
+
+    uint32_t ok  = 0;
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < 40; i++) {
+        /*Insert and cut at the end, the start and in the middle*/
+        uint32_t len = lv_txt_get_encoded_length(ext->text);
+        uint32_t pos = (i % 3 == 0) ? len : (i % 3 == 1) ? 0 : len / 2;
+        if(i % 4 == 3 && len > 5) lv_label_cut_text(label, pos > 5 ? pos - 5 : pos, 5);
+        else lv_label_ins_text(label, pos, ins[i % 4]);
+
+        /*The kept lines and the new ones are the same as in a new layout*/
+        if(lines_match(&ext->layout, ext->text, 120, LV_TXT_FLAG_NONE)) ok++;
+
+        const lv_style_t * style = lv_obj_get_style(label);
+        lv_point_t size;
+        lv_txt_get_size(&size, ext->text, style->text.font, style->text.letter_space, style->text.line_space, 120,
+                        LV_TXT_FLAG_NONE);
+        if(size.y == lv_obj_get_height(label)) ok++;
+        cnt += 2;
+    }
+
+    TEST_ASSERT_EQUAL(cnt, ok);
+
+    lv_obj_del(label);
+}
+
+static void test_label_letter_pos(void)
+{
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain);
+    style.text.font = FONT;
+
+    lv_obj_t * label = lv_label_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_label_set_style(label, LV_LABEL_STYLE_MAIN, &style);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_BREAK);
+    lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
+    lv_obj_set_width(label, 150);
+    lv_label_set_text(label, "The letters of a centered text are found where they are drawn.\nNew line");
+
+    uint32_t ok  = 0;
+    uint32_t len = lv_txt_get_encoded_length(lv_label_get_text(label));
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        lv_point_t p;
+        lv_label_get_letter_pos(label, i, &p);
+        p.x += 1;
+        p.y += 1;
+        if(lv_label_get_letter_on(label, &p) == i) ok++;
+    }
+
+    TEST_ASSERT_EQUAL(len, ok);
+
+    /*The cursor after a trailing new line is in a new line*/
+    lv_point_t p_end;
+    lv_point_t p_nl;
+    lv_label_set_text(label, "Text\n");
+    lv_label_get_letter_pos(label, 5, &p_end);
+    lv_label_get_letter_pos(label, 4, &p_nl);
+    TEST_ASSERT(p_end.y > p_nl.y);
+
+    lv_obj_del(label);
+}
+
+/*Compare the lines of a layout to the lines found by `lv_txt_get_next_line`*/
+static bool lines_match(lv_txt_layout_t * layout, const char * txt, lv_coord_t max_w, lv_txt_flag_t flag)
+{
+    uint32_t line_start = 0;
+    uint32_t line_id    = 0;
+    uint32_t start;
+    uint32_t end;
+    lv_coord_t w;
+
+    if(flag & LV_TXT_FLAG_EXPAND) max_w = LV_COORD_MAX;
+
+    while(txt[line_start] != '\0') {
+        uint32_t len = lv_txt_get_next_line(&txt[line_start], layout->font, layout->letter_space, max_w, flag);
+        lv_coord_t w_ref = lv_txt_get_width(&txt[line_start], len, layout->font, layout->letter_space, flag);
+
+        if(lv_txt_layout_get_line(layout, line_id, &start, &end, &w) == false) return false;
+        if(start != line_start || end != line_start + len || w != w_ref) return false;
+
+        line_start += len;
+        line_id++;
+    }
+
+    return lv_txt_layout_get_line(layout, line_id, &start, &end, &w) == false;
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    lv_port_host_init();
+
+    TEST_RUN(test_lines_match_lv_txt);
+    TEST_RUN(test_find_line);
+    TEST_RUN(test_label_edit);
+    TEST_RUN(test_label_letter_pos);
+
+    return TEST_RESULT();
+}
@@ -96,7 +96,7 @@ extern "C"
 #define DDL_DAC_ENABLE                              (DDL_OFF)
 #define DDL_DCU_ENABLE                              (DDL_OFF)
 #define DDL_DMA_ENABLE                              (DDL_ON)
-#define DDL_DMC_ENABLE                              (DDL_OFF)
+#define DDL_DMC_ENABLE                              (DDL_ON)
 #define DDL_DVP_ENABLE                              (DDL_OFF)
 #define DDL_EFM_ENABLE                              (DDL_ON)
 #define DDL_EMB_ENABLE                              (DDL_OFF)
@@ -116,7 +116,7 @@ extern "C"
 #define DDL_NFC_ENABLE                              (DDL_OFF)
 #define DDL_OTS_ENABLE                              (DDL_OFF)
 #define DDL_PWC_ENABLE                              (DDL_ON)
-#define DDL_QSPI_ENABLE                             (DDL_OFF)
+#define DDL_QSPI_ENABLE                             (DDL_ON)
 #define DDL_RMU_ENABLE                              (DDL_OFF)
 #define DDL_RTC_ENABLE                              (DDL_OFF)
 #define DDL_SDIOC_ENABLE                            (DDL_OFF)
@@ -170,7 +170,7 @@ extern "C"
  * Select the components you need to use to BSP_ON.
  */
 #define BSP_GT9147_ENABLE                           (BSP_ON)
-#define BSP_IS42S16400J7TLI_ENABLE                  (BSP_OFF)
+#define BSP_IS42S16400J7TLI_ENABLE                  (BSP_ON)
 #define BSP_IS62WV51216_ENABLE                      (BSP_OFF)
 #define BSP_MT29F2G08AB_ENABLE                      (BSP_OFF)
 #define BSP_NT35510_ENABLE                          (BSP_ON)
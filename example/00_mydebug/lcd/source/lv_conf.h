@@ -19,11 +19,21 @@
    Graphical settings
  *====================*/
 
+/* Display configuration of the board (see lv_port_disp_template.c):
+ * 0: 480x320 GUI rendered in strips in the SRAMH, the camera video can be composed behind it (lv_port_comp)
+ * 1: 480x800 GUI in two frame buffers in the SDRAM (true double buffering, lv_port_fb), no camera video */
+#ifndef LV_PORT_DISP_SDRAM_FB
+#define LV_PORT_DISP_SDRAM_FB   0
+#endif
+
 /* Maximal horizontal and vertical resolution to support by the library.*/
-//#define LV_HOR_RES_MAX          (480)
-//#define LV_VER_RES_MAX          (800)
+#if LV_PORT_DISP_SDRAM_FB
+#define LV_HOR_RES_MAX          (480)
+#define LV_VER_RES_MAX          (800)
+#else
 #define LV_HOR_RES_MAX          (480)
 #define LV_VER_RES_MAX          (320)
+#endif
 
 /* Color depth:
  * - 1:  1 byte per pixel
@@ -55,6 +65,14 @@
  * Can be changed in the display driver (`lv_disp_drv_t`).*/
 #define LV_DISP_DEF_REFR_PERIOD      30      /*[ms]*/
 
+/* Invalidated areas are collected on a grid of tiles with this size [px] (max. 256).
+ * Smaller tiles give tighter areas but need more RAM in every display.*/
+#define LV_INV_TILE_SIZE             32
+
+/* Cost of flushing one more area (address window, DMA start) in pixels.
+ * Invalidated areas are joined if it redraws less pixels needlessly than this.*/
+#define LV_INV_JOIN_COST             256
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -83,8 +101,9 @@ typedef int16_t lv_coord_t;
  * Can be in external SRAM too. */
 #  define LV_MEM_ADR          0
 
-/* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
-#  define LV_MEM_AUTO_DEFRAG  1
+/* Number of memory regions: the built-in pool and the ones added by `lv_mem_add_pool`
+ * (e.g. a part of an external SDRAM). The free blocks are joined on free in every region. */
+#  define LV_MEM_POOL_MAX     4
 #else       /*LV_MEM_CUSTOM*/
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
 #  define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
@@ -124,6 +143,14 @@ typedef int16_t lv_coord_t;
  * Time between `LV_EVENT_LONG_PRESSED_REPEAT */
 #define LV_INDEV_DEF_LONG_PRESS_REP_TIME  100
 
+/* Index the children of the objects having at least this many children on a grid
+ * to find the pressed object quickly (e.g. long lists and tables). 0: disable*/
+#define LV_INDEV_HIT_MIN_CHILD    16
+#if LV_INDEV_HIT_MIN_CHILD
+/* Number of indexed objects. The index of the least recently used is dropped for a new one.*/
+#  define LV_INDEV_HIT_CACHE_NUM  4
+#endif
+
 /*==================
  * Feature usage
  *==================*/
@@ -139,6 +166,24 @@ typedef void * lv_anim_user_data_t;
 
 /* 1: Enable shadow drawing*/
 #define LV_USE_SHADOW           1
+#if LV_USE_SHADOW
+/* Size of the cache of the shadow masks in bytes (0: no caching).
+ * The corners of the same shadows are calculated only once and drawn from the cache.
+ * The masks are allocated with `lv_mem_alloc`.*/
+#  define LV_SHADOW_CACHE_SIZE      (4U * 1024U)
+
+/* Maximal number of cached masks*/
+#  define LV_SHADOW_CACHE_ENTRY_NUM 8
+#endif
+
+/* Size of the cache of the anti-aliased corner masks of the rounded rectangles in bytes (0: no caching).
+ * The corners of the bodies and borders are drawn with runs of fills instead of pixel by pixel.
+ * The masks are allocated with `lv_mem_alloc`.*/
+#define LV_CORNER_CACHE_SIZE      (2U * 1024U)
+#if LV_CORNER_CACHE_SIZE
+/* Maximal number of cached masks*/
+#  define LV_CORNER_CACHE_ENTRY_NUM 16
+#endif
 
 /* 1: Enable object groups (for keyboard/encoder navigation) */
 #define LV_USE_GROUP            1
@@ -147,7 +192,7 @@ typedef void * lv_group_user_data_t;
 #endif  /*LV_USE_GROUP*/
 
 /* 1: Enable GPU interface*/
-#define LV_USE_GPU              0
+#define LV_USE_GPU              1
 
 /* 1: Enable file system (might be required for images */
 #define LV_USE_FILESYSTEM       0
@@ -170,12 +215,18 @@ typedef void * lv_fs_drv_user_data_t;
 #define LV_IMG_CF_ALPHA         1
 
 /* Default image cache size. Image caching keeps the images opened.
- * If only the built-in image formats are used there is no real advantage of caching.
- * (I.e. no new image decoder is added)
+ * It's the number of the opened images (the slots of the cache), not a size in bytes.
+ * The byte budget of the decoded images is set only at run time by `lv_img_cache_set_mem(mem, size)`:
+ * the images which can't give all of their pixels at open (files, indexed and alpha images)
+ * are decoded once into that memory. Without it they are decoded line-by-line at every draw.
  * With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  * However the opened images might consume additional RAM.
  * LV_IMG_CACHE_DEF_SIZE must be >= 1 */
-#define LV_IMG_CACHE_DEF_SIZE       1
+#define LV_IMG_CACHE_DEF_SIZE       8
+
+/* 1: Enable the line indexed compressed images (`LV_IMG_CF_QLI`, see lv_img_qli.h).
+ * Their lines are decoded on demand so they can be drawn from a memory mapped (e.g. QSPI XIP) flash.*/
+#define LV_USE_IMG_QLI              1
 
 /*Declare the type of the user data of image decoder (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_img_decoder_user_data_t;
@@ -333,6 +384,30 @@ typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the i
  * but with > 10,000 characters if you see issues probably you need to enable it.*/
 #define LV_FONT_FMT_TXT_LARGE   0
 
+/* Number of fonts with a direct table of the glyph ids of the first 256 letters
+ * (ASCII and Latin-1) and of the last 8 other letters to skip the search in the cmaps (0: no tables).
+ * Every table takes ~600 bytes. The least recently used font's table is reused.*/
+#define LV_FONT_FMT_TXT_LUT_NUM     4
+
+/* Number of remembered kerning pairs of the fonts with sorted kern pairs (0: no memo).
+ * Must be a power of 2. Fonts with kern classes don't need it.*/
+#define LV_FONT_FMT_TXT_KERN_MEMO   256
+
+/* Size of the cache of decompressed glyph bitmaps in bytes (0: no cache).
+ * A letter of a compressed font is decompressed only once while its bitmap is in the cache.*/
+#define LV_FONT_CACHE_SIZE      (16U * 1024U)
+#if LV_FONT_CACHE_SIZE
+/* Maximal number of cached bitmaps*/
+#  define LV_FONT_CACHE_ENTRY_NUM   128
+
+/* Complier prefix for the cache array*/
+#  define LV_FONT_CACHE_ATTR
+
+/* Set an address for the cache instead of allocating it as an array.
+ * Can be in the external SDRAM too (e.g. 0x80000000 on the EXMC if it's initialized before `lv_init`). */
+#  define LV_FONT_CACHE_ADR         0
+#endif
+
 /* Set the pixel order of the display.
  * Important only if "subpx fonts" are used.
  * With "normal" font it doesn't matter.
@@ -402,6 +477,10 @@ typedef void * lv_obj_user_data_t;
 /*1: enable `lv_obj_realaign()` based on `lv_obj_align()` parameters*/
 #define LV_USE_OBJ_REALIGN          1
 
+/*1: cache the style inherited from the parents on the objects with NULL style.
+ * The cache is dropped when a style is set, refreshed or reported as modified*/
+#define LV_USE_OBJ_STYLE_CACHE      1
+
 /* Enable to make the object clickable on a larger area.
  * LV_EXT_CLICK_AREA_OFF or 0: Disable this feature
  * LV_EXT_CLICK_AREA_TINY: The extra area can be adjusted horizontally and vertically (0..255 px)
@@ -490,6 +569,10 @@ typedef void * lv_obj_user_data_t;
 
 /*Store extra some info in labels (12 bytes) to speed up drawing of very long texts*/
 #  define LV_LABEL_LONG_TXT_HINT          0
+
+/*Keep the line breaks and line widths of the labels (~8 bytes per line) to measure the text
+ * only when it changes and not on every draw, size, letter position and click*/
+#  define LV_LABEL_LAYOUT_CACHE           1
 #endif
 
 /*LED (dependencies: -)*/
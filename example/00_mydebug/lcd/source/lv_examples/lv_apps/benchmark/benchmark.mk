@@ -1,5 +1,6 @@
 CSRCS += benchmark.c
 CSRCS += benchmark_bg.c
+CSRCS += benchmark_suite.c
 
 DEPPATH += --dep-path $(LVGL_DIR)/lv_examples/lv_apps/benchmark
 VPATH += :$(LVGL_DIR)/lv_examples/lv_apps/benchmark
@@ -0,0 +1,732 @@
+/**
+ * @file benchmark_suite.c
+ * Non-interactive render benchmark: a catalogue of scenes measured frame by frame
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "benchmark_suite.h"
+#if LV_USE_BENCHMARK
+
+#include <stdio.h>
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PAD             (LV_DPI / 10)
+#define RECT_COL_NUM    4
+#define RECT_ROW_NUM    3
+#define SHADOW_WIDTH    (LV_DPI / 8)
+#define RADIUS          (LV_DPI / 6)
+#define OPACITY         LV_OPA_60
+#define GEN_IMG_SIZE    64
+#define CHART_POINT_NUM 40
+#define LED_COL_NUM     12
+#define LED_ROW_NUM     6
+#define TAB_BTN_NUM     24
+#define TAB_LIST_NUM    16
+#define TXT_LOOKUP_REPEAT   4
+#define ANIM_COL_NUM    8
+#define ANIM_ROW_NUM    4
+#define ANIM_TIME       900
+#define DEEP_COL_NUM    4
+#define DEEP_ROW_NUM    3
+#define DEEP_LEVEL_NUM  12
+#define DEEP_LABEL_NUM  4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const char * name;
+    void (*create_cb)(lv_obj_t * scr, const void * param);
+    void (*frame_cb)(uint32_t frame);   /*Modify the scene (measured as update time). NULL: invalidate the whole screen*/
+    const void * param;
+} scene_dsc_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void rect_grid_create(lv_obj_t * scr, const lv_style_t * style);
+static void fill_opa_create(lv_obj_t * scr, const void * param);
+static void fill_alpha_create(lv_obj_t * scr, const void * param);
+static void shadow_create(lv_obj_t * scr, const void * param);
+static void radius_create(lv_obj_t * scr, const void * param);
+static void font_create(lv_obj_t * scr, const void * param);
+static void img_create(lv_obj_t * scr, const void * param);
+static void img_alpha_create(lv_obj_t * scr, const void * param);
+static void chart_create(lv_obj_t * scr, const void * param);
+static void chart_frame(uint32_t frame);
+static void gauge_create(lv_obj_t * scr, const void * param);
+static void gauge_frame(uint32_t frame);
+static void ta_create(lv_obj_t * scr, const void * param);
+static void ta_frame(uint32_t frame);
+static void leds_create(lv_obj_t * scr, const void * param);
+static void leds_frame(uint32_t frame);
+static void txt_lookup_create(lv_obj_t * scr, const void * param);
+static void txt_lookup_frame(uint32_t frame);
+static void tabview_create(lv_obj_t * scr, const void * param);
+static void btnm_create(lv_obj_t * scr, const void * param);
+static void kb_create(lv_obj_t * scr, const void * param);
+static void anim_create(lv_obj_t * scr, const void * param);
+static void anim_frame(uint32_t frame);
+static void deep_create(lv_obj_t * scr, const void * param);
+static void gen_img_init(void);
+static uint32_t rnd_next(void);
+static void refr_monitor(lv_disp_drv_t * disp_drv, uint32_t time_ms, uint32_t px_num);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+LV_IMG_DECLARE(benchmark_bg)
+
+/*Not declared in lv_font.h*/
+#if LV_FONT_ROBOTO_12_SUBPX
+LV_FONT_DECLARE(lv_font_roboto_12_subpx)
+#endif
+#if LV_FONT_ROBOTO_28_COMPRESSED
+LV_FONT_DECLARE(lv_font_roboto_28_compressed)
+#endif
+
+static lv_img_dsc_t img_indexed;
+static lv_img_dsc_t img_alpha;
+static uint8_t img_indexed_map[16 * sizeof(lv_color32_t) + GEN_IMG_SIZE * GEN_IMG_SIZE / 2];
+static uint8_t img_alpha_map[GEN_IMG_SIZE * GEN_IMG_SIZE];
+static void (*monitor_ori)(lv_disp_drv_t *, uint32_t, uint32_t);
+
+static const scene_dsc_t scenes[] = {
+    {"fill_opa", fill_opa_create, NULL, NULL},
+    {"fill_alpha", fill_alpha_create, NULL, NULL},
+    {"shadow", shadow_create, NULL, NULL},
+    {"radius", radius_create, NULL, NULL},
+#if LV_FONT_ROBOTO_12
+    {"font_roboto_12", font_create, NULL, &lv_font_roboto_12},
+#endif
+#if LV_FONT_ROBOTO_16
+    {"font_roboto_16", font_create, NULL, &lv_font_roboto_16},
+#endif
+#if LV_FONT_ROBOTO_22
+    {"font_roboto_22", font_create, NULL, &lv_font_roboto_22},
+#endif
+#if LV_FONT_ROBOTO_28
+    {"font_roboto_28", font_create, NULL, &lv_font_roboto_28},
+#endif
+#if LV_FONT_ROBOTO_12_SUBPX
+    {"font_roboto_12_subpx", font_create, NULL, &lv_font_roboto_12_subpx},
+#endif
+#if LV_FONT_ROBOTO_28_COMPRESSED
+    {"font_roboto_28_compressed", font_create, NULL, &lv_font_roboto_28_compressed},
+#endif
+#if LV_FONT_UNSCII_8
+    {"font_unscii_8", font_create, NULL, &lv_font_unscii_8},
+#endif
+    {"img_true_color", img_create, NULL, &benchmark_bg},
+#if LV_IMG_CF_INDEXED
+    {"img_indexed", img_create, NULL, &img_indexed},
+#endif
+#if LV_IMG_CF_ALPHA
+    {"img_alpha", img_alpha_create, NULL, &img_alpha},
+#endif
+    {"chart", chart_create, chart_frame, NULL},
+    {"gauge", gauge_create, gauge_frame, NULL},
+    {"ta", ta_create, ta_frame, NULL},
+    {"leds", leds_create, leds_frame, NULL},
+    {"txt_lookup", txt_lookup_create, txt_lookup_frame, NULL},
+    {"tabview", tabview_create, NULL, NULL},
+    {"btnm", btnm_create, NULL, NULL},
+    {"kb", kb_create, NULL, NULL},
+    {"anim", anim_create, anim_frame, NULL},
+    {"deep", deep_create, NULL, NULL},
+};
+
+static const char font_txt[] =
+    "The quick brown fox jumps over the lazy dog. 0123456789\n"
+    "THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG. !?#%&()[]{}\n"
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt "
+    "ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco "
+    "laboris nisi ut aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in "
+    "voluptate velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint occaecat cupidatat "
+    "non proident, sunt in culpa qui officia deserunt mollit anim id est laborum.";
+
+static benchmark_suite_time_cb_t time_cb;
+static benchmark_suite_print_cb_t print_cb;
+static uint32_t last_px_num;
+static uint32_t rnd_seed;
+
+static lv_obj_t * chart;
+static lv_chart_series_t * chart_ser[2];
+static lv_obj_t * gauge;
+static lv_obj_t * ta;
+static lv_obj_t * leds[LED_ROW_NUM * LED_COL_NUM];
+static lv_obj_t * txt_label;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Set the callbacks of the benchmark suite
+ * @param time get a time stamp in microseconds
+ * @param print output of the CSV lines (NULL: don't print)
+ */
+void benchmark_suite_init(benchmark_suite_time_cb_t time, benchmark_suite_print_cb_t print)
+{
+    time_cb  = time;
+    print_cb = print;
+
+    gen_img_init();
+}
+
+/**
+ * Get the number of scenes
+ * @return number of scenes
+ */
+uint16_t benchmark_suite_get_scene_cnt(void)
+{
+    return sizeof(scenes) / sizeof(scenes[0]);
+}
+
+/**
+ * Get the name of a scene
+ * @param id index of the scene
+ * @return name of the scene or NULL if `id` is invalid
+ */
+const char * benchmark_suite_get_scene_name(uint16_t id)
+{
+    if(id >= benchmark_suite_get_scene_cnt()) return NULL;
+
+    return scenes[id].name;
+}
+
+/**
+ * Measure one scene: create it on a new screen, render `frame_num` frames and print a CSV line for each.
+ * The original screen is loaded again at the end.
+ * @param id index of the scene
+ * @param frame_num number of measured frames
+ * @param res store the summary here (can be NULL)
+ * @return LV_RES_OK: the scene was measured; LV_RES_INV: invalid `id`
+ */
+lv_res_t benchmark_suite_run_scene(uint16_t id, uint32_t frame_num, benchmark_suite_res_t * res)
+{
+    if(id >= benchmark_suite_get_scene_cnt()) return LV_RES_INV;
+
+    const scene_dsc_t * dsc = &scenes[id];
+    lv_disp_t * disp        = lv_disp_get_default();
+    lv_disp_buf_t * vdb     = lv_disp_get_buf(disp);
+    lv_obj_t * scr_ori      = lv_disp_get_scr_act(disp);
+    benchmark_suite_res_t r;
+    lv_mem_monitor_t mon;
+    lv_font_fmt_txt_stat_t font_stat;
+    char buf[128];
+
+    memset(&r, 0, sizeof(r));
+    r.name     = dsc->name;
+    r.time_min = UINT32_MAX;
+    rnd_seed   = 1;
+
+    lv_obj_t * scr = lv_obj_create(NULL, NULL);
+    lv_disp_load_scr(scr);
+    dsc->create_cb(scr, dsc->param);
+
+    /*The first frame renders the creation of the scene. Don't measure it.*/
+    lv_refr_now(disp);
+    while(vdb->flushing);
+
+    monitor_ori             = disp->driver.monitor_cb;
+    disp->driver.monitor_cb = refr_monitor;
+
+    uint32_t f;
+    for(f = 0; f < frame_num; f++) {
+        uint32_t t_update = time_cb ? time_cb() : 0;
+        if(dsc->frame_cb) dsc->frame_cb(f);
+        else lv_obj_invalidate(scr);
+        t_update = time_cb ? time_cb() - t_update : 0;
+
+        uint32_t inv_cnt = disp->inv_p;
+        last_px_num      = 0;
+        lv_font_fmt_txt_reset_stat();
+
+        uint32_t t_start = time_cb ? time_cb() : 0;
+        lv_refr_now(disp);
+        /*Count the flushing of the last strip too*/
+        while(vdb->flushing);
+        uint32_t t = time_cb ? time_cb() - t_start : 0;
+
+        lv_mem_monitor(&mon);
+        uint32_t mem_used = mon.total_size - mon.free_size;
+
+        /*Only the searches: the table and memo hits are the cheap part of the lookups*/
+        lv_font_fmt_txt_get_stat(&font_stat);
+        uint32_t search = font_stat.glyph_search_cnt + font_stat.kern_search_cnt;
+
+        r.frame_cnt++;
+        r.time_sum += t;
+        r.update_sum += t_update;
+        if(t < r.time_min) r.time_min = t;
+        if(t > r.time_max) r.time_max = t;
+        r.px_sum += last_px_num;
+        r.inv_sum += inv_cnt;
+        if(mem_used > r.mem_peak) r.mem_peak = mem_used;
+        r.search_sum += search;
+
+        if(print_cb) {
+            sprintf(buf, "%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu", dsc->name, (unsigned long)f, (unsigned long)t,
+                    (unsigned long)last_px_num, (unsigned long)inv_cnt, (unsigned long)mem_used,
+                    (unsigned long)r.mem_peak, (unsigned long)search, (unsigned long)t_update);
+            print_cb(buf);
+        }
+    }
+
+    if(r.frame_cnt == 0) r.time_min = 0;
+
+    disp->driver.monitor_cb = monitor_ori;
+    lv_disp_load_scr(scr_ori);
+    lv_obj_del(scr);
+
+    if(res) *res = r;
+
+    return LV_RES_OK;
+}
+
+/**
+ * Print the CSV header and measure all scenes
+ * @param frame_num number of measured frames in every scene
+ */
+void benchmark_suite_run(uint32_t frame_num)
+{
+    if(print_cb) print_cb(BENCHMARK_SUITE_CSV_HEADER);
+
+    uint16_t i;
+    for(i = 0; i < benchmark_suite_get_scene_cnt(); i++) {
+        benchmark_suite_run_scene(i, frame_num, NULL);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*--------------------
+ * SCENES
+ ---------------------*/
+
+static void rect_grid_create(lv_obj_t * scr, const lv_style_t * style)
+{
+    lv_coord_t w = (lv_obj_get_width(scr) - PAD) / RECT_COL_NUM;
+    lv_coord_t h = (lv_obj_get_height(scr) - PAD) / RECT_ROW_NUM;
+    uint32_t col, row;
+
+    for(row = 0; row < RECT_ROW_NUM; row++) {
+        for(col = 0; col < RECT_COL_NUM; col++) {
+            lv_obj_t * obj = lv_obj_create(scr, NULL);
+            lv_obj_set_style(obj, style);
+            lv_obj_set_size(obj, w - PAD, h - PAD);
+            lv_obj_set_pos(obj, PAD + col * w, PAD + row * h);
+        }
+    }
+}
+
+static void fill_opa_create(lv_obj_t * scr, const void * param)
+{
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain_color);
+
+    rect_grid_create(scr, &style);
+}
+
+static void fill_alpha_create(lv_obj_t * scr, const void * param)
+{
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain_color);
+    style.body.opa = OPACITY;
+
+    rect_grid_create(scr, &style);
+}
+
+static void shadow_create(lv_obj_t * scr, const void * param)
+{
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain_color);
+    style.body.shadow.width = SHADOW_WIDTH;
+    style.body.shadow.color = LV_COLOR_GRAY;
+
+    rect_grid_create(scr, &style);
+}
+
+static void radius_create(lv_obj_t * scr, const void * param)
+{
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain_color);
+    style.body.radius = RADIUS;
+
+    rect_grid_create(scr, &style);
+}
+
+static void font_create(lv_obj_t * scr, const void * param)
+{
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain);
+    style.text.font = param;
+
+    lv_obj_t * label = lv_label_create(scr, NULL);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_BREAK);
+    lv_obj_set_width(label, lv_obj_get_width(scr) - 2 * PAD);
+    lv_obj_set_pos(label, PAD, PAD);
+    lv_label_set_style(label, LV_LABEL_STYLE_MAIN, &style);
+    lv_label_set_static_text(label, font_txt);
+}
+
+/*Cover the screen with the image (tiled)*/
+static void img_create(lv_obj_t * scr, const void * param)
+{
+    lv_obj_t * img = lv_img_create(scr, NULL);
+    lv_img_set_src(img, param);
+    lv_img_set_auto_size(img, false);
+    lv_obj_set_size(img, lv_obj_get_width(scr), lv_obj_get_height(scr));
+}
+
+/*Alpha only images are drawn with the image color of the style*/
+static void img_alpha_create(lv_obj_t * scr, const void * param)
+{
+    static lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain);
+    style.image.color = LV_COLOR_BLUE;
+
+    img_create(scr, param);
+    lv_img_set_style(lv_obj_get_child(scr, NULL), LV_IMG_STYLE_MAIN, &style);
+}
+
+static void chart_create(lv_obj_t * scr, const void * param)
+{
+    chart = lv_chart_create(scr, NULL);
+    lv_obj_set_size(chart, lv_obj_get_width(scr) - 2 * PAD, lv_obj_get_height(scr) - 2 * PAD);
+    lv_obj_set_pos(chart, PAD, PAD);
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE | LV_CHART_TYPE_COLUMN);
+    lv_chart_set_point_count(chart, CHART_POINT_NUM);
+    chart_ser[0] = lv_chart_add_series(chart, LV_COLOR_RED);
+    chart_ser[1] = lv_chart_add_series(chart, LV_COLOR_GREEN);
+
+    uint32_t i;
+    for(i = 0; i < CHART_POINT_NUM; i++) chart_frame(i);
+}
+
+/*Shift in a new point like a live chart*/
+static void chart_frame(uint32_t frame)
+{
+    lv_chart_set_next(chart, chart_ser[0], rnd_next() % 100);
+    lv_chart_set_next(chart, chart_ser[1], rnd_next() % 100);
+}
+
+static void gauge_create(lv_obj_t * scr, const void * param)
+{
+    static lv_color_t needle_colors[] = {LV_COLOR_BLUE, LV_COLOR_ORANGE};
+    lv_coord_t size = LV_MATH_MIN(lv_obj_get_width(scr), lv_obj_get_height(scr)) - 2 * PAD;
+
+    gauge = lv_gauge_create(scr, NULL);
+    lv_gauge_set_needle_count(gauge, 2, needle_colors);
+    lv_obj_set_size(gauge, size, size);
+    lv_obj_align(gauge, NULL, LV_ALIGN_CENTER, 0, 0);
+}
+
+static void gauge_frame(uint32_t frame)
+{
+    lv_gauge_set_value(gauge, 0, (frame * 7) % 100);
+    lv_gauge_set_value(gauge, 1, 100 - (frame * 3) % 100);
+}
+
+static void ta_create(lv_obj_t * scr, const void * param)
+{
+    ta = lv_ta_create(scr, NULL);
+    lv_obj_set_size(ta, lv_obj_get_width(scr) - 2 * PAD, lv_obj_get_height(scr) - 2 * PAD);
+    lv_obj_set_pos(ta, PAD, PAD);
+    lv_ta_set_text(ta, font_txt);
+}
+
+/*Type at the end of the text*/
+static void ta_frame(uint32_t frame)
+{
+    lv_ta_add_char(ta, 'a' + frame % 26);
+}
+
+/*Many small widgets changing at once: more invalid areas than a frame usually has*/
+static void leds_create(lv_obj_t * scr, const void * param)
+{
+    lv_coord_t w = lv_obj_get_width(scr) / LED_COL_NUM;
+    lv_coord_t h = lv_obj_get_height(scr) / LED_ROW_NUM;
+    lv_coord_t size = LV_MATH_MIN(w, h) / 2;
+    uint32_t i;
+
+    for(i = 0; i < LED_ROW_NUM * LED_COL_NUM; i++) {
+        leds[i] = lv_led_create(scr, NULL);
+        lv_obj_set_size(leds[i], size, size);
+        lv_obj_set_pos(leds[i], (i % LED_COL_NUM) * w + (w - size) / 2, (i / LED_COL_NUM) * h + (h - size) / 2);
+    }
+}
+
+/*Toggle a random half of the LEDs*/
+static void leds_frame(uint32_t frame)
+{
+    uint32_t i;
+    for(i = 0; i < LED_ROW_NUM * LED_COL_NUM; i++) {
+        if(rnd_next() & 0x100) lv_led_toggle(leds[i]);
+    }
+}
+
+/*A screen of text with symbols like a terminal*/
+static void txt_lookup_create(lv_obj_t * scr, const void * param)
+{
+    static char txt[(sizeof(font_txt) + 32) * TXT_LOOKUP_REPEAT];
+    uint32_t i;
+
+    txt[0] = '\0';
+    for(i = 0; i < TXT_LOOKUP_REPEAT; i++) {
+        strcat(txt, LV_SYMBOL_WIFI " " LV_SYMBOL_BATTERY_FULL " " LV_SYMBOL_OK " ");
+        strcat(txt, font_txt);
+        strcat(txt, "\n");
+    }
+
+    txt_label = lv_label_create(scr, NULL);
+    lv_label_set_long_mode(txt_label, LV_LABEL_LONG_BREAK);
+    lv_obj_set_width(txt_label, lv_obj_get_width(scr) - 2 * PAD);
+    lv_obj_set_pos(txt_label, PAD, 0);
+    lv_label_set_static_text(txt_label, txt);
+}
+
+/* Redraw only the bottom of the screen. Drawing the label measures every line above it
+ * so the time is mostly the glyph id and kerning lookups.*/
+static void txt_lookup_frame(uint32_t frame)
+{
+    lv_disp_t * disp = lv_disp_get_default();
+    lv_area_t area;
+
+    area.x1 = 0;
+    area.x2 = lv_disp_get_hor_res(disp) - 1;
+    area.y2 = lv_disp_get_ver_res(disp) - 1;
+    area.y1 = area.y2 - lv_font_get_line_height(lv_obj_get_style(txt_label)->text.font) + 1;
+    lv_inv_area(disp, &area);
+}
+
+/*A screen with many objects like the demo: tabs with buttons, a list and some controls*/
+static void tabview_create(lv_obj_t * scr, const void * param)
+{
+    static const char * list_txt[] = {LV_SYMBOL_AUDIO, LV_SYMBOL_VIDEO, LV_SYMBOL_LIST, LV_SYMBOL_OK};
+    lv_obj_t * tv = lv_tabview_create(scr, NULL);
+    lv_obj_set_size(tv, lv_obj_get_width(scr), lv_obj_get_height(scr));
+
+    lv_obj_t * tab1 = lv_tabview_add_tab(tv, "Buttons");
+    lv_obj_t * tab2 = lv_tabview_add_tab(tv, "List");
+    lv_obj_t * tab3 = lv_tabview_add_tab(tv, "Controls");
+    char txt[16];
+    uint32_t i;
+
+    lv_page_set_scrl_layout(tab1, LV_LAYOUT_PRETTY);
+    for(i = 0; i < TAB_BTN_NUM; i++) {
+        lv_obj_t * btn = lv_btn_create(tab1, NULL);
+        lv_obj_set_size(btn, lv_obj_get_width(scr) / 5, LV_DPI / 3);
+        lv_obj_t * label = lv_label_create(btn, NULL);
+        sprintf(txt, "Button %lu", (unsigned long)i);
+        lv_label_set_text(label, txt);
+    }
+
+    lv_obj_t * list = lv_list_create(tab2, NULL);
+    lv_obj_set_size(list, lv_obj_get_width(scr) - 2 * PAD, lv_obj_get_height(scr));
+    for(i = 0; i < TAB_LIST_NUM; i++) {
+        sprintf(txt, "Item %lu", (unsigned long)i);
+        lv_list_add_btn(list, list_txt[i % 4], txt);
+    }
+
+    lv_page_set_scrl_layout(tab3, LV_LAYOUT_COL_M);
+    lv_slider_create(tab3, NULL);
+    lv_sw_create(tab3, NULL);
+    lv_cb_create(tab3, NULL);
+    lv_bar_set_value(lv_bar_create(tab3, NULL), 60, LV_ANIM_OFF);
+    lv_ddlist_create(tab3, NULL);
+
+    /*Show the list on the middle. The other tabs are still in the object tree.*/
+    lv_tabview_set_tab_act(tv, 1, LV_ANIM_OFF);
+}
+
+/*Many small rounded buttons*/
+static void btnm_create(lv_obj_t * scr, const void * param)
+{
+    static const char * map[] = {"1", "2", "3", "4", "5", "6", "\n",
+                                 "7", "8", "9", "10", "11", "12", "\n",
+                                 "13", "14", "15", "16", "17", "18", "\n",
+                                 "19", "20", "21", "22", "23", "24", ""};
+
+    lv_obj_t * btnm = lv_btnm_create(scr, NULL);
+    lv_btnm_set_map(btnm, map);
+    lv_obj_set_size(btnm, lv_obj_get_width(scr), lv_obj_get_height(scr));
+}
+
+static void kb_create(lv_obj_t * scr, const void * param)
+{
+    lv_obj_t * ta = lv_ta_create(scr, NULL);
+    lv_obj_set_size(ta, lv_obj_get_width(scr) - 2 * PAD, lv_obj_get_height(scr) / 3);
+    lv_obj_set_pos(ta, PAD, PAD);
+
+    lv_obj_t * kb = lv_kb_create(scr, NULL);
+    lv_obj_set_size(kb, lv_obj_get_width(scr), lv_obj_get_height(scr) / 2);
+    lv_obj_align(kb, NULL, LV_ALIGN_IN_BOTTOM_MID, 0, 0);
+    lv_kb_set_ta(kb, ta);
+}
+
+/* Rows of small objects moving with different paths and preloaders like a busy animated screen.
+ * The objects of a row start together so their animations are on the same timeline.*/
+static void anim_create(lv_obj_t * scr, const void * param)
+{
+    static const lv_anim_path_cb_t paths[ANIM_ROW_NUM] = {lv_anim_path_ease_in_out, lv_anim_path_overshoot,
+                                                          lv_anim_path_bounce, lv_anim_path_linear
+                                                         };
+    lv_coord_t w    = lv_obj_get_width(scr) / ANIM_COL_NUM;
+    lv_coord_t h    = lv_obj_get_height(scr) / ANIM_ROW_NUM;
+    lv_coord_t size = LV_MATH_MIN(w, h) / 3;
+    uint32_t row, col;
+
+    for(row = 0; row < ANIM_ROW_NUM; row++) {
+        for(col = 0; col < ANIM_COL_NUM; col++) {
+            lv_obj_t * obj = lv_obj_create(scr, NULL);
+            lv_obj_set_style(obj, &lv_style_plain_color);
+            lv_obj_set_size(obj, size, size);
+
+            lv_anim_t a;
+            lv_anim_init(&a);
+            lv_anim_set_exec_cb(&a, obj, (lv_anim_exec_xcb_t)lv_obj_set_x);
+            lv_anim_set_time(&a, ANIM_TIME, 0);
+            lv_anim_set_values(&a, col * w, col * w + w - size);
+            lv_anim_set_path_cb(&a, paths[row]);
+            lv_anim_set_playback(&a, 0);
+            lv_anim_set_repeat(&a, 0);
+            lv_anim_create(&a);
+
+            lv_anim_set_exec_cb(&a, obj, (lv_anim_exec_xcb_t)lv_obj_set_y);
+            lv_anim_set_values(&a, row * h, row * h + h / 2 - size);
+            lv_anim_create(&a);
+        }
+    }
+
+    lv_obj_t * preload = lv_preload_create(scr, NULL);
+    lv_obj_align(preload, NULL, LV_ALIGN_IN_TOP_RIGHT, -PAD, PAD);
+    preload = lv_preload_create(scr, preload);
+    lv_preload_set_type(preload, LV_PRELOAD_TYPE_FILLSPIN_ARC);
+    lv_obj_align(preload, NULL, LV_ALIGN_IN_BOTTOM_RIGHT, -PAD, -PAD);
+}
+
+/* Step the animations by a refresh period. The update time is the cost of the animations
+ * (path calculation, setting the coordinates and invalidation)*/
+static void anim_frame(uint32_t frame)
+{
+    lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+    lv_anim_refr_now();
+}
+
+/* Panels with labels deep in transparent containers. The labels inherit the style of the panels
+ * through every level (the containers are glass)*/
+static void deep_create(lv_obj_t * scr, const void * param)
+{
+    lv_coord_t w = lv_obj_get_width(scr) / DEEP_COL_NUM;
+    lv_coord_t h = lv_obj_get_height(scr) / DEEP_ROW_NUM;
+    char txt[16];
+    uint32_t i;
+    uint32_t j;
+
+    for(i = 0; i < DEEP_COL_NUM * DEEP_ROW_NUM; i++) {
+        lv_obj_t * panel = lv_obj_create(scr, NULL);
+        lv_obj_set_style(panel, &lv_style_pretty);
+        lv_obj_set_size(panel, w - PAD, h - PAD);
+        lv_obj_set_pos(panel, (i % DEEP_COL_NUM) * w, (i / DEEP_COL_NUM) * h);
+
+        lv_obj_t * par = panel;
+        for(j = 0; j < DEEP_LEVEL_NUM; j++) {
+            lv_obj_t * cont = lv_obj_create(par, NULL);
+            lv_obj_set_style(cont, &lv_style_transp);
+            lv_obj_set_size(cont, lv_obj_get_width(par) - 2, lv_obj_get_height(par) - 2);
+            lv_obj_set_pos(cont, 1, 1);
+            par = cont;
+        }
+
+        for(j = 0; j < DEEP_LABEL_NUM; j++) {
+            lv_obj_t * label = lv_label_create(par, NULL);
+            sprintf(txt, "Level %d #%lu", DEEP_LEVEL_NUM, (unsigned long)j);
+            lv_label_set_text(label, txt);
+            lv_obj_set_pos(label, PAD, PAD + j * (lv_obj_get_height(par) - 2 * PAD) / DEEP_LABEL_NUM);
+        }
+    }
+}
+
+/*--------------------
+ * OTHER FUNCTIONS
+ ---------------------*/
+
+/*Generate the indexed and alpha images to not depend on converted image files*/
+static void gen_img_init(void)
+{
+    uint32_t x, y;
+
+    /*4 bit indexed: 16 colors palette then 2 pixels/byte*/
+    lv_color32_t * palette = (lv_color32_t *)img_indexed_map;
+    for(x = 0; x < 16; x++) {
+        lv_color_t c = lv_color_hsv_to_rgb(x * 360 / 16, 80, 90);
+        palette[x].full = lv_color_to32(c);
+    }
+
+    uint8_t * px = &img_indexed_map[16 * sizeof(lv_color32_t)];
+    for(y = 0; y < GEN_IMG_SIZE; y++) {
+        for(x = 0; x < GEN_IMG_SIZE; x += 2) {
+            uint8_t i1 = ((x / 8) + (y / 8)) & 0xF;
+            uint8_t i2 = (((x + 1) / 8) + (y / 8)) & 0xF;
+            *px++ = (i1 << 4) | i2;
+        }
+    }
+
+    img_indexed.header.always_zero = 0;
+    img_indexed.header.w           = GEN_IMG_SIZE;
+    img_indexed.header.h           = GEN_IMG_SIZE;
+    img_indexed.header.cf          = LV_IMG_CF_INDEXED_4BIT;
+    img_indexed.data_size          = sizeof(img_indexed_map);
+    img_indexed.data               = img_indexed_map;
+
+    /*8 bit alpha: diagonal gradient*/
+    for(y = 0; y < GEN_IMG_SIZE; y++) {
+        for(x = 0; x < GEN_IMG_SIZE; x++) {
+            img_alpha_map[y * GEN_IMG_SIZE + x] = ((x + y) * 255) / (2 * (GEN_IMG_SIZE - 1));
+        }
+    }
+
+    img_alpha.header.always_zero = 0;
+    img_alpha.header.w           = GEN_IMG_SIZE;
+    img_alpha.header.h           = GEN_IMG_SIZE;
+    img_alpha.header.cf          = LV_IMG_CF_ALPHA_8BIT;
+    img_alpha.data_size          = sizeof(img_alpha_map);
+    img_alpha.data               = img_alpha_map;
+}
+
+/*Reproducible pseudo random numbers*/
+static uint32_t rnd_next(void)
+{
+    rnd_seed = rnd_seed * 1103515245 + 12345;
+    return (rnd_seed >> 16) & 0x7FFF;
+}
+
+/**
+ * Called when a the library finished rendering
+ * @param disp_drv pointer to the caller display driver
+ * @param time_ms time of rendering in milliseconds
+ * @param px_num Number of pixels drawn
+ */
+static void refr_monitor(lv_disp_drv_t * disp_drv, uint32_t time_ms, uint32_t px_num)
+{
+    last_px_num = px_num;
+
+    /*Keep the port's monitor (e.g. the counters of the pipelined rendering) working*/
+    if(monitor_ori) monitor_ori(disp_drv, time_ms, px_num);
+}
+
+#endif /*LV_USE_BENCHMARK*/
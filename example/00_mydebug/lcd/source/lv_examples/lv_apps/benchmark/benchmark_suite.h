@@ -0,0 +1,114 @@
+/**
+ * @file benchmark_suite.h
+ * Non-interactive render benchmark: a catalogue of scenes measured frame by frame
+ */
+
+#ifndef BENCHMARK_SUITE_H
+#define BENCHMARK_SUITE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "../../../lvgl/lvgl.h"
+#include "../../../lv_ex_conf.h"
+#endif
+
+#if LV_USE_BENCHMARK
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Header line of the CSV output*/
+#define BENCHMARK_SUITE_CSV_HEADER  "scene,frame,time_us,px_num,inv_areas,mem_used,mem_peak,font_search,update_us"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Get a time stamp in microseconds. Only the difference of two time stamps is used.
+ */
+typedef uint32_t (*benchmark_suite_time_cb_t)(void);
+
+/**
+ * Output one line of the CSV (without line ending)
+ */
+typedef void (*benchmark_suite_print_cb_t)(const char * line);
+
+/**
+ * Summary of a scene
+ */
+typedef struct
+{
+    const char * name;      /**< Name of the scene*/
+    uint32_t frame_cnt;     /**< Measured frames*/
+    uint32_t time_sum;      /**< Sum of the render times [us]*/
+    uint32_t time_min;      /**< Fastest frame [us]*/
+    uint32_t time_max;      /**< Slowest frame [us]*/
+    uint32_t px_sum;        /**< Sum of the refreshed pixels*/
+    uint32_t inv_sum;       /**< Sum of the invalidated areas*/
+    uint32_t mem_peak;      /**< Highest `lv_mem` usage during the scene [bytes]*/
+    uint32_t search_sum;    /**< Sum of the glyph id and kerning searches of the fonts*/
+    uint32_t update_sum;    /**< Sum of the times of modifying the scene before the frames [us]*/
+} benchmark_suite_res_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Set the callbacks of the benchmark suite
+ * @param time get a time stamp in microseconds
+ * @param print output of the CSV lines (NULL: don't print)
+ */
+void benchmark_suite_init(benchmark_suite_time_cb_t time, benchmark_suite_print_cb_t print);
+
+/**
+ * Get the number of scenes
+ * @return number of scenes
+ */
+uint16_t benchmark_suite_get_scene_cnt(void);
+
+/**
+ * Get the name of a scene
+ * @param id index of the scene
+ * @return name of the scene or NULL if `id` is invalid
+ */
+const char * benchmark_suite_get_scene_name(uint16_t id);
+
+/**
+ * Measure one scene: create it on a new screen, render `frame_num` frames and print a CSV line for each.
+ * The original screen is loaded again at the end.
+ * @param id index of the scene
+ * @param frame_num number of measured frames
+ * @param res store the summary here (can be NULL)
+ * @return LV_RES_OK: the scene was measured; LV_RES_INV: invalid `id`
+ */
+lv_res_t benchmark_suite_run_scene(uint16_t id, uint32_t frame_num, benchmark_suite_res_t * res);
+
+/**
+ * Print the CSV header and measure all scenes
+ * @param frame_num number of measured frames in every scene
+ */
+void benchmark_suite_run(uint32_t frame_num);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_BENCHMARK*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*BENCHMARK_SUITE_H*/
@@ -144,6 +144,34 @@ static void sysmon_task(lv_task_t * param)
             (int)mem_mon.total_size,
             (int)mem_mon.total_size - mem_mon.free_size, mem_mon.free_size, mem_mon.frag_pct);
 
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+    /*The cached shadow masks are allocated from the memory above*/
+    lv_mask_cache_stat_t shadow_stat;
+    lv_mask_cache_get_stat(&lv_shadow_cache, &shadow_stat);
+    uint32_t shadow_get_cnt = shadow_stat.hit_cnt + shadow_stat.miss_cnt;
+    len += lv_snprintf(buf_long+len, SYSMON_STRING_BUFFER_SIZE-len, "\nShadow: %d bytes, %d %% hit",
+            (int)shadow_stat.used,
+            shadow_get_cnt ? (int)((uint64_t)shadow_stat.hit_cnt * 100 / shadow_get_cnt) : 0);
+#endif
+
+#if LV_CORNER_CACHE_SIZE
+    /*The cached corner masks are allocated from the memory above too*/
+    lv_mask_cache_stat_t corner_stat;
+    lv_mask_cache_get_stat(&lv_corner_cache, &corner_stat);
+    uint32_t corner_get_cnt = corner_stat.hit_cnt + corner_stat.miss_cnt;
+    len += lv_snprintf(buf_long+len, SYSMON_STRING_BUFFER_SIZE-len, "\nCorner: %d bytes, %d %% hit",
+            (int)corner_stat.used,
+            corner_get_cnt ? (int)((uint64_t)corner_stat.hit_cnt * 100 / corner_get_cnt) : 0);
+#endif
+
+    /*The decoded images are stored out of the memory above (e.g. in an SDRAM)*/
+    lv_img_cache_stat_t img_stat;
+    lv_img_cache_get_stat(&img_stat);
+    uint32_t img_get_cnt = img_stat.hit_cnt + img_stat.miss_cnt;
+    len += lv_snprintf(buf_long+len, SYSMON_STRING_BUFFER_SIZE-len, "\nImage: %d bytes, %d %% hit",
+            (int)img_stat.used,
+            img_get_cnt ? (int)((uint64_t)img_stat.hit_cnt * 100 / img_get_cnt) : 0);
+
 #else
     len += lv_snprintf(buf_long+len, SYSMON_STRING_BUFFER_SIZE-len, LV_TXT_COLOR_CMD"%s MEMORY: N/A"LV_TXT_COLOR_CMD,
             MEM_LABEL_COLOR);
@@ -35,6 +35,7 @@ extern "C" {
 
 #include "src/lv_font/lv_font.h"
 #include "src/lv_font/lv_font_fmt_txt.h"
+#include "src/lv_font/lv_font_cache.h"
 #include "src/lv_misc/lv_bidi.h"
 #include "src/lv_misc/lv_printf.h"
 
@@ -73,6 +74,10 @@ extern "C" {
 #include "src/lv_objx/lv_spinbox.h"
 
 #include "src/lv_draw/lv_img_cache.h"
+#include "src/lv_draw/lv_img_qli.h"
+#include "src/lv_draw/lv_mask_cache.h"
+#include "src/lv_draw/lv_shadow_cache.h"
+#include "src/lv_draw/lv_corner_cache.h"
 
 /*********************
  *      DEFINES
@@ -0,0 +1,245 @@
+/**
+ * @file lv_port_blit.c
+ * 2D fill and copy service (DMA2D style) on the repeat and non-sequential modes of the DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_port_blit.h"
+#include "lvgl/src/lv_draw/lv_draw_blend.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool dma_blit(lv_color_t * dest, lv_coord_t dest_stride, const void * src, lv_coord_t src_stride,
+                     lv_coord_t w, lv_coord_t h, bool src_fix);
+static uint8_t get_unit_width(uintptr_t dest, lv_coord_t dest_stride, uintptr_t src, lv_coord_t src_stride,
+                              lv_coord_t w);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_port_blit_hw_t * hw;
+static lv_port_blit_stat_t stat;
+
+/*Source of the fills: the DMA reads the color from here with a fixed source address*/
+static uint32_t fill_word;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize the blit service
+ * @param hw_p pointer to the DMA interface. Only the pointer is saved. NULL: use only the CPU
+ */
+void lv_port_blit_init(const lv_port_blit_hw_t * hw_p)
+{
+    hw = hw_p;
+    lv_port_blit_reset_stat();
+}
+
+/**
+ * Fill a rectangle of a memory with a color
+ * @param dest pointer to the first pixel of the rectangle
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param w width of the rectangle
+ * @param h height of the rectangle
+ * @param color the fill color
+ */
+void lv_port_blit_fill(lv_color_t * dest, lv_coord_t dest_stride, lv_coord_t w, lv_coord_t h, lv_color_t color)
+{
+    if(w <= 0 || h <= 0) return;
+
+    stat.fill_cnt++;
+
+    /*With 32 bit units one unit is two pixels*/
+#if LV_COLOR_DEPTH == 16
+    fill_word = (uint32_t)color.full | ((uint32_t)color.full << 16);
+#else
+    fill_word = color.full;
+#endif
+
+    if(dma_blit(dest, dest_stride, &fill_word, 0, w, h, true)) return;
+
+    lv_area_t area;
+    lv_area_set(&area, 0, 0, w - 1, h - 1);
+    lv_draw_blend_fill(dest, dest_stride, &area, color, LV_OPA_COVER);
+    stat.cpu_px += (uint32_t)w * h;
+}
+
+/**
+ * Copy a rectangle of pixels. The memories must not overlap.
+ * @param dest pointer to the first pixel of the destination rectangle
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param src pointer to the first pixel of the source rectangle
+ * @param src_stride pixels from a row to the next in `src`. 0: copy the same row to every row
+ * @param w width of the rectangle
+ * @param h height of the rectangle
+ */
+void lv_port_blit_copy(lv_color_t * dest, lv_coord_t dest_stride, const lv_color_t * src, lv_coord_t src_stride,
+                       lv_coord_t w, lv_coord_t h)
+{
+    if(w <= 0 || h <= 0) return;
+
+    stat.copy_cnt++;
+
+    if(dma_blit(dest, dest_stride, src, src_stride, w, h, false)) return;
+
+    lv_coord_t row;
+    for(row = 0; row < h; row++) {
+        memcpy(dest, src, w * sizeof(lv_color_t));
+        dest += dest_stride;
+        src += src_stride;
+    }
+    stat.cpu_px += (uint32_t)w * h;
+}
+
+/**
+ * Fill an area with a color. Can be used as `gpu_fill_cb` of the display driver.
+ * @param disp_drv pointer to the display driver
+ * @param dest_buf pointer to the display buffer
+ * @param dest_width width of the display buffer
+ * @param fill_area the area to fill, relative to `dest_buf`
+ * @param color the fill color
+ */
+void lv_port_blit_gpu_fill_cb(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
+                              const lv_area_t * fill_area, lv_color_t color)
+{
+    (void)disp_drv; /*Unused*/
+
+    dest_buf += (uint32_t)dest_width * fill_area->y1 + fill_area->x1;
+    lv_port_blit_fill(dest_buf, dest_width, lv_area_get_width(fill_area), lv_area_get_height(fill_area), color);
+}
+
+/**
+ * Copy a rectangle of pixels. Can be used as `gpu_copy_cb` of the display driver.
+ * @param disp_drv pointer to the display driver
+ * @param dest pointer to the first pixel of the destination rectangle
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param src pointer to the first pixel of the source rectangle
+ * @param src_stride pixels from a row to the next in `src`
+ * @param w width of the rectangle
+ * @param h height of the rectangle
+ */
+void lv_port_blit_gpu_copy_cb(lv_disp_drv_t * disp_drv, lv_color_t * dest, lv_coord_t dest_stride,
+                              const lv_color_t * src, lv_coord_t src_stride, lv_coord_t w, lv_coord_t h)
+{
+    (void)disp_drv; /*Unused*/
+
+    lv_port_blit_copy(dest, dest_stride, src, src_stride, w, h);
+}
+
+/**
+ * Get the counters of the blit service
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_port_blit_get_stat(lv_port_blit_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**
+ * Clear the counters of the blit service
+ */
+void lv_port_blit_reset_stat(void)
+{
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Do a fill or copy with the DMA if it's worth it.
+ * A block is a row. At the end of a row the non-sequential mode jumps over the rest of the
+ * stride: the address of the next unit is the address of the last unit + `ofs` units,
+ * so `ofs = stride - w + 1` in units. A single source row is reloaded by the repeat mode.
+ * @param dest pointer to the first pixel of the destination
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param src pointer to the first pixel of the source or to the fill unit
+ * @param src_stride pixels from a row to the next in `src`. 0: the same row for every row
+ * @param w width of the rectangle
+ * @param h height of the rectangle
+ * @param src_fix true: `src` is one unit to fill with
+ * @return true: done by the DMA; false: the CPU should do it
+ */
+static bool dma_blit(lv_color_t * dest, lv_coord_t dest_stride, const void * src, lv_coord_t src_stride,
+                     lv_coord_t w, lv_coord_t h, bool src_fix)
+{
+    if(hw == NULL) return false;
+    if(w < LV_PORT_BLIT_DMA_MIN_W || (uint32_t)w * h < LV_PORT_BLIT_DMA_MIN_PX) return false;
+    if((uint32_t)h > LV_PORT_BLIT_DMA_CNT_MAX) return false;
+
+    uint8_t width     = get_unit_width((uintptr_t)dest, dest_stride, (uintptr_t)src, src_stride, w);
+    uint8_t px_unit   = width / sizeof(lv_color_t);
+    uint32_t row_unit = (uint32_t)w / px_unit;
+    if(row_unit > LV_PORT_BLIT_DMA_BLK_MAX) return false;
+
+    lv_port_blit_dma_t xfer;
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.src      = (uintptr_t)src;
+    xfer.dest     = (uintptr_t)dest;
+    xfer.width    = width;
+    xfer.blk_size = (uint16_t)row_unit;
+    xfer.blk_cnt  = (uint16_t)h;
+    xfer.src_fix  = src_fix;
+
+    if(dest_stride != w) {
+        xfer.dest_ns_cnt = (uint16_t)row_unit;
+        xfer.dest_ns_ofs = (uint32_t)(dest_stride - w) / px_unit + 1;
+        if(xfer.dest_ns_ofs > LV_PORT_BLIT_DMA_NS_OFS_MAX) return false;
+    }
+
+    if(src_fix == false) {
+        if(src_stride == 0) {
+            xfer.src_rpt = (uint16_t)row_unit;
+        } else if(src_stride != w) {
+            xfer.src_ns_cnt = (uint16_t)row_unit;
+            xfer.src_ns_ofs = (uint32_t)(src_stride - w) / px_unit + 1;
+            if(xfer.src_ns_ofs > LV_PORT_BLIT_DMA_NS_OFS_MAX) return false;
+        }
+    }
+
+    hw->dma_xfer(&xfer);
+
+    stat.dma_cnt++;
+    stat.dma_px += (uint32_t)w * h;
+
+    return true;
+}
+
+/**
+ * Get the largest unit which keeps every row on unit boundaries
+ * @param dest address of the destination
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param src address of the source
+ * @param src_stride pixels from a row to the next in `src`
+ * @param w width of the rectangle
+ * @return size of a unit in bytes
+ */
+static uint8_t get_unit_width(uintptr_t dest, lv_coord_t dest_stride, uintptr_t src, lv_coord_t src_stride,
+                              lv_coord_t w)
+{
+#if LV_COLOR_DEPTH == 16
+    /*Two pixels in a word if every row starts on a word*/
+    if(((dest | src) & 0x3) == 0 && ((w | dest_stride | src_stride) & 0x1) == 0) return 4;
+#endif
+
+    return sizeof(lv_color_t);
+}
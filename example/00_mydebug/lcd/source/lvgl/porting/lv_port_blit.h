@@ -0,0 +1,156 @@
+/**
+ * @file lv_port_blit.h
+ * 2D fill and copy service (DMA2D style) on the repeat and non-sequential modes of the DMA
+ */
+
+#ifndef LV_PORT_BLIT_H
+#define LV_PORT_BLIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Smaller areas are done by the CPU because setting up and waiting for the DMA costs more than the copy*/
+#ifndef LV_PORT_BLIT_DMA_MIN_PX
+#define LV_PORT_BLIT_DMA_MIN_PX     2048
+#endif
+
+/*Narrower areas are done by the CPU: every row is a block which needs its own request*/
+#ifndef LV_PORT_BLIT_DMA_MIN_W
+#define LV_PORT_BLIT_DMA_MIN_W      32
+#endif
+
+/*Limits of one DMA transfer*/
+#define LV_PORT_BLIT_DMA_BLK_MAX    1024U       /*Units in a block (a row)*/
+#define LV_PORT_BLIT_DMA_CNT_MAX    0xFFFFU     /*Blocks in a transfer (rows)*/
+#define LV_PORT_BLIT_DMA_NS_OFS_MAX 0xFFFFFU    /*Non-sequential offset in units*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Register settings of one memory to memory DMA transfer.
+ * A block is one row of the area, the row to row jumps are done by the non-sequential mode.
+ */
+typedef struct
+{
+    uintptr_t src;          /**< Source address (SAR)*/
+    uintptr_t dest;         /**< Destination address (DAR)*/
+    uint8_t width;          /**< Size of a unit in bytes: 1, 2 or 4*/
+    uint16_t blk_size;      /**< Units in a block: the units of a row*/
+    uint16_t blk_cnt;       /**< Number of blocks: the rows*/
+    bool src_fix;           /**< The source address is fixed (fill from one unit)*/
+    uint16_t src_rpt;       /**< Reload the source address after this many units (0: no repeat)*/
+    uint16_t src_ns_cnt;    /**< Jump the source address after this many units (0: sequential)*/
+    uint32_t src_ns_ofs;    /**< Jump of the source address in units from the last unit*/
+    uint16_t dest_ns_cnt;   /**< Jump the destination address after this many units (0: sequential)*/
+    uint32_t dest_ns_ofs;   /**< Jump of the destination address in units from the last unit*/
+} lv_port_blit_dma_t;
+
+/**
+ * DMA access used by the blit service.
+ * On the board it is implemented with the DDL `DMA_*` API, on the host with the simulated DMA.
+ */
+typedef struct
+{
+    /** Run a memory to memory transfer and return when it's complete*/
+    void (*dma_xfer)(const lv_port_blit_dma_t * xfer);
+} lv_port_blit_hw_t;
+
+/**
+ * Counters of the blit service
+ */
+typedef struct
+{
+    uint32_t fill_cnt;  /**< Number of fills*/
+    uint32_t copy_cnt;  /**< Number of copies*/
+    uint32_t dma_cnt;   /**< Number of DMA transfers*/
+    uint32_t dma_px;    /**< Pixels written by the DMA*/
+    uint32_t cpu_px;    /**< Pixels written by the CPU*/
+} lv_port_blit_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the blit service
+ * @param hw pointer to the DMA interface. Only the pointer is saved. NULL: use only the CPU
+ */
+void lv_port_blit_init(const lv_port_blit_hw_t * hw);
+
+/**
+ * Fill a rectangle of a memory with a color
+ * @param dest pointer to the first pixel of the rectangle
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param w width of the rectangle
+ * @param h height of the rectangle
+ * @param color the fill color
+ */
+void lv_port_blit_fill(lv_color_t * dest, lv_coord_t dest_stride, lv_coord_t w, lv_coord_t h, lv_color_t color);
+
+/**
+ * Copy a rectangle of pixels. The memories must not overlap.
+ * @param dest pointer to the first pixel of the destination rectangle
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param src pointer to the first pixel of the source rectangle
+ * @param src_stride pixels from a row to the next in `src`. 0: copy the same row to every row
+ * @param w width of the rectangle
+ * @param h height of the rectangle
+ */
+void lv_port_blit_copy(lv_color_t * dest, lv_coord_t dest_stride, const lv_color_t * src, lv_coord_t src_stride,
+                       lv_coord_t w, lv_coord_t h);
+
+/**
+ * Fill an area with a color. Can be used as `gpu_fill_cb` of the display driver.
+ * @param disp_drv pointer to the display driver
+ * @param dest_buf pointer to the display buffer
+ * @param dest_width width of the display buffer
+ * @param fill_area the area to fill, relative to `dest_buf`
+ * @param color the fill color
+ */
+void lv_port_blit_gpu_fill_cb(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
+                              const lv_area_t * fill_area, lv_color_t color);
+
+/**
+ * Copy a rectangle of pixels. Can be used as `gpu_copy_cb` of the display driver.
+ * @param disp_drv pointer to the display driver
+ * @param dest pointer to the first pixel of the destination rectangle
+ * @param dest_stride pixels from a row to the next in `dest`
+ * @param src pointer to the first pixel of the source rectangle
+ * @param src_stride pixels from a row to the next in `src`
+ * @param w width of the rectangle
+ * @param h height of the rectangle
+ */
+void lv_port_blit_gpu_copy_cb(lv_disp_drv_t * disp_drv, lv_color_t * dest, lv_coord_t dest_stride,
+                              const lv_color_t * src, lv_coord_t src_stride, lv_coord_t w, lv_coord_t h);
+
+/**
+ * Get the counters of the blit service
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_port_blit_get_stat(lv_port_blit_stat_t * stat);
+
+/**
+ * Clear the counters of the blit service
+ */
+void lv_port_blit_reset_stat(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PORT_BLIT_H*/
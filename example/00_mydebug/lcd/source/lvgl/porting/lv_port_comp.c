@@ -0,0 +1,492 @@
+/**
+ * @file lv_port_comp.c
+ * Compositor of the camera video and the GUI: the video is captured into a surface (e.g. in the SDRAM)
+ * and merged into the strips of LVGL where the GUI has the colour key
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_port_comp.h"
+#include "lv_port_blit.h"
+#include "lvgl/src/lv_draw/lv_draw_blend.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void comp_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void comp_render_start_cb(lv_disp_drv_t * drv);
+static void comp_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static void comp_strip(const lv_area_t * area, lv_color_t * color_p);
+static lv_coord_t key_end(const lv_color_t * row, lv_coord_t x, lv_coord_t end);
+static lv_coord_t gui_end(const lv_color_t * row, lv_coord_t x, lv_coord_t end);
+static void video_run(lv_coord_t y, lv_coord_t x1, lv_coord_t x2);
+static void rects_copy(lv_coord_t y);
+static lv_disp_t * comp_disp_get(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static void (*flush_ori)(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void (*render_start_ori)(lv_disp_drv_t * drv);
+static void (*monitor_ori)(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static uint32_t (*comp_time_us)(void);
+static uint32_t (*irq_lock)(void);
+static void (*irq_unlock)(uint32_t state);
+
+static lv_coord_t comp_hor;
+static lv_area_t video_area;
+static lv_color_t comp_key;
+static lv_opa_t comp_opa;
+static bool comp_en;
+
+static lv_color_t * cam_surf[2];
+static lv_color_t * volatile cam_wr;        /*The camera writes this surface*/
+static lv_color_t * volatile cam_latest;    /*The last complete frame*/
+static lv_color_t * volatile cam_rd;        /*The refresh reads this surface*/
+static volatile bool cam_new;               /*`cam_latest` is not shown yet*/
+static volatile bool refreshing;            /*Between the start of the rendering and the monitor*/
+static bool cam_inv;                        /*The video is invalidated for the new frame*/
+
+/*The strip being composed and its video rectangles (relative to the strip)*/
+static lv_color_t * strip_buf;
+static const lv_area_t * strip_area;
+static lv_area_t rects[LV_PORT_COMP_RECT_MAX];
+static uint32_t rect_cnt;
+
+static lv_port_comp_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Set up the display driver to merge the camera video into the strips before they are flushed.
+ * Call it before `lv_disp_drv_register()`, after `lv_port_pipe_init()` (the strips) and `lv_port_blit_init()`.
+ * The original `flush_cb` gets the composed strips, the original `render_start_cb` and `monitor_cb` are called too.
+ * It doesn't work with screen sized buffers (`lv_port_fb`): the video would stay in the GUI's buffer.
+ * The compositor is disabled after the init.
+ * @param drv pointer to the initialized display driver
+ * @param cam1 a camera surface (`hor_res * ver_res` pixels)
+ * @param cam2 an other camera surface to capture while `cam1` is shown or NULL (the video can tear)
+ * @param time_us get a free running time stamp in microseconds
+ */
+void lv_port_comp_init(lv_disp_drv_t * drv, lv_color_t * cam1, lv_color_t * cam2, uint32_t (*time_us)(void))
+{
+    comp_time_us = time_us;
+    comp_hor     = drv->hor_res;
+    comp_key     = LV_PORT_COMP_KEY;
+    comp_opa     = LV_OPA_COVER;
+    comp_en      = false;
+
+    video_area.x1 = 0;
+    video_area.y1 = 0;
+    video_area.x2 = drv->hor_res - 1;
+    video_area.y2 = drv->ver_res - 1;
+
+    cam_surf[0] = cam1;
+    cam_surf[1] = cam2;
+    cam_wr      = cam1;
+    cam_latest  = cam2 ? cam2 : cam1;
+    cam_rd      = cam_latest;
+    cam_new     = false;
+    cam_inv     = false;
+    refreshing  = false;
+
+    flush_ori        = drv->flush_cb;
+    render_start_ori = drv->render_start_cb;
+    monitor_ori      = drv->monitor_cb;
+
+    drv->flush_cb        = comp_flush_cb;
+    drv->render_start_cb = comp_render_start_cb;
+    drv->monitor_cb      = comp_monitor_cb;
+
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**
+ * Set the functions which mask the interrupt of the camera's frame end (`lv_port_comp_cam_frame_end()`).
+ * The start of a refresh takes the last camera frame with the interrupt masked.
+ * Without them the frame end must not interrupt the rendering (e.g. it's polled by the main loop).
+ * @param lock mask the interrupt and return the previous state (e.g. save PRIMASK and disable the interrupts)
+ * @param unlock restore the state returned by `lock`
+ */
+void lv_port_comp_set_irq_lock(uint32_t (*lock)(void), void (*unlock)(uint32_t state))
+{
+    irq_lock   = lock;
+    irq_unlock = unlock;
+}
+
+/**
+ * Enable or disable the video. If disabled the strips are flushed as they are rendered.
+ * @param en true: show the video where the GUI has the colour key
+ */
+void lv_port_comp_enable(bool en)
+{
+    comp_en = en;
+    cam_inv = false;
+}
+
+/**
+ * Tell whether the video is enabled
+ * @return true: enabled
+ */
+bool lv_port_comp_is_enabled(void)
+{
+    return comp_en;
+}
+
+/**
+ * Set the colour key of the GUI. Keep the anti-aliased edges away from it
+ * (e.g. use it only for the background of the screen).
+ * @param key the GUI is transparent where it has this colour
+ */
+void lv_port_comp_set_key(lv_color_t key)
+{
+    comp_key = key;
+}
+
+/**
+ * Get the colour key of the GUI
+ * @return the colour key
+ */
+lv_color_t lv_port_comp_get_key(void)
+{
+    return comp_key;
+}
+
+/**
+ * Set the opacity of the GUI above the video
+ * @param opa LV_OPA_COVER: the GUI covers the video ... LV_OPA_TRANSP: only the video
+ */
+void lv_port_comp_set_opa(lv_opa_t opa)
+{
+    comp_opa = opa;
+}
+
+/**
+ * Set the area of the video. The colour key is kept outside of it.
+ * @param area the area on the screen (the default is the whole screen)
+ */
+void lv_port_comp_set_area(const lv_area_t * area)
+{
+    lv_area_copy(&video_area, area);
+}
+
+/**
+ * Get the surface which the camera writes now. Its rows are `hor_res` pixels long.
+ * @return the surface
+ */
+lv_color_t * lv_port_comp_get_cam_buf(void)
+{
+    return cam_wr;
+}
+
+/**
+ * Tell that a camera frame is captured. Call it from the interrupt of the frame end.
+ * @return the surface to capture the next frame into
+ */
+lv_color_t * lv_port_comp_cam_frame_end(void)
+{
+    lv_color_t * done = cam_wr;
+    lv_color_t * next = done == cam_surf[0] ? cam_surf[1] : cam_surf[0];
+
+    stat.cam_cnt++;
+
+    /*One surface: it's shown while it's written*/
+    if(next == NULL) {
+        cam_latest = done;
+        cam_new    = true;
+        return done;
+    }
+
+    /* The refresh reads the other surface: capture into the same one again.
+     * `cam_latest` stays the other (complete) one, it's never the surface being written. */
+    if(refreshing && next == cam_rd) {
+        stat.drop_cnt++;
+        return done;
+    }
+
+    if(cam_new) stat.drop_cnt++;
+
+    cam_latest = done;
+    cam_new    = true;
+    cam_wr     = next;
+
+    return next;
+}
+
+/**
+ * Tell whether a new camera frame waits to be shown
+ * @return true: call `lv_port_comp_handler()` and `lv_task_handler()`
+ */
+bool lv_port_comp_frame_pending(void)
+{
+    return comp_en && cam_new && !cam_inv;
+}
+
+/**
+ * Invalidate the area of the video if a new camera frame is captured.
+ * Call it periodically before `lv_task_handler()`.
+ */
+void lv_port_comp_handler(void)
+{
+    if(!lv_port_comp_frame_pending()) return;
+
+    lv_disp_t * disp = comp_disp_get();
+    if(disp == NULL) return;
+
+    lv_inv_area(disp, &video_area);
+    cam_inv = true;
+}
+
+/**
+ * Get the counters of the camera and of the last refresh
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_port_comp_get_stat(lv_port_comp_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void comp_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    if(comp_en) comp_strip(area, color_p);
+
+    flush_ori(drv, area, color_p);
+}
+
+/* The whole refresh shows one camera frame */
+static void comp_render_start_cb(lv_disp_drv_t * drv)
+{
+    /* The frame end interrupt reads and writes these too: take the frame with it masked.
+     * A frame captured after it is shown in the next refresh. */
+    uint32_t state = irq_lock ? irq_lock() : 0;
+
+    /*Disabled: the frames wait*/
+    refreshing = comp_en;
+    bool fresh = false;
+    if(comp_en) {
+        fresh   = cam_new;
+        cam_new = false;
+        cam_rd  = cam_latest;
+        cam_inv = false;
+    }
+
+    if(irq_unlock) irq_unlock(state);
+
+    if(fresh) stat.frame_cnt++;
+
+    stat.video_px = 0;
+    stat.blend_px = 0;
+    stat.rect_cnt = 0;
+    stat.comp_us  = 0;
+
+    if(render_start_ori) render_start_ori(drv);
+}
+
+static void comp_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    refreshing = false;
+
+    if(monitor_ori) monitor_ori(drv, time, px);
+}
+
+/**
+ * Merge the video into a strip: the key pixels are replaced by the video,
+ * the other ones are mixed with it if the GUI is not opaque.
+ * @param area the area of the strip on the screen
+ * @param color_p the pixels of the strip
+ */
+static void comp_strip(const lv_area_t * area, lv_color_t * color_p)
+{
+    lv_area_t clip;
+    if(!lv_area_intersect(&clip, area, &video_area)) return;
+
+    uint32_t start = comp_time_us();
+    lv_coord_t w   = lv_area_get_width(area);
+    lv_coord_t x1  = clip.x1 - area->x1;
+    lv_coord_t end = clip.x2 - area->x1 + 1;
+    lv_coord_t y;
+
+    strip_buf  = color_p;
+    strip_area = area;
+    rect_cnt   = 0;
+
+    for(y = clip.y1 - area->y1; y <= clip.y2 - area->y1; y++) {
+        lv_color_t * row           = color_p + (uint32_t)y * w;
+        const lv_color_t * cam_row = cam_rd + (uint32_t)(area->y1 + y) * comp_hor + area->x1;
+        lv_coord_t x               = x1;
+
+        while(x < end) {
+            lv_coord_t x_end = key_end(row, x, end);
+            if(x_end > x) {
+                video_run(y, x, x_end - 1);
+                x = x_end;
+                if(x >= end) break;
+            }
+
+            x_end = gui_end(row, x, end);
+            if(comp_opa < LV_OPA_COVER) {
+                lv_draw_blend_map(&row[x], &cam_row[x], x_end - x, LV_OPA_COVER - comp_opa);
+                stat.blend_px += x_end - x;
+            }
+            x = x_end;
+        }
+
+        /*The rectangles which didn't go on in this row are complete*/
+        rects_copy(y);
+    }
+
+    rects_copy(LV_COORD_MAX);
+
+    stat.comp_us += comp_time_us() - start;
+}
+
+/**
+ * Find the end of the key pixels
+ * @param row pixels of a row of the strip
+ * @param x start here
+ * @param end the end of the row
+ * @return the first pixel from `x` which is not the key or `end`
+ */
+static lv_coord_t key_end(const lv_color_t * row, lv_coord_t x, lv_coord_t end)
+{
+#if LV_COLOR_DEPTH == 16
+    if(((lv_uintptr_t)&row[x] & 0x3) && x < end) {
+        if(row[x].full != comp_key.full) return x;
+        x++;
+    }
+
+    /*Two pixels in a word*/
+    uint32_t key32         = ((uint32_t)comp_key.full << 16) | comp_key.full;
+    const uint32_t * row32 = (const uint32_t *)&row[x];
+    while(x + 1 < end && *row32 == key32) {
+        row32++;
+        x += 2;
+    }
+#endif
+
+    while(x < end && row[x].full == comp_key.full) x++;
+
+    return x;
+}
+
+/**
+ * Find the end of the GUI pixels
+ * @param row pixels of a row of the strip
+ * @param x start here
+ * @param end the end of the row
+ * @return the first key pixel from `x` or `end`
+ */
+static lv_coord_t gui_end(const lv_color_t * row, lv_coord_t x, lv_coord_t end)
+{
+#if LV_COLOR_DEPTH == 16
+    if(((lv_uintptr_t)&row[x] & 0x3) && x < end) {
+        if(row[x].full == comp_key.full) return x;
+        x++;
+    }
+
+    /*Two pixels in a word: a half of `v` is zero where a pixel is the key*/
+    uint32_t key32         = ((uint32_t)comp_key.full << 16) | comp_key.full;
+    const uint32_t * row32 = (const uint32_t *)&row[x];
+    while(x + 1 < end) {
+        uint32_t v = *row32 ^ key32;
+        if(((v - 0x00010001U) & ~v & 0x80008000U) != 0) break;
+        row32++;
+        x += 2;
+    }
+#endif
+
+    while(x < end && row[x].full != comp_key.full) x++;
+
+    return x;
+}
+
+/**
+ * Put the video into a run of key pixels. Short runs are copied at once, the long ones
+ * continue a rectangle of the previous row or start a new one.
+ * @param y row in the strip
+ * @param x1 first key pixel
+ * @param x2 last key pixel
+ */
+static void video_run(lv_coord_t y, lv_coord_t x1, lv_coord_t x2)
+{
+    lv_coord_t len = x2 - x1 + 1;
+    stat.video_px += len;
+
+    if(len >= LV_PORT_COMP_RUN_MIN) {
+        uint32_t i;
+        for(i = 0; i < rect_cnt; i++) {
+            if(rects[i].x1 == x1 && rects[i].x2 == x2 && rects[i].y2 == y - 1) {
+                rects[i].y2 = y;
+                return;
+            }
+        }
+
+        if(rect_cnt < LV_PORT_COMP_RECT_MAX) {
+            rects[rect_cnt].x1 = x1;
+            rects[rect_cnt].y1 = y;
+            rects[rect_cnt].x2 = x2;
+            rects[rect_cnt].y2 = y;
+            rect_cnt++;
+            return;
+        }
+    }
+
+    lv_coord_t w = lv_area_get_width(strip_area);
+    memcpy(&strip_buf[(uint32_t)y * w + x1],
+           &cam_rd[(uint32_t)(strip_area->y1 + y) * comp_hor + strip_area->x1 + x1], len * sizeof(lv_color_t));
+}
+
+/**
+ * Copy the video into the rectangles which end before a row and drop them
+ * @param y the row in the strip
+ */
+static void rects_copy(lv_coord_t y)
+{
+    lv_coord_t w = lv_area_get_width(strip_area);
+    uint32_t i   = 0;
+
+    while(i < rect_cnt) {
+        const lv_area_t * r = &rects[i];
+        if(r->y2 >= y) {
+            i++;
+            continue;
+        }
+
+        lv_port_blit_copy(&strip_buf[(uint32_t)r->y1 * w + r->x1], w,
+                          &cam_rd[(uint32_t)(strip_area->y1 + r->y1) * comp_hor + strip_area->x1 + r->x1], comp_hor,
+                          lv_area_get_width(r), lv_area_get_height(r));
+        stat.rect_cnt++;
+
+        rect_cnt--;
+        rects[i] = rects[rect_cnt];
+    }
+}
+
+/*The display registered with the driver of the compositor*/
+static lv_disp_t * comp_disp_get(void)
+{
+    lv_disp_t * disp = lv_disp_get_next(NULL);
+    while(disp && disp->driver.flush_cb != comp_flush_cb) disp = lv_disp_get_next(disp);
+
+    return disp;
+}
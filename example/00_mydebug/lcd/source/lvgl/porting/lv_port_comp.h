@@ -0,0 +1,151 @@
+/**
+ * @file lv_port_comp.h
+ * Compositor of the camera video and the GUI: the video is captured into a surface (e.g. in the SDRAM)
+ * and merged into the strips of LVGL where the GUI has the colour key
+ */
+
+#ifndef LV_PORT_COMP_H
+#define LV_PORT_COMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The default colour key: the GUI is transparent where it has this colour*/
+#define LV_PORT_COMP_KEY            LV_COLOR_MAKE(0xFF, 0x00, 0xFF)
+
+/*Video runs of a row shorter than this are copied at once. The longer ones are collected to rectangles
+ *which are copied with lv_port_blit (DMA if they are big enough).*/
+#define LV_PORT_COMP_RUN_MIN        8
+
+/*Max. number of video rectangles collected in a strip*/
+#define LV_PORT_COMP_RECT_MAX       8U
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Counters of the camera and of the last refresh
+ */
+typedef struct
+{
+    uint32_t cam_cnt;     /**< Captured camera frames*/
+    uint32_t drop_cnt;    /**< Captured camera frames which were overwritten before they were shown*/
+    uint32_t frame_cnt;   /**< Refreshes which showed a new camera frame*/
+    uint32_t video_px;    /**< Pixels of the video in the last refresh (colour key)*/
+    uint32_t blend_px;    /**< Pixels of the GUI mixed with the video in the last refresh*/
+    uint32_t rect_cnt;    /**< Video rectangles copied with lv_port_blit in the last refresh*/
+    uint32_t comp_us;     /**< Composing the strips of the last refresh [us]*/
+} lv_port_comp_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Set up the display driver to merge the camera video into the strips before they are flushed.
+ * Call it before `lv_disp_drv_register()`, after `lv_port_pipe_init()` (the strips) and `lv_port_blit_init()`.
+ * The original `flush_cb` gets the composed strips, the original `render_start_cb` and `monitor_cb` are called too.
+ * It doesn't work with screen sized buffers (`lv_port_fb`): the video would stay in the GUI's buffer.
+ * The compositor is disabled after the init.
+ * @param drv pointer to the initialized display driver
+ * @param cam1 a camera surface (`hor_res * ver_res` pixels)
+ * @param cam2 an other camera surface to capture while `cam1` is shown or NULL (the video can tear)
+ * @param time_us get a free running time stamp in microseconds
+ */
+void lv_port_comp_init(lv_disp_drv_t * drv, lv_color_t * cam1, lv_color_t * cam2, uint32_t (*time_us)(void));
+
+/**
+ * Set the functions which mask the interrupt of the camera's frame end (`lv_port_comp_cam_frame_end()`).
+ * The start of a refresh takes the last camera frame with the interrupt masked.
+ * Without them the frame end must not interrupt the rendering (e.g. it's polled by the main loop).
+ * @param lock mask the interrupt and return the previous state (e.g. save PRIMASK and disable the interrupts)
+ * @param unlock restore the state returned by `lock`
+ */
+void lv_port_comp_set_irq_lock(uint32_t (*lock)(void), void (*unlock)(uint32_t state));
+
+/**
+ * Enable or disable the video. If disabled the strips are flushed as they are rendered.
+ * @param en true: show the video where the GUI has the colour key
+ */
+void lv_port_comp_enable(bool en);
+
+/**
+ * Tell whether the video is enabled
+ * @return true: enabled
+ */
+bool lv_port_comp_is_enabled(void);
+
+/**
+ * Set the colour key of the GUI. Keep the anti-aliased edges away from it
+ * (e.g. use it only for the background of the screen).
+ * @param key the GUI is transparent where it has this colour
+ */
+void lv_port_comp_set_key(lv_color_t key);
+
+/**
+ * Get the colour key of the GUI
+ * @return the colour key
+ */
+lv_color_t lv_port_comp_get_key(void);
+
+/**
+ * Set the opacity of the GUI above the video
+ * @param opa LV_OPA_COVER: the GUI covers the video ... LV_OPA_TRANSP: only the video
+ */
+void lv_port_comp_set_opa(lv_opa_t opa);
+
+/**
+ * Set the area of the video. The colour key is kept outside of it.
+ * @param area the area on the screen (the default is the whole screen)
+ */
+void lv_port_comp_set_area(const lv_area_t * area);
+
+/**
+ * Get the surface which the camera writes now. Its rows are `hor_res` pixels long.
+ * @return the surface
+ */
+lv_color_t * lv_port_comp_get_cam_buf(void);
+
+/**
+ * Tell that a camera frame is captured. Call it from the interrupt of the frame end.
+ * @return the surface to capture the next frame into
+ */
+lv_color_t * lv_port_comp_cam_frame_end(void);
+
+/**
+ * Tell whether a new camera frame waits to be shown
+ * @return true: call `lv_port_comp_handler()` and `lv_task_handler()`
+ */
+bool lv_port_comp_frame_pending(void);
+
+/**
+ * Invalidate the area of the video if a new camera frame is captured.
+ * Call it periodically before `lv_task_handler()`.
+ */
+void lv_port_comp_handler(void);
+
+/**
+ * Get the counters of the camera and of the last refresh
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_port_comp_get_stat(lv_port_comp_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PORT_COMP_H*/
@@ -10,11 +10,75 @@
  *      INCLUDES
  *********************/
 #include "lv_port_disp_template.h"
+#include "lv_port_flush.h"
+#include "lv_port_blit.h"
+#include "lv_port_pipe.h"
+#include "lv_port_fb.h"
+#include "lv_port_comp.h"
 #include "hc32_ddl_lcd.h"
 
 /*********************
  *      DEFINES
  *********************/
+/*DMA channel sending the display buffer to the LCD (DMA1 CH0..2 and DMA2 CH0..1 are used by the DVP)*/
+#define DISP_DMA_UNIT           (M4_DMA2)
+#define DISP_DMA_CH             (DMA_CH2)
+#define DISP_DMA_TC_INT         (DMA_TC_INT_CH2)
+#define DISP_DMA_TC_INT_SRC     (INT_DMA2_TC2)
+#define DISP_DMA_BTC_EVT        (EVT_DMA2_BTC2)
+#define DISP_DMA_IRQn           (Int008_IRQn)
+
+/*DMA channel of the 2D fills and copies (lv_port_blit)*/
+#define BLIT_DMA_UNIT           (M4_DMA2)
+#define BLIT_DMA_CH             (DMA_CH3)
+#define BLIT_DMA_TC_INT         (DMA_TC_INT_CH3)
+#define BLIT_DMA_BTC_EVT        (EVT_DMA2_BTC3)
+
+/*Data register of the LCD on the EXMC*/
+#define DISP_LCD_DATA_ADDR      (0x60002000UL)
+
+/*Rows in one display buffer if the linker doesn't give a SRAMH block for them*/
+#define DISP_BUF_ROWS           10
+
+/*1: render into two screen sized frame buffers in the SDRAM (true double buffering) instead of the strips.
+ *Select it with LV_PORT_DISP_SDRAM_FB in lv_conf.h: it sets LV_VER_RES_MAX to 800 too.
+ *The SDRAM has to be initialized before lv_port_disp_init().*/
+#ifdef LV_PORT_DISP_SDRAM_FB
+#define DISP_SDRAM_FB           LV_PORT_DISP_SDRAM_FB
+#else
+#define DISP_SDRAM_FB           0
+#endif
+/*The frame buffers: 2 * 480 * 800 * 2 bytes after the shadow of the panel (see main.c)*/
+#define DISP_SDRAM_FB_ADDR      (0x80100000UL)
+
+/*1: merge the camera video into the strips where the GUI has the colour key (lv_port_comp).
+ *The camera writes its frames into two screen sized surfaces in the SDRAM, after the frame buffers.
+ *It needs the strips, so it's off with the frame buffers.*/
+#define DISP_CAM_COMP           (!DISP_SDRAM_FB)
+#define DISP_CAM_SDRAM_ADDR     (0x80280000UL)
+
+#if DISP_SDRAM_FB && LV_VER_RES_MAX != 800
+#error "The frame buffers are as tall as the panel: set LV_PORT_DISP_SDRAM_FB in lv_conf.h instead of DISP_SDRAM_FB"
+#endif
+
+#if DISP_CAM_COMP && DISP_SDRAM_FB
+#error "The compositor needs the strips: DISP_CAM_COMP and DISP_SDRAM_FB can't be used together"
+#endif
+
+/*1: pace the refresh with the tearing effect output of the NT35510 (TEON is set by NT35510_Init).
+ *Wire the TE pad of the panel to DISP_TE_PIN first: it's not connected on the board.
+ *0: the refresh runs with LV_DISP_DEF_REFR_PERIOD and the flushes are not paced.*/
+#define DISP_TE                 0
+#define DISP_TE_PORT            (GPIO_PORT_B)
+#define DISP_TE_PIN             (GPIO_PIN_05)
+#define DISP_TE_EXINT_CH        (EXINT_CH05)
+#define DISP_TE_INT_SRC         (INT_PORT_EIRQ5)
+#define DISP_TE_IRQn            (Int009_IRQn)
+
+/*Vertical blanking of the NT35510 in rows (back and front porch)*/
+#define DISP_TE_BLANK_LINES     16
+/*Bus time of a pixel: 4 EXCLK (120 MHz) cycles and the turnaround. It's measured later.*/
+#define DISP_TE_PX_NS           40
 
 /**********************
  *      TYPEDEFS
@@ -24,17 +88,52 @@
  *  STATIC PROTOTYPES
  **********************/
 static void disp_init(void);
-
-static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+static void disp_dma_init(void);
+
+static void disp_write_reg(uint16_t reg, uint16_t data);
+static void disp_write_cmd(uint16_t cmd);
+static void disp_dma_start(const lv_color_t * src, uint16_t blk_size, uint16_t blk_cnt);
+static void disp_dma_tc_irq(void);
+#if DISP_TE
+static void disp_te_init(void);
+static void disp_te_irq(void);
+#endif
+static uint32_t disp_time_us(void);
+#if DISP_CAM_COMP
+static uint32_t disp_irq_lock(void);
+static void disp_irq_unlock(uint32_t u32Primask);
+#endif
 #if LV_USE_GPU
-static void gpu_blend(lv_disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
-static void gpu_fill(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
-        const lv_area_t * fill_area, lv_color_t color);
+static void blit_dma_init(void);
+static void blit_dma_xfer(const lv_port_blit_dma_t * xfer);
 #endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if DISP_SDRAM_FB
+static lv_color_t * const disp_fb = (lv_color_t *)DISP_SDRAM_FB_ADDR;
+#elif defined (__ICCARM__)
+/*The rest of SRAMH for the strip buffers (see the linker configuration)*/
+#pragma section = "DISP_STRIP"
+#else
+static lv_color_t disp_strip[2 * LV_HOR_RES_MAX * DISP_BUF_ROWS];
+#endif
+
+static const lv_port_flush_hw_t disp_hw = {
+    .write_reg = disp_write_reg,
+    .write_cmd = disp_write_cmd,
+    .dma_start = disp_dma_start,
+    .bus_wait  = NULL,
+    .time_us   = disp_time_us,
+    .wait_us   = NULL,
+};
+
+#if LV_USE_GPU
+static const lv_port_blit_hw_t blit_hw = {
+    .dma_xfer = blit_dma_xfer,
+};
+#endif
 
 /**********************
  *      MACROS
@@ -44,8 +143,6 @@ static void gpu_fill(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t
  *   GLOBAL FUNCTIONS
  **********************/
 
-
-
 void lv_port_disp_init(void)
 {
     /*-------------------------
@@ -76,17 +173,19 @@ void lv_port_disp_init(void)
      * */
 
     /* Example for 1) */
-    static lv_disp_buf_t disp_buf_1;
-    static lv_color_t buf1_1[LV_HOR_RES_MAX * 10];                      /*A buffer for 10 rows*/
-    lv_disp_buf_init(&disp_buf_1, buf1_1, NULL, LV_HOR_RES_MAX * 10);   /*Initialize the display buffer*/
+//    static lv_disp_buf_t disp_buf_1;
+//    static lv_color_t buf1_1[LV_HOR_RES_MAX * 10];                      /*A buffer for 10 rows*/
+//    lv_disp_buf_init(&disp_buf_1, buf1_1, NULL, LV_HOR_RES_MAX * 10);   /*Initialize the display buffer*/
 
-    /* Example for 2) */
+    /* Example for 2): the DMA sends one buffer while the other is drawn.
+     * lv_port_pipe creates them from the free SRAMH in lv_port_pipe_init() below. */
 //    static lv_disp_buf_t disp_buf_2;
 //    static lv_color_t buf2_1[LV_HOR_RES_MAX * 10];                        /*A buffer for 10 rows*/
 //    static lv_color_t buf2_2[LV_HOR_RES_MAX * 10];                        /*An other buffer for 10 rows*/
 //    lv_disp_buf_init(&disp_buf_2, buf2_1, buf2_2, LV_HOR_RES_MAX * 10);   /*Initialize the display buffer*/
-//
-//    /* Example for 3) */
+
+    /* Example for 3): lv_port_fb sends the front buffer while the next frame is drawn into the other one.
+     * It's set up with the buffers in the SDRAM below if DISP_SDRAM_FB is 1. */
 //    static lv_disp_buf_t disp_buf_3;
 //    static lv_color_t buf3_1[LV_HOR_RES_MAX * LV_VER_RES_MAX];            /*A screen sized buffer*/
 //    static lv_color_t buf3_2[LV_HOR_RES_MAX * LV_VER_RES_MAX];            /*An other screen sized buffer*/
@@ -107,23 +206,66 @@ void lv_port_disp_init(void)
     disp_drv.ver_res = LV_VER_RES_MAX;
 
     /*Used to copy the buffer's content to the display*/
-    disp_drv.flush_cb = disp_flush;
-
-    /*Set a display buffer*/
-    disp_drv.buffer = &disp_buf_1;
+    disp_drv.flush_cb = lv_port_flush_cb;
 
-#if LV_USE_GPU
-    /*Optionally add functions to access the GPU. (Only in buffered mode, LV_VDB_SIZE != 0)*/
+#if DISP_SDRAM_FB
+    /*Set two frame buffers: the refreshed areas are copied to the other one by DMA
+     *and sent to the panel while the next frame is drawn.*/
+    lv_port_fb_init(&disp_drv, disp_fb, disp_fb + LV_HOR_RES_MAX * LV_VER_RES_MAX, disp_time_us);
+#else
+    /*Set two strip buffers: a strip is drawn while the previous one is sent.
+     *The strip height follows the cost of the drawing and the sending.*/
+#if defined (__ICCARM__)
+    lv_port_pipe_init(&disp_drv, __section_begin("DISP_STRIP"), __section_size("DISP_STRIP"), disp_time_us);
+#else
+    lv_port_pipe_init(&disp_drv, disp_strip, sizeof(disp_strip), disp_time_us);
+#endif
+#endif  /*DISP_SDRAM_FB*/
 
-    /*Blend two color array using opacity*/
-    disp_drv.gpu_blend_cb = gpu_blend;
+#if DISP_CAM_COMP
+    /*The camera is shown behind the GUI when the compositor is enabled*/
+    lv_color_t * cam = (lv_color_t *)DISP_CAM_SDRAM_ADDR;
+    lv_port_comp_init(&disp_drv, cam, cam + LV_HOR_RES_MAX * LV_VER_RES_MAX, disp_time_us);
+    lv_port_comp_set_irq_lock(disp_irq_lock, disp_irq_unlock);
+#endif
 
-    /*Fill a memory array with a color*/
-    disp_drv.gpu_fill_cb = gpu_fill;
+#if LV_USE_GPU
+    /*Fill and copy big rectangles with the DMA (lv_port_blit). Small ones are done by the CPU.*/
+    disp_drv.gpu_fill_cb = lv_port_blit_gpu_fill_cb;
+    disp_drv.gpu_copy_cb = lv_port_blit_gpu_copy_cb;
 #endif
 
     /*Finally register the driver*/
+#if DISP_TE
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
+
+    /*Start the refresh on the TE pulses and keep the flushes away from the scan*/
+    lv_port_flush_te_cfg_t te_cfg;
+    te_cfg.line_num    = NT35510_LCD_PIXEL_HEIGHT;
+    te_cfg.blank_lines = DISP_TE_BLANK_LINES;
+    te_cfg.px_ns       = DISP_TE_PX_NS;
+    te_cfg.refr_div    = 1;
+    lv_port_flush_te_init(disp, &te_cfg);
+#else
     lv_disp_drv_register(&disp_drv);
+#endif
+}
+
+/* Wait for the last flush and set the whole panel as window.
+ * Call it before something else (e.g. the camera) writes the LCD from the cursor position.
+ * The shadow of the differential flush doesn't match the panel after that. */
+void lv_port_disp_full_window(void)
+{
+    lv_area_t area;
+
+    while(lv_port_flush_is_busy());
+    lv_port_flush_shadow_invalidate();
+
+    area.x1 = 0;
+    area.y1 = 0;
+    area.x2 = NT35510_LCD_PIXEL_WIDTH - 1;
+    area.y2 = NT35510_LCD_PIXEL_HEIGHT - 1;
+    lv_port_flush_set_window(&area);
 }
 
 /**********************
@@ -140,130 +282,225 @@ static void disp_init(void)
 
     /* Turn on backlight */
     BSP_LCD_BKLCmd(EIO_PIN_SET);
+
+    /*The DWT cycle counter gives the time stamps of disp_time_us()*/
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    disp_dma_init();
+#if DISP_TE
+    disp_te_init();
+#endif
+#if LV_USE_GPU
+    blit_dma_init();
+#endif
 }
 
-/* Flush the content of the internal buffer the specific area on the display
- * You can use DMA or any hardware acceleration to do this operation in the background but
- * 'lv_disp_flush_ready()' has to be called when finished. */
-uint32_t cc=5000;
-extern uint8_t cam_state;
-//extern uint16_t test_buf[800];
-static void disp_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+/* Set up the DMA which sends the display buffer to the LCD data register.
+ * Every finished block (line) triggers the next one, the first block is started by the AOS
+ * software trigger. The transfer complete interrupt tells the flush engine that the area is sent. */
+static void disp_dma_init(void)
 {
-    static uint32_t cnt = 0;
-//    cnt = 100;
-#if 1
-    uint32_t size;
-    uint32_t line_size;
-    uint32_t row_num = ((area->y2)-(area->y1)+1);
-    line_size = (area->x2)-(area->x1)+1;
-    size = ((area->y2)-(area->y1)+1)*((area->x2)-(area->x1)+1);
-    for (uint32_t row = 0; row < row_num; row++)
-    {
-        cnt = cc;
-        while(cam_state);
-        /* Set cursor */
-        NT35510_SetCursor(area->x1, area->y1+row);
-//        NT35510_SetCursor(area->x1, area->y1+row);
-//        NT35510_SetCursor(area->x1, area->y1+row);
-//        __asm("nop");
-//        __asm("nop");
-//        __asm("nop");
-        do {
-          __asm("nop");
-        } while(cnt--);
-//        DDL_DelayMS(1);
-
-        /* Prepare to write to LCD RAM */
-        LCD_WriteReg(lcddev.wramcmd);
-#if 1//use CPU
-        for (uint32_t i = 0; i < line_size; i++)
-        {
-            //LCD_WriteData(color_p->full);
-            *(uint16_t *)(0x60002000UL) = color_p->full;
-            color_p++;
-//            cnt++;
-        }
-#else//use DMA
-        DMA_SetSrcAddr(M4_DMA1, DMA_CH0, (uint32_t)color_p);
-//        DMA_SetDestAddr(M4_DMA1, DMA_CH0, (uint32_t)0x1FFEA864);
-//        DMA_SetBlockSize(M4_DMA1, DMA_CH0, line_size/2);
-        DMA_SetTransCnt(M4_DMA1, DMA_CH0, line_size);
-        DMA_ChannelCmd(M4_DMA1, DMA_CH0, Enable);
-        AOS_SW_Trigger();
-        while(Reset == DMA_GetTransIntStatus(M4_DMA1, DMA_TC_INT0))
-        {
-            AOS_SW_Trigger();
-            //DDL_DelayMS(1);
-        }
-        DMA_ClearTransIntStatus(M4_DMA1, DMA_TC_INT0);
-//        if(memcmp(color_p, test_buf, line_size))
-//        {
-//          while(1);
-//        }
-#endif
-    }
+    stc_dma_init_t stcDmaInit;
+    stc_irq_signin_config_t stcIrqSignConfig;
+
+    DMA_StructInit(&stcDmaInit);
+    stcDmaInit.u32DestAddr  = DISP_LCD_DATA_ADDR;
+    stcDmaInit.u32DataWidth = DMA_DATAWIDTH_16BIT;
+    stcDmaInit.u32DestInc   = DMA_DEST_ADDR_FIX;
+    stcDmaInit.u32SrcInc    = DMA_SRC_ADDR_INC;
+    stcDmaInit.u32IntEn     = DMA_INT_ENABLE;
+    stcDmaInit.u32TransCnt  = 1UL;
+    stcDmaInit.u32BlockSize = LV_HOR_RES_MAX;
+    DMA_Init(DISP_DMA_UNIT, DISP_DMA_CH, &stcDmaInit);
+
+    DMA_SetTriggerSrc(DISP_DMA_UNIT, DISP_DMA_CH, DISP_DMA_BTC_EVT);
+    AOS_COM_Trigger1(EVT_AOS_STRG);
+    DMA_ComTriggerCmd(DISP_DMA_UNIT, DISP_DMA_CH, DMA_COM_TRIG1, Enable);
+
+    stcIrqSignConfig.enIntSrc   = DISP_DMA_TC_INT_SRC;
+    stcIrqSignConfig.enIRQn     = DISP_DMA_IRQn;
+    stcIrqSignConfig.pfnCallback= &disp_dma_tc_irq;
+    INTC_IrqSignIn(&stcIrqSignConfig);
+
+    NVIC_ClearPendingIRQ(DISP_DMA_IRQn);
+    NVIC_SetPriority(DISP_DMA_IRQn, DDL_IRQ_PRIORITY_03);
+    NVIC_EnableIRQ(DISP_DMA_IRQn);
+
+    DMA_Cmd(DISP_DMA_UNIT, Enable);
+
+    lv_port_flush_init(&disp_hw);
+}
 
+static void disp_write_reg(uint16_t reg, uint16_t data)
+{
+    NT35510_WriteReg(reg, data);
+}
 
-#else
-    /*The most simple case (but also the slowest) to put all pixels to the screen one-by-one*/
-
-    int32_t x;
-    int32_t y;
-//    GPIO_TogglePins(TEST_PORT, TEST_PIN);
-////    NT35510_SetCursor(area->x1, area->y1);
-////    LCD_WriteReg(NT35510_WRITE_RAM);
-    for(y = area->y1; y <= area->y2; y++) {
-        for(x = area->x1; x <= area->x2; x++) {
-            /* Put a pixel to the display. For example: */
-            /* put_px(x, y, *color_p)*/
-//          GPIO_TogglePins(TEST_PORT, TEST_PIN);
-            NT35510_WritePixel(x, y, color_p->full);
-////          LCD_WriteData(color_p->full);
-//            GPIO_TogglePins(TEST_PORT, TEST_PIN);
-            color_p++;
-            cnt++;
-
-        }
+static void disp_write_cmd(uint16_t cmd)
+{
+    LCD_WriteReg(cmd);
+}
+
+/* Send `blk_cnt` lines of `blk_size` pixels in the background */
+static void disp_dma_start(const lv_color_t * src, uint16_t blk_size, uint16_t blk_cnt)
+{
+    DMA_SetSrcAddr(DISP_DMA_UNIT, DISP_DMA_CH, (uint32_t)src);
+    DMA_SetBlockSize(DISP_DMA_UNIT, DISP_DMA_CH, blk_size);
+    DMA_SetTransCnt(DISP_DMA_UNIT, DISP_DMA_CH, blk_cnt);
+    DMA_ChannelCmd(DISP_DMA_UNIT, DISP_DMA_CH, Enable);
+    AOS_SW_Trigger();
+}
+
+static void disp_dma_tc_irq(void)
+{
+    DMA_ClearTransIntStatus(DISP_DMA_UNIT, DISP_DMA_TC_INT);
+    lv_port_flush_dma_isr();
+}
+
+#if DISP_TE
+/* Capture the TE pulses on the rising edge (the start of the vertical blanking).
+ * The HC32F4A0 has no internal pull-down: the pin is pulled up, so a broken wire keeps it high
+ * and gives no rising edges. The push-pull TE output of the panel overrides the pull-up.
+ * The Schmitt input and the digital filter drop the short spikes. */
+static void disp_te_init(void)
+{
+    stc_gpio_init_t stcGpioInit;
+    stc_exint_init_t stcExintInit;
+    stc_irq_signin_config_t stcIrqSignConfig;
+
+    GPIO_StructInit(&stcGpioInit);
+    stcGpioInit.u16PullUp   = PIN_PU_ON;
+    stcGpioInit.u16PinIType = PIN_ITYPE_SMT;
+    stcGpioInit.u16ExInt    = PIN_EXINT_ON;
+    GPIO_Init(DISP_TE_PORT, DISP_TE_PIN, &stcGpioInit);
+
+    EXINT_StructInit(&stcExintInit);
+    stcExintInit.u32ExIntCh    = DISP_TE_EXINT_CH;
+    stcExintInit.u32ExIntFAE   = EXINT_FILTER_A_ON;
+    stcExintInit.u32ExIntFAClk = EXINT_FACLK_HCLK_DIV64;
+    stcExintInit.u32ExIntLvl   = EXINT_TRIGGER_RISING;
+    EXINT_Init(&stcExintInit);
+
+    stcIrqSignConfig.enIntSrc   = DISP_TE_INT_SRC;
+    stcIrqSignConfig.enIRQn     = DISP_TE_IRQn;
+    stcIrqSignConfig.pfnCallback= &disp_te_irq;
+    INTC_IrqSignIn(&stcIrqSignConfig);
+
+    NVIC_ClearPendingIRQ(DISP_TE_IRQn);
+    NVIC_SetPriority(DISP_TE_IRQn, DDL_IRQ_PRIORITY_02);
+    NVIC_EnableIRQ(DISP_TE_IRQn);
+}
+
+static void disp_te_irq(void)
+{
+    if(Set == EXINT_GetExIntSrc(DISP_TE_EXINT_CH)) {
+        EXINT_ClrExIntSrc(DISP_TE_EXINT_CH);
+        lv_port_flush_te_isr();
     }
-//    GPIO_TogglePins(TEST_PORT, TEST_PIN);
-#endif
-    /* IMPORTANT!!!
-     * Inform the graphics library that you are ready with the flushing*/
-//    cnt++;
-    lv_disp_flush_ready(disp_drv);
+}
+#endif  /*DISP_TE*/
+
+/* Microseconds from the DWT cycle counter. It's called from the TE interrupt too. */
+static uint32_t disp_time_us(void)
+{
+    static uint32_t u32LastCyc = 0UL;
+    static uint32_t u32CycRem = 0UL;
+    static uint32_t u32Us = 0UL;
+    const uint32_t u32CycPerUs = SystemCoreClock / 1000000UL;
+
+    uint32_t u32Primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t u32Cyc = DWT->CYCCNT;
+    u32CycRem += u32Cyc - u32LastCyc;
+    u32LastCyc = u32Cyc;
+    u32Us += u32CycRem / u32CycPerUs;
+    u32CycRem %= u32CycPerUs;
+    uint32_t u32Ret = u32Us;
+    __set_PRIMASK(u32Primask);
+
+    return u32Ret;
+}
+
+#if DISP_CAM_COMP
+/* Mask the interrupts (the DVP frame end calls lv_port_comp_cam_frame_end()) */
+static uint32_t disp_irq_lock(void)
+{
+    uint32_t u32Primask = __get_PRIMASK();
+    __disable_irq();
+
+    return u32Primask;
 }
 
+static void disp_irq_unlock(uint32_t u32Primask)
+{
+    __set_PRIMASK(u32Primask);
+}
+#endif  /*DISP_CAM_COMP*/
 
 /*OPTIONAL: GPU INTERFACE*/
 #if LV_USE_GPU
 
-/* If your MCU has hardware accelerator (GPU) then you can use it to blend to memories using opacity
- * It can be used only in buffered mode (LV_VDB_SIZE != 0 in lv_conf.h)*/
-static void gpu_blend(lv_disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+/* Set up the DMA of the 2D fills and copies. Like the display DMA every finished block (row)
+ * triggers the next one and the first block is started by the AOS software trigger.
+ * The software trigger is shared with the display DMA: an extra request there only starts
+ * its next block, the transfer count still limits the transfer. */
+static void blit_dma_init(void)
 {
-    /*It's an example code which should be done by your GPU*/
-    uint32_t i;
-    for(i = 0; i < length; i++) {
-        dest[i] = lv_color_mix(dest[i], src[i], opa);
-    }
+    stc_dma_init_t stcDmaInit;
+
+    DMA_StructInit(&stcDmaInit);
+    stcDmaInit.u32IntEn     = DMA_INT_DISABLE;
+    stcDmaInit.u32TransCnt  = 1UL;
+    stcDmaInit.u32BlockSize = 1UL;
+    DMA_Init(BLIT_DMA_UNIT, BLIT_DMA_CH, &stcDmaInit);
+
+    DMA_SetTriggerSrc(BLIT_DMA_UNIT, BLIT_DMA_CH, BLIT_DMA_BTC_EVT);
+    DMA_ComTriggerCmd(BLIT_DMA_UNIT, BLIT_DMA_CH, DMA_COM_TRIG1, Enable);
+
+    lv_port_blit_init(&blit_hw);
 }
 
-/* If your MCU has hardware accelerator (GPU) then you can use it to fill a memory with a color
- * It can be used only in buffered mode (LV_VDB_SIZE != 0 in lv_conf.h)*/
-static void gpu_fill(lv_disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
-                    const lv_area_t * fill_area, lv_color_t color)
+/* Run a 2D transfer prepared by lv_port_blit and wait for its end */
+static void blit_dma_xfer(const lv_port_blit_dma_t * xfer)
 {
-    /*It's an example code which should be done by your GPU*/
-    int32_t x, y;
-    dest_buf += dest_width * fill_area->y1; /*Go to the first line*/
-
-    for(y = fill_area->y1; y <= fill_area->y2; y++) {
-        for(x = fill_area->x1; x <= fill_area->x2; x++) {
-            dest_buf[x] = color;
-        }
-        dest_buf+=dest_width;    /*Go to the next line*/
-    }
+    stc_dma_init_t stcDmaInit;
+    stc_dma_rpt_init_t stcDmaRptInit;
+    stc_dma_nonseq_init_t stcDmaNonSeqInit;
+
+    DMA_StructInit(&stcDmaInit);
+    stcDmaInit.u32IntEn     = DMA_INT_DISABLE;
+    stcDmaInit.u32SrcAddr   = (uint32_t)xfer->src;
+    stcDmaInit.u32DestAddr  = (uint32_t)xfer->dest;
+    stcDmaInit.u32DataWidth = xfer->width == 4 ? DMA_DATAWIDTH_32BIT :
+                              xfer->width == 2 ? DMA_DATAWIDTH_16BIT : DMA_DATAWIDTH_8BIT;
+    stcDmaInit.u32SrcInc    = xfer->src_fix ? DMA_SRC_ADDR_FIX : DMA_SRC_ADDR_INC;
+    stcDmaInit.u32DestInc   = DMA_DEST_ADDR_INC;
+    stcDmaInit.u32BlockSize = xfer->blk_size;
+    stcDmaInit.u32TransCnt  = xfer->blk_cnt;
+    DMA_Init(BLIT_DMA_UNIT, BLIT_DMA_CH, &stcDmaInit);
+
+    DMA_RepeatStructInit(&stcDmaRptInit);
+    stcDmaRptInit.u32SrcRptEn   = xfer->src_rpt ? DMA_SRC_RPT_ENABLE : DMA_SRC_RPT_DISABLE;
+    stcDmaRptInit.u32SrcRptSize = xfer->src_rpt;
+    DMA_RepeatInit(BLIT_DMA_UNIT, BLIT_DMA_CH, &stcDmaRptInit);
+
+    DMA_NonSeqStructInit(&stcDmaNonSeqInit);
+    stcDmaNonSeqInit.u32SrcNonSeqEn  = xfer->src_ns_cnt ? DMA_SRC_NS_ENABLE : DMA_SRC_NS_DISABLE;
+    stcDmaNonSeqInit.u32SrcNonSeqCnt = xfer->src_ns_cnt;
+    stcDmaNonSeqInit.u32SrcNonSeqOfs = xfer->src_ns_ofs;
+    stcDmaNonSeqInit.u32DestNonSeqEn = xfer->dest_ns_cnt ? DMA_DEST_NS_ENABLE : DMA_DEST_NS_DISABLE;
+    DMA_NonSeqInit(BLIT_DMA_UNIT, BLIT_DMA_CH, &stcDmaNonSeqInit);
+    /*DMA_NonSeqInit() writes only SNSEQCTL*/
+    DMA_SetNonSeqDestCnt(BLIT_DMA_UNIT, BLIT_DMA_CH, xfer->dest_ns_cnt);
+    DMA_SetNonSeqDestOffset(BLIT_DMA_UNIT, BLIT_DMA_CH, xfer->dest_ns_ofs);
+
+    DMA_ClearTransIntStatus(BLIT_DMA_UNIT, BLIT_DMA_TC_INT);
+    DMA_ChannelCmd(BLIT_DMA_UNIT, BLIT_DMA_CH, Enable);
+    AOS_SW_Trigger();
+
+    while(Reset == DMA_GetTransIntStatus(BLIT_DMA_UNIT, BLIT_DMA_TC_INT));
+    DMA_ClearTransIntStatus(BLIT_DMA_UNIT, BLIT_DMA_TC_INT);
 }
 
 #endif  /*LV_USE_GPU*/
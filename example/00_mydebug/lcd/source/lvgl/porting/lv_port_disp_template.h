@@ -29,6 +29,8 @@ extern "C" {
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
+void lv_port_disp_init(void);
+void lv_port_disp_full_window(void);
 
 /**********************
  *      MACROS
@@ -0,0 +1,233 @@
+/**
+ * @file lv_port_fb.c
+ * True double buffering with two screen sized frame buffers (e.g. in the SDRAM):
+ * the panel is fed from the front buffer in the background and the buffers are synchronized with DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_port_fb.h"
+#include "lv_port_flush.h"
+#include "lv_port_blit.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The bus time of a pixel is measured on the feeds with at least this many pixels*/
+#define FEED_MEAS_MIN       1024U
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fb_render_start_cb(lv_disp_drv_t * drv);
+static void fb_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void fb_sync_cb(lv_disp_drv_t * drv, lv_color_t * dest, const lv_color_t * src, const lv_area_t * area);
+static void fb_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static void feed_eval(uint32_t busy_start, uint32_t busy_end);
+static uint32_t px_ns_avg(uint32_t avg, uint32_t px_ns);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_buf_t fb_buf;
+static void (*monitor_ori)(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static uint32_t (*fb_time_us)(void);
+
+static const lv_color_t * front;    /*The last flushed frame buffer*/
+static lv_area_t areas[LV_PORT_FLUSH_DIFF_RECT_MAX];    /*Refreshed areas to send from `front`*/
+static uint32_t area_cnt;
+
+static uint32_t render_start;       /*The rendering started [us]*/
+static uint32_t render_end;
+static uint32_t copy_sum;
+static uint32_t copy_px_sum;
+
+static bool feed_act;               /*A feed was started and not evaluated yet*/
+static uint32_t feed_start;         /*The feed was started [us]*/
+static uint32_t feed_dma_start;     /*DMA time of the flush engine at the start [us]*/
+static uint32_t feed_px;
+static lv_port_fb_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Set up the display driver for true double buffering with two screen sized frame buffers.
+ * LVGL renders into the back buffer, then the refreshed areas are sent to the panel from it
+ * by `lv_port_flush` in the background while the next frame is rendered into the other buffer.
+ * The refreshed areas are copied to the other buffer with `lv_port_blit` (DMA).
+ * Call it before `lv_disp_drv_register()`, after `lv_port_flush_init()` and `lv_port_blit_init()`.
+ * The original `monitor_cb` is called after the counters of the refresh are updated.
+ * @param drv pointer to the initialized display driver
+ * @param fb1 the first frame buffer (`hor_res * ver_res` pixels)
+ * @param fb2 the second frame buffer (`hor_res * ver_res` pixels)
+ * @param time_us get a free running time stamp in microseconds
+ */
+void lv_port_fb_init(lv_disp_drv_t * drv, lv_color_t * fb1, lv_color_t * fb2, uint32_t (*time_us)(void))
+{
+    fb_time_us = time_us;
+
+    /*Screen sized buffers switch LVGL to true double buffering*/
+    lv_disp_buf_init(&fb_buf, fb1, fb2, (uint32_t)drv->hor_res * drv->ver_res);
+
+    monitor_ori = drv->monitor_cb;
+
+    drv->buffer          = &fb_buf;
+    drv->flush_cb        = fb_flush_cb;
+    drv->monitor_cb      = fb_monitor_cb;
+    drv->render_start_cb = fb_render_start_cb;
+    drv->sync_cb         = fb_sync_cb;
+
+    area_cnt = 0;
+    feed_act = false;
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**
+ * Get the counters of the last refresh
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_port_fb_get_stat(lv_port_fb_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void fb_render_start_cb(lv_disp_drv_t * drv)
+{
+    (void)drv;
+
+    render_start = fb_time_us();
+    copy_sum     = 0;
+    copy_px_sum  = 0;
+    area_cnt     = 0;
+}
+
+/* The rendered buffer becomes the front buffer. It's sent to the panel after the buffers are synchronized,
+ * so LVGL can go on immediately. */
+static void fb_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    (void)area;
+
+    front      = color_p;
+    render_end = fb_time_us();
+
+    lv_disp_flush_ready(drv);
+}
+
+/* Copy a refreshed area to the new back buffer and note it for the feed of the panel */
+static void fb_sync_cb(lv_disp_drv_t * drv, lv_color_t * dest, const lv_color_t * src, const lv_area_t * area)
+{
+    uint32_t start = fb_time_us();
+    uint32_t ofs   = (uint32_t)area->y1 * drv->hor_res + area->x1;
+
+    lv_port_blit_copy(dest + ofs, drv->hor_res, src + ofs, drv->hor_res, lv_area_get_width(area),
+                      lv_area_get_height(area));
+
+    copy_sum += fb_time_us() - start;
+    copy_px_sum += lv_area_get_size(area);
+
+    /*Too many areas: send their bounding box*/
+    if(area_cnt < LV_PORT_FLUSH_DIFF_RECT_MAX) {
+        areas[area_cnt] = *area;
+        area_cnt++;
+    } else {
+        lv_area_join(&areas[area_cnt - 1], &areas[area_cnt - 1], area);
+    }
+}
+
+/* All areas are rendered and copied: send them to the panel from the front buffer */
+static void fb_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    uint32_t busy_end = fb_time_us();
+
+    /*The previous feed reads the buffer of the next rendering*/
+    while(lv_port_flush_is_busy()) lv_port_flush_wait();
+    uint32_t now = fb_time_us();
+
+    if(feed_act) feed_eval(render_start, busy_end);
+
+    lv_port_flush_stat_t flush_stat;
+    lv_port_flush_get_stat(&flush_stat);
+    uint32_t px_start = flush_stat.px_cnt;
+    feed_dma_start    = flush_stat.dma_us;
+    feed_start        = now;
+
+    lv_port_flush_fb(front, drv->hor_res, areas, area_cnt);
+
+    lv_port_flush_get_stat(&flush_stat);
+    feed_px  = flush_stat.px_cnt - px_start;
+    feed_act = true;
+
+    stat.frame_cnt++;
+    stat.render_us = render_end - render_start;
+    stat.copy_us   = copy_sum;
+    stat.copy_px   = copy_px_sum;
+    stat.wait_us   = now - busy_end;
+
+    if(monitor_ori) monitor_ori(drv, time, px);
+}
+
+/**
+ * Evaluate the finished feed. It ran while the next frame was rendered and copied
+ * (from `busy_start` to `busy_end`). The pixels sent before and after this overlap went with the
+ * quiet speed measured on the feeds without overlap, the rest shows the speed with the contention.
+ * @param busy_start the rendering started [us]
+ * @param busy_end the copying ended [us]
+ */
+static void feed_eval(uint32_t busy_start, uint32_t busy_end)
+{
+    lv_port_flush_stat_t flush_stat;
+    lv_port_flush_get_stat(&flush_stat);
+
+    uint32_t feed_us  = flush_stat.dma_us - feed_dma_start;
+    uint32_t feed_end = feed_start + feed_us;
+    uint32_t ovl_end  = (int32_t)(busy_end - feed_end) < 0 ? busy_end : feed_end;
+    uint32_t overlap  = (int32_t)(ovl_end - busy_start) > 0 ? ovl_end - busy_start : 0;
+
+    feed_act        = false;
+    stat.feed_us    = feed_us;
+    stat.feed_px    = feed_px;
+    stat.overlap_us = overlap;
+
+    if(feed_px < FEED_MEAS_MIN) return;
+
+    if(overlap == 0) {
+        stat.quiet_px_ns = px_ns_avg(stat.quiet_px_ns, (uint32_t)((uint64_t)feed_us * 1000 / feed_px));
+        return;
+    }
+
+    if(stat.quiet_px_ns == 0) return;
+
+    uint32_t quiet_px = (uint32_t)((uint64_t)(feed_us - overlap) * 1000 / stat.quiet_px_ns);
+    if(quiet_px >= feed_px) return;
+
+    stat.busy_px_ns = px_ns_avg(stat.busy_px_ns, (uint32_t)((uint64_t)overlap * 1000 / (feed_px - quiet_px)));
+    if(stat.busy_px_ns > stat.quiet_px_ns) {
+        stat.contention = (uint16_t)((stat.busy_px_ns - stat.quiet_px_ns) * 100 / stat.quiet_px_ns);
+    } else {
+        stat.contention = 0;
+    }
+}
+
+/*Smooth the measured bus times: the first one is taken as it is*/
+static uint32_t px_ns_avg(uint32_t avg, uint32_t px_ns)
+{
+    if(avg == 0) return px_ns;
+
+    return (3 * avg + px_ns + 3) / 4;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file lv_port_fb.h
+ * True double buffering with two screen sized frame buffers (e.g. in the SDRAM):
+ * the panel is fed from the front buffer in the background and the buffers are synchronized with DMA
+ */
+
+#ifndef LV_PORT_FB_H
+#define LV_PORT_FB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Counters of the last refresh and of the last finished feed of the panel
+ */
+typedef struct
+{
+    uint32_t frame_cnt;   /**< Number of refreshes*/
+    uint32_t render_us;   /**< Rendering into the back buffer [us]*/
+    uint32_t copy_us;     /**< Copying the refreshed areas to the other frame buffer [us]*/
+    uint32_t copy_px;     /**< Copied pixels*/
+    uint32_t wait_us;     /**< Waiting for the end of the previous feed [us]*/
+    uint32_t feed_us;     /**< Sending the last finished frame to the panel [us]*/
+    uint32_t feed_px;     /**< Pixels of the last finished frame*/
+    uint32_t overlap_us;  /**< The last feed ran while the rendering and the copying used the SDRAM [us]*/
+    uint32_t quiet_px_ns; /**< Bus time of a pixel of the feed alone [ns]*/
+    uint32_t busy_px_ns;  /**< Bus time of a pixel of the feed while the rendering and the copying run [ns]*/
+    uint16_t contention;  /**< Slow down of the feed by the other SDRAM accesses: (busy - quiet) / quiet [%]*/
+} lv_port_fb_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Set up the display driver for true double buffering with two screen sized frame buffers.
+ * LVGL renders into the back buffer, then the refreshed areas are sent to the panel from it
+ * by `lv_port_flush` in the background while the next frame is rendered into the other buffer.
+ * The refreshed areas are copied to the other buffer with `lv_port_blit` (DMA).
+ * Call it before `lv_disp_drv_register()`, after `lv_port_flush_init()` and `lv_port_blit_init()`.
+ * The original `monitor_cb` is called after the counters of the refresh are updated.
+ * @param drv pointer to the initialized display driver
+ * @param fb1 the first frame buffer (`hor_res * ver_res` pixels)
+ * @param fb2 the second frame buffer (`hor_res * ver_res` pixels)
+ * @param time_us get a free running time stamp in microseconds
+ */
+void lv_port_fb_init(lv_disp_drv_t * drv, lv_color_t * fb1, lv_color_t * fb2, uint32_t (*time_us)(void));
+
+/**
+ * Get the counters of the last refresh
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_port_fb_get_stat(lv_port_fb_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PORT_FB_H*/
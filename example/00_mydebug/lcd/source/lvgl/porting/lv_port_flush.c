@@ -0,0 +1,843 @@
+/**
+ * @file lv_port_flush.c
+ * Flush engine for 8080 bus panels (NT35510) fed by DMA
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_port_flush.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*One command or data write is a 16 bit bus cycle*/
+#define BUS_CYCLE_BYTES     2U
+
+/*The bus time of a pixel is measured on the transfers with at least this many pixels*/
+#define PX_MEAS_MIN         256U
+
+/*Bus bytes of a window setting (CASET and RASET with 4 parameters each)*/
+#define WIN_BYTES           (8U * 2U * BUS_CYCLE_BYTES)
+
+/*Cost of a new window in the differential flush in bus time of pixels: CASET, RASET and RAMWR (17 cycles)
+ *and restarting the DMA. Unchanged pixels shorter than this between two changed ones are sent rather
+ *than starting a new window.*/
+#define DIFF_WIN_PX         24U
+
+/*Cost of starting the DMA for every line of a rectangle narrower than the area [px]*/
+#define DIFF_LINE_PX        8U
+
+/*Max. number of changed spans in a row. Further spans are joined to the last one.*/
+#define DIFF_SPAN_MAX       8U
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    lv_coord_t x1;
+    lv_coord_t x2;
+} diff_span_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void dma_next(void);
+static void flush_done(uint32_t now);
+static void rects_send(void);
+static void rect_start(const lv_area_t * rect);
+static bool diff_build(const lv_area_t * area, const lv_color_t * color_p);
+static uint32_t diff_row(const lv_color_t * src, const lv_color_t * shadow, lv_coord_t w, diff_span_t * spans);
+static lv_coord_t diff_skip_equal(const lv_color_t * src, const lv_color_t * shadow, lv_coord_t x, lv_coord_t w);
+static bool diff_add(lv_coord_t y, lv_coord_t x1, lv_coord_t x2);
+static void shadow_copy(const lv_area_t * rect);
+static void te_wait(const lv_area_t * area);
+static void te_delay(uint32_t us);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const lv_port_flush_hw_t * hw;
+static lv_disp_drv_t * flush_drv;
+static const lv_color_t * flush_src;
+static uint32_t flush_line_px;
+static uint32_t flush_remain_px;
+static uint32_t flush_stride;       /*Pixels between the start of two lines in the source*/
+static volatile bool flush_busy;
+static lv_port_flush_stat_t stat;
+
+static uint32_t flush_call_time;    /*`lv_port_flush_cb()` was called [us]*/
+static uint32_t flush_dma_time;     /*The first pixel was sent [us]*/
+static uint32_t flush_px;
+static uint32_t flush_deadline;     /*The last pixel has to be sent until this to not be caught by the scan [us]*/
+static bool flush_deadline_en;
+static uint32_t bus_px_ns;          /*Estimated bus time of a pixel [ns] (0: not known yet)*/
+static bool flush_meas;             /*The flush is one transfer: the bus time can be measured on it*/
+
+static lv_color_t * shadow_buf;     /*Copy of the panel's content (NULL: no differential flush)*/
+static lv_coord_t shadow_hor;
+static lv_coord_t shadow_ver;
+static uint8_t shadow_valid[(LV_PORT_FLUSH_SHADOW_ROWS_MAX + 7) / 8];  /*The row of the shadow matches the panel*/
+static lv_area_t flush_area;        /*The area being flushed and its pixels (rectangles of it are sent)*/
+static const lv_color_t * flush_color;
+static lv_area_t rects[LV_PORT_FLUSH_DIFF_RECT_MAX];    /*Rectangles of the area to send with their own window*/
+static uint32_t rect_cnt;
+static uint32_t rect_act;           /*Index of the next rectangle to send*/
+
+static lv_port_flush_te_cfg_t te_cfg;
+static lv_disp_t * te_disp;
+static bool te_en;
+static volatile bool te_seen;       /*A TE pulse came since the init*/
+static volatile bool te_pending;
+static volatile uint32_t te_time;   /*Time stamp of the last TE pulse [us]*/
+static volatile uint32_t te_period; /*Measured frame time [us] (0: not known yet or not plausible)*/
+static uint8_t te_div_cnt;
+static bool te_refr_paced;          /*The refresh task waits for the TE pulses*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize the flush engine
+ * @param hw_p pointer to the bus and DMA interface. Only the pointer is saved.
+ */
+void lv_port_flush_init(const lv_port_flush_hw_t * hw_p)
+{
+    hw         = hw_p;
+    flush_busy = false;
+    shadow_buf = NULL;
+    te_en      = false;
+    te_pending = false;
+    te_period  = 0;
+    te_refr_paced = false;
+    bus_px_ns  = 0;
+    lv_port_flush_reset_stat();
+}
+
+/**
+ * Flush an area to the panel. Can be used as `flush_cb` of the display driver.
+ * The window is set once and the pixels are sent with DMA, so the function returns
+ * before the data is on the panel. `lv_disp_flush_ready()` is called from `lv_port_flush_dma_isr()`.
+ * @param disp_drv pointer to the display driver
+ * @param area the area to flush
+ * @param color_p the pixels of `area`
+ */
+void lv_port_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    if(hw->time_us) flush_call_time = hw->time_us();
+
+    stat.flush_cnt++;
+    flush_drv     = disp_drv;
+    flush_area    = *area;
+    flush_color   = color_p;
+    flush_stride  = lv_area_get_width(area);
+    rect_cnt = 0;
+    rect_act = 0;
+
+    bool diff = false;
+    if(shadow_buf && area->x1 >= 0 && area->y1 >= 0 && area->x2 < shadow_hor && area->y2 < shadow_ver) {
+        diff = diff_build(area, color_p);
+
+        /*The shadow shows the panel as it will be after the flush*/
+        if(diff) {
+            uint32_t i;
+            for(i = 0; i < rect_cnt; i++) shadow_copy(&rects[i]);
+        } else {
+            shadow_copy(area);
+        }
+
+        /*Nothing has changed*/
+        if(diff && rect_cnt == 0) {
+            lv_disp_flush_ready(disp_drv);
+            return;
+        }
+    }
+
+    if(hw->bus_wait) hw->bus_wait();
+
+    flush_deadline_en = false;
+    if(te_en) te_wait(area);
+
+    if(diff) {
+        stat.diff_cnt++;
+        rects_send();
+        return;
+    }
+
+    lv_port_flush_set_window(area);
+    hw->write_cmd(LV_PORT_FLUSH_CMD_RAMWR);
+    stat.bus_bytes += BUS_CYCLE_BYTES;
+
+    flush_src       = color_p;
+    flush_line_px   = flush_stride;
+    flush_remain_px = lv_area_get_size(area);
+    flush_px        = flush_remain_px;
+    flush_meas      = true;
+    flush_busy      = true;
+    if(hw->time_us) flush_dma_time = hw->time_us();
+
+    stat.px_cnt += flush_px;
+    stat.bus_bytes += flush_px * sizeof(lv_color_t);
+
+    dma_next();
+}
+
+/**
+ * Send areas of a frame buffer to the panel in the background, e.g. the front buffer in true double buffering.
+ * Every area is sent with its own window. `lv_disp_flush_ready()` is not called:
+ * the frame buffer can be written again when `lv_port_flush_is_busy()` returns false.
+ * Call it only when the engine is not busy. The shadow of the differential flush is invalidated.
+ * @param fb pointer to the frame buffer
+ * @param hor_res width of the frame buffer in pixels
+ * @param areas the areas to send. They are copied.
+ * @param area_cnt number of areas. With more than `LV_PORT_FLUSH_DIFF_RECT_MAX` the bounding box of them is sent.
+ */
+void lv_port_flush_fb(const lv_color_t * fb, lv_coord_t hor_res, const lv_area_t * areas, uint32_t area_cnt)
+{
+    if(area_cnt == 0) return;
+
+    if(hw->time_us) flush_call_time = hw->time_us();
+
+    stat.flush_cnt++;
+    flush_drv    = NULL;
+    flush_color  = fb;
+    flush_stride = hor_res;
+    rect_act     = 0;
+
+    lv_area_t bound = areas[0];
+    uint32_t i;
+    for(i = 1; i < area_cnt; i++) lv_area_join(&bound, &bound, &areas[i]);
+
+    if(area_cnt > LV_PORT_FLUSH_DIFF_RECT_MAX) {
+        rects[0] = bound;
+        rect_cnt = 1;
+    } else {
+        memcpy(rects, areas, area_cnt * sizeof(lv_area_t));
+        rect_cnt = area_cnt;
+    }
+
+    /*The rectangles are relative to the start of the frame buffer*/
+    flush_area.x1 = 0;
+    flush_area.y1 = 0;
+    flush_area.x2 = hor_res - 1;
+    flush_area.y2 = bound.y2;
+
+    /*The shadow of the differential flush isn't updated (it would be a copy of the frame buffer)*/
+    if(shadow_buf) lv_port_flush_shadow_invalidate();
+
+    if(hw->bus_wait) hw->bus_wait();
+
+    flush_deadline_en = false;
+    if(te_en) te_wait(&bound);
+
+    rects_send();
+}
+
+/**
+ * Set the column and row address window of the panel. The RAM write will wrap inside it.
+ * @param area the new window
+ */
+void lv_port_flush_set_window(const lv_area_t * area)
+{
+    hw->write_reg(LV_PORT_FLUSH_CMD_CASET + 0, (uint16_t)area->x1 >> 8);
+    hw->write_reg(LV_PORT_FLUSH_CMD_CASET + 1, (uint16_t)area->x1 & 0xFF);
+    hw->write_reg(LV_PORT_FLUSH_CMD_CASET + 2, (uint16_t)area->x2 >> 8);
+    hw->write_reg(LV_PORT_FLUSH_CMD_CASET + 3, (uint16_t)area->x2 & 0xFF);
+    hw->write_reg(LV_PORT_FLUSH_CMD_RASET + 0, (uint16_t)area->y1 >> 8);
+    hw->write_reg(LV_PORT_FLUSH_CMD_RASET + 1, (uint16_t)area->y1 & 0xFF);
+    hw->write_reg(LV_PORT_FLUSH_CMD_RASET + 2, (uint16_t)area->y2 >> 8);
+    hw->write_reg(LV_PORT_FLUSH_CMD_RASET + 3, (uint16_t)area->y2 & 0xFF);
+
+    stat.win_cnt++;
+    stat.bus_bytes += WIN_BYTES;
+}
+
+/**
+ * Handle the transfer complete event of the DMA. Call it from the DMA TC interrupt.
+ */
+void lv_port_flush_dma_isr(void)
+{
+    if(flush_busy == false) return;
+
+    dma_next();
+}
+
+/**
+ * Tell whether a flush is in progress
+ * @return true: the DMA is still sending
+ */
+bool lv_port_flush_is_busy(void)
+{
+    return flush_busy;
+}
+
+/**
+ * Let the time pass while LVGL waits for the end of a flush: call `wait_us` of the interface if it's set.
+ * Can be called from the `wait_cb` of the display driver.
+ */
+void lv_port_flush_wait(void)
+{
+    if(hw->wait_us) hw->wait_us(1);
+}
+
+/**
+ * Get the time the DMA was sending since the last reset of the counters, including the running transfer.
+ * Needs `time_us` in the interface.
+ * @return the sending time [us]
+ */
+uint32_t lv_port_flush_get_busy_us(void)
+{
+    if(hw->time_us == NULL) return 0;
+
+    uint32_t busy_us = stat.dma_us;
+    if(flush_busy) busy_us += hw->time_us() - flush_dma_time;
+
+    return busy_us;
+}
+
+/**
+ * Estimate the time until the running flush is finished from the measured speed of the bus.
+ * Needs `time_us` in the interface.
+ * @return the remaining time [us] (0: no flush is running)
+ */
+uint32_t lv_port_flush_get_remain_us(void)
+{
+    if(hw->time_us == NULL || flush_busy == false) return 0;
+
+    uint32_t total_us = (uint32_t)(((uint64_t)flush_px * bus_px_ns + 999) / 1000);
+    uint32_t elaps_us = hw->time_us() - flush_dma_time;
+
+    return total_us > elaps_us ? total_us - elaps_us : 0;
+}
+
+/**
+ * Pace the refreshes and the flushes with the TE signal of the panel.
+ * The refresh of `disp` is started on the TE pulse and the areas are sent only when the scan of the panel
+ * can't catch them in a half written state: ahead of the scan in the blanking and on the top, or behind it.
+ * Needs `time_us` in the interface. Call `lv_port_flush_init()` again to switch it off.
+ * @param disp the display to refresh on TE (NULL: only pace the flushes)
+ * @param cfg the timing of the panel. It's copied.
+ */
+void lv_port_flush_te_init(lv_disp_t * disp, const lv_port_flush_te_cfg_t * cfg)
+{
+    if(hw->time_us == NULL) {
+        LV_LOG_WARN("lv_port_flush_te_init: no time_us in the interface");
+        return;
+    }
+
+    te_cfg = *cfg;
+    if(te_cfg.refr_div == 0) te_cfg.refr_div = 1;
+
+    te_disp    = disp;
+    te_seen    = false;
+    te_pending = false;
+    te_period  = 0;
+    te_div_cnt = 0;
+    te_refr_paced = false;
+    bus_px_ns  = te_cfg.px_ns;
+    te_en      = true;
+}
+
+/**
+ * Handle a TE pulse. Call it from the interrupt of the TE pin (rising edge).
+ */
+void lv_port_flush_te_isr(void)
+{
+    if(te_en == false) return;
+
+    uint32_t now = hw->time_us();
+    uint32_t period = now - te_time;
+
+    /*Sooner than a frame can be: noise (e.g. on an unconnected pin)*/
+    if(te_seen && period < LV_PORT_FLUSH_TE_PERIOD_MIN) {
+        stat.te_noise_cnt++;
+        return;
+    }
+
+    /*After a long gap the next period is measured again. Only a plausible period starts the refresh.*/
+    te_period = (te_seen && period <= LV_PORT_FLUSH_TE_PERIOD_MAX) ? period : 0;
+    te_time = now;
+    te_seen = true;
+    stat.te_cnt++;
+    if(te_period == 0) return;
+
+    te_div_cnt++;
+    if(te_div_cnt < te_cfg.refr_div) return;
+    te_div_cnt = 0;
+
+    /*The refresh of the previous pulse hasn't been started*/
+    if(te_pending) stat.miss_cnt++;
+    te_pending = true;
+}
+
+/**
+ * Tell whether a refresh is due because of a TE pulse.
+ * The main loop shouldn't sleep if it's true.
+ * @return true: `lv_port_flush_te_handler()` will start a refresh
+ */
+bool lv_port_flush_te_pending(void)
+{
+    return te_pending;
+}
+
+/**
+ * Start the refresh if a TE pulse came. Call it in the main loop before `lv_task_handler()`.
+ * @return true: the refresh task was made ready
+ */
+bool lv_port_flush_te_handler(void)
+{
+    if(te_pending == false) {
+        /*The pulses are lost: the refresh task runs with its own period again*/
+        if(te_refr_paced && (te_period == 0 || hw->time_us() - te_time > 2 * te_period)) {
+            lv_task_set_period(te_disp->refr_task, LV_DISP_DEF_REFR_PERIOD);
+            te_refr_paced = false;
+        }
+        return false;
+    }
+
+    te_pending = false;
+    stat.refr_cnt++;
+
+    /*From the first valid period the refresh is started by TE, the task's own period is only a fallback*/
+    if(te_disp) {
+        lv_task_set_period(te_disp->refr_task, LV_PORT_FLUSH_TE_TIMEOUT);
+        lv_task_ready(te_disp->refr_task);
+        te_refr_paced = true;
+    }
+
+    return true;
+}
+
+/**
+ * Send only the changed parts of the areas. A copy of the panel's content (the shadow) is kept
+ * and every area is compared with it: only the rectangles around the changed pixels are sent,
+ * each with its own window. If the changes are dense the area is sent in full.
+ * The shadow is large (e.g. 750 kB for 480x800) and is read and written by the CPU, so the SDRAM is a good place for it.
+ * Call `lv_port_flush_init()` again to switch it off.
+ * @param shadow memory for `hor_res * ver_res` pixels (the content doesn't matter)
+ * @param hor_res horizontal resolution of the panel (max. `LV_PORT_FLUSH_DMA_BLK_MAX`)
+ * @param ver_res vertical resolution of the panel (max. `LV_PORT_FLUSH_SHADOW_ROWS_MAX`)
+ */
+void lv_port_flush_shadow_init(lv_color_t * shadow, lv_coord_t hor_res, lv_coord_t ver_res)
+{
+    /*A line of a rectangle has to fit into a DMA block*/
+    if(hor_res > (lv_coord_t)LV_PORT_FLUSH_DMA_BLK_MAX || ver_res > (lv_coord_t)LV_PORT_FLUSH_SHADOW_ROWS_MAX) {
+        LV_LOG_WARN("lv_port_flush_shadow_init: the panel is too large");
+        return;
+    }
+
+    shadow_buf = shadow;
+    shadow_hor = hor_res;
+    shadow_ver = ver_res;
+    lv_port_flush_shadow_invalidate();
+}
+
+/**
+ * Tell the flush engine that the panel's content is unknown, e.g. something else wrote the panel.
+ * The rows are sent in full until they are sent on the whole width again.
+ */
+void lv_port_flush_shadow_invalidate(void)
+{
+    memset(shadow_valid, 0, sizeof(shadow_valid));
+}
+
+/**
+ * Get the counters of the flush engine
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_port_flush_get_stat(lv_port_flush_stat_t * stat_p)
+{
+    *stat_p           = stat;
+    stat_p->te_period = te_period;
+}
+
+/**
+ * Clear the counters of the flush engine
+ */
+void lv_port_flush_reset_stat(void)
+{
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Start the DMA with the next part of the area or report the end of the flush.
+ * Normally the whole area is one transfer (a block is a line), it's split only if
+ * a line or the line count doesn't fit into the DMA's limits.
+ */
+static void dma_next(void)
+{
+    /*The rectangle is sent, continue with the next one*/
+    if(flush_remain_px == 0 && rect_act < rect_cnt) {
+        rect_start(&rects[rect_act]);
+        rect_act++;
+    }
+
+    if(flush_remain_px == 0) {
+        if(hw->time_us) flush_done(hw->time_us());
+        flush_busy = false;
+        if(flush_drv) lv_disp_flush_ready(flush_drv);
+        return;
+    }
+
+    /*The lines of a narrower rectangle are not continuous in the source: send them one by one*/
+    if(flush_line_px != flush_stride) {
+        const lv_color_t * src = flush_src;
+        flush_src += flush_stride;
+        flush_remain_px -= flush_line_px;
+
+        stat.dma_cnt++;
+        hw->dma_start(src, (uint16_t)flush_line_px, 1);
+        return;
+    }
+
+    uint32_t blk_size = flush_line_px;
+    if(blk_size > LV_PORT_FLUSH_DMA_BLK_MAX) blk_size = LV_PORT_FLUSH_DMA_BLK_MAX;
+
+    uint32_t blk_cnt = flush_remain_px / blk_size;
+    if(blk_cnt > LV_PORT_FLUSH_DMA_CNT_MAX) blk_cnt = LV_PORT_FLUSH_DMA_CNT_MAX;
+
+    /*Only a tail shorter than a block is remaining*/
+    if(blk_cnt == 0) {
+        blk_size = flush_remain_px;
+        blk_cnt  = 1;
+    }
+
+    const lv_color_t * src = flush_src;
+    flush_src += blk_size * blk_cnt;
+    flush_remain_px -= blk_size * blk_cnt;
+
+    stat.dma_cnt++;
+    hw->dma_start(src, (uint16_t)blk_size, (uint16_t)blk_cnt);
+}
+
+/**
+ * Update the latency counters and the bus time estimation at the end of a flush
+ * @param now the current time [us]
+ */
+static void flush_done(uint32_t now)
+{
+    uint32_t lat = now - flush_call_time;
+    stat.lat_us_sum += lat;
+    if(lat > stat.lat_us_max) stat.lat_us_max = lat;
+    stat.dma_us += now - flush_dma_time;
+
+    if(te_en && flush_deadline_en && (int32_t)(now - flush_deadline) > 0) stat.late_cnt++;
+
+    /*Follow the real speed of the bus (rounded up to be on the safe side)*/
+    if(flush_meas && flush_px >= PX_MEAS_MIN) {
+        uint32_t px_ns = ((now - flush_dma_time) * 1000 + flush_px - 1) / flush_px;
+        if(bus_px_ns == 0) bus_px_ns = px_ns;
+        else bus_px_ns = (3 * bus_px_ns + px_ns + 3) / 4;
+    }
+}
+
+/**
+ * Start sending the rectangles in `rects`. They are started one by one from `dma_next()`.
+ */
+static void rects_send(void)
+{
+    uint32_t i;
+
+    flush_px = 0;
+    for(i = 0; i < rect_cnt; i++) flush_px += lv_area_get_size(&rects[i]);
+    flush_remain_px = 0;
+    flush_meas      = false;
+    flush_busy      = true;
+    if(hw->time_us) flush_dma_time = hw->time_us();
+
+    stat.px_cnt += flush_px;
+    stat.bus_bytes += flush_px * sizeof(lv_color_t);
+
+    dma_next();
+}
+
+/**
+ * Set the window of a rectangle and prepare sending its pixels
+ * @param rect the rectangle on the panel (inside `flush_area`)
+ */
+static void rect_start(const lv_area_t * rect)
+{
+    lv_port_flush_set_window(rect);
+    hw->write_cmd(LV_PORT_FLUSH_CMD_RAMWR);
+    stat.bus_bytes += BUS_CYCLE_BYTES;
+
+    flush_src       = flush_color + (uint32_t)(rect->y1 - flush_area.y1) * flush_stride + (rect->x1 - flush_area.x1);
+    flush_line_px   = lv_area_get_width(rect);
+    flush_remain_px = lv_area_get_size(rect);
+}
+
+/**
+ * Collect the rectangles around the changed pixels of an area into `rects`.
+ * The changed spans of a row are joined if the gap between them is cheaper to send than a new window.
+ * A span is added to a rectangle of the previous row if the unchanged pixels it adds are cheaper than
+ * a new window too. The rows not matching the panel are changed on the whole width of the area.
+ * @param area the area to send
+ * @param color_p the pixels of `area`
+ * @return true: send the rectangles (maybe none); false: send the whole area
+ */
+static bool diff_build(const lv_area_t * area, const lv_color_t * color_p)
+{
+    lv_coord_t w = lv_area_get_width(area);
+    diff_span_t spans[DIFF_SPAN_MAX];
+    lv_coord_t y;
+
+    for(y = area->y1; y <= area->y2; y++) {
+        const lv_color_t * src    = color_p + (uint32_t)(y - area->y1) * w;
+        const lv_color_t * shadow = shadow_buf + (uint32_t)y * shadow_hor + area->x1;
+        uint32_t span_cnt;
+
+        if(shadow_valid[y >> 3] & (1 << (y & 0x7))) {
+            span_cnt = diff_row(src, shadow, w, spans);
+        } else {
+            spans[0].x1 = 0;
+            spans[0].x2 = w - 1;
+            span_cnt    = 1;
+        }
+
+        uint32_t i;
+        for(i = 0; i < span_cnt; i++) {
+            if(diff_add(y, area->x1 + spans[i].x1, area->x1 + spans[i].x2) == false) {
+                /*Too many rectangles: the area is sent in full, drop the collected ones*/
+                rect_cnt = 0;
+                stat.dense_cnt++;
+                return false;
+            }
+        }
+    }
+
+    /*Compare the bus time of the rectangles with the whole area*/
+    uint32_t area_px = lv_area_get_size(area);
+    uint32_t diff_px = 0;
+    uint32_t cost_px = 0;
+    uint32_t i;
+    for(i = 0; i < rect_cnt; i++) {
+        const lv_area_t * rect = &rects[i];
+        diff_px += lv_area_get_size(rect);
+        cost_px += lv_area_get_size(rect) + DIFF_WIN_PX;
+        if(lv_area_get_width(rect) != w) cost_px += lv_area_get_height(rect) * DIFF_LINE_PX;
+    }
+
+    if(cost_px * 100 >= area_px * LV_PORT_FLUSH_DIFF_DENSE_PCT) {
+        rect_cnt = 0;
+        stat.dense_cnt++;
+        return false;
+    }
+
+    uint32_t full_bytes = WIN_BYTES + BUS_CYCLE_BYTES + area_px * sizeof(lv_color_t);
+    uint32_t diff_bytes = rect_cnt * (WIN_BYTES + BUS_CYCLE_BYTES) + diff_px * sizeof(lv_color_t);
+    if(full_bytes > diff_bytes) stat.saved_bytes += full_bytes - diff_bytes;
+
+    return true;
+}
+
+/**
+ * Find the changed spans of a row
+ * @param src the new pixels
+ * @param shadow the pixels on the panel
+ * @param w number of pixels
+ * @param spans store the spans here (max. `DIFF_SPAN_MAX`), relative to the start of the row
+ * @return number of spans
+ */
+static uint32_t diff_row(const lv_color_t * src, const lv_color_t * shadow, lv_coord_t w, diff_span_t * spans)
+{
+    uint32_t cnt = 0;
+    lv_coord_t x = 0;
+
+    while(1) {
+        x = diff_skip_equal(src, shadow, x, w);
+        if(x >= w) break;
+
+        lv_coord_t x_end = x + 1;
+        while(x_end < w && src[x_end].full != shadow[x_end].full) x_end++;
+
+        /*Join to the previous span if the gap is short or there are too many spans*/
+        if(cnt > 0 && (x - spans[cnt - 1].x2 - 1 <= (lv_coord_t)DIFF_WIN_PX || cnt == DIFF_SPAN_MAX)) {
+            spans[cnt - 1].x2 = x_end - 1;
+        } else {
+            spans[cnt].x1 = x;
+            spans[cnt].x2 = x_end - 1;
+            cnt++;
+        }
+
+        x = x_end;
+    }
+
+    return cnt;
+}
+
+/**
+ * Skip the unchanged pixels. Most of the pixels are unchanged, so with 16 bit colors two of them
+ * are compared at once if the two rows are aligned the same way.
+ * @param src the new pixels
+ * @param shadow the pixels on the panel
+ * @param x start from this pixel
+ * @param w number of pixels
+ * @return index of the first changed pixel (`w` if none)
+ */
+static lv_coord_t diff_skip_equal(const lv_color_t * src, const lv_color_t * shadow, lv_coord_t x, lv_coord_t w)
+{
+#if LV_COLOR_DEPTH == 16
+    if((((lv_uintptr_t)&src[x] ^ (lv_uintptr_t)&shadow[x]) & 0x3) == 0) {
+        if(((lv_uintptr_t)&src[x] & 0x3) && x < w) {
+            if(src[x].full != shadow[x].full) return x;
+            x++;
+        }
+
+        const uint32_t * src32    = (const uint32_t *)&src[x];
+        const uint32_t * shadow32 = (const uint32_t *)&shadow[x];
+        while(x + 1 < w && *src32 == *shadow32) {
+            src32++;
+            shadow32++;
+            x += 2;
+        }
+    }
+#endif
+
+    while(x < w && src[x].full == shadow[x].full) x++;
+
+    return x;
+}
+
+/**
+ * Add a changed span to a rectangle of the previous row or start a new rectangle
+ * @param y the row
+ * @param x1 first changed pixel
+ * @param x2 last changed pixel
+ * @return false: there are too many rectangles
+ */
+static bool diff_add(lv_coord_t y, lv_coord_t x1, lv_coord_t x2)
+{
+    uint32_t i;
+    for(i = 0; i < rect_cnt; i++) {
+        lv_area_t * rect = &rects[i];
+        if(rect->y2 != y - 1) continue;
+
+        lv_coord_t ux1   = LV_MATH_MIN(rect->x1, x1);
+        lv_coord_t ux2   = LV_MATH_MAX(rect->x2, x2);
+        uint32_t uw      = ux2 - ux1 + 1;
+        uint32_t waste   = (uw - (x2 - x1 + 1)) + (uw - lv_area_get_width(rect)) * lv_area_get_height(rect);
+        if(waste <= DIFF_WIN_PX) {
+            rect->x1 = ux1;
+            rect->x2 = ux2;
+            rect->y2 = y;
+            return true;
+        }
+    }
+
+    if(rect_cnt >= LV_PORT_FLUSH_DIFF_RECT_MAX) return false;
+
+    lv_area_t * rect = &rects[rect_cnt];
+    rect->x1 = x1;
+    rect->y1 = y;
+    rect->x2 = x2;
+    rect->y2 = y;
+    rect_cnt++;
+
+    return true;
+}
+
+/**
+ * Copy the pixels of a rectangle of the flushed area into the shadow.
+ * The rows copied on the whole width of the panel match it.
+ * @param rect the rectangle (inside `flush_area`)
+ */
+static void shadow_copy(const lv_area_t * rect)
+{
+    uint32_t w = lv_area_get_width(rect);
+    const lv_color_t * src = flush_color + (uint32_t)(rect->y1 - flush_area.y1) * flush_stride + (rect->x1 - flush_area.x1);
+    lv_color_t * dest = shadow_buf + (uint32_t)rect->y1 * shadow_hor + rect->x1;
+    bool full_w = rect->x1 == 0 && rect->x2 == shadow_hor - 1;
+    lv_coord_t y;
+
+    for(y = rect->y1; y <= rect->y2; y++) {
+        memcpy(dest, src, w * sizeof(lv_color_t));
+        if(full_w) shadow_valid[y >> 3] |= 1 << (y & 0x7);
+        src += flush_stride;
+        dest += shadow_hor;
+    }
+}
+
+/**
+ * Wait until an area can be sent without the scan of the panel catching it half written.
+ * In every frame the panel scans the row `y` at `te_time + (blank_lines + y) * line time`.
+ * The area can be sent if the write stays ahead of the scan (the first and the last row are written
+ * before the scan reaches them) or if the scan has passed the area and the write ends before
+ * the next frame reaches it. Otherwise wait until the scan leaves the area or the next frame begins.
+ * Without recent TE pulses the area is sent immediately.
+ * @param area the area to send
+ */
+static void te_wait(const lv_area_t * area)
+{
+    uint32_t frame_lines = te_cfg.line_num + te_cfg.blank_lines;
+    uint32_t row_us      = (uint32_t)(((uint64_t)lv_area_get_width(area) * bus_px_ns + 999) / 1000);
+    uint32_t write_us    = (uint32_t)(((uint64_t)lv_area_get_size(area) * bus_px_ns + 999) / 1000);
+    uint32_t waited      = 0;
+
+    while(1) {
+        uint32_t period = te_period;
+        uint32_t now    = hw->time_us();
+        uint32_t elaps  = now - te_time;
+
+        /*The frame time isn't known yet or the TE pulses are lost*/
+        if(period == 0 || elaps > 2 * period) return;
+
+        uint32_t line_ns = (period * 1000) / frame_lines;
+        uint32_t y1_us   = ((te_cfg.blank_lines + area->y1) * line_ns) / 1000;
+        uint32_t y2_us   = ((te_cfg.blank_lines + area->y2 + 1) * line_ns) / 1000;
+        uint32_t pos     = elaps % period;
+
+        bool ahead_ok  = row_us <= y1_us && write_us <= y2_us;
+        bool behind_ok = y2_us + write_us <= period + y1_us;
+
+        /*Ahead of the scan*/
+        if(ahead_ok && pos + row_us <= y1_us && pos + write_us <= y2_us) {
+            flush_deadline = now + (y2_us - pos);
+            break;
+        }
+
+        /*Behind the scan*/
+        if(behind_ok && pos >= y2_us && pos + write_us <= period + y1_us) {
+            flush_deadline = now + (period + y1_us - pos);
+            break;
+        }
+
+        /*Can't be sent in one go: start at the beginning of a frame to tear as little as possible*/
+        if((ahead_ok == false && behind_ok == false && pos * 1000 < line_ns) || waited > 2 * period) {
+            flush_deadline = now + (y2_us > pos ? y2_us - pos : 0);
+            break;
+        }
+
+        uint32_t wait_us = (pos < y2_us && behind_ok) ? y2_us - pos : period - pos;
+        te_delay(wait_us);
+        waited += wait_us;
+        stat.wait_us += wait_us;
+    }
+
+    flush_deadline_en = true;
+}
+
+/**
+ * Wait with the DMA running in the background
+ * @param us time to wait [us]
+ */
+static void te_delay(uint32_t us)
+{
+    if(hw->wait_us) {
+        hw->wait_us(us);
+        return;
+    }
+
+    uint32_t start = hw->time_us();
+    while(hw->time_us() - start < us);
+}
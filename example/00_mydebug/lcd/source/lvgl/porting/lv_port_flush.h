@@ -0,0 +1,251 @@
+/**
+ * @file lv_port_flush.h
+ * Flush engine for 8080 bus panels (NT35510) fed by DMA
+ */
+
+#ifndef LV_PORT_FLUSH_H
+#define LV_PORT_FLUSH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*NT35510 commands in 16 bit command mode. The parameter index is added to the command*/
+#define LV_PORT_FLUSH_CMD_CASET     0x2A00
+#define LV_PORT_FLUSH_CMD_RASET     0x2B00
+#define LV_PORT_FLUSH_CMD_RAMWR     0x2C00
+
+/*Limits of one DMA transfer: a block is 1..1024 units, the transfer count is 16 bit*/
+#define LV_PORT_FLUSH_DMA_BLK_MAX   1024U
+#define LV_PORT_FLUSH_DMA_CNT_MAX   0xFFFFU
+
+/*Refresh period if no tearing effect signal comes [ms]. With TE the refresh is started by the signal.*/
+#define LV_PORT_FLUSH_TE_TIMEOUT    (2 * LV_DISP_DEF_REFR_PERIOD)
+
+/*Plausible frame time of the panel [us]. Pulses sooner than the min. are ignored as noise,
+ *the flushes and the refresh are paced only while the measured period is in this range.*/
+#define LV_PORT_FLUSH_TE_PERIOD_MIN 10000U
+#define LV_PORT_FLUSH_TE_PERIOD_MAX 40000U
+
+/*Max. rows of the shadow of the panel in the differential flush (NT35510: 480x800)*/
+#define LV_PORT_FLUSH_SHADOW_ROWS_MAX   800U
+
+/*Max. number of changed rectangles in an area. With more changes the area is sent in full.
+ *It's the max. number of areas of `lv_port_flush_fb()` too.*/
+#define LV_PORT_FLUSH_DIFF_RECT_MAX     32U
+
+/*The changed rectangles are sent only if they take less than this part of the bus time of the whole area [%]*/
+#define LV_PORT_FLUSH_DIFF_DENSE_PCT    75U
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Bus and DMA access used by the flush engine.
+ * On the board it is implemented with the EXMC and the DDL `DMA_*` API,
+ * on the host with the simulated LCD bus and DMA.
+ */
+typedef struct
+{
+    /** Write a command and one parameter (`NT35510_WriteReg`)*/
+    void (*write_reg)(uint16_t reg, uint16_t data);
+
+    /** Write a command without parameter (`LCD_WriteReg`)*/
+    void (*write_cmd)(uint16_t cmd);
+
+    /** Start sending `blk_cnt` blocks of `blk_size` pixels from `src` to the LCD data register
+     * in the background. `lv_port_flush_dma_isr()` has to be called when the transfer is complete.*/
+    void (*dma_start)(const lv_color_t * src, uint16_t blk_size, uint16_t blk_cnt);
+
+    /** OPTIONAL: wait until the bus can be used (e.g. the camera is streaming to the panel)*/
+    void (*bus_wait)(void);
+
+    /** OPTIONAL: get a free running time stamp in microseconds. Needed by the TE pacing and the latency counters.
+     * It's called from `lv_port_flush_te_isr()` too.*/
+    uint32_t (*time_us)(void);
+
+    /** OPTIONAL: wait `us` microseconds (the DMA keeps running). If not set `time_us` is polled.*/
+    void (*wait_us)(uint32_t us);
+} lv_port_flush_hw_t;
+
+/**
+ * Timing of the panel for the TE (tearing effect) pacing.
+ * The TE pulse comes at the start of the vertical blanking, then the panel scans the rows from the top.
+ */
+typedef struct
+{
+    uint16_t line_num;      /**< Scanned rows (the vertical resolution)*/
+    uint16_t blank_lines;   /**< Length of the vertical blanking in rows (back porch + front porch)*/
+    uint16_t px_ns;         /**< Initial estimation of the bus time of a pixel [ns]. It's measured on the transfers later.*/
+    uint8_t refr_div;       /**< Refresh on every `refr_div`th TE pulse (1: on every frame)*/
+} lv_port_flush_te_cfg_t;
+
+/**
+ * Counters of the flush engine
+ */
+typedef struct
+{
+    uint32_t flush_cnt;  /**< Number of flushed areas*/
+    uint32_t win_cnt;    /**< Number of window (CASET/RASET) settings*/
+    uint32_t dma_cnt;    /**< Number of started DMA transfers*/
+    uint32_t px_cnt;     /**< Number of sent pixels*/
+    uint32_t bus_bytes;  /**< Bytes sent on the bus including the commands*/
+    uint32_t te_cnt;     /**< Number of TE pulses*/
+    uint32_t te_noise_cnt; /**< TE pulses ignored because they came sooner than `LV_PORT_FLUSH_TE_PERIOD_MIN`*/
+    uint32_t refr_cnt;   /**< Number of refreshes started by TE*/
+    uint32_t miss_cnt;   /**< Missed vsyncs: the refresh due at a TE pulse couldn't start until the next one*/
+    uint32_t late_cnt;   /**< Areas not sent in time: they might be torn on the panel*/
+    uint32_t wait_us;    /**< Time spent with waiting for the scan*/
+    uint32_t lat_us_sum; /**< Sum of the flush latencies (from the call of the flush until the last pixel) [us]*/
+    uint32_t lat_us_max; /**< Max. flush latency [us]*/
+    uint32_t te_period;  /**< Last measured TE period [us] (0: not known or out of range)*/
+    uint32_t dma_us;     /**< Time the DMA was sending (finished flushes) [us]*/
+    uint32_t diff_cnt;   /**< Areas sent as changed rectangles (differential flush)*/
+    uint32_t dense_cnt;  /**< Areas sent in full because the changes were dense*/
+    uint32_t saved_bytes; /**< Bus bytes saved by the differential flush*/
+} lv_port_flush_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the flush engine
+ * @param hw pointer to the bus and DMA interface. Only the pointer is saved.
+ */
+void lv_port_flush_init(const lv_port_flush_hw_t * hw);
+
+/**
+ * Flush an area to the panel. Can be used as `flush_cb` of the display driver.
+ * The window is set once and the pixels are sent with DMA, so the function returns
+ * before the data is on the panel. `lv_disp_flush_ready()` is called from `lv_port_flush_dma_isr()`.
+ * @param disp_drv pointer to the display driver
+ * @param area the area to flush
+ * @param color_p the pixels of `area`
+ */
+void lv_port_flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+
+/**
+ * Send areas of a frame buffer to the panel in the background, e.g. the front buffer in true double buffering.
+ * Every area is sent with its own window. `lv_disp_flush_ready()` is not called:
+ * the frame buffer can be written again when `lv_port_flush_is_busy()` returns false.
+ * Call it only when the engine is not busy. The shadow of the differential flush is invalidated.
+ * @param fb pointer to the frame buffer
+ * @param hor_res width of the frame buffer in pixels
+ * @param areas the areas to send. They are copied.
+ * @param area_cnt number of areas. With more than `LV_PORT_FLUSH_DIFF_RECT_MAX` the bounding box of them is sent.
+ */
+void lv_port_flush_fb(const lv_color_t * fb, lv_coord_t hor_res, const lv_area_t * areas, uint32_t area_cnt);
+
+/**
+ * Set the column and row address window of the panel. The RAM write will wrap inside it.
+ * @param area the new window
+ */
+void lv_port_flush_set_window(const lv_area_t * area);
+
+/**
+ * Handle the transfer complete event of the DMA. Call it from the DMA TC interrupt.
+ */
+void lv_port_flush_dma_isr(void);
+
+/**
+ * Tell whether a flush is in progress
+ * @return true: the DMA is still sending
+ */
+bool lv_port_flush_is_busy(void);
+
+/**
+ * Let the time pass while LVGL waits for the end of a flush: call `wait_us` of the interface if it's set.
+ * Can be called from the `wait_cb` of the display driver.
+ */
+void lv_port_flush_wait(void);
+
+/**
+ * Get the time the DMA was sending since the last reset of the counters, including the running transfer.
+ * Needs `time_us` in the interface.
+ * @return the sending time [us]
+ */
+uint32_t lv_port_flush_get_busy_us(void);
+
+/**
+ * Estimate the time until the running flush is finished from the measured speed of the bus.
+ * Needs `time_us` in the interface.
+ * @return the remaining time [us] (0: no flush is running)
+ */
+uint32_t lv_port_flush_get_remain_us(void);
+
+/**
+ * Pace the refreshes and the flushes with the TE signal of the panel.
+ * The refresh of `disp` is started on the TE pulse and the areas are sent only when the scan of the panel
+ * can't catch them in a half written state: ahead of the scan in the blanking and on the top, or behind it.
+ * Needs `time_us` in the interface. Call `lv_port_flush_init()` again to switch it off.
+ * @param disp the display to refresh on TE (NULL: only pace the flushes)
+ * @param cfg the timing of the panel. It's copied.
+ */
+void lv_port_flush_te_init(lv_disp_t * disp, const lv_port_flush_te_cfg_t * cfg);
+
+/**
+ * Handle a TE pulse. Call it from the interrupt of the TE pin (rising edge).
+ */
+void lv_port_flush_te_isr(void);
+
+/**
+ * Tell whether a refresh is due because of a TE pulse.
+ * The main loop shouldn't sleep if it's true.
+ * @return true: `lv_port_flush_te_handler()` will start a refresh
+ */
+bool lv_port_flush_te_pending(void);
+
+/**
+ * Start the refresh if a TE pulse came. Call it in the main loop before `lv_task_handler()`.
+ * @return true: the refresh task was made ready
+ */
+bool lv_port_flush_te_handler(void);
+
+/**
+ * Send only the changed parts of the areas. A copy of the panel's content (the shadow) is kept
+ * and every area is compared with it: only the rectangles around the changed pixels are sent,
+ * each with its own window. If the changes are dense the area is sent in full.
+ * The shadow is large (e.g. 750 kB for 480x800) and is read and written by the CPU, so the SDRAM is a good place for it.
+ * Call `lv_port_flush_init()` again to switch it off.
+ * @param shadow memory for `hor_res * ver_res` pixels (the content doesn't matter)
+ * @param hor_res horizontal resolution of the panel (max. `LV_PORT_FLUSH_DMA_BLK_MAX`)
+ * @param ver_res vertical resolution of the panel (max. `LV_PORT_FLUSH_SHADOW_ROWS_MAX`)
+ */
+void lv_port_flush_shadow_init(lv_color_t * shadow, lv_coord_t hor_res, lv_coord_t ver_res);
+
+/**
+ * Tell the flush engine that the panel's content is unknown, e.g. something else wrote the panel.
+ * The rows are sent in full until they are sent on the whole width again.
+ */
+void lv_port_flush_shadow_invalidate(void);
+
+/**
+ * Get the counters of the flush engine
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_port_flush_get_stat(lv_port_flush_stat_t * stat);
+
+/**
+ * Clear the counters of the flush engine
+ */
+void lv_port_flush_reset_stat(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PORT_FLUSH_H*/
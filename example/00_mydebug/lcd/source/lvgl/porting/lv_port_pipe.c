@@ -0,0 +1,245 @@
+/**
+ * @file lv_port_pipe.c
+ * Pipelined strip rendering: two strip buffers from a memory block and a strip height
+ * adapted to the cost of the rendering and the flushing
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_port_pipe.h"
+#include "lv_port_flush.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void pipe_render_start_cb(lv_disp_drv_t * drv);
+static void pipe_wait_cb(lv_disp_drv_t * drv);
+static void pipe_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void pipe_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static void pipe_adapt(void);
+static void pipe_set_size(lv_coord_t rows);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_buf_t pipe_buf;
+static void (*flush_ori)(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void (*monitor_ori)(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static uint32_t (*pipe_time_us)(void);
+
+static lv_coord_t pipe_hor_res;
+static lv_coord_t rows_max;
+static lv_coord_t rows_min;
+static lv_coord_t rows_act;
+static lv_coord_t rows_fix;
+
+static bool frame_act;
+static uint32_t frame_start;    /*The rendering started [us]*/
+static uint32_t busy_start;     /*DMA time of the flush engine at the start [us]*/
+static bool waiting;
+static uint32_t wait_start;
+static uint32_t spin_sum;       /*Waiting in LVGL for the end of the previous flush [us]*/
+static uint32_t cb_sum;         /*Spent in the flush_cb (setting the window, TE pacing) [us]*/
+static uint32_t saved_start;    /*Saved bytes of the flush engine at the start*/
+static lv_port_pipe_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Split a memory block into two strip buffers and set up the display driver to render
+ * a strip while the previous one is sent. Call it before `lv_disp_drv_register()`.
+ * `flush_cb` has to be `lv_port_flush_cb` (or a wrapper of it). The original `monitor_cb`
+ * is called after the counters of the refresh are updated.
+ * @param drv pointer to the initialized display driver
+ * @param mem memory of the buffers (e.g. the free part of SRAMH)
+ * @param mem_size size of `mem` in bytes
+ * @param time_us get a free running time stamp in microseconds
+ */
+void lv_port_pipe_init(lv_disp_drv_t * drv, void * mem, uint32_t mem_size, uint32_t (*time_us)(void))
+{
+    pipe_hor_res = drv->hor_res;
+    pipe_time_us = time_us;
+
+    /*A screen sized buffer would switch LVGL to true double buffering*/
+    uint32_t rows = mem_size / 2 / sizeof(lv_color_t) / (uint32_t)pipe_hor_res;
+    if(rows >= (uint32_t)drv->ver_res) rows = drv->ver_res - 1;
+    if(rows == 0) {
+        LV_LOG_ERROR("lv_port_pipe_init: not enough memory for a row");
+        return;
+    }
+
+    rows_max = (lv_coord_t)rows;
+    rows_min = LV_MATH_MIN(LV_PORT_PIPE_ROWS_MIN, rows_max);
+    rows_fix = 0;
+
+    lv_color_t * buf1 = mem;
+    lv_color_t * buf2 = buf1 + (uint32_t)rows_max * pipe_hor_res;
+    lv_disp_buf_init(&pipe_buf, buf1, buf2, (uint32_t)rows_max * pipe_hor_res);
+    pipe_set_size(rows_max);
+
+    flush_ori   = drv->flush_cb;
+    monitor_ori = drv->monitor_cb;
+
+    drv->buffer          = &pipe_buf;
+    drv->flush_cb        = pipe_flush_cb;
+    drv->monitor_cb      = pipe_monitor_cb;
+    drv->render_start_cb = pipe_render_start_cb;
+    drv->wait_cb         = pipe_wait_cb;
+
+    frame_act = false;
+    waiting   = false;
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**
+ * Get the max. strip height which fits into the buffers
+ * @return number of rows
+ */
+lv_coord_t lv_port_pipe_get_rows_max(void)
+{
+    return rows_max;
+}
+
+/**
+ * Set a fixed strip height or let it be adapted
+ * @param rows the strip height (0: adapt it to the measured costs)
+ */
+void lv_port_pipe_set_rows(lv_coord_t rows)
+{
+    if(rows > rows_max) rows = rows_max;
+    rows_fix = rows;
+
+    if(rows_fix != 0) pipe_set_size(rows_fix);
+}
+
+/**
+ * Get the counters of the last refresh
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_port_pipe_get_stat(lv_port_pipe_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void pipe_render_start_cb(lv_disp_drv_t * drv)
+{
+    (void)drv;
+
+    frame_act   = true;
+    frame_start = pipe_time_us();
+    busy_start  = lv_port_flush_get_busy_us();
+    spin_sum    = 0;
+
+    lv_port_flush_stat_t flush_stat;
+    lv_port_flush_get_stat(&flush_stat);
+    saved_start = flush_stat.saved_bytes;
+    cb_sum      = 0;
+}
+
+/* Called in LVGL's loop while the other buffer is being sent */
+static void pipe_wait_cb(lv_disp_drv_t * drv)
+{
+    (void)drv;
+
+    if(waiting == false) {
+        waiting    = true;
+        wait_start = pipe_time_us();
+    }
+
+    lv_port_flush_wait();
+}
+
+static void pipe_flush_cb(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    uint32_t start = pipe_time_us();
+    if(waiting) {
+        spin_sum += start - wait_start;
+        waiting = false;
+    }
+
+    flush_ori(drv, area, color_p);
+
+    cb_sum += pipe_time_us() - start;
+}
+
+/**
+ * Close the counters of the refresh. The last strip is still being sent: its remaining time is estimated.
+ * The DMA runs only when LVGL doesn't wait for it in `flush_cb` so the DMA time without the waiting
+ * overlapped the rendering.
+ */
+static void pipe_monitor_cb(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    if(frame_act) {
+        uint32_t busy_end = lv_port_flush_get_busy_us();
+        uint32_t busy_us  = busy_end >= busy_start ? busy_end - busy_start : 0;
+        uint32_t remain   = lv_port_flush_get_remain_us();
+        uint32_t win_us   = pipe_time_us() - frame_start;
+        lv_port_flush_stat_t flush_stat;
+        lv_port_flush_get_stat(&flush_stat);
+
+        stat.frame_cnt++;
+        stat.frame_us   = win_us + remain;
+        stat.wait_us    = spin_sum + cb_sum;
+        stat.render_us  = win_us > stat.wait_us ? win_us - stat.wait_us : 0;
+        stat.flush_us   = busy_us + remain;
+        stat.overlap_us = busy_us > spin_sum ? busy_us - spin_sum : 0;
+        stat.overlap    = stat.flush_us ? (uint8_t)((uint64_t)stat.overlap_us * 100 / stat.flush_us) : 0;
+        stat.rows       = rows_act;
+        stat.saved_bytes = flush_stat.saved_bytes >= saved_start ? flush_stat.saved_bytes - saved_start : 0;
+
+        frame_act = false;
+        pipe_adapt();
+    }
+
+    if(monitor_ori) monitor_ori(drv, time, px);
+}
+
+/**
+ * Set the strip height for the next refresh.
+ * Sending and rendering the strips is overlapped except the first rendering and the last sending.
+ * So about `min(render, flush) / strip count` remains visible: if the two costs are similar shorter strips
+ * hide more. If one of them dominates there is not much to hide and taller strips save the overhead
+ * of the strips (walking the objects, setting the window).
+ */
+static void pipe_adapt(void)
+{
+    if(rows_fix != 0) return;
+
+    uint32_t lo = LV_MATH_MIN(stat.render_us, stat.flush_us);
+    uint32_t hi = LV_MATH_MAX(stat.render_us, stat.flush_us);
+    if(hi == 0) return;
+
+    lv_coord_t target = rows_max - (lv_coord_t)((uint32_t)(rows_max - rows_min) * lo / hi);
+
+    /*Move halfway to smooth out the different frames*/
+    pipe_set_size((rows_act + target + 1) / 2);
+}
+
+static void pipe_set_size(lv_coord_t rows)
+{
+    if(rows < rows_min) rows = rows_min;
+    if(rows > rows_max) rows = rows_max;
+
+    rows_act      = rows;
+    pipe_buf.size = (uint32_t)rows * pipe_hor_res;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file lv_port_pipe.h
+ * Pipelined strip rendering: two strip buffers from a memory block and a strip height
+ * adapted to the cost of the rendering and the flushing
+ */
+
+#ifndef LV_PORT_PIPE_H
+#define LV_PORT_PIPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The strips are not made shorter than this*/
+#define LV_PORT_PIPE_ROWS_MIN   8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Counters of the last refresh
+ */
+typedef struct
+{
+    uint32_t frame_cnt;  /**< Number of measured refreshes*/
+    uint32_t frame_us;   /**< From the start of the rendering until the last pixel is sent [us]*/
+    uint32_t render_us;  /**< Rendering without the waiting for the flush [us]*/
+    uint32_t flush_us;   /**< Sending the strips [us]*/
+    uint32_t wait_us;    /**< The rendering waited for the flush [us]*/
+    uint32_t overlap_us; /**< The strips were sent while the next ones were rendered [us]*/
+    uint32_t saved_bytes; /**< Bus bytes saved by the differential flush (see `lv_port_flush_shadow_init()`)*/
+    uint8_t overlap;     /**< Part of the flush time hidden behind the rendering [%]*/
+    lv_coord_t rows;     /**< Strip height in the refresh*/
+} lv_port_pipe_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Split a memory block into two strip buffers and set up the display driver to render
+ * a strip while the previous one is sent. Call it before `lv_disp_drv_register()`.
+ * `flush_cb` has to be `lv_port_flush_cb` (or a wrapper of it). The original `monitor_cb`
+ * is called after the counters of the refresh are updated.
+ * @param drv pointer to the initialized display driver
+ * @param mem memory of the buffers (e.g. the free part of SRAMH)
+ * @param mem_size size of `mem` in bytes
+ * @param time_us get a free running time stamp in microseconds
+ */
+void lv_port_pipe_init(lv_disp_drv_t * drv, void * mem, uint32_t mem_size, uint32_t (*time_us)(void));
+
+/**
+ * Get the max. strip height which fits into the buffers
+ * @return number of rows
+ */
+lv_coord_t lv_port_pipe_get_rows_max(void);
+
+/**
+ * Set a fixed strip height or let it be adapted
+ * @param rows the strip height (0: adapt it to the measured costs)
+ */
+void lv_port_pipe_set_rows(lv_coord_t rows);
+
+/**
+ * Get the counters of the last refresh
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_port_pipe_get_stat(lv_port_pipe_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PORT_PIPE_H*/
@@ -138,6 +138,7 @@ void lv_group_add_obj(lv_group_t * group, lv_obj_t * obj)
     }
 
     obj->group_p     = group;
+    lv_obj_clear_style_cache(); /*The children might inherit the focused style from now*/
     lv_obj_t ** next = lv_ll_ins_tail(&group->obj_ll);
     LV_ASSERT_MEM(next);
     if(next == NULL) return;
@@ -9,12 +9,14 @@
 #include "lv_indev.h"
 #include "lv_disp.h"
 #include "lv_obj.h"
+#include <string.h>
 
 #include "../lv_hal/lv_hal_tick.h"
 #include "../lv_core/lv_group.h"
 #include "../lv_core/lv_refr.h"
 #include "../lv_misc/lv_task.h"
 #include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_mem.h"
 
 /*********************
  *      DEFINES
@@ -24,10 +26,30 @@
 #warning "LV_INDEV_DRAG_THROW must be greater than 0"
 #endif
 
+/*Smallest cells of the hit-test grids in pixels (as a shift)*/
+#define LV_INDEV_HIT_CELL_SHIFT_MIN 4
+
 /**********************
  *      TYPEDEFS
  **********************/
 
+#if LV_INDEV_HIT_MIN_CHILD
+/* Grid of the children of an object for hit-testing.
+ * It's relative to the object so it remains valid while the object is moved or scrolled.*/
+typedef struct
+{
+    lv_obj_t * obj;         /*The indexed object. NULL: free entry*/
+    uint32_t last_use;      /*To find the least recently used entry*/
+    lv_coord_t x_ofs;       /*Top left corner of the grid relative to `obj`*/
+    lv_coord_t y_ofs;
+    uint16_t col_cnt;
+    uint16_t row_cnt;
+    uint8_t cell_shift;     /*The cells are `1 << cell_shift` pixels large*/
+    uint16_t * cell_start;  /*The children of cell `i` are `child[cell_start[i]..cell_start[i + 1] - 1]`*/
+    lv_obj_t ** child;      /*The children touching the cells in the order of `child_ll`*/
+} lv_indev_hit_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -39,7 +61,13 @@ static void indev_button_proc(lv_indev_t * i, lv_indev_data_t * data);
 static void indev_proc_press(lv_indev_proc_t * proc);
 static void indev_proc_release(lv_indev_proc_t * proc);
 static void indev_proc_reset_query_handler(lv_indev_t * indev);
-static lv_obj_t * indev_search_obj(const lv_indev_proc_t * proc, lv_obj_t * obj);
+static lv_obj_t * indev_search_obj(const lv_point_t * point, lv_obj_t * obj);
+static void indev_get_click_area(const lv_obj_t * obj, lv_area_t * area);
+#if LV_INDEV_HIT_MIN_CHILD
+static lv_indev_hit_t * indev_hit_get(lv_obj_t * obj);
+static bool indev_hit_build(lv_indev_hit_t * hit, lv_obj_t * obj, uint32_t child_cnt);
+static bool indev_hit_get_area(const lv_obj_t * obj, lv_area_t * area);
+#endif
 static void indev_drag(lv_indev_proc_t * state);
 static void indev_drag_throw(lv_indev_proc_t * proc);
 static bool indev_reset_check(lv_indev_proc_t * proc);
@@ -49,6 +77,12 @@ static bool indev_reset_check(lv_indev_proc_t * proc);
  **********************/
 static lv_indev_t * indev_act;
 static lv_obj_t * indev_obj_act = NULL;
+static uint32_t indev_hit_test_cnt; /*Objects tested in the current read*/
+
+#if LV_INDEV_HIT_MIN_CHILD
+static lv_indev_hit_t indev_hit[LV_INDEV_HIT_CACHE_NUM];
+static uint32_t indev_hit_use;
+#endif
 
 /**********************
  *      MACROS
@@ -64,6 +98,11 @@ static lv_obj_t * indev_obj_act = NULL;
 void lv_indev_init(void)
 {
     lv_indev_reset(NULL); /*Reset all input devices*/
+
+#if LV_INDEV_HIT_MIN_CHILD
+    memset(indev_hit, 0, sizeof(indev_hit));
+    indev_hit_use = 0;
+#endif
 }
 
 /**
@@ -87,6 +126,9 @@ void lv_indev_read_task(lv_task_t * task)
     if(indev_act->proc.disabled) return;
     bool more_to_read;
     do {
+        uint32_t start      = lv_tick_get();
+        indev_hit_test_cnt = 0;
+
         /*Read the data*/
         more_to_read = lv_indev_read(indev_act, &data);
 
@@ -114,6 +156,10 @@ void lv_indev_read_task(lv_task_t * task)
         }
         /*Handle reset query if it happened in during processing*/
         indev_proc_reset_query_handler(indev_act);
+
+        if(indev_act->driver.monitor_cb) {
+            indev_act->driver.monitor_cb(&indev_act->driver, lv_tick_elaps(start), indev_hit_test_cnt);
+        }
     } while(more_to_read);
 
     /*End of indev processing, so no act indev*/
@@ -326,6 +372,48 @@ lv_obj_t * lv_indev_get_obj_act(void)
     return indev_obj_act;
 }
 
+/**
+ * Search the topmost clickable object on a point of a display like a pressed pointer does
+ * @param disp pointer to a display. NULL to use the default display.
+ * @param point pointer to a point in absolute coordinates
+ * @return the found object or NULL if there is no clickable object on the point
+ */
+lv_obj_t * lv_indev_search_obj(lv_disp_t * disp, const lv_point_t * point)
+{
+    if(disp == NULL) disp = lv_disp_get_default();
+    if(disp == NULL) return NULL;
+
+    lv_obj_t * found = indev_search_obj(point, lv_disp_get_layer_sys(disp));
+    if(found == NULL) found = indev_search_obj(point, lv_disp_get_layer_top(disp));
+    if(found == NULL) found = indev_search_obj(point, lv_disp_get_scr_act(disp));
+
+    return found;
+}
+
+/**
+ * Drop the hit-test index of an object's children.
+ * Required if a child is added, deleted, reordered or its clickable area is changed
+ * not by moving the object itself. Also required if the object is deleted.
+ * @param obj pointer to an object
+ */
+void lv_indev_hit_invalidate(lv_obj_t * obj)
+{
+#if LV_INDEV_HIT_MIN_CHILD
+    if(obj == NULL) return;
+
+    uint16_t i;
+    for(i = 0; i < LV_INDEV_HIT_CACHE_NUM; i++) {
+        if(indev_hit[i].obj == obj) {
+            lv_mem_free(indev_hit[i].cell_start);
+            memset(&indev_hit[i], 0, sizeof(lv_indev_hit_t));
+            return;
+        }
+    }
+#else
+    (void)obj; /*Unused*/
+#endif
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -692,17 +780,13 @@ static void indev_proc_press(lv_indev_proc_t * proc)
 
     /*If there is no last object then search*/
     if(indev_obj_act == NULL) {
-        indev_obj_act = indev_search_obj(proc, lv_disp_get_layer_sys(disp));
-        if(indev_obj_act == NULL) indev_obj_act = indev_search_obj(proc, lv_disp_get_layer_top(disp));
-        if(indev_obj_act == NULL) indev_obj_act = indev_search_obj(proc, lv_disp_get_scr_act(disp));
+        indev_obj_act = lv_indev_search_obj(disp, &proc->types.pointer.act_point);
         new_obj_searched = true;
     }
     /*If there is last object but it is not dragged and not protected also search*/
     else if(proc->types.pointer.drag_in_prog == 0 &&
             lv_obj_is_protected(indev_obj_act, LV_PROTECT_PRESS_LOST) == false) {
-        indev_obj_act = indev_search_obj(proc, lv_disp_get_layer_sys(disp));
-        if(indev_obj_act == NULL) indev_obj_act = indev_search_obj(proc, lv_disp_get_layer_top(disp));
-        if(indev_obj_act == NULL) indev_obj_act = indev_search_obj(proc, lv_disp_get_scr_act(disp));
+        indev_obj_act = lv_indev_search_obj(disp, &proc->types.pointer.act_point);
         new_obj_searched = true;
     }
     /*If a dragable or a protected object was the last then keep it*/
@@ -991,44 +1075,51 @@ static void indev_proc_reset_query_handler(lv_indev_t * indev)
     }
 }
 /**
- * Search the most top, clickable object on the last point of an input device
- * @param proc pointer to  the `lv_indev_proc_t` part of the input device
+ * Search the most top, clickable object on a point
+ * @param point pointer to the point (absolute coordinates)
  * @param obj pointer to a start object, typically the screen
  * @return pointer to the found object or NULL if there was no suitable object
  */
-static lv_obj_t * indev_search_obj(const lv_indev_proc_t * proc, lv_obj_t * obj)
+static lv_obj_t * indev_search_obj(const lv_point_t * point, lv_obj_t * obj)
 {
     lv_obj_t * found_p = NULL;
+    lv_area_t click_area;
 
-    /*If the point is on this object check its children too*/
-#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
-    lv_area_t ext_area;
-    ext_area.x1 = obj->coords.x1 - obj->ext_click_pad_hor;
-    ext_area.x2 = obj->coords.x2 + obj->ext_click_pad_hor;
-    ext_area.y1 = obj->coords.y1 - obj->ext_click_pad_ver;
-    ext_area.y2 = obj->coords.y2 + obj->ext_click_pad_ver;
+    indev_hit_test_cnt++;
 
-    if(lv_area_is_point_on(&ext_area, &proc->types.pointer.act_point)) {
-#elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
-    lv_area_t ext_area;
-    ext_area.x1 = obj->coords.x1 - obj->ext_click_pad.x1;
-    ext_area.x2 = obj->coords.x2 + obj->ext_click_pad.x2;
-    ext_area.y1 = obj->coords.y1 - obj->ext_click_pad.y1;
-    ext_area.y2 = obj->coords.y2 + obj->ext_click_pad.y2;
-
-    if(lv_area_is_point_on(&ext_area, &proc->types.pointer.act_point)) {
-#else
-    if(lv_area_is_point_on(&obj->coords, &proc->types.pointer.act_point)) {
-#endif
+    /*If the point is on this object check its children too*/
+    indev_get_click_area(obj, &click_area);
+    if(lv_area_is_point_on(&click_area, point)) {
         lv_obj_t * i;
-
-        LV_LL_READ(obj->child_ll, i)
+#if LV_INDEV_HIT_MIN_CHILD
+        /*Check only the children on the cell of the point*/
+        lv_indev_hit_t * hit = indev_hit_get(obj);
+        if(hit) {
+            lv_coord_t x = point->x - obj->coords.x1 - hit->x_ofs;
+            lv_coord_t y = point->y - obj->coords.y1 - hit->y_ofs;
+            if(x >= 0 && y >= 0) {
+                uint32_t col = (uint32_t)x >> hit->cell_shift;
+                uint32_t row = (uint32_t)y >> hit->cell_shift;
+                if(col < hit->col_cnt && row < hit->row_cnt) {
+                    uint32_t cell = row * hit->col_cnt + col;
+                    uint32_t c;
+                    for(c = hit->cell_start[cell]; c < hit->cell_start[cell + 1]; c++) {
+                        found_p = indev_search_obj(point, hit->child[c]);
+                        if(found_p != NULL) break;
+                    }
+                }
+            }
+        } else
+#endif
         {
-            found_p = indev_search_obj(proc, i);
+            LV_LL_READ(obj->child_ll, i)
+            {
+                found_p = indev_search_obj(point, i);
 
-            /*If a child was found then break*/
-            if(found_p != NULL) {
-                break;
+                /*If a child was found then break*/
+                if(found_p != NULL) {
+                    break;
+                }
             }
         }
 
@@ -1048,6 +1139,173 @@ static lv_obj_t * indev_search_obj(const lv_indev_proc_t * proc, lv_obj_t * obj)
     return found_p;
 }
 
+/**
+ * Get the area of an object where it can be clicked (its coordinates with the extended click area)
+ * @param obj pointer to an object
+ * @param area store the area here
+ */
+static void indev_get_click_area(const lv_obj_t * obj, lv_area_t * area)
+{
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
+    area->x1 = obj->coords.x1 - obj->ext_click_pad_hor;
+    area->x2 = obj->coords.x2 + obj->ext_click_pad_hor;
+    area->y1 = obj->coords.y1 - obj->ext_click_pad_ver;
+    area->y2 = obj->coords.y2 + obj->ext_click_pad_ver;
+#elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+    area->x1 = obj->coords.x1 - obj->ext_click_pad.x1;
+    area->x2 = obj->coords.x2 + obj->ext_click_pad.x2;
+    area->y1 = obj->coords.y1 - obj->ext_click_pad.y1;
+    area->y2 = obj->coords.y2 + obj->ext_click_pad.y2;
+#else
+    lv_area_copy(area, &obj->coords);
+#endif
+}
+
+#if LV_INDEV_HIT_MIN_CHILD
+/**
+ * Get the hit-test index of an object's children. Build it if the object has enough children.
+ * @param obj pointer to an object
+ * @return pointer to the index or NULL if the children should be checked one by one
+ */
+static lv_indev_hit_t * indev_hit_get(lv_obj_t * obj)
+{
+    lv_indev_hit_t * lru = &indev_hit[0];
+    uint16_t i;
+    for(i = 0; i < LV_INDEV_HIT_CACHE_NUM; i++) {
+        if(indev_hit[i].obj == obj) {
+            indev_hit[i].last_use = ++indev_hit_use;
+            return &indev_hit[i];
+        }
+        if(indev_hit[i].last_use < lru->last_use) lru = &indev_hit[i];
+    }
+
+    /*Indexing is worth only with many children*/
+    uint32_t child_cnt = 0;
+    lv_obj_t * child;
+    LV_LL_READ(obj->child_ll, child)
+    {
+        child_cnt++;
+        if(child_cnt >= LV_INDEV_HIT_MIN_CHILD) break;
+    }
+    if(child_cnt < LV_INDEV_HIT_MIN_CHILD) return NULL;
+
+    /*Replace the least recently used index*/
+    if(lru->obj) lv_indev_hit_invalidate(lru->obj);
+    if(indev_hit_build(lru, obj, lv_ll_get_len(&obj->child_ll)) == false) return NULL;
+
+    lru->obj      = obj;
+    lru->last_use = ++indev_hit_use;
+
+    return lru;
+}
+
+/**
+ * Sort the children of an object into the cells of a grid.
+ * The grid covers the clickable area of all children with about one cell per child.
+ * @param hit pointer to a free index
+ * @param obj pointer to an object
+ * @param child_cnt number of children of `obj`
+ * @return true: the index is built; false: not enough memory
+ */
+static bool indev_hit_build(lv_indev_hit_t * hit, lv_obj_t * obj, uint32_t child_cnt)
+{
+    lv_obj_t * child;
+    lv_area_t a;
+    lv_area_t bound;
+
+    /*The children's bounding box. The children of zero size can't be clicked: leave them out.*/
+    bool first = true;
+    LV_LL_READ(obj->child_ll, child)
+    {
+        if(indev_hit_get_area(child, &a) == false) continue;
+        if(first) lv_area_copy(&bound, &a);
+        else lv_area_join(&bound, &bound, &a);
+        first = false;
+    }
+    if(first) return false;
+
+    hit->x_ofs = bound.x1 - obj->coords.x1;
+    hit->y_ofs = bound.y1 - obj->coords.y1;
+
+    uint32_t w     = lv_area_get_width(&bound);
+    uint32_t h     = lv_area_get_height(&bound);
+    uint8_t shift  = LV_INDEV_HIT_CELL_SHIFT_MIN;
+    while(((((w - 1) >> shift) + 1) * (((h - 1) >> shift) + 1)) > child_cnt) shift++;
+
+    hit->cell_shift = shift;
+    hit->col_cnt    = ((w - 1) >> shift) + 1;
+    hit->row_cnt    = ((h - 1) >> shift) + 1;
+
+    /*Count the cells touched by the children*/
+    uint32_t cell_cnt  = (uint32_t)hit->col_cnt * hit->row_cnt;
+    uint32_t entry_cnt = 0;
+    LV_LL_READ(obj->child_ll, child)
+    {
+        if(indev_hit_get_area(child, &a) == false) continue;
+        uint32_t cols = ((uint32_t)(a.x2 - bound.x1) >> shift) - ((uint32_t)(a.x1 - bound.x1) >> shift) + 1;
+        uint32_t rows = ((uint32_t)(a.y2 - bound.y1) >> shift) - ((uint32_t)(a.y1 - bound.y1) >> shift) + 1;
+        entry_cnt += cols * rows;
+    }
+    if(entry_cnt > UINT16_MAX) return false;
+
+    /*The cell starts and the children in one block. Keep the pointers aligned.*/
+    uint32_t start_size = ((cell_cnt + 1) * sizeof(uint16_t) + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    uint8_t * buf       = lv_mem_alloc(start_size + entry_cnt * sizeof(lv_obj_t *));
+    if(buf == NULL) return false;
+
+    hit->cell_start = (uint16_t *)buf;
+    hit->child      = (lv_obj_t **)(buf + start_size);
+    memset(hit->cell_start, 0, (cell_cnt + 1) * sizeof(uint16_t));
+
+    /*Count the children of the cells. The sums give the start of the cells' part.*/
+    uint32_t col, row;
+    LV_LL_READ(obj->child_ll, child)
+    {
+        if(indev_hit_get_area(child, &a) == false) continue;
+        for(row = (a.y1 - bound.y1) >> shift; row <= (uint32_t)(a.y2 - bound.y1) >> shift; row++) {
+            for(col = (a.x1 - bound.x1) >> shift; col <= (uint32_t)(a.x2 - bound.x1) >> shift; col++) {
+                hit->cell_start[row * hit->col_cnt + col + 1]++;
+            }
+        }
+    }
+
+    uint32_t c;
+    for(c = 1; c <= cell_cnt; c++) hit->cell_start[c] += hit->cell_start[c - 1];
+
+    /*Fill the cells in the children's order. `cell_start[c]` is the next free place meanwhile.*/
+    LV_LL_READ(obj->child_ll, child)
+    {
+        if(indev_hit_get_area(child, &a) == false) continue;
+        for(row = (a.y1 - bound.y1) >> shift; row <= (uint32_t)(a.y2 - bound.y1) >> shift; row++) {
+            for(col = (a.x1 - bound.x1) >> shift; col <= (uint32_t)(a.x2 - bound.x1) >> shift; col++) {
+                c = row * hit->col_cnt + col;
+                hit->child[hit->cell_start[c]] = child;
+                hit->cell_start[c]++;
+            }
+        }
+    }
+
+    /*Shift back the starts*/
+    for(c = cell_cnt; c > 0; c--) hit->cell_start[c] = hit->cell_start[c - 1];
+    hit->cell_start[0] = 0;
+
+    return true;
+}
+
+/**
+ * Get the clickable area of an object for the index
+ * @param obj pointer to an object
+ * @param area store the area here
+ * @return false: the area is empty
+ */
+static bool indev_hit_get_area(const lv_obj_t * obj, lv_area_t * area)
+{
+    indev_get_click_area(obj, area);
+
+    return area->x2 >= area->x1 && area->y2 >= area->y1;
+}
+#endif
+
 /**
  * Handle the dragging of indev_proc_p->types.pointer.act_obj
  * @param indev pointer to a input device state
@@ -148,6 +148,22 @@ lv_task_t * lv_indev_get_read_task(lv_disp_t * indev);
  */
 lv_obj_t * lv_indev_get_obj_act(void);
 
+/**
+ * Search the topmost clickable object on a point of a display like a pressed pointer does
+ * @param disp pointer to a display. NULL to use the default display.
+ * @param point pointer to a point in absolute coordinates
+ * @return the found object or NULL if there is no clickable object on the point
+ */
+lv_obj_t * lv_indev_search_obj(lv_disp_t * disp, const lv_point_t * point);
+
+/**
+ * Drop the hit-test index of an object's children.
+ * Required if a child is added, deleted, reordered or its clickable area is changed
+ * not by moving the object itself. Also required if the object is deleted.
+ * @param obj pointer to an object
+ */
+void lv_indev_hit_invalidate(lv_obj_t * obj);
+
 /**********************
  *      MACROS
  **********************/
@@ -51,6 +51,7 @@ typedef struct _lv_event_temp_data
 static void refresh_children_position(lv_obj_t * obj, lv_coord_t x_diff, lv_coord_t y_diff);
 static void report_style_mod_core(void * style_p, lv_obj_t * obj);
 static void refresh_children_style(lv_obj_t * obj);
+static const lv_style_t * get_inherited_style(const lv_obj_t * obj);
 static void delete_children(lv_obj_t * obj);
 static void base_dir_refr_children(lv_obj_t * obj);
 static void lv_event_mark_deleted(lv_obj_t * obj);
@@ -64,6 +65,9 @@ static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param);
 static bool lv_initialized = false;
 static lv_event_temp_data_t * event_temp_data_head;
 static const void * event_act_data;
+#if LV_USE_OBJ_STYLE_CACHE
+static uint32_t style_cache_gen = 1; /*0 is the generation of the new objects*/
+#endif
 
 /**********************
  *      MACROS
@@ -196,6 +200,11 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj->realign.auto_realign = 0;
 #endif
 
+#if LV_USE_OBJ_STYLE_CACHE
+        new_obj->style_cache = NULL;
+        new_obj->style_gen   = 0;
+#endif
+
         /*Set the default styles*/
         lv_theme_t * th = lv_theme_get_current();
         if(th) {
@@ -246,6 +255,7 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
 
         new_obj->par = parent; /*Set the parent*/
         lv_ll_init(&(new_obj->child_ll), sizeof(lv_obj_t));
+        lv_indev_hit_invalidate(parent);
 
         /*Set the callbacks*/
         new_obj->signal_cb = lv_obj_signal;
@@ -287,6 +297,11 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj->realign.base         = NULL;
         new_obj->realign.auto_realign = 0;
 #endif
+
+#if LV_USE_OBJ_STYLE_CACHE
+        new_obj->style_cache = NULL;
+        new_obj->style_gen   = 0;
+#endif
         /*Set appearance*/
         lv_theme_t * th = lv_theme_get_current();
         if(th) {
@@ -477,6 +492,8 @@ lv_res_t lv_obj_del(lv_obj_t * obj)
     } else {
         lv_ll_rem(&(par->child_ll), obj);
     }
+    lv_indev_hit_invalidate(par);
+    lv_indev_hit_invalidate(obj);
 
     /*Delete the base objects*/
     if(obj->ext_attr != NULL) lv_mem_free(obj->ext_attr);
@@ -625,6 +642,9 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
 
     lv_ll_chg_list(&obj->par->child_ll, &parent->child_ll, obj, true);
     obj->par = parent;
+    lv_obj_clear_style_cache();
+    lv_indev_hit_invalidate(old_par);
+    lv_indev_hit_invalidate(parent);
     lv_obj_set_pos(obj, old_pos.x, old_pos.y);
 
     /*Notify the original parent because one of its children is lost*/
@@ -652,6 +672,7 @@ void lv_obj_move_foreground(lv_obj_t * obj)
     lv_obj_invalidate(parent);
 
     lv_ll_chg_list(&parent->child_ll, &parent->child_ll, obj, true);
+    lv_indev_hit_invalidate(parent);
 
     /*Notify the new parent about the child*/
     parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
@@ -675,6 +696,7 @@ void lv_obj_move_background(lv_obj_t * obj)
     lv_obj_invalidate(parent);
 
     lv_ll_chg_list(&parent->child_ll, &parent->child_ll, obj, false);
+    lv_indev_hit_invalidate(parent);
 
     /*Notify the new parent about the child*/
     parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
@@ -726,6 +748,9 @@ void lv_obj_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
 
     refresh_children_position(obj, diff.x, diff.y);
 
+    /*The children moved together with the object so only the parent's index is changed*/
+    lv_indev_hit_invalidate(par);
+
     /*Inform the object about its new coordinates*/
     obj->signal_cb(obj, LV_SIGNAL_CORD_CHG, &ori);
 
@@ -792,6 +817,8 @@ void lv_obj_set_size(lv_obj_t * obj, lv_coord_t w, lv_coord_t h)
     } else {
         obj->coords.x2 = obj->coords.x1 + w - 1;
     }
+    lv_indev_hit_invalidate(lv_obj_get_parent(obj));
+    lv_indev_hit_invalidate(obj);
 
     /*Send a signal to the object with its new coordinates*/
     obj->signal_cb(obj, LV_SIGNAL_CORD_CHG, &ori);
@@ -1201,9 +1228,11 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, lv_coord_t left, lv_coord_t right
     obj->ext_click_pad.x2 = right;
     obj->ext_click_pad.y1 = top;
     obj->ext_click_pad.y2 = bottom;
+    lv_indev_hit_invalidate(lv_obj_get_parent(obj));
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     obj->ext_click_pad_hor = LV_MATH_MAX(left, right);
     obj->ext_click_pad_ver = LV_MATH_MAX(top, bottom);
+    lv_indev_hit_invalidate(lv_obj_get_parent(obj));
 #else
     (void)obj;    /*Unused*/
     (void)left;   /*Unused*/
@@ -1228,6 +1257,7 @@ void lv_obj_set_style(lv_obj_t * obj, const lv_style_t * style)
     LV_ASSERT_STYLE(style);
 
     obj->style_p = style;
+    lv_obj_clear_style_cache();
 
     /*Send a signal about style change to every children with NULL style*/
     refresh_children_style(obj);
@@ -1244,6 +1274,8 @@ void lv_obj_refresh_style(lv_obj_t * obj)
 {
     LV_ASSERT_OBJ(obj, LV_OBJX_NAME);
 
+    lv_obj_clear_style_cache();
+
     lv_obj_invalidate(obj);
     obj->signal_cb(obj, LV_SIGNAL_STYLE_CHG, NULL);
     lv_obj_invalidate(obj);
@@ -1258,6 +1290,9 @@ void lv_obj_report_style_mod(lv_style_t * style)
 {
     LV_ASSERT_STYLE(style);
 
+    /*E.g. the `glass` of the style might be changed*/
+    lv_obj_clear_style_cache();
+
     lv_disp_t * d = lv_disp_get_next(NULL);
 
     while(d) {
@@ -1274,6 +1309,18 @@ void lv_obj_report_style_mod(lv_style_t * style)
     }
 }
 
+/**
+ * Drop the inherited styles cached on the objects.
+ * Required only if the inheritance is changed without setting or refreshing a style (e.g. the group of an object)
+ */
+void lv_obj_clear_style_cache(void)
+{
+#if LV_USE_OBJ_STYLE_CACHE
+    style_cache_gen++;
+    if(style_cache_gen == 0) style_cache_gen = 1;
+#endif
+}
+
 /*-----------------
  * Attribute set
  *----------------*/
@@ -2025,27 +2072,16 @@ const lv_style_t * lv_obj_get_style(const lv_obj_t * obj)
 
     const lv_style_t * style_act = obj->style_p;
     if(style_act == NULL) {
-        lv_obj_t * par = obj->par;
-
-        while(par) {
-            if(par->style_p) {
-                if(par->style_p->glass == 0) {
-#if LV_USE_GROUP == 0
-                    style_act = par->style_p;
+#if LV_USE_OBJ_STYLE_CACHE
+        /*Walk up on the parents only if a style has changed since the last time*/
+        if(obj->style_gen == style_cache_gen) {
+            style_act = obj->style_cache;
+        } else {
+            style_act = get_inherited_style(obj);
+        }
 #else
-                    /*If a parent is focused then use then focused style*/
-                    lv_group_t * g = lv_obj_get_group(par);
-                    if(lv_group_get_focused(g) == par) {
-                        style_act = lv_group_mod_style(g, par->style_p);
-                    } else {
-                        style_act = par->style_p;
-                    }
+        style_act = get_inherited_style(obj);
 #endif
-                    break;
-                }
-            }
-            par = par->par;
-        }
     }
 #if LV_USE_GROUP
     if(obj->group_p) {
@@ -2552,6 +2588,48 @@ static void refresh_children_style(lv_obj_t * obj)
     }
 }
 
+/**
+ * Get the style of the first parent with a not glass style and save it in the cache of the object
+ * @param obj pointer to an object
+ * @return the inherited style or NULL if there is no such parent
+ */
+static const lv_style_t * get_inherited_style(const lv_obj_t * obj)
+{
+    const lv_style_t * style_act = NULL;
+    lv_obj_t * par               = obj->par;
+
+    while(par) {
+        if(par->style_p) {
+            if(par->style_p->glass == 0) {
+#if LV_USE_GROUP == 0
+                style_act = par->style_p;
+#else
+                /*If a parent is focused then use then focused style*/
+                lv_group_t * g = lv_obj_get_group(par);
+                if(lv_group_get_focused(g) == par) {
+                    style_act = lv_group_mod_style(g, par->style_p);
+                } else {
+                    style_act = par->style_p;
+                }
+
+                /*The focus can change any time and the modified style is only a temporal copy*/
+                if(g) return style_act;
+#endif
+                break;
+            }
+        }
+        par = par->par;
+    }
+
+#if LV_USE_OBJ_STYLE_CACHE
+    lv_obj_t * obj_cache   = (lv_obj_t *)obj;
+    obj_cache->style_cache = style_act;
+    obj_cache->style_gen   = style_cache_gen;
+#endif
+
+    return style_act;
+}
+
 /**
  * Called by 'lv_obj_del' to delete the children objects
  * @param obj pointer to an object (all of its children will be deleted)
@@ -2616,6 +2694,7 @@ static void delete_children(lv_obj_t * obj)
     /*Remove the object from parent's children list*/
     lv_obj_t * par = lv_obj_get_parent(obj);
     lv_ll_rem(&(par->child_ll), obj);
+    lv_indev_hit_invalidate(obj);
 
     /*Delete the base objects*/
     if(obj->ext_attr != NULL) lv_mem_free(obj->ext_attr);
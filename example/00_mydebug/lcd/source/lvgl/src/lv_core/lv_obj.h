@@ -198,6 +198,11 @@ typedef struct _lv_obj_t
     void * ext_attr;            /**< Object type specific extended data*/
     const lv_style_t * style_p; /**< Pointer to the object's style*/
 
+#if LV_USE_OBJ_STYLE_CACHE
+    const lv_style_t * style_cache; /**< Style inherited from the parents. Valid if `style_gen` is up to date*/
+    uint32_t style_gen;             /**< Generation of the style changes when `style_cache` was saved*/
+#endif
+
 #if LV_USE_GROUP != 0
     void * group_p; /**< Pointer to the group of the object*/
 #endif
@@ -470,6 +475,12 @@ void lv_obj_refresh_style(lv_obj_t * obj);
  */
 void lv_obj_report_style_mod(lv_style_t * style);
 
+/**
+ * Drop the inherited styles cached on the objects.
+ * Required only if the inheritance is changed without setting or refreshing a style (e.g. the group of an object)
+ */
+void lv_obj_clear_style_cache(void);
+
 /*-----------------
  * Attribute set
  *----------------*/
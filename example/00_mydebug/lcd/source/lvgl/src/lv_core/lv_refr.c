@@ -26,20 +26,55 @@
 /* Draw translucent random colored areas on the invalidated (redrawn) areas*/
 #define MASK_AREA_DEBUG 0
 
+/*Max. number of areas built from the tile map: one for every tile*/
+#define LV_INV_AREA_MAX (LV_INV_TILE_ROW_NUM * LV_INV_TILE_COL_NUM)
+
+/*Initial number of elements in the draw list*/
+#define LV_REFR_ITEM_DEF_NUM 32
+
+/*Max. number of areas collected between `lv_inv_batch_start` and `lv_inv_batch_end`*/
+#define LV_INV_BATCH_MAX 32
+
 /**********************
  *      TYPEDEFS
  **********************/
+/*An element of the draw list: a design call with the object's mask clipped to the invalidated area*/
+typedef struct
+{
+    lv_obj_t * obj;
+    lv_area_t mask;
+    lv_design_mode_t mode;
+} lv_refr_item_t;
+
+/*An invalidated area collected in a batch*/
+typedef struct
+{
+    lv_disp_t * disp;
+    lv_area_t area;
+} lv_refr_inv_batch_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void lv_refr_inv_add(lv_disp_t * disp, lv_area_t * area_p);
+static bool lv_refr_inv_batch_add(lv_disp_t * disp, const lv_area_t * area_p);
+static void lv_refr_inv_batch_flush(lv_disp_t * disp);
+static void lv_refr_inv_mark(lv_disp_t * disp, const lv_area_t * area_p);
 static void lv_refr_join_area(void);
+static void lv_refr_join_run(const lv_area_t * run_p, const uint16_t * open, uint16_t open_cnt, uint16_t * open_new,
+                             uint16_t * open_new_cnt);
+static bool lv_refr_join_is_cheaper(const lv_area_t * joined_p, const lv_area_t * a1_p, const lv_area_t * a2_p);
 static void lv_refr_areas(void);
 static void lv_refr_area(const lv_area_t * area_p);
 static void lv_refr_area_part(const lv_area_t * area_p);
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void lv_refr_obj_and_children(lv_obj_t * top_p, const lv_area_t * mask_p);
 static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p);
+static bool lv_refr_items_build(const lv_area_t * area_p);
+static void lv_refr_items_add_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p);
+static void lv_refr_items_add(lv_obj_t * obj, const lv_area_t * mask_p, lv_design_mode_t mode);
+static void lv_refr_items_draw(const lv_area_t * mask_p);
+static void lv_refr_wait_flush(lv_disp_buf_t * vdb);
 static void lv_refr_vdb_flush(void);
 
 /**********************
@@ -47,6 +82,16 @@ static void lv_refr_vdb_flush(void);
  **********************/
 static uint32_t px_num;
 static lv_disp_t * disp_refr; /*Display being refreshed*/
+static lv_area_t inv_areas[LV_INV_AREA_MAX]; /*Areas to refresh built from the tile map of `disp_refr`*/
+static uint16_t inv_area_cnt;
+static lv_refr_item_t * items; /*Draw list of the area being refreshed*/
+static uint32_t item_cnt;
+static uint32_t item_scr_cnt; /*The first `item_scr_cnt` items are from the screen, the rest from the layers*/
+static uint32_t item_buf_size;
+static bool items_ok;
+static lv_refr_inv_batch_t inv_batch[LV_INV_BATCH_MAX];
+static uint16_t inv_batch_cnt;
+static uint16_t inv_batch_depth; /*Nesting of `lv_inv_batch_start` calls. 0: no batch*/
 
 /**********************
  *      MACROS
@@ -61,7 +106,8 @@ static lv_disp_t * disp_refr; /*Display being refreshed*/
  */
 void lv_refr_init(void)
 {
-    /*Nothing to do*/
+    inv_batch_cnt   = 0;
+    inv_batch_depth = 0;
 }
 
 /**
@@ -98,7 +144,15 @@ void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
 
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
+        memset(disp->inv_tile_map, 0, sizeof(disp->inv_tile_map));
         disp->inv_p = 0;
+
+        /*Drop the batched areas of the display too*/
+        uint16_t i = 0;
+        while(i < inv_batch_cnt) {
+            if(inv_batch[i].disp == disp) inv_batch[i] = inv_batch[--inv_batch_cnt];
+            else i++;
+        }
         return;
     }
 
@@ -115,25 +169,34 @@ void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
 
     /*The area is truncated to the screen*/
     if(suc != false) {
-        if(disp->driver.rounder_cb) disp->driver.rounder_cb(&disp->driver, &com_area);
-
-        /*Save only if this area is not in one of the saved areas*/
-        uint16_t i;
-        for(i = 0; i < disp->inv_p; i++) {
-            if(lv_area_is_in(&com_area, &disp->inv_areas[i]) != false) return;
-        }
+        if(inv_batch_depth > 0 && lv_refr_inv_batch_add(disp, &com_area)) return;
 
-        /*Save the area*/
-        if(disp->inv_p < LV_INV_BUF_SIZE) {
-            lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
-        } else { /*If no place for the area add the screen*/
-            disp->inv_p = 0;
-            lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
-        }
-        disp->inv_p++;
+        lv_refr_inv_add(disp, &com_area);
     }
 }
 
+/**
+ * Collect the invalidated areas and join the overlapping ones until `lv_inv_batch_end`.
+ * E.g. an object moved by more animations in one tick invalidates almost the same area more times.
+ * The calls can be nested.
+ */
+void lv_inv_batch_start(void)
+{
+    inv_batch_depth++;
+}
+
+/**
+ * Invalidate the collected areas and stop collecting them (at the end of the outermost batch)
+ */
+void lv_inv_batch_end(void)
+{
+    if(inv_batch_depth == 0) return;
+    inv_batch_depth--;
+    if(inv_batch_depth > 0) return;
+
+    lv_refr_inv_batch_flush(NULL);
+}
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
@@ -166,12 +229,17 @@ void lv_disp_refr_task(lv_task_t * task)
 
     disp_refr = task->user_data;
 
+    /*Refreshed inside a batch (e.g. `lv_refr_now` from an animation): don't miss the collected areas*/
+    lv_refr_inv_batch_flush(disp_refr);
+
     lv_refr_join_area();
 
+    if(inv_area_cnt != 0 && disp_refr->driver.render_start_cb) disp_refr->driver.render_start_cb(&disp_refr->driver);
+
     lv_refr_areas();
 
     /*If refresh happened ...*/
-    if(disp_refr->inv_p != 0) {
+    if(inv_area_cnt != 0) {
         /* In true double buffered mode copy the refreshed areas to the new VDB to keep it up to date.
          * With set_px_cb we don't know anything about the buffer (even it's size) so skip copying.*/
         if(lv_disp_is_true_double_buf(disp_refr) && disp_refr->driver.set_px_cb == NULL) {
@@ -183,33 +251,35 @@ void lv_disp_refr_task(lv_task_t * task)
             /* With true double buffering the flushing should be only the address change of the
              * current frame buffer. Wait until the address change is ready and copy the changed
              * content to the other frame buffer (new active VDB) to keep the buffers synchronized*/
-            while(vdb->flushing)
-                ;
+            lv_refr_wait_flush(vdb);
 
             uint8_t * buf_act = (uint8_t *)vdb->buf_act;
             uint8_t * buf_ina = (uint8_t *)vdb->buf_act == vdb->buf1 ? vdb->buf2 : vdb->buf1;
 
             lv_coord_t hres = lv_disp_get_hor_res(disp_refr);
             uint16_t a;
-            for(a = 0; a < disp_refr->inv_p; a++) {
-                if(disp_refr->inv_area_joined[a] == 0) {
-                    lv_coord_t y;
-                    uint32_t start_offs =
-                        (hres * disp_refr->inv_areas[a].y1 + disp_refr->inv_areas[a].x1) * sizeof(lv_color_t);
-                    uint32_t line_length = lv_area_get_width(&disp_refr->inv_areas[a]) * sizeof(lv_color_t);
-
-                    for(y = disp_refr->inv_areas[a].y1; y <= disp_refr->inv_areas[a].y2; y++) {
-                        memcpy(buf_act + start_offs, buf_ina + start_offs, line_length);
-                        start_offs += hres * sizeof(lv_color_t);
-                    }
+            for(a = 0; a < inv_area_cnt; a++) {
+                if(disp_refr->driver.sync_cb) {
+                    disp_refr->driver.sync_cb(&disp_refr->driver, (lv_color_t *)buf_act, (lv_color_t *)buf_ina,
+                                              &inv_areas[a]);
+                    continue;
+                }
+
+                lv_coord_t y;
+                uint32_t start_offs  = (hres * inv_areas[a].y1 + inv_areas[a].x1) * sizeof(lv_color_t);
+                uint32_t line_length = lv_area_get_width(&inv_areas[a]) * sizeof(lv_color_t);
+
+                for(y = inv_areas[a].y1; y <= inv_areas[a].y2; y++) {
+                    memcpy(buf_act + start_offs, buf_ina + start_offs, line_length);
+                    start_offs += hres * sizeof(lv_color_t);
                 }
             }
         } /*End of true double buffer handling*/
 
         /*Clean up*/
-        memset(disp_refr->inv_areas, 0, sizeof(disp_refr->inv_areas));
-        memset(disp_refr->inv_area_joined, 0, sizeof(disp_refr->inv_area_joined));
+        memset(disp_refr->inv_tile_map, 0, sizeof(disp_refr->inv_tile_map));
         disp_refr->inv_p = 0;
+        inv_area_cnt     = 0;
 
         /*Call monitor cb if present*/
         if(disp_refr->driver.monitor_cb) {
@@ -219,6 +289,12 @@ void lv_disp_refr_task(lv_task_t * task)
 
     lv_draw_free_buf();
 
+    if(items) {
+        lv_mem_free(items);
+        items         = NULL;
+        item_buf_size = 0;
+    }
+
     LV_LOG_TRACE("lv_refr_task: ready");
 }
 
@@ -227,40 +303,240 @@ void lv_disp_refr_task(lv_task_t * task)
  **********************/
 
 /**
- * Join the areas which has got common parts
+ * Round an area and mark it invalid on a display
+ * @param disp pointer to a display
+ * @param area_p pointer to an area truncated to the screen. It might be modified by the rounder.
  */
-static void lv_refr_join_area(void)
+static void lv_refr_inv_add(lv_disp_t * disp, lv_area_t * area_p)
 {
-    uint32_t join_from;
-    uint32_t join_in;
-    lv_area_t joined_area;
-    for(join_in = 0; join_in < disp_refr->inv_p; join_in++) {
-        if(disp_refr->inv_area_joined[join_in] != 0) continue;
+    if(disp->driver.rounder_cb) {
+        disp->driver.rounder_cb(&disp->driver, area_p);
+
+        /*The rounded area can't be out of the tile map*/
+        lv_area_t scr_area;
+        scr_area.x1 = 0;
+        scr_area.y1 = 0;
+        scr_area.x2 = lv_disp_get_hor_res(disp) - 1;
+        scr_area.y2 = lv_disp_get_ver_res(disp) - 1;
+        lv_area_intersect(area_p, area_p, &scr_area);
+    }
 
-        /*Check all areas to join them in 'join_in'*/
-        for(join_from = 0; join_from < disp_refr->inv_p; join_from++) {
-            /*Handle only unjoined areas and ignore itself*/
-            if(disp_refr->inv_area_joined[join_from] != 0 || join_in == join_from) {
-                continue;
+    /*Mark the touched tiles. The tile map never overflows so no need to fall back to the full screen.*/
+    lv_refr_inv_mark(disp, area_p);
+    if(disp->inv_p < UINT16_MAX) disp->inv_p++;
+}
+
+/**
+ * Add an area to the batch. Join it to the last batched area if their bounding box is not larger
+ * than the two areas together: an object typically invalidates its old and new position after each other.
+ * @param disp pointer to a display
+ * @param area_p pointer to an area truncated to the screen
+ * @return true: batched; false: the batch is full, invalidate the area now
+ */
+static bool lv_refr_inv_batch_add(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    if(inv_batch_cnt > 0) {
+        lv_refr_inv_batch_t * last = &inv_batch[inv_batch_cnt - 1];
+        if(last->disp == disp) {
+            lv_area_t joined;
+            lv_area_join(&joined, &last->area, area_p);
+            if(lv_area_get_size(&joined) <= lv_area_get_size(&last->area) + lv_area_get_size(area_p)) {
+                last->area = joined;
+                return true;
             }
+        }
+    }
 
-            /*Check if the areas are on each other*/
-            if(lv_area_is_on(&disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]) == false) {
+    if(inv_batch_cnt >= LV_INV_BATCH_MAX) return false;
+
+    inv_batch[inv_batch_cnt].disp = disp;
+    inv_batch[inv_batch_cnt].area = *area_p;
+    inv_batch_cnt++;
+
+    return true;
+}
+
+/**
+ * Invalidate the batched areas now
+ * @param disp invalidate only the areas of this display. NULL: all of them
+ */
+static void lv_refr_inv_batch_flush(lv_disp_t * disp)
+{
+    uint16_t i = 0;
+    while(i < inv_batch_cnt) {
+        if(disp == NULL || inv_batch[i].disp == disp) {
+            lv_refr_inv_add(inv_batch[i].disp, &inv_batch[i].area);
+            inv_batch[i] = inv_batch[--inv_batch_cnt];
+        } else {
+            i++;
+        }
+    }
+}
+
+/**
+ * Mark the tiles touched by an area as invalid and extend their invalid part with the area.
+ * It takes a constant time for every touched tile regardless of how many areas are invalidated already.
+ * @param disp pointer to a display
+ * @param area_p pointer to an area on the screen
+ */
+static void lv_refr_inv_mark(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    uint16_t tx1 = area_p->x1 / LV_INV_TILE_SIZE;
+    uint16_t tx2 = area_p->x2 / LV_INV_TILE_SIZE;
+    uint16_t ty1 = area_p->y1 / LV_INV_TILE_SIZE;
+    uint16_t ty2 = area_p->y2 / LV_INV_TILE_SIZE;
+
+    uint16_t tx;
+    uint16_t ty;
+    for(ty = ty1; ty <= ty2; ty++) {
+        lv_coord_t ty_ofs = ty * LV_INV_TILE_SIZE;
+        uint8_t y1        = ty == ty1 ? area_p->y1 - ty_ofs : 0;
+        uint8_t y2        = ty == ty2 ? area_p->y2 - ty_ofs : LV_INV_TILE_SIZE - 1;
+        uint32_t * map    = disp->inv_tile_map[ty];
+
+        for(tx = tx1; tx <= tx2; tx++) {
+            lv_coord_t tx_ofs         = tx * LV_INV_TILE_SIZE;
+            uint8_t x1                = tx == tx1 ? area_p->x1 - tx_ofs : 0;
+            uint8_t x2                = tx == tx2 ? area_p->x2 - tx_ofs : LV_INV_TILE_SIZE - 1;
+            uint32_t bit              = (uint32_t)1 << (tx & 0x1F);
+            lv_disp_inv_tile_t * tile = &disp->inv_tiles[ty][tx];
+
+            if(map[tx >> 5] & bit) {
+                if(x1 < tile->x1) tile->x1 = x1;
+                if(y1 < tile->y1) tile->y1 = y1;
+                if(x2 > tile->x2) tile->x2 = x2;
+                if(y2 > tile->y2) tile->y2 = y2;
+            } else {
+                map[tx >> 5] |= bit;
+                tile->x1 = x1;
+                tile->y1 = y1;
+                tile->x2 = x2;
+                tile->y2 = y2;
+            }
+        }
+    }
+}
+
+/**
+ * Build the areas to refresh from the tile map of `disp_refr`.
+ * The invalid tiles of a row are joined into runs and the runs are joined with the areas of the
+ * previous row, both only if it's cheaper than flushing them separately (see `LV_INV_JOIN_COST`).
+ */
+static void lv_refr_join_area(void)
+{
+    uint16_t open_buf[2][LV_INV_TILE_COL_NUM]; /*Areas which reached the previous and the current row*/
+    uint16_t open_cnt = 0;
+    uint16_t * open   = open_buf[0];
+    uint16_t * open_new;
+    uint16_t open_new_cnt;
+    lv_area_t run;
+    lv_area_t tile_area;
+    lv_area_t joined_area;
+    bool run_valid;
+    uint16_t tx;
+    uint16_t ty;
+
+    inv_area_cnt = 0;
+
+    for(ty = 0; ty < LV_INV_TILE_ROW_NUM; ty++) {
+        open_new     = open == open_buf[0] ? open_buf[1] : open_buf[0];
+        open_new_cnt = 0;
+        run_valid    = false;
+
+        const uint32_t * map = disp_refr->inv_tile_map[ty];
+        for(tx = 0; tx < LV_INV_TILE_COL_NUM; tx++) {
+            /*Skip 32 clean tiles at once*/
+            if((tx & 0x1F) == 0 && map[tx >> 5] == 0) {
+                tx += 31;
                 continue;
             }
 
-            lv_area_join(&joined_area, &disp_refr->inv_areas[join_in], &disp_refr->inv_areas[join_from]);
+            if((map[tx >> 5] & ((uint32_t)1 << (tx & 0x1F))) == 0) continue;
 
-            /*Join two area only if the joined area size is smaller*/
-            if(lv_area_get_size(&joined_area) < (lv_area_get_size(&disp_refr->inv_areas[join_in]) +
-                                                 lv_area_get_size(&disp_refr->inv_areas[join_from]))) {
-                lv_area_copy(&disp_refr->inv_areas[join_in], &joined_area);
+            const lv_disp_inv_tile_t * tile = &disp_refr->inv_tiles[ty][tx];
+            tile_area.x1 = tx * LV_INV_TILE_SIZE + tile->x1;
+            tile_area.y1 = ty * LV_INV_TILE_SIZE + tile->y1;
+            tile_area.x2 = tx * LV_INV_TILE_SIZE + tile->x2;
+            tile_area.y2 = ty * LV_INV_TILE_SIZE + tile->y2;
 
-                /*Mark 'join_form' is joined into 'join_in'*/
-                disp_refr->inv_area_joined[join_from] = 1;
+            if(run_valid) {
+                lv_area_join(&joined_area, &run, &tile_area);
+                if(lv_refr_join_is_cheaper(&joined_area, &run, &tile_area)) {
+                    lv_area_copy(&run, &joined_area);
+                    continue;
+                }
+
+                lv_refr_join_run(&run, open, open_cnt, open_new, &open_new_cnt);
             }
+
+            lv_area_copy(&run, &tile_area);
+            run_valid = true;
+        }
+
+        if(run_valid) lv_refr_join_run(&run, open, open_cnt, open_new, &open_new_cnt);
+
+        open     = open_new;
+        open_cnt = open_new_cnt;
+    }
+
+    /*The joined areas might be not aligned as required*/
+    if(disp_refr->driver.rounder_cb) {
+        uint16_t i;
+        for(i = 0; i < inv_area_cnt; i++) {
+            disp_refr->driver.rounder_cb(&disp_refr->driver, &inv_areas[i]);
+        }
+    }
+}
+
+/**
+ * Join a run of a tile row into an area which reached the previous row or save it as a new area
+ * @param run_p pointer to the run
+ * @param open index of the areas which reached the previous row
+ * @param open_cnt number of elements in `open`
+ * @param open_new store the index of the joined or new area here
+ * @param open_new_cnt number of elements in `open_new` (incremented if a new index is stored)
+ */
+static void lv_refr_join_run(const lv_area_t * run_p, const uint16_t * open, uint16_t open_cnt, uint16_t * open_new,
+                             uint16_t * open_new_cnt)
+{
+    lv_area_t joined_area;
+    uint16_t idx = inv_area_cnt;
+    uint16_t i;
+
+    for(i = 0; i < open_cnt; i++) {
+        lv_area_join(&joined_area, &inv_areas[open[i]], run_p);
+        if(lv_refr_join_is_cheaper(&joined_area, &inv_areas[open[i]], run_p)) {
+            lv_area_copy(&inv_areas[open[i]], &joined_area);
+            idx = open[i];
+            break;
         }
     }
+
+    /*Not joined: save as a new area*/
+    if(idx == inv_area_cnt) {
+        lv_area_copy(&inv_areas[inv_area_cnt], run_p);
+        inv_area_cnt++;
+    }
+
+    /*An area can be joined with more runs of the same row but it's enough to keep it open once*/
+    for(i = 0; i < *open_new_cnt; i++) {
+        if(open_new[i] == idx) return;
+    }
+
+    open_new[*open_new_cnt] = idx;
+    (*open_new_cnt)++;
+}
+
+/**
+ * Tell whether refreshing the joined area is cheaper than refreshing two areas separately
+ * @param joined_p pointer to the joined area
+ * @param a1_p pointer to the first area
+ * @param a2_p pointer to the second area
+ * @return true: join the areas
+ */
+static bool lv_refr_join_is_cheaper(const lv_area_t * joined_p, const lv_area_t * a1_p, const lv_area_t * a2_p)
+{
+    return lv_area_get_size(joined_p) < lv_area_get_size(a1_p) + lv_area_get_size(a2_p) + LV_INV_JOIN_COST;
 }
 
 /**
@@ -271,14 +547,10 @@ static void lv_refr_areas(void)
     px_num = 0;
     uint32_t i;
 
-    for(i = 0; i < disp_refr->inv_p; i++) {
-        /*Refresh the unjoined areas*/
-        if(disp_refr->inv_area_joined[i] == 0) {
-
-            lv_refr_area(&disp_refr->inv_areas[i]);
+    for(i = 0; i < inv_area_cnt; i++) {
+        lv_refr_area(&inv_areas[i]);
 
-            if(disp_refr->driver.monitor_cb) px_num += lv_area_get_size(&disp_refr->inv_areas[i]);
-        }
+        if(disp_refr->driver.monitor_cb) px_num += lv_area_get_size(&inv_areas[i]);
     }
 }
 
@@ -339,6 +611,10 @@ static void lv_refr_area(const lv_area_t * area_p)
             }
         }
 
+        /* If the area is rendered in more parts collect the objects to draw only once.
+         * Every part uses this list instead of walking the object tree again.*/
+        items_ok = max_row < h ? lv_refr_items_build(area_p) : false;
+
         /*Always use the full row*/
         lv_coord_t row;
         lv_coord_t row_last = 0;
@@ -364,6 +640,8 @@ static void lv_refr_area(const lv_area_t * area_p)
             /*Refresh this part too*/
             lv_refr_area_part(area_p);
         }
+
+        items_ok = false;
     }
 }
 
@@ -379,8 +657,7 @@ static void lv_refr_area_part(const lv_area_t * area_p)
     /*In non double buffered mode, before rendering the next part wait until the previous image is
      * flushed*/
     if(lv_disp_is_double_buf(disp_refr) == false) {
-        while(vdb->flushing)
-            ;
+        lv_refr_wait_flush(vdb);
     }
 
     lv_obj_t * top_p;
@@ -390,15 +667,19 @@ static void lv_refr_area_part(const lv_area_t * area_p)
     lv_area_t start_mask;
     lv_area_intersect(&start_mask, area_p, &vdb->area);
 
-    /*Get the most top object which is not covered by others*/
-    top_p = lv_refr_get_top_obj(&start_mask, lv_disp_get_scr_act(disp_refr));
+    if(items_ok) {
+        lv_refr_items_draw(&start_mask);
+    } else {
+        /*Get the most top object which is not covered by others*/
+        top_p = lv_refr_get_top_obj(&start_mask, lv_disp_get_scr_act(disp_refr));
 
-    /*Do the refreshing from the top object*/
-    lv_refr_obj_and_children(top_p, &start_mask);
+        /*Do the refreshing from the top object*/
+        lv_refr_obj_and_children(top_p, &start_mask);
 
-    /*Also refresh top and sys layer unconditionally*/
-    lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), &start_mask);
-    lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), &start_mask);
+        /*Also refresh top and sys layer unconditionally*/
+        lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), &start_mask);
+        lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), &start_mask);
+    }
 
     /* In true double buffered mode flush only once when all areas were rendered.
      * In normal mode flush after every area */
@@ -554,6 +835,144 @@ static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
     }
 }
 
+/**
+ * Collect the design calls of an area into the draw list in the order of drawing.
+ * The masks of the calls are clipped to the area. The mask of a part of the area is the part clipped with them.
+ * @param area_p pointer to an invalidated area
+ * @return true: the list is ready; false: out of memory, walk the object tree instead
+ */
+static bool lv_refr_items_build(const lv_area_t * area_p)
+{
+    item_cnt = 0;
+    items_ok = true; /*Cleared by `lv_refr_items_add` if the list can't grow*/
+
+    lv_refr_items_add_obj(lv_disp_get_scr_act(disp_refr), area_p);
+    item_scr_cnt = item_cnt;
+
+    lv_refr_items_add_obj(lv_disp_get_layer_top(disp_refr), area_p);
+    lv_refr_items_add_obj(lv_disp_get_layer_sys(disp_refr), area_p);
+
+    return items_ok;
+}
+
+/**
+ * Add the design calls of an object and its children to the draw list.
+ * Works like `lv_refr_obj` but saves the calls instead of drawing.
+ * @param obj pointer to an object
+ * @param mask_ori_p pointer to an area, the objects will be drawn only here
+ */
+static void lv_refr_items_add_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
+{
+    if(obj->hidden != 0) return;
+
+    lv_area_t obj_mask;
+    lv_area_t obj_ext_mask;
+    lv_area_t obj_area;
+    lv_coord_t ext_size = obj->ext_draw_pad;
+    lv_obj_get_coords(obj, &obj_area);
+    obj_area.x1 -= ext_size;
+    obj_area.y1 -= ext_size;
+    obj_area.x2 += ext_size;
+    obj_area.y2 += ext_size;
+    if(lv_area_intersect(&obj_ext_mask, mask_ori_p, &obj_area) == false) return;
+
+    lv_refr_items_add(obj, &obj_ext_mask, LV_DESIGN_DRAW_MAIN);
+
+    /*The children are visible only on the object's coordinates (the extended mask is clipped by them anyway)*/
+    lv_obj_get_coords(obj, &obj_area);
+    if(lv_area_intersect(&obj_mask, mask_ori_p, &obj_area) != false) {
+        lv_obj_t * child_p;
+        LV_LL_READ_BACK(obj->child_ll, child_p)
+        {
+            lv_refr_items_add_obj(child_p, &obj_mask);
+        }
+    }
+
+    lv_refr_items_add(obj, &obj_ext_mask, LV_DESIGN_DRAW_POST);
+}
+
+/**
+ * Append a design call to the draw list. The list grows if required.
+ * @param obj pointer to an object
+ * @param mask_p mask of the call
+ * @param mode `LV_DESIGN_DRAW_MAIN` or `LV_DESIGN_DRAW_POST`
+ */
+static void lv_refr_items_add(lv_obj_t * obj, const lv_area_t * mask_p, lv_design_mode_t mode)
+{
+    if(items_ok == false) return;
+
+    if(item_cnt >= item_buf_size) {
+        uint32_t new_size     = item_buf_size ? item_buf_size * 2 : LV_REFR_ITEM_DEF_NUM;
+        lv_refr_item_t * tmp = lv_mem_realloc(items, new_size * sizeof(lv_refr_item_t));
+        if(tmp == NULL) {
+            items_ok = false;
+            return;
+        }
+        items         = tmp;
+        item_buf_size = new_size;
+    }
+
+    items[item_cnt].obj  = obj;
+    items[item_cnt].mode = mode;
+    lv_area_copy(&items[item_cnt].mask, mask_p);
+    item_cnt++;
+}
+
+/**
+ * Draw a part of an area from the draw list.
+ * The parts come from top to bottom so the items above the bottom of this part are dropped.
+ * @param mask_p pointer to the part to draw
+ */
+static void lv_refr_items_draw(const lv_area_t * mask_p)
+{
+    uint32_t start = 0;
+    uint32_t i;
+    uint32_t keep = 0;
+    uint32_t scr_keep = 0;
+    lv_area_t mask;
+
+    /* The objects below the top covering object are not visible.
+     * The draw order from its `DRAW_MAIN` is the same as in `lv_refr_obj_and_children`*/
+    lv_obj_t * top_p = lv_refr_get_top_obj(mask_p, lv_disp_get_scr_act(disp_refr));
+    if(top_p) {
+        for(i = 0; i < item_scr_cnt; i++) {
+            if(items[i].obj == top_p && items[i].mode == LV_DESIGN_DRAW_MAIN) {
+                start = i;
+                break;
+            }
+        }
+    }
+
+    for(i = 0; i < item_cnt; i++) {
+        if(i >= start && lv_area_intersect(&mask, &items[i].mask, mask_p)) {
+            items[i].obj->design_cb(items[i].obj, &mask, items[i].mode);
+        }
+
+        /*Keep only the items which reach the next parts*/
+        if(items[i].mask.y2 > mask_p->y2) {
+            items[keep] = items[i];
+            keep++;
+        }
+
+        if(i + 1 == item_scr_cnt) scr_keep = keep;
+    }
+
+    item_cnt     = keep;
+    item_scr_cnt = scr_keep;
+}
+
+/**
+ * Wait until the flushing of a buffer is finished. Call the driver's `wait_cb` in the meantime.
+ * @param vdb pointer to the display buffer
+ */
+static void lv_refr_wait_flush(lv_disp_buf_t * vdb)
+{
+    lv_disp_drv_t * drv = &disp_refr->driver;
+    while(vdb->flushing) {
+        if(drv->wait_cb) drv->wait_cb(drv);
+    }
+}
+
 /**
  * Flush the content of the VDB
  */
@@ -564,8 +983,7 @@ static void lv_refr_vdb_flush(void)
     /*In double buffered mode wait until the other buffer is flushed before flushing the current
      * one*/
     if(lv_disp_is_double_buf(disp_refr)) {
-        while(vdb->flushing)
-            ;
+        lv_refr_wait_flush(vdb);
     }
 
     vdb->flushing = 1;
@@ -62,6 +62,18 @@ void lv_refr_now(lv_disp_t * disp);
  */
 void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p);
 
+/**
+ * Collect the invalidated areas and join the overlapping ones until `lv_inv_batch_end`.
+ * E.g. an object moved by more animations in one tick invalidates almost the same area more times.
+ * The calls can be nested.
+ */
+void lv_inv_batch_start(void);
+
+/**
+ * Invalidate the collected areas and stop collecting them (at the end of the outermost batch)
+ */
+void lv_inv_batch_end(void);
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
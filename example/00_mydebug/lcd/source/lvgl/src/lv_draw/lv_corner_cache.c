@@ -0,0 +1,26 @@
+/**
+ * @file lv_corner_cache.c
+ * Cache of the coverage masks of the rounded corners.
+ * An instance of `lv_mask_cache` with its own keys and budget.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_corner_cache.h"
+
+#if LV_CORNER_CACHE_SIZE
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_mask_cache_entry_t entries[LV_CORNER_CACHE_ENTRY_NUM];
+static lv_corner_cache_key_t keys[LV_CORNER_CACHE_ENTRY_NUM];
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+lv_mask_cache_t lv_corner_cache = {entries, keys, sizeof(lv_corner_cache_key_t), LV_CORNER_CACHE_ENTRY_NUM,
+                                 LV_CORNER_CACHE_SIZE};
+
+#endif /*LV_CORNER_CACHE_SIZE*/
@@ -0,0 +1,78 @@
+/**
+ * @file lv_corner_cache.h
+ * Cache of the coverage masks of the rounded corners
+ */
+
+#ifndef LV_CORNER_CACHE_H
+#define LV_CORNER_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include "../lv_misc/lv_area.h"
+#include "../lv_misc/lv_color.h"
+#include "lv_mask_cache.h"
+
+#if LV_CORNER_CACHE_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Types of the corner masks*/
+enum {
+    LV_CORNER_BODY = 0, /**< Coverage of the body's corner*/
+    LV_CORNER_BORDER,   /**< Coverage of the border's right bottom (and mirrored left top) corner*/
+    LV_CORNER_BORDER_SWAP, /**< The border's corner with swapped x and y for the left bottom and right top corners*/
+};
+typedef uint8_t lv_corner_type_t;
+
+/**
+ * The parameters a corner mask depends on.
+ * The keys are compared byte by byte, clear them with `memset` before setting the fields.
+ */
+typedef struct
+{
+    lv_coord_t radius;  /**< Radius of the corner after the correction with the size*/
+    lv_coord_t width;   /**< Width of the border (decreased like in the drawing) or 0 for the body*/
+    lv_opa_t opa;       /**< Opacity of the anti-aliased pixels*/
+    uint8_t aa;         /**< 1: anti-aliased corner*/
+    uint8_t type;       /**< Body or border corner from `lv_corner_type_t`*/
+} lv_corner_cache_key_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * The cache of the corner masks (`LV_CORNER_CACHE_SIZE` bytes, `LV_CORNER_CACHE_ENTRY_NUM` masks)
+ * with `lv_corner_cache_key_t` keys. Use it with the `lv_mask_cache_...` functions.
+ */
+extern lv_mask_cache_t lv_corner_cache;
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_CORNER_CACHE_SIZE*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_CORNER_CACHE_H*/
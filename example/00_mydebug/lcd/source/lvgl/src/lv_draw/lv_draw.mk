@@ -1,4 +1,5 @@
 CSRCS += lv_draw_basic.c
+CSRCS += lv_draw_blend.c
 CSRCS += lv_draw.c
 CSRCS += lv_draw_rect.c
 CSRCS += lv_draw_label.c
@@ -8,6 +9,10 @@ CSRCS += lv_draw_arc.c
 CSRCS += lv_draw_triangle.c
 CSRCS += lv_img_decoder.c
 CSRCS += lv_img_cache.c
+CSRCS += lv_img_qli.c
+CSRCS += lv_mask_cache.c
+CSRCS += lv_shadow_cache.c
+CSRCS += lv_corner_cache.c
 
 DEPPATH += --dep-path $(LVGL_DIR)/lvgl/src/lv_draw
 VPATH += :$(LVGL_DIR)/lvgl/src/lv_draw
@@ -18,6 +18,7 @@
 
 #include <stddef.h>
 #include "lv_draw.h"
+#include "lv_draw_blend.h"
 
 /*********************
  *      INCLUDES
@@ -41,7 +42,6 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void sw_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
 static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area, lv_color_t color,
                           lv_opa_t opa);
 
@@ -448,6 +448,77 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
     }
 }
 
+/**
+ * Draw a color through an opacity map (one `lv_opa_t` per pixel)
+ * @param cords_p coordinates of the map
+ * @param mask_p the map will drawn only on this area
+ * @param map_p opacity of the pixels, rows of `lv_area_get_width(cords_p)` pixels
+ * @param mirror `LV_DRAW_MIRROR_X/Y` to draw the map mirrored horizontally/vertically
+ * @param color color of the pixels
+ */
+void lv_draw_opa_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const lv_opa_t * map_p, uint8_t mirror,
+                     lv_color_t color)
+{
+    lv_area_t draw_a;
+    if(lv_area_intersect(&draw_a, cords_p, mask_p) == false) return;
+
+    lv_disp_t * disp    = lv_refr_get_disp_refreshing();
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+    lv_coord_t vdb_width = lv_area_get_width(&vdb->area);
+    lv_coord_t map_width = lv_area_get_width(cords_p);
+
+    bool scr_transp = false;
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+    scr_transp = disp->driver.screen_transp;
+#endif
+
+    /*Find the map pixel of the first drawn pixel and the steps on the map*/
+    int32_t step_x = 1;
+    int32_t step_y = map_width;
+    lv_coord_t map_x = draw_a.x1 - cords_p->x1;
+    lv_coord_t map_y = draw_a.y1 - cords_p->y1;
+    if(mirror & LV_DRAW_MIRROR_X) {
+        map_x  = cords_p->x2 - draw_a.x1;
+        step_x = -1;
+    }
+    if(mirror & LV_DRAW_MIRROR_Y) {
+        map_y  = cords_p->y2 - draw_a.y1;
+        step_y = -map_width;
+    }
+    map_p += (int32_t)map_y * map_width + map_x;
+
+    lv_coord_t draw_w = lv_area_get_width(&draw_a);
+    lv_color_t * vdb_buf_tmp = vdb->buf_act;
+    vdb_buf_tmp += (int32_t)(draw_a.y1 - vdb->area.y1) * vdb_width + draw_a.x1 - vdb->area.x1;
+
+    lv_coord_t row;
+    lv_coord_t col;
+    for(row = draw_a.y1; row <= draw_a.y2; row++) {
+        const lv_opa_t * map_px = map_p;
+        for(col = 0; col < draw_w; col++) {
+            lv_opa_t opa = *map_px;
+            map_px += step_x;
+            if(opa < LV_OPA_MIN) continue;
+            if(opa > LV_OPA_MAX) opa = LV_OPA_COVER;
+
+            if(disp->driver.set_px_cb) {
+                disp->driver.set_px_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width,
+                                       draw_a.x1 + col - vdb->area.x1, row - vdb->area.y1, color, opa);
+            } else if(scr_transp == false) {
+                if(opa == LV_OPA_COVER) vdb_buf_tmp[col] = color;
+                else vdb_buf_tmp[col] = lv_color_mix(color, vdb_buf_tmp[col], opa);
+            } else {
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+                vdb_buf_tmp[col] = color_mix_2_alpha(vdb_buf_tmp[col], vdb_buf_tmp[col].ch.alpha, color, opa);
+#endif
+            }
+        }
+
+        map_p += step_y;
+        vdb_buf_tmp += vdb_width;
+    }
+}
+
 /**
  * Draw a color map to the display (image)
  * @param cords_p coordinates the color map
@@ -526,17 +597,24 @@ void lv_draw_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint
                 map_p += map_width * px_size_byte; /*Next row on the map*/
             }
         }
+#if LV_USE_GPU
+        /*Copy the whole rectangle at once with the hw. acc. if present*/
+        else if(disp->driver.gpu_copy_cb) {
+            disp->driver.gpu_copy_cb(&disp->driver, vdb_buf_tmp, vdb_width, (const lv_color_t *)map_p, map_width,
+                                     map_useful_w, lv_area_get_height(&masked_a));
+        }
+#endif
         /*Normal native VDB*/
         else {
             for(row = masked_a.y1; row <= masked_a.y2; row++) {
 #if LV_USE_GPU
                 if(disp->driver.gpu_blend_cb == NULL) {
-                    sw_mem_blend(vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
+                    lv_draw_blend_map(vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
                 } else {
                     disp->driver.gpu_blend_cb(&disp->driver, vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
                 }
 #else
-                sw_mem_blend(vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
+                lv_draw_blend_map(vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
 #endif
                 map_p += map_width * px_size_byte; /*Next row on the map*/
                 vdb_buf_tmp += vdb_width;          /*Next row on the VDB*/
@@ -633,25 +711,6 @@ void lv_draw_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint
  *   STATIC FUNCTIONS
  **********************/
 
-/**
- * Blend pixels to destination memory using opacity
- * @param dest a memory address. Copy 'src' here.
- * @param src pointer to pixel map. Copy it to 'dest'.
- * @param length number of pixels in 'src'
- * @param opa opacity (0, LV_OPA_TRANSP: transparent ... 255, LV_OPA_COVER, fully cover)
- */
-static void sw_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
-{
-    if(opa == LV_OPA_COVER) {
-        memcpy(dest, src, length * sizeof(lv_color_t));
-    } else {
-        uint32_t col;
-        for(col = 0; col < length; col++) {
-            dest[col] = lv_color_mix(src[col], dest[col], opa);
-        }
-    }
-}
-
 /**
  * Fill an area with a color
  * @param mem a memory address. Considered to a rectangular window according to 'mem_area'
@@ -674,56 +733,22 @@ static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_
                 disp->driver.set_px_cb(&disp->driver, (uint8_t *)mem, mem_width, col, row, color, opa);
             }
         }
-    } else {
+    }
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+    /*Mix the alpha channels too*/
+    else if(opa != LV_OPA_COVER && disp->driver.screen_transp) {
         mem += fill_area->y1 * mem_width; /*Go to the first row*/
 
-        /*Run simpler function without opacity*/
-        if(opa == LV_OPA_COVER) {
-
-            /*Fill the first row with 'color'*/
+        for(row = fill_area->y1; row <= fill_area->y2; row++) {
             for(col = fill_area->x1; col <= fill_area->x2; col++) {
-                mem[col] = color;
+                mem[col] = color_mix_2_alpha(mem[col], mem[col].ch.alpha, color, opa);
             }
-
-            /*Copy the first row to all other rows*/
-            lv_color_t * mem_first = &mem[fill_area->x1];
-            lv_coord_t copy_size   = (fill_area->x2 - fill_area->x1 + 1) * sizeof(lv_color_t);
             mem += mem_width;
-
-            for(row = fill_area->y1 + 1; row <= fill_area->y2; row++) {
-                memcpy(&mem[fill_area->x1], mem_first, copy_size);
-                mem += mem_width;
-            }
         }
-        /*Calculate with alpha too*/
-        else {
-            bool scr_transp = false;
-#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
-            scr_transp = disp->driver.screen_transp;
-#endif
-
-            lv_color_t bg_tmp  = LV_COLOR_BLACK;
-            lv_color_t opa_tmp = lv_color_mix(color, bg_tmp, opa);
-            for(row = fill_area->y1; row <= fill_area->y2; row++) {
-                for(col = fill_area->x1; col <= fill_area->x2; col++) {
-                    if(scr_transp == false) {
-                        /*If the bg color changed recalculate the result color*/
-                        if(mem[col].full != bg_tmp.full) {
-                            bg_tmp  = mem[col];
-                            opa_tmp = lv_color_mix(color, bg_tmp, opa);
-                        }
-
-                        mem[col] = opa_tmp;
-
-                    } else {
-#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
-                        mem[col] = color_mix_2_alpha(mem[col], mem[col].ch.alpha, color, opa);
+    }
 #endif
-                    }
-                }
-                mem += mem_width;
-            }
-        }
+    else {
+        lv_draw_blend_fill(mem, mem_width, fill_area, color, opa);
     }
 }
 
@@ -26,6 +26,9 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/*Flags of `lv_draw_opa_map` to mirror the map*/
+#define LV_DRAW_MIRROR_X    0x01
+#define LV_DRAW_MIRROR_Y    0x02
 
 /**********************
  *      TYPEDEFS
@@ -71,6 +74,17 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
 void lv_draw_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint8_t * map_p, lv_opa_t opa,
                  bool chroma_key, bool alpha_byte, lv_color_t recolor, lv_opa_t recolor_opa);
 
+/**
+ * Draw a color through an opacity map (one `lv_opa_t` per pixel)
+ * @param cords_p coordinates of the map
+ * @param mask_p the map will drawn only on this area
+ * @param map_p opacity of the pixels, rows of `lv_area_get_width(cords_p)` pixels
+ * @param mirror `LV_DRAW_MIRROR_X/Y` to draw the map mirrored horizontally/vertically
+ * @param color color of the pixels
+ */
+void lv_draw_opa_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const lv_opa_t * map_p, uint8_t mirror,
+                     lv_color_t color);
+
 /**********************
  *      MACROS
  **********************/
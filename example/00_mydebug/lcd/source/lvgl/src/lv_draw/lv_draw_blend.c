@@ -0,0 +1,248 @@
+/**
+ * @file lv_draw_blend.c
+ * Fill and blend kernels of the software renderer.
+ * With RGB565 colors two pixels are mixed at once: the same channel of both pixels is moved into
+ * the two halves of a 32 bit word so one multiplication handles both. `channel * opa` fits into
+ * 16 bits (max. 63 * 255) so the halves can't overflow into each other and the result is
+ * exactly the same as `lv_color_mix`.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_draw_blend.h"
+#include "../lv_misc/lv_types.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_DRAW_BLEND_PACKED
+/*Masks of the channels of two pixels after shifting them to bit 0 and 16*/
+#define MASK_B 0x001F001FU
+#define MASK_G 0x003F003FU
+#define MASK_R 0x001F001FU
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fill_row(lv_color_t * dest, lv_coord_t len, lv_color_t color);
+#if LV_DRAW_BLEND_PACKED
+static inline uint32_t mix_packed(uint32_t bg, uint32_t fg_b, uint32_t fg_g, uint32_t fg_r, uint32_t opa_inv);
+static inline uint32_t load_packed(const lv_color_t * p);
+static inline void store_packed(lv_color_t * p, uint32_t v);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Blend pixels to destination memory using opacity.
+ * Gives the same result as `lv_color_mix(src[i], dest[i], opa)` for every pixel.
+ * @param dest a memory address. Copy 'src' here.
+ * @param src pointer to pixel map. Copy it to 'dest'.
+ * @param length number of pixels in 'src'
+ * @param opa opacity (0, LV_OPA_TRANSP: transparent ... 255, LV_OPA_COVER, fully cover)
+ */
+void lv_draw_blend_map(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    if(opa == LV_OPA_COVER) {
+        memcpy(dest, src, length * sizeof(lv_color_t));
+        return;
+    }
+
+#if LV_DRAW_BLEND_PACKED
+    uint32_t opa_inv = 255 - opa;
+
+    /*Mix one pixel alone to write whole words*/
+    if(((lv_uintptr_t)dest & 0x3) && length > 0) {
+        *dest = lv_color_mix(*src, *dest, opa);
+        dest++;
+        src++;
+        length--;
+    }
+
+    for(; length >= 2; length -= 2) {
+        uint32_t fg = load_packed(src);
+        store_packed(dest, mix_packed(load_packed(dest), (fg & MASK_B) * opa, ((fg >> 5) & MASK_G) * opa,
+                                      ((fg >> 11) & MASK_R) * opa, opa_inv));
+        dest += 2;
+        src += 2;
+    }
+
+    if(length > 0) *dest = lv_color_mix(*src, *dest, opa);
+#else
+    uint32_t col;
+    for(col = 0; col < length; col++) {
+        dest[col] = lv_color_mix(src[col], dest[col], opa);
+    }
+#endif
+}
+
+/**
+ * Fill an area of a memory with a color.
+ * Gives the same result as `lv_color_mix(color, mem[i], opa)` for every pixel.
+ * @param mem a memory address. Considered to a rectangular window according to 'mem_area'
+ * @param mem_width width of the 'mem' buffer
+ * @param fill_area coordinates of an area to fill. Relative to 'mem_area'.
+ * @param color fill color
+ * @param opa opacity (0, LV_OPA_TRANSP: transparent ... 255, LV_OPA_COVER, fully cover)
+ */
+void lv_draw_blend_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area, lv_color_t color,
+                        lv_opa_t opa)
+{
+    lv_coord_t w = lv_area_get_width(fill_area);
+    lv_coord_t row;
+
+    mem += fill_area->y1 * mem_width + fill_area->x1; /*Go to the first pixel*/
+
+    /*Run simpler function without opacity*/
+    if(opa == LV_OPA_COVER) {
+        /*Fill the first row with 'color' and copy it to all other rows*/
+        fill_row(mem, w, color);
+
+        lv_color_t * mem_first = mem;
+        for(row = fill_area->y1 + 1; row <= fill_area->y2; row++) {
+            mem += mem_width;
+            memcpy(mem, mem_first, w * sizeof(lv_color_t));
+        }
+        return;
+    }
+
+    /*The background is mostly the same color so save the last result*/
+#if LV_DRAW_BLEND_PACKED
+    uint32_t fg      = (uint32_t)color.full | ((uint32_t)color.full << 16);
+    uint32_t fg_b    = (fg & MASK_B) * opa;
+    uint32_t fg_g    = ((fg >> 5) & MASK_G) * opa;
+    uint32_t fg_r    = ((fg >> 11) & MASK_R) * opa;
+    uint32_t opa_inv = 255 - opa;
+    uint32_t bg_tmp  = 0;
+    uint32_t res_tmp = mix_packed(bg_tmp, fg_b, fg_g, fg_r, opa_inv);
+
+    for(row = fill_area->y1; row <= fill_area->y2; row++) {
+        lv_color_t * p = mem;
+        lv_coord_t len = w;
+
+        /*Mix one pixel alone to write whole words*/
+        if(((lv_uintptr_t)p & 0x3) && len > 0) {
+            *p = lv_color_mix(color, *p, opa);
+            p++;
+            len--;
+        }
+
+        for(; len >= 2; len -= 2) {
+            uint32_t bg = load_packed(p);
+            if(bg != bg_tmp) {
+                bg_tmp  = bg;
+                res_tmp = mix_packed(bg, fg_b, fg_g, fg_r, opa_inv);
+            }
+            store_packed(p, res_tmp);
+            p += 2;
+        }
+
+        if(len > 0) *p = lv_color_mix(color, *p, opa);
+
+        mem += mem_width;
+    }
+#else
+    lv_color_t bg_tmp  = LV_COLOR_BLACK;
+    lv_color_t opa_tmp = lv_color_mix(color, bg_tmp, opa);
+    lv_coord_t col;
+
+    for(row = fill_area->y1; row <= fill_area->y2; row++) {
+        for(col = 0; col < w; col++) {
+            /*If the bg color changed recalculate the result color*/
+            if(mem[col].full != bg_tmp.full) {
+                bg_tmp  = mem[col];
+                opa_tmp = lv_color_mix(color, bg_tmp, opa);
+            }
+
+            mem[col] = opa_tmp;
+        }
+        mem += mem_width;
+    }
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Set the pixels of a row to a color
+ * @param dest pointer to the first pixel
+ * @param len number of pixels
+ * @param color the color
+ */
+static void fill_row(lv_color_t * dest, lv_coord_t len, lv_color_t color)
+{
+#if LV_DRAW_BLEND_PACKED
+    if(((lv_uintptr_t)dest & 0x3) && len > 0) {
+        *dest = color;
+        dest++;
+        len--;
+    }
+
+    /*Write two pixels at once*/
+    uint32_t c32 = (uint32_t)color.full | ((uint32_t)color.full << 16);
+    for(; len >= 2; len -= 2) {
+        store_packed(dest, c32);
+        dest += 2;
+    }
+
+    if(len > 0) *dest = color;
+#else
+    lv_coord_t i;
+    for(i = 0; i < len; i++) {
+        dest[i] = color;
+    }
+#endif
+}
+
+#if LV_DRAW_BLEND_PACKED
+/**
+ * Mix two packed RGB565 pixels with a foreground color
+ * @param bg two background pixels
+ * @param fg_b blue channels of the foreground at bit 0 and 16, multiplied by the opacity
+ * @param fg_g green channels of the foreground at bit 0 and 16, multiplied by the opacity
+ * @param fg_r red channels of the foreground at bit 0 and 16, multiplied by the opacity
+ * @param opa_inv 255 - opacity
+ * @return the two mixed pixels
+ */
+static inline uint32_t mix_packed(uint32_t bg, uint32_t fg_b, uint32_t fg_g, uint32_t fg_r, uint32_t opa_inv)
+{
+    uint32_t b = ((fg_b + (bg & MASK_B) * opa_inv) >> 8) & MASK_B;
+    uint32_t g = ((fg_g + ((bg >> 5) & MASK_G) * opa_inv) >> 8) & MASK_G;
+    uint32_t r = ((fg_r + ((bg >> 11) & MASK_R) * opa_inv) >> 8) & MASK_R;
+
+    return b | (g << 5) | (r << 11);
+}
+
+/*Read two pixels as a word. `memcpy` is compiled to a single load but doesn't break strict aliasing.*/
+static inline uint32_t load_packed(const lv_color_t * p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/*Write two pixels as a word*/
+static inline void store_packed(lv_color_t * p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+#endif
@@ -586,7 +586,7 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
         for(row = mask_com.y1; row <= mask_com.y2; row++) {
             read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
             if(read_res != LV_RES_OK) {
-                lv_img_decoder_close(&cdsc->dec_dsc);
+                lv_img_cache_invalidate_src(src);
                 LV_LOG_WARN("Image draw can't read the line");
                 return LV_RES_INV;
             }
@@ -29,6 +29,14 @@ typedef uint8_t cmd_state_t;
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
+                       const char * txt, lv_txt_flag_t flag, lv_point_t * offset, lv_draw_label_txt_sel_t * sel,
+                       lv_draw_label_hint_t * hint, lv_txt_layout_t * layout, lv_bidi_dir_t bidi_dir);
+static uint32_t get_line_end(const char * txt, uint32_t line_start, uint32_t line_id, const lv_font_t * font,
+                             lv_coord_t letter_space, lv_coord_t w, lv_txt_flag_t flag, lv_txt_layout_t * layout);
+static lv_coord_t get_line_width(const char * txt, uint32_t line_start, uint32_t line_end, uint32_t line_id,
+                                 const lv_font_t * font, lv_coord_t letter_space, lv_txt_flag_t flag,
+                                 lv_txt_layout_t * layout);
 static uint8_t hex_char_to_num(char hex);
 
 /**********************
@@ -57,6 +65,38 @@ static uint8_t hex_char_to_num(char hex);
 void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
                    const char * txt, lv_txt_flag_t flag, lv_point_t * offset, lv_draw_label_txt_sel_t * sel,
                    lv_draw_label_hint_t * hint, lv_bidi_dir_t bidi_dir)
+{
+    draw_label(coords, mask, style, opa_scale, txt, flag, offset, sel, hint, NULL, bidi_dir);
+}
+
+/**
+ * Write a text with the line breaks of a layout cache.
+ * The lines are measured only once while the text, the font and the width are the same.
+ * @param coords coordinates of the label
+ * @param mask the label will be drawn only in this area
+ * @param style pointer to a style
+ * @param opa_scale scale down all opacities by the factor
+ * @param txt 0 terminated text to write
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @param offset text offset in x and y direction (NULL if unused)
+ * @param sel make the text selected in the range by drawing a background there
+ * @param layout pointer to the layout of the text. Updated if it belongs to an other text, font or width.
+ * @param bidi_dir base direction of the text
+ */
+void lv_draw_label_layout(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
+                          lv_opa_t opa_scale, const char * txt, lv_txt_flag_t flag, lv_point_t * offset,
+                          lv_draw_label_txt_sel_t * sel, lv_txt_layout_t * layout, lv_bidi_dir_t bidi_dir)
+{
+    draw_label(coords, mask, style, opa_scale, txt, flag, offset, sel, NULL, layout, bidi_dir);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
+                       const char * txt, lv_txt_flag_t flag, lv_point_t * offset, lv_draw_label_txt_sel_t * sel,
+                       lv_draw_label_hint_t * hint, lv_txt_layout_t * layout, lv_bidi_dir_t bidi_dir)
 {
     const lv_font_t * font = style->text.font;
     lv_coord_t w;
@@ -70,11 +110,18 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     } else {
         /*If EXAPND is enabled then not limit the text's width to the object's width*/
         lv_point_t p;
-        lv_txt_get_size(&p, txt, style->text.font, style->text.letter_space, style->text.line_space, LV_COORD_MAX,
-                flag);
+        if(layout) {
+            lv_txt_layout_set(layout, txt, font, style->text.letter_space, LV_COORD_MAX, flag);
+            lv_txt_layout_get_size(layout, &p, style->text.line_space);
+        } else {
+            lv_txt_get_size(&p, txt, style->text.font, style->text.letter_space, style->text.line_space, LV_COORD_MAX,
+                    flag);
+        }
         w = p.x;
     }
 
+    if(layout) lv_txt_layout_set(layout, txt, font, style->text.letter_space, w, flag);
+
     lv_coord_t line_height = lv_font_get_line_height(font) + style->text.line_space;
 
     /*Init variables for the first line*/
@@ -92,6 +139,7 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     }
 
     uint32_t line_start     = 0;
+    uint32_t line_id        = 0;
     int32_t last_line_start = -1;
 
     /*Check the hint to use the cached info*/
@@ -110,13 +158,14 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     }
 
 
-    uint32_t line_end = line_start + lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+    uint32_t line_end = get_line_end(txt, line_start, line_id, font, style->text.letter_space, w, flag, layout);
 
     /*Go the first visible line*/
     while(pos.y + line_height < mask->y1) {
         /*Go to next line*/
         line_start = line_end;
-        line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+        line_id++;
+        line_end = get_line_end(txt, line_start, line_id, font, style->text.letter_space, w, flag, layout);
         pos.y += line_height;
 
         /*Save at the threshold coordinate*/
@@ -131,14 +180,14 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
 
     /*Align to middle*/
     if(flag & LV_TXT_FLAG_CENTER) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        line_width = get_line_width(txt, line_start, line_end, line_id, font, style->text.letter_space, flag, layout);
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(flag & LV_TXT_FLAG_RIGHT) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        line_width = get_line_width(txt, line_start, line_end, line_id, font, style->text.letter_space, flag, layout);
         pos.x += lv_area_get_width(coords) - line_width;
     }
 
@@ -261,13 +310,14 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         }
         /*Go to next line*/
         line_start = line_end;
-        line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+        line_id++;
+        line_end = get_line_end(txt, line_start, line_id, font, style->text.letter_space, w, flag, layout);
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(flag & LV_TXT_FLAG_CENTER) {
             line_width =
-                    lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+                    get_line_width(txt, line_start, line_end, line_id, font, style->text.letter_space, flag, layout);
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
@@ -275,7 +325,7 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         /*Align to the right*/
         else if(flag & LV_TXT_FLAG_RIGHT) {
             line_width =
-                    lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+                    get_line_width(txt, line_start, line_end, line_id, font, style->text.letter_space, flag, layout);
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
@@ -286,9 +336,52 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     }
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+/**
+ * Get the end of a line: the start of the next line
+ * @param txt the text
+ * @param line_start byte index of the line's first letter
+ * @param line_id index of the line
+ * @param font pointer to the font
+ * @param letter_space letter space
+ * @param w max. width of the line
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @param layout pointer to the layout of the text or NULL to measure the line
+ * @return byte index of the next line's first letter
+ */
+static uint32_t get_line_end(const char * txt, uint32_t line_start, uint32_t line_id, const lv_font_t * font,
+                             lv_coord_t letter_space, lv_coord_t w, lv_txt_flag_t flag, lv_txt_layout_t * layout)
+{
+    uint32_t start;
+    uint32_t end;
+    if(layout && lv_txt_layout_get_line(layout, line_id, &start, &end, NULL)) return end;
+
+    /*Past the last line or out of memory in the layout*/
+    return line_start + lv_txt_get_next_line(&txt[line_start], font, letter_space, w, flag);
+}
+
+/**
+ * Get the width of a line
+ * @param txt the text
+ * @param line_start byte index of the line's first letter
+ * @param line_end byte index of the next line's first letter
+ * @param line_id index of the line
+ * @param font pointer to the font
+ * @param letter_space letter space
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @param layout pointer to the layout of the text or NULL to measure the line
+ * @return width of the line
+ */
+static lv_coord_t get_line_width(const char * txt, uint32_t line_start, uint32_t line_end, uint32_t line_id,
+                                 const lv_font_t * font, lv_coord_t letter_space, lv_txt_flag_t flag,
+                                 lv_txt_layout_t * layout)
+{
+    uint32_t start;
+    uint32_t end;
+    lv_coord_t line_w;
+    if(layout && lv_txt_layout_get_line(layout, line_id, &start, &end, &line_w)) return line_w;
+
+    return lv_txt_get_width(&txt[line_start], line_end - line_start, font, letter_space, flag);
+}
 
 /**
  * Convert a hexadecimal characters to a number (0..15)
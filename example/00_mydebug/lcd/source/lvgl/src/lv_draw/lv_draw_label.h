@@ -15,6 +15,7 @@ extern "C" {
  *********************/
 #include "lv_draw.h"
 #include "../lv_misc/lv_bidi.h"
+#include "../lv_misc/lv_txt_layout.h"
 
 /*********************
  *      DEFINES
@@ -69,6 +70,24 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
                    const char * txt, lv_txt_flag_t flag, lv_point_t * offset, lv_draw_label_txt_sel_t * sel,
                    lv_draw_label_hint_t * hint, lv_bidi_dir_t bidi_dir);
 
+/**
+ * Write a text with the line breaks of a layout cache.
+ * The lines are measured only once while the text, the font and the width are the same.
+ * @param coords coordinates of the label
+ * @param mask the label will be drawn only in this area
+ * @param style pointer to a style
+ * @param opa_scale scale down all opacities by the factor
+ * @param txt 0 terminated text to write
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @param offset text offset in x and y direction (NULL if unused)
+ * @param sel make the text selected in the range by drawing a background there
+ * @param layout pointer to the layout of the text. Updated if it belongs to an other text, font or width.
+ * @param bidi_dir base direction of the text
+ */
+void lv_draw_label_layout(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
+                          lv_opa_t opa_scale, const char * txt, lv_txt_flag_t flag, lv_point_t * offset,
+                          lv_draw_label_txt_sel_t * sel, lv_txt_layout_t * layout, lv_bidi_dir_t bidi_dir);
+
 /**********************
  *      MACROS
  **********************/
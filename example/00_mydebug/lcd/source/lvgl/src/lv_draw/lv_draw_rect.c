@@ -6,7 +6,10 @@
 /*********************
  *      INCLUDES
  *********************/
+#include <string.h>
 #include "lv_draw_rect.h"
+#include "lv_shadow_cache.h"
+#include "lv_corner_cache.h"
 #include "../lv_misc/lv_circ.h"
 #include "../lv_misc/lv_math.h"
 #include "../lv_core/lv_refr.h"
@@ -24,9 +27,53 @@
 /*Add extra radius with LV_SHADOW_BOTTOM to cover anti-aliased corners*/
 #define SHADOW_BOTTOM_AA_EXTRA_RADIUS 3
 
+/*Corners with greater radius are drawn without a cached mask*/
+#define CORNER_MASK_RADIUS_MAX 48
+
+/*Max. number of pixels drawn again while the mask of a corner is calculated*/
+#define CORNER_MASK_AGAIN_MAX 32
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+/*Header of a cached shadow mask. It's followed by the opacities of the edge and the map of a corner.*/
+typedef struct
+{
+    lv_coord_t corner_w;
+    lv_coord_t corner_h;
+} shadow_mask_t;
+#endif
+
+#if LV_CORNER_CACHE_SIZE
+/* Header of a cached corner mask. It's followed by the offsets of the rows and the rows.
+ * A row is the number of runs and the runs as x, length and type.
+ * `LV_OPA_COVER` type is a run of the body or the border drawn with the style's opacity,
+ * `LV_OPA_TRANSP` type is followed by `length` opacities of anti-aliased pixels.*/
+typedef struct
+{
+    uint16_t row_cnt;
+} corner_mask_t;
+
+/*A pixel of a corner drawn again (blended to itself)*/
+typedef struct
+{
+    uint8_t x;
+    uint8_t y;
+    lv_opa_t cov;
+} corner_px_t;
+
+/*Right bottom corner drawn to a buffer*/
+typedef struct
+{
+    lv_opa_t * buf;         /*`size` x `size` opacities. 0: not drawn*/
+    corner_px_t * again;    /*The pixels drawn again*/
+    uint16_t again_cnt;
+    lv_coord_t size;
+    lv_opa_t opa;           /*Opacity of the anti-aliased pixels*/
+    bool ok;                /*false: a pixel was drawn out of the buffer or `again` is full*/
+} corner_canvas_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -39,6 +86,23 @@ static void lv_draw_rect_border_straight(const lv_area_t * coords, const lv_area
                                          lv_opa_t opa_scale);
 static void lv_draw_rect_border_corner(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                        lv_opa_t opa_scale);
+#if LV_CORNER_CACHE_SIZE
+static bool lv_draw_rect_main_corner_cached(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
+                                            lv_opa_t opa_scale);
+static bool lv_draw_rect_border_corner_cached(const lv_area_t * coords, const lv_area_t * mask,
+                                              const lv_style_t * style, lv_opa_t opa_scale);
+static void lv_draw_corner_row(const uint8_t * mask_data, uint16_t row, lv_coord_t y, lv_coord_t x_left,
+                               lv_coord_t x_right, bool body, const lv_area_t * mask, lv_color_t fill_color,
+                               lv_color_t aa_color, lv_opa_t opa);
+static const uint8_t * lv_draw_corner_mask_get(lv_coord_t radius, lv_coord_t bwidth, bool aa, lv_opa_t opa,
+                                               lv_corner_type_t type);
+static void corner_canvas_body(corner_canvas_t * canvas, lv_coord_t radius, bool aa);
+static void corner_canvas_border(corner_canvas_t * canvas, lv_coord_t radius, lv_coord_t bwidth, bool aa);
+static void corner_canvas_out_aa(corner_canvas_t * canvas, lv_coord_t x_last, lv_coord_t seg_start, lv_coord_t seg_size,
+                                 bool last, bool ver_first);
+static void corner_canvas_px(corner_canvas_t * canvas, lv_coord_t x, lv_coord_t y, lv_opa_t cov);
+static uint32_t corner_canvas_encode(const corner_canvas_t * canvas, bool swap, uint8_t * mask_data);
+#endif
 
 #if LV_USE_SHADOW
 static void lv_draw_shadow(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
@@ -49,6 +113,18 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
                                   lv_opa_t opa_scale);
 static void lv_draw_shadow_full_straight(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                          const lv_opa_t * map);
+static void lv_draw_shadow_full_init(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, lv_coord_t ** curve_x,
+                                     uint32_t ** line_1d_blur, lv_opa_t ** line_2d_blur);
+static uint16_t lv_draw_shadow_full_blur_line(int16_t line, lv_coord_t radius, lv_coord_t swidth,
+                                              const lv_coord_t * curve_x, const uint32_t * line_1d_blur,
+                                              lv_opa_t * line_2d_blur);
+static void lv_draw_shadow_bottom_init(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, lv_coord_t ** curve_x,
+                                       lv_opa_t ** line_1d_blur);
+static lv_opa_t lv_draw_shadow_bottom_get_opa(const lv_opa_t * line_1d_blur, uint16_t d, int16_t diff);
+#if LV_SHADOW_CACHE_SIZE
+static const uint8_t * lv_draw_shadow_full_mask(const lv_shadow_cache_key_t * key);
+static const uint8_t * lv_draw_shadow_bottom_mask(const lv_shadow_cache_key_t * key);
+#endif
 #endif
 
 static uint16_t lv_draw_cont_radius_corr(uint16_t r, lv_coord_t w, lv_coord_t h);
@@ -194,6 +270,10 @@ static void lv_draw_rect_main_mid(const lv_area_t * coords, const lv_area_t * ma
 static void lv_draw_rect_main_corner(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                      lv_opa_t opa_scale)
 {
+#if LV_CORNER_CACHE_SIZE
+    if(lv_draw_rect_main_corner_cached(coords, mask, style, opa_scale)) return;
+#endif
+
     uint16_t radius = style->body.radius;
     bool aa         = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
 
@@ -666,6 +746,10 @@ static void lv_draw_rect_border_straight(const lv_area_t * coords, const lv_area
 static void lv_draw_rect_border_corner(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                        lv_opa_t opa_scale)
 {
+#if LV_CORNER_CACHE_SIZE
+    if(lv_draw_rect_border_corner_cached(coords, mask, style, opa_scale)) return;
+#endif
+
     uint16_t radius       = style->body.radius;
     bool aa               = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
     lv_coord_t bwidth     = style->body.border.width;
@@ -1065,6 +1149,606 @@ static void lv_draw_rect_border_corner(const lv_area_t * coords, const lv_area_t
 #endif
 }
 
+#if LV_CORNER_CACHE_SIZE
+/**
+ * Draw the top and bottom parts (corners) of a rectangle with the cached mask of the corners
+ * @param coords the coordinates of the original rectangle
+ * @param mask the rectangle will be drawn only  on this area
+ * @param style pointer to a style
+ * @param opa_scale scale down all opacities by the factor
+ * @return true: the corners are drawn; false: the corners can't be drawn with a mask
+ */
+static bool lv_draw_rect_main_corner_cached(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
+                                            lv_opa_t opa_scale)
+{
+    uint16_t radius = style->body.radius;
+    bool aa         = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
+
+    lv_color_t mcolor = style->body.main_color;
+    lv_color_t gcolor = style->body.grad_color;
+    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
+    lv_coord_t height = lv_area_get_height(coords);
+    lv_coord_t width  = lv_area_get_width(coords);
+
+    radius = lv_draw_cont_radius_corr(radius, width, height);
+
+    lv_point_t lt_origo; /*Left  Top    origo*/
+    lv_point_t rb_origo; /*Right Bottom origo*/
+
+    lt_origo.x = coords->x1 + radius + aa;
+    lt_origo.y = coords->y1 + radius + aa;
+
+    rb_origo.x = coords->x2 - radius - aa;
+    rb_origo.y = coords->y2 - radius - aa;
+
+    /*The corners would overlap*/
+    if(rb_origo.x <= lt_origo.x || rb_origo.y <= lt_origo.y) return false;
+
+    const uint8_t * mask_data = lv_draw_corner_mask_get(radius, 0, aa, opa, LV_CORNER_BODY);
+    if(mask_data == NULL) return false;
+
+    lv_coord_t row_cnt = ((const corner_mask_t *)mask_data)->row_cnt;
+    lv_coord_t y;
+    for(y = LV_MATH_MAX(mask->y1, rb_origo.y); y <= LV_MATH_MIN(mask->y2, rb_origo.y + row_cnt - 1); y++) {
+        uint8_t mix          = (uint32_t)((uint32_t)(coords->y2 - y) * 255) / height;
+        lv_color_t aa_color  = lv_color_mix(mcolor, gcolor, mix);
+        lv_color_t act_color = mcolor.full == gcolor.full ? mcolor : aa_color;
+        lv_draw_corner_row(mask_data, y - rb_origo.y, y, lt_origo.x, rb_origo.x, true, mask, act_color, aa_color, opa);
+    }
+
+    for(y = LV_MATH_MAX(mask->y1, lt_origo.y - row_cnt + 1); y <= LV_MATH_MIN(mask->y2, lt_origo.y); y++) {
+        uint8_t mix          = (uint32_t)((uint32_t)(coords->y2 - y) * 255) / height;
+        lv_color_t aa_color  = lv_color_mix(mcolor, gcolor, mix);
+        lv_color_t act_color = mcolor.full == gcolor.full ? mcolor : aa_color;
+        lv_draw_corner_row(mask_data, lt_origo.y - y, y, lt_origo.x, rb_origo.x, true, mask, act_color, aa_color, opa);
+    }
+
+#if LV_ANTIALIAS
+    if(aa) {
+        /*The first and the last line is not drawn*/
+        lv_area_t edge_area;
+        edge_area.x1 = coords->x1 + radius + 2;
+        edge_area.x2 = coords->x2 - radius - 2;
+        edge_area.y1 = coords->y1;
+        edge_area.y2 = coords->y1;
+        lv_draw_fill(&edge_area, mask, style->body.main_color, opa);
+
+        edge_area.y1 = coords->y2;
+        edge_area.y2 = coords->y2;
+        lv_draw_fill(&edge_area, mask, style->body.grad_color, opa);
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * Draw the corners of a rectangle border with the cached masks of the corners
+ * @param coords the coordinates of the original rectangle
+ * @param mask the rectangle will be drawn only  on this area
+ * @param style pointer to a style
+ * @param opa_scale scale down all opacities by the factor
+ * @return true: the corners are drawn; false: the corners can't be drawn with masks
+ */
+static bool lv_draw_rect_border_corner_cached(const lv_area_t * coords, const lv_area_t * mask,
+                                              const lv_style_t * style, lv_opa_t opa_scale)
+{
+    uint16_t radius       = style->body.radius;
+    bool aa               = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
+    lv_coord_t bwidth     = style->body.border.width;
+    lv_color_t color      = style->body.border.color;
+    lv_border_part_t part = style->body.border.part;
+    lv_opa_t opa          = opa_scale == LV_OPA_COVER ? style->body.border.opa
+                                             : (uint16_t)((uint16_t)style->body.border.opa * opa_scale) >> 8;
+    /*0 px border width drawn as 1 px, so decrement the bwidth*/
+    bwidth--;
+
+#if LV_ANTIALIAS
+    if(aa) bwidth--; /*Because of anti-aliasing the border seems one pixel ticker*/
+#endif
+
+    lv_coord_t width  = lv_area_get_width(coords);
+    lv_coord_t height = lv_area_get_height(coords);
+
+    radius = lv_draw_cont_radius_corr(radius, width, height);
+
+    lv_point_t lt_origo; /*Left  Top    origo*/
+    lv_point_t rb_origo; /*Right Bottom origo*/
+
+    lt_origo.x = coords->x1 + radius + aa;
+    lt_origo.y = coords->y1 + radius + aa;
+
+    rb_origo.x = coords->x2 - radius - aa;
+    rb_origo.y = coords->y2 - radius - aa;
+
+    /*The corners would overlap*/
+    if(rb_origo.x <= lt_origo.x || rb_origo.y <= lt_origo.y) return false;
+
+    /*The left bottom and right top corners are the right bottom corner with swapped x and y*/
+    const uint8_t * mask_data      = lv_draw_corner_mask_get(radius, bwidth, aa, opa, LV_CORNER_BORDER);
+    const uint8_t * mask_data_swap = lv_draw_corner_mask_get(radius, bwidth, aa, opa, LV_CORNER_BORDER_SWAP);
+    if(mask_data == NULL || mask_data_swap == NULL) return false;
+
+    lv_coord_t row_cnt = ((const corner_mask_t *)mask_data)->row_cnt;
+    lv_coord_t y;
+    if(part & LV_BORDER_BOTTOM) {
+        for(y = LV_MATH_MAX(mask->y1, rb_origo.y); y <= LV_MATH_MIN(mask->y2, rb_origo.y + row_cnt - 1); y++) {
+            if(part & LV_BORDER_RIGHT) {
+                lv_draw_corner_row(mask_data, y - rb_origo.y, y, LV_COORD_MIN, rb_origo.x, false, mask, color, color,
+                                   opa);
+            }
+            if(part & LV_BORDER_LEFT) {
+                lv_draw_corner_row(mask_data_swap, y - rb_origo.y, y, lt_origo.x, LV_COORD_MIN, false, mask, color,
+                                   color, opa);
+            }
+        }
+    }
+
+    if(part & LV_BORDER_TOP) {
+        for(y = LV_MATH_MAX(mask->y1, lt_origo.y - row_cnt + 1); y <= LV_MATH_MIN(mask->y2, lt_origo.y); y++) {
+            if(part & LV_BORDER_LEFT) {
+                lv_draw_corner_row(mask_data, lt_origo.y - y, y, lt_origo.x, LV_COORD_MIN, false, mask, color, color,
+                                   opa);
+            }
+            if(part & LV_BORDER_RIGHT) {
+                lv_draw_corner_row(mask_data_swap, lt_origo.y - y, y, LV_COORD_MIN, rb_origo.x, false, mask, color,
+                                   color, opa);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Draw a row of a corner mask on the right and/or on the left (mirrored) side
+ * @param mask_data the corner mask
+ * @param row index of the row in the mask
+ * @param y draw the row here
+ * @param x_left x coordinate of the left corner's origo or `LV_COORD_MIN` to not draw on the left
+ * @param x_right x coordinate of the right corner's origo or `LV_COORD_MIN` to not draw on the right
+ * @param body true: the run from the origo is a body part and it's drawn between the corners too
+ * @param mask the row will be drawn only on this area
+ * @param fill_color color of the body part between the corners
+ * @param aa_color color of the other runs
+ * @param opa opacity of the body or border runs (the anti-aliased pixels have their own opacity)
+ */
+static void lv_draw_corner_row(const uint8_t * mask_data, uint16_t row, lv_coord_t y, lv_coord_t x_left,
+                               lv_coord_t x_right, bool body, const lv_area_t * mask, lv_color_t fill_color,
+                               lv_color_t aa_color, lv_opa_t opa)
+{
+    const corner_mask_t * m = (const corner_mask_t *)mask_data;
+    const uint16_t * ofs    = (const uint16_t *)&mask_data[sizeof(corner_mask_t)];
+    const uint8_t * runs    = (const uint8_t *)&ofs[m->row_cnt] + ofs[row];
+
+    uint8_t run_cnt = *runs;
+    runs++;
+
+    lv_area_t run_area;
+    run_area.y1 = y;
+    run_area.y2 = y;
+
+    uint8_t i;
+    for(i = 0; i < run_cnt; i++) {
+        lv_coord_t x   = runs[0];
+        lv_coord_t len = runs[1];
+        lv_opa_t type  = runs[2];
+        runs += 3;
+
+        if(type == LV_OPA_COVER) {
+            /*The anti-aliasing in the last row is not part of the body*/
+            if(body && i == 0 && x == 0 && row + 1 < m->row_cnt) {
+                run_area.x1 = x_left - len + 1;
+                run_area.x2 = x_right + len - 1;
+                lv_draw_fill(&run_area, mask, fill_color, opa);
+            } else {
+                if(x_right != LV_COORD_MIN) {
+                    run_area.x1 = x_right + x;
+                    run_area.x2 = run_area.x1 + len - 1;
+                    lv_draw_fill(&run_area, mask, aa_color, opa);
+                }
+                if(x_left != LV_COORD_MIN) {
+                    run_area.x2 = x_left - x;
+                    run_area.x1 = run_area.x2 - len + 1;
+                    lv_draw_fill(&run_area, mask, aa_color, opa);
+                }
+            }
+        } else {
+            if(x_right != LV_COORD_MIN) {
+                run_area.x1 = x_right + x;
+                run_area.x2 = run_area.x1 + len - 1;
+                lv_draw_opa_map(&run_area, mask, runs, 0, aa_color);
+            }
+            if(x_left != LV_COORD_MIN) {
+                run_area.x2 = x_left - x;
+                run_area.x1 = run_area.x2 - len + 1;
+                lv_draw_opa_map(&run_area, mask, runs, LV_DRAW_MIRROR_X, aa_color);
+            }
+            runs += len;
+        }
+    }
+}
+
+/**
+ * Get the mask of a corner from the cache or calculate it and add it to the cache
+ * @param radius radius of the corner (corrected with the size)
+ * @param bwidth width of the border (decreased like in the drawing) or 0 for the body
+ * @param aa true: the corner is anti-aliased
+ * @param opa opacity of the body or border
+ * @param type `LV_CORNER_BODY/BORDER/BORDER_SWAP`
+ * @return pointer to the mask or NULL if it can't be calculated or cached
+ */
+static const uint8_t * lv_draw_corner_mask_get(lv_coord_t radius, lv_coord_t bwidth, bool aa, lv_opa_t opa,
+                                               lv_corner_type_t type)
+{
+    lv_corner_cache_key_t key;
+    memset(&key, 0, sizeof(key));
+    key.radius = radius;
+    key.width  = bwidth;
+    key.opa    = aa ? opa : LV_OPA_COVER; /*Only the anti-aliased pixels depend on the opacity*/
+    key.aa     = aa ? 1 : 0;
+    key.type   = type;
+
+    const uint8_t * mask_data = lv_mask_cache_get(&lv_corner_cache, &key);
+    if(mask_data) return mask_data;
+
+    if(radius > CORNER_MASK_RADIUS_MAX) return NULL;
+
+    /*Draw the right bottom corner to a canvas*/
+    corner_canvas_t canvas;
+    canvas.size      = radius + 2;
+    canvas.again_cnt = 0;
+    canvas.opa       = opa;
+    canvas.ok        = true;
+
+    uint32_t buf_size = (uint32_t)canvas.size * canvas.size;
+    uint8_t * draw_buf = lv_draw_get_buf(buf_size + CORNER_MASK_AGAIN_MAX * sizeof(corner_px_t));
+    canvas.buf   = draw_buf;
+    canvas.again = (corner_px_t *)&draw_buf[buf_size];
+    memset(canvas.buf, 0, buf_size);
+
+    if(type == LV_CORNER_BODY) corner_canvas_body(&canvas, radius, aa);
+    else corner_canvas_border(&canvas, radius, bwidth, aa);
+    if(canvas.ok == false) return NULL;
+
+    bool swap      = type == LV_CORNER_BORDER_SWAP;
+    uint8_t * data = lv_mask_cache_add(&lv_corner_cache, &key, corner_canvas_encode(&canvas, swap, NULL));
+    if(data == NULL) return NULL;
+
+    corner_canvas_encode(&canvas, swap, data);
+    return data;
+}
+
+/**
+ * Draw the right bottom corner of a body like `lv_draw_rect_main_corner` to a canvas
+ * @param canvas pointer to an empty canvas
+ * @param radius radius of the corner (corrected with the size)
+ * @param aa true: anti-aliased corner
+ */
+static void corner_canvas_body(corner_canvas_t * canvas, lv_coord_t radius, bool aa)
+{
+    lv_point_t cir;
+    lv_coord_t cir_tmp;
+    lv_circ_init(&cir, &cir_tmp, radius);
+
+    /*The rows from the middle and from the edge and their ends*/
+    lv_coord_t mid_y  = LV_CIRC_OCT1_Y(cir);
+    lv_coord_t mid_x  = LV_CIRC_OCT1_X(cir);
+    lv_coord_t edge_y = LV_CIRC_OCT2_Y(cir);
+    lv_coord_t edge_x = LV_CIRC_OCT2_X(cir);
+
+    lv_coord_t out_y_seg_start = 0;
+    lv_coord_t out_x_last      = radius;
+    lv_coord_t x;
+
+    while(lv_circ_cont(&cir)) {
+#if LV_ANTIALIAS
+        /*New step in y on the outter circle*/
+        if(aa && out_x_last != cir.x) {
+            corner_canvas_out_aa(canvas, out_x_last, out_y_seg_start, cir.y - out_y_seg_start, false, false);
+            out_x_last      = cir.x;
+            out_y_seg_start = cir.y;
+        }
+#endif
+
+        /*Draw the previous row if a new row is coming*/
+        if(mid_y != LV_CIRC_OCT1_Y(cir)) {
+            for(x = 0; x <= mid_x; x++) corner_canvas_px(canvas, x, mid_y, LV_OPA_COVER);
+        }
+
+        if(edge_y != LV_CIRC_OCT2_Y(cir)) {
+            for(x = 0; x <= edge_x; x++) corner_canvas_px(canvas, x, edge_y, LV_OPA_COVER);
+        }
+
+        mid_y  = LV_CIRC_OCT1_Y(cir);
+        mid_x  = LV_CIRC_OCT1_X(cir);
+        edge_y = LV_CIRC_OCT2_Y(cir);
+        edge_x = LV_CIRC_OCT2_X(cir);
+
+        lv_circ_next(&cir, &cir_tmp);
+    }
+
+    for(x = 0; x <= mid_x; x++) corner_canvas_px(canvas, x, mid_y, LV_OPA_COVER);
+
+    if(edge_y != mid_y) {
+        for(x = 0; x <= edge_x; x++) corner_canvas_px(canvas, x, edge_y, LV_OPA_COVER);
+    }
+
+#if LV_ANTIALIAS
+    if(aa) {
+        /*Last parts of the anti-alias*/
+        corner_canvas_out_aa(canvas, out_x_last, out_y_seg_start, cir.y - out_y_seg_start, true, false);
+    }
+#endif
+}
+
+/**
+ * Draw the right bottom corner of a border like `lv_draw_rect_border_corner` to a canvas
+ * @param canvas pointer to an empty canvas
+ * @param radius radius of the corner (corrected with the size)
+ * @param bwidth width of the border (decreased like in the drawing)
+ * @param aa true: anti-aliased corner
+ */
+static void corner_canvas_border(corner_canvas_t * canvas, lv_coord_t radius, lv_coord_t bwidth, bool aa)
+{
+    lv_point_t cir_out;
+    lv_coord_t tmp_out;
+    lv_circ_init(&cir_out, &tmp_out, radius);
+
+    lv_point_t cir_in;
+    lv_coord_t tmp_in;
+    lv_coord_t radius_in = radius - bwidth;
+
+    if(radius_in < 0) {
+        radius_in = 0;
+    }
+
+    lv_circ_init(&cir_in, &tmp_in, radius_in);
+
+    lv_coord_t act_w1;
+    lv_coord_t act_w2;
+    lv_coord_t i;
+
+#if LV_ANTIALIAS
+    lv_coord_t out_y_seg_start = 0;
+    lv_coord_t out_x_last      = radius;
+
+    lv_coord_t in_y_seg_start = 0;
+    lv_coord_t in_x_last      = radius - bwidth;
+    lv_coord_t seg_size;
+#endif
+
+    while(cir_out.y <= cir_out.x) {
+
+        /*Calculate the actual width to avoid overwriting pixels*/
+        if(cir_in.y < cir_in.x) {
+            act_w1 = cir_out.x - cir_in.x;
+            act_w2 = act_w1;
+        } else {
+            act_w1 = cir_out.x - cir_out.y;
+            act_w2 = act_w1 - 1;
+        }
+
+#if LV_ANTIALIAS
+        if(aa) {
+            /*New step in y on the outter circle*/
+            if(out_x_last != cir_out.x) {
+                corner_canvas_out_aa(canvas, out_x_last, out_y_seg_start, cir_out.y - out_y_seg_start, false, true);
+                out_x_last      = cir_out.x;
+                out_y_seg_start = cir_out.y;
+            }
+
+            /*New step in y on the inner circle*/
+            if(in_x_last != cir_in.x) {
+                seg_size = cir_out.y - in_y_seg_start;
+                for(i = 0; i < seg_size; i++) {
+                    lv_opa_t aa_opa;
+                    if(seg_size > CIRCLE_AA_NON_LINEAR_OPA_THRESHOLD) {
+                        aa_opa = canvas->opa - antialias_get_opa_circ(seg_size, i, canvas->opa);
+                    } else {
+                        aa_opa = lv_draw_aa_get_opa(seg_size, i, canvas->opa);
+                    }
+
+                    corner_canvas_px(canvas, in_x_last - 1, in_y_seg_start + i, aa_opa);
+                    /*Be sure the pixels on the middle are not drawn twice*/
+                    if(in_x_last - 1 != in_y_seg_start + i) {
+                        corner_canvas_px(canvas, in_y_seg_start + i, in_x_last - 1, aa_opa);
+                    }
+                }
+
+                in_x_last      = cir_in.x;
+                in_y_seg_start = cir_out.y;
+            }
+        }
+#endif
+
+        for(i = cir_out.x - act_w2; i <= cir_out.x; i++) corner_canvas_px(canvas, i, cir_out.y, LV_OPA_COVER);
+        for(i = cir_out.x - act_w1; i <= cir_out.x; i++) corner_canvas_px(canvas, cir_out.y, i, LV_OPA_COVER);
+
+        lv_circ_next(&cir_out, &tmp_out);
+
+        /*The internal circle will be ready faster
+         * so check it! */
+        if(cir_in.y < cir_in.x) {
+            lv_circ_next(&cir_in, &tmp_in);
+        }
+    }
+
+#if LV_ANTIALIAS
+    if(aa) {
+        /*Last parts of the outer anti-alias*/
+        corner_canvas_out_aa(canvas, out_x_last, out_y_seg_start, cir_out.y - out_y_seg_start, true, true);
+
+        /*Last parts of the inner anti-alias*/
+        seg_size = cir_in.y - in_y_seg_start;
+        for(i = 0; i < seg_size; i++) {
+            lv_opa_t aa_opa = lv_draw_aa_get_opa(seg_size, i, canvas->opa);
+            corner_canvas_px(canvas, in_x_last - 1, in_y_seg_start + i, aa_opa);
+            if(in_x_last - 1 != in_y_seg_start + i) {
+                corner_canvas_px(canvas, in_y_seg_start + i, in_x_last - 1, aa_opa);
+            }
+        }
+    }
+#endif
+}
+
+/**
+ * Draw a segment of the outer anti-aliasing of a corner to a canvas
+ * @param canvas pointer to a canvas
+ * @param x_last the x coordinate of the circle before the step
+ * @param seg_start y coordinate where the segment starts
+ * @param seg_size length of the segment
+ * @param last true: it's the last segment
+ * @param ver_first true: draw the vertical pixel first (like the border); false: the horizontal
+ */
+static void corner_canvas_out_aa(corner_canvas_t * canvas, lv_coord_t x_last, lv_coord_t seg_start, lv_coord_t seg_size,
+                                 bool last, bool ver_first)
+{
+#if LV_ANTIALIAS
+    lv_coord_t i;
+    for(i = 0; i < seg_size; i++) {
+        lv_opa_t aa_opa;
+        if(seg_size > CIRCLE_AA_NON_LINEAR_OPA_THRESHOLD && last == false) { /*Use non-linear opa mapping
+                                                                                on the first segment*/
+            aa_opa = antialias_get_opa_circ(seg_size, i, canvas->opa);
+        } else {
+            aa_opa = canvas->opa - lv_draw_aa_get_opa(seg_size, i, canvas->opa);
+        }
+
+        if(ver_first) corner_canvas_px(canvas, x_last + 1, seg_start + i, aa_opa);
+        corner_canvas_px(canvas, seg_start + i, x_last + 1, aa_opa);
+        if(!ver_first) corner_canvas_px(canvas, x_last + 1, seg_start + i, aa_opa);
+    }
+
+    /*In some cases the last pixel in the middle is not drawn*/
+    if(last && LV_MATH_ABS(x_last - seg_start) == seg_size) {
+        corner_canvas_px(canvas, x_last, x_last, canvas->opa >> 1);
+    }
+#endif
+}
+
+/**
+ * Draw a pixel to a corner's canvas
+ * @param canvas pointer to a canvas
+ * @param x x coordinate relative to the origo of the corner
+ * @param y y coordinate relative to the origo of the corner
+ * @param cov `LV_OPA_COVER` for the pixels of the body or border else the opacity of an anti-aliased pixel
+ */
+static void corner_canvas_px(corner_canvas_t * canvas, lv_coord_t x, lv_coord_t y, lv_opa_t cov)
+{
+    if(cov == LV_OPA_TRANSP) return;
+
+    if(x < 0 || y < 0 || x >= canvas->size || y >= canvas->size) {
+        canvas->ok = false;
+        return;
+    }
+
+    lv_opa_t * px = &canvas->buf[(uint32_t)y * canvas->size + x];
+    if(*px == LV_OPA_TRANSP) {
+        *px = cov;
+        return;
+    }
+
+    /*Keep the pixels drawn again to blend them the same way*/
+    if(canvas->again_cnt >= CORNER_MASK_AGAIN_MAX) {
+        canvas->ok = false;
+        return;
+    }
+
+    canvas->again[canvas->again_cnt].x   = x;
+    canvas->again[canvas->again_cnt].y   = y;
+    canvas->again[canvas->again_cnt].cov = cov;
+    canvas->again_cnt++;
+}
+
+/**
+ * Convert a canvas to runs of coverages
+ * @param canvas pointer to a canvas
+ * @param swap true: swap the x and y coordinates
+ * @param mask_data write the mask here. NULL: only calculate its size
+ * @return size of the mask in bytes
+ */
+static uint32_t corner_canvas_encode(const corner_canvas_t * canvas, bool swap, uint8_t * mask_data)
+{
+    lv_coord_t size = canvas->size;
+    int32_t step_x  = swap ? size : 1;
+    int32_t step_y  = swap ? 1 : size;
+
+    uint16_t row_cnt = size;
+    uint32_t ofs_size = sizeof(corner_mask_t) + row_cnt * sizeof(uint16_t);
+    uint32_t data_ofs = 0;
+    uint8_t * rows    = NULL;
+    uint16_t * ofs    = NULL;
+    if(mask_data) {
+        ((corner_mask_t *)mask_data)->row_cnt = row_cnt;
+        ofs  = (uint16_t *)&mask_data[sizeof(corner_mask_t)];
+        rows = &mask_data[ofs_size];
+    }
+
+    lv_coord_t y;
+    for(y = 0; y < row_cnt; y++) {
+        const lv_opa_t * row_buf = &canvas->buf[y * step_y];
+        uint32_t run_cnt_ofs = data_ofs;
+        uint8_t run_cnt      = 0;
+        if(ofs) ofs[y] = data_ofs;
+        data_ofs++;
+
+        lv_coord_t x = 0;
+        while(x < size) {
+            lv_opa_t cov = row_buf[x * step_x];
+            if(cov == LV_OPA_TRANSP) {
+                x++;
+                continue;
+            }
+
+            /*The body or border pixels are one run and the anti-aliased ones are an other*/
+            lv_coord_t len = 1;
+            if(cov == LV_OPA_COVER) {
+                while(x + len < size && row_buf[(x + len) * step_x] == LV_OPA_COVER) len++;
+            } else {
+                while(x + len < size && row_buf[(x + len) * step_x] != LV_OPA_TRANSP &&
+                      row_buf[(x + len) * step_x] != LV_OPA_COVER) {
+                    len++;
+                }
+            }
+
+            if(rows) {
+                rows[data_ofs]     = x;
+                rows[data_ofs + 1] = len;
+                rows[data_ofs + 2] = cov == LV_OPA_COVER ? LV_OPA_COVER : LV_OPA_TRANSP;
+                if(cov != LV_OPA_COVER) {
+                    lv_coord_t i;
+                    for(i = 0; i < len; i++) rows[data_ofs + 3 + i] = row_buf[(x + i) * step_x];
+                }
+            }
+            data_ofs += 3 + (cov == LV_OPA_COVER ? 0 : len);
+            run_cnt++;
+            x += len;
+        }
+
+        /*The pixels drawn again come after the others*/
+        uint16_t i;
+        for(i = 0; i < canvas->again_cnt; i++) {
+            const corner_px_t * px = &canvas->again[i];
+            if((swap ? px->x : px->y) != y) continue;
+
+            if(rows) {
+                rows[data_ofs]     = swap ? px->y : px->x;
+                rows[data_ofs + 1] = 1;
+                rows[data_ofs + 2] = px->cov == LV_OPA_COVER ? LV_OPA_COVER : LV_OPA_TRANSP;
+                if(px->cov != LV_OPA_COVER) rows[data_ofs + 3] = px->cov;
+            }
+            data_ofs += px->cov == LV_OPA_COVER ? 3 : 4;
+            run_cnt++;
+        }
+
+        if(rows) rows[run_cnt_ofs] = run_cnt;
+    }
+
+    return ofs_size + data_ofs;
+}
+#endif
+
 #if LV_USE_SHADOW
 
 /**
@@ -1129,45 +1813,8 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
 
     radius += aa;
 
-    /*Allocate a draw buffer the buffer required to draw the shadow*/
-    int16_t filter_width = 2 * swidth + 1;
-    uint32_t curve_x_size = ((radius + swidth + 1) + 3) & ~0x3; /*Round to 4*/
-    curve_x_size *= sizeof(lv_coord_t);
-    uint32_t line_1d_blur_size = (filter_width + 3) & ~0x3;     /*Round to 4*/
-    line_1d_blur_size *= sizeof(uint32_t);
-    uint32_t line_2d_blur_size = ((radius + swidth + 1) + 3) & ~0x3;     /*Round to 4*/
-    line_2d_blur_size *= sizeof(lv_opa_t);
-
-    uint8_t * draw_buf = lv_draw_get_buf(curve_x_size + line_1d_blur_size + line_2d_blur_size);
-
-    /*Divide the draw buffer*/
-    lv_coord_t  * curve_x = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
-    uint32_t * line_1d_blur = (uint32_t *)&draw_buf[curve_x_size];
-    lv_opa_t * line_2d_blur = (lv_opa_t *)&draw_buf[curve_x_size + line_1d_blur_size];
-
-    memset(curve_x, 0, curve_x_size);
-    lv_point_t circ;
-    lv_coord_t circ_tmp;
-    lv_circ_init(&circ, &circ_tmp, radius);
-    while(lv_circ_cont(&circ)) {
-        curve_x[LV_CIRC_OCT1_Y(circ)] = LV_CIRC_OCT1_X(circ);
-        curve_x[LV_CIRC_OCT2_Y(circ)] = LV_CIRC_OCT2_X(circ);
-        lv_circ_next(&circ, &circ_tmp);
-    }
-    int16_t line;
-    /*1D Blur horizontally*/
     lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
-    for(line = 0; line < filter_width; line++) {
-        line_1d_blur[line] = (uint32_t)((uint32_t)(filter_width - line) * (opa * 2) << SHADOW_OPA_EXTRA_PRECISION) /
-                             (filter_width * filter_width);
-    }
-
-    uint16_t col;
 
-    lv_point_t point_rt;
-    lv_point_t point_rb;
-    lv_point_t point_lt;
-    lv_point_t point_lb;
     lv_point_t ofs_rb;
     lv_point_t ofs_rt;
     lv_point_t ofs_lb;
@@ -1183,44 +1830,71 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
 
     ofs_lt.x = coords->x1 + radius + aa;
     ofs_lt.y = coords->y1 + radius + aa;
-    bool line_ready;
-    for(line = 0; line <= radius + swidth; line++) { /*Check all rows and make the 1D blur to 2D*/
-        line_ready = false;
-        for(col = 0; col <= radius + swidth; col++) { /*Check all pixels in a 1D blur line (from the origo to last
-                                                         shadow pixel (radius + swidth))*/
-
-            /*Sum the opacities from the lines above and below this 'row'*/
-            int16_t line_rel;
-            uint32_t px_opa_sum = 0;
-            for(line_rel = -swidth; line_rel <= swidth; line_rel++) {
-                /*Get the relative x position of the 'line_rel' to 'line'*/
-                int16_t col_rel;
-                if(line + line_rel < 0) { /*Below the radius, here is the blur of the edge */
-                    col_rel = radius - curve_x[line] - col;
-                } else if(line + line_rel > radius) { /*Above the radius, here won't be more 1D blur*/
-                    break;
-                } else { /*Blur from the curve*/
-                    col_rel = curve_x[line + line_rel] - curve_x[line] - col;
-                }
-
-                /*Add the value of the 1D blur on 'col_rel' position*/
-                if(col_rel < -swidth) { /*Outside of the blurred area. */
-                    if(line_rel == -swidth)
-                        line_ready = true; /*If no data even on the very first line then it wont't
-                                              be anything else in this line*/
-                    break;                 /*Break anyway because only smaller 'col_rel' values will come */
-                } else if(col_rel > swidth)
-                    px_opa_sum += line_1d_blur[0]; /*Inside the not blurred area*/
-                else
-                    px_opa_sum += line_1d_blur[swidth - col_rel]; /*On the 1D blur (+ swidth to align to the center)*/
-            }
 
-            line_2d_blur[col] = px_opa_sum >> SHADOW_OPA_EXTRA_PRECISION;
-            if(line_ready) {
-                col++; /*To make this line to the last one ( drawing will go to '< col')*/
-                break;
-            }
+#if LV_SHADOW_CACHE_SIZE
+    /*Draw the corners with their masks if they don't overlap (else some pixels are blended twice)*/
+    if(ofs_lt.x - ofs_rt.x < 2 && ofs_lt.y - ofs_lb.y < 2) {
+        lv_shadow_cache_key_t key;
+        memset(&key, 0, sizeof(key));
+        key.radius = radius;
+        key.width  = swidth;
+        key.opa    = opa;
+        key.type   = LV_SHADOW_FULL;
+
+        const uint8_t * mask_data = lv_mask_cache_get(&lv_shadow_cache, &key);
+        if(mask_data == NULL) mask_data = lv_draw_shadow_full_mask(&key);
+
+        if(mask_data) {
+            const shadow_mask_t * m   = (const shadow_mask_t *)mask_data;
+            const lv_opa_t * edge     = &mask_data[sizeof(shadow_mask_t)];
+            const lv_opa_t * corner   = &edge[swidth + 1];
+            lv_color_t color          = style->body.shadow.color;
+
+            lv_draw_shadow_full_straight(coords, mask, style, edge);
+
+            lv_area_t corner_area;
+            corner_area.x1 = ofs_rb.x + 1;
+            corner_area.y1 = ofs_rb.y + 1;
+            corner_area.x2 = corner_area.x1 + m->corner_w - 1;
+            corner_area.y2 = corner_area.y1 + m->corner_h - 1;
+            lv_draw_opa_map(&corner_area, mask, corner, 0, color);
+
+            corner_area.x1 = ofs_rt.x + 1;
+            corner_area.y2 = ofs_rt.y - 1;
+            corner_area.x2 = corner_area.x1 + m->corner_w - 1;
+            corner_area.y1 = corner_area.y2 - m->corner_h + 1;
+            lv_draw_opa_map(&corner_area, mask, corner, LV_DRAW_MIRROR_Y, color);
+
+            corner_area.x2 = ofs_lb.x - 1;
+            corner_area.y1 = ofs_lb.y + 1;
+            corner_area.x1 = corner_area.x2 - m->corner_w + 1;
+            corner_area.y2 = corner_area.y1 + m->corner_h - 1;
+            lv_draw_opa_map(&corner_area, mask, corner, LV_DRAW_MIRROR_X, color);
+
+            corner_area.x2 = ofs_lt.x - 1;
+            corner_area.y2 = ofs_lt.y - 1;
+            corner_area.x1 = corner_area.x2 - m->corner_w + 1;
+            corner_area.y1 = corner_area.y2 - m->corner_h + 1;
+            lv_draw_opa_map(&corner_area, mask, corner, LV_DRAW_MIRROR_X | LV_DRAW_MIRROR_Y, color);
+            return;
         }
+    }
+#endif
+
+    lv_coord_t * curve_x;
+    uint32_t * line_1d_blur;
+    lv_opa_t * line_2d_blur;
+    lv_draw_shadow_full_init(radius, swidth, opa, &curve_x, &line_1d_blur, &line_2d_blur);
+
+    int16_t line;
+    uint16_t col;
+
+    lv_point_t point_rt;
+    lv_point_t point_rb;
+    lv_point_t point_lt;
+    lv_point_t point_lb;
+    for(line = 0; line <= radius + swidth; line++) { /*Check all rows and make the 1D blur to 2D*/
+        col = lv_draw_shadow_full_blur_line(line, radius, swidth, curve_x, line_1d_blur, line_2d_blur);
 
         /*Flush the line*/
         point_rt.x = curve_x[line] + ofs_rt.x + 1;
@@ -1268,6 +1942,163 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
     }
 }
 
+/**
+ * Prepare the buffers to calculate a full shadow
+ * @param radius radius of the corners (corrected and increased with anti-aliasing)
+ * @param swidth width of the shadow
+ * @param opa opacity of the shadow
+ * @param curve_x store the 'x' coordinates of a quarter circle here
+ * @param line_1d_blur store the 1D blur here
+ * @param line_2d_blur store a buffer for a line of the 2D blur here
+ */
+static void lv_draw_shadow_full_init(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, lv_coord_t ** curve_x,
+                                     uint32_t ** line_1d_blur, lv_opa_t ** line_2d_blur)
+{
+    /*Allocate a draw buffer the buffer required to draw the shadow*/
+    int16_t filter_width = 2 * swidth + 1;
+    uint32_t curve_x_size = ((radius + swidth + 1) + 3) & ~0x3; /*Round to 4*/
+    curve_x_size *= sizeof(lv_coord_t);
+    uint32_t line_1d_blur_size = (filter_width + 3) & ~0x3;     /*Round to 4*/
+    line_1d_blur_size *= sizeof(uint32_t);
+    uint32_t line_2d_blur_size = ((radius + swidth + 1) + 3) & ~0x3;     /*Round to 4*/
+    line_2d_blur_size *= sizeof(lv_opa_t);
+
+    uint8_t * draw_buf = lv_draw_get_buf(curve_x_size + line_1d_blur_size + line_2d_blur_size);
+
+    /*Divide the draw buffer*/
+    *curve_x      = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
+    *line_1d_blur = (uint32_t *)&draw_buf[curve_x_size];
+    *line_2d_blur = (lv_opa_t *)&draw_buf[curve_x_size + line_1d_blur_size];
+
+    memset(*curve_x, 0, curve_x_size);
+    lv_point_t circ;
+    lv_coord_t circ_tmp;
+    lv_circ_init(&circ, &circ_tmp, radius);
+    while(lv_circ_cont(&circ)) {
+        (*curve_x)[LV_CIRC_OCT1_Y(circ)] = LV_CIRC_OCT1_X(circ);
+        (*curve_x)[LV_CIRC_OCT2_Y(circ)] = LV_CIRC_OCT2_X(circ);
+        lv_circ_next(&circ, &circ_tmp);
+    }
+
+    /*1D Blur horizontally*/
+    int16_t line;
+    for(line = 0; line < filter_width; line++) {
+        (*line_1d_blur)[line] = (uint32_t)((uint32_t)(filter_width - line) * (opa * 2) << SHADOW_OPA_EXTRA_PRECISION) /
+                                (filter_width * filter_width);
+    }
+}
+
+/**
+ * Calculate the opacities of a line of a full shadow's corner from the middle of the radius
+ * @param line index of the line (0: the middle of the radius)
+ * @param radius radius of the corners (corrected and increased with anti-aliasing)
+ * @param swidth width of the shadow
+ * @param curve_x the 'x' coordinates of a quarter circle
+ * @param line_1d_blur the 1D blur
+ * @param line_2d_blur store the opacities here
+ * @return number of opacities in `line_2d_blur`
+ */
+static uint16_t lv_draw_shadow_full_blur_line(int16_t line, lv_coord_t radius, lv_coord_t swidth,
+                                              const lv_coord_t * curve_x, const uint32_t * line_1d_blur,
+                                              lv_opa_t * line_2d_blur)
+{
+    bool line_ready = false;
+    uint16_t col;
+    for(col = 0; col <= radius + swidth; col++) { /*Check all pixels in a 1D blur line (from the origo to last
+                                                     shadow pixel (radius + swidth))*/
+
+        /*Sum the opacities from the lines above and below this 'row'*/
+        int16_t line_rel;
+        uint32_t px_opa_sum = 0;
+        for(line_rel = -swidth; line_rel <= swidth; line_rel++) {
+            /*Get the relative x position of the 'line_rel' to 'line'*/
+            int16_t col_rel;
+            if(line + line_rel < 0) { /*Below the radius, here is the blur of the edge */
+                col_rel = radius - curve_x[line] - col;
+            } else if(line + line_rel > radius) { /*Above the radius, here won't be more 1D blur*/
+                break;
+            } else { /*Blur from the curve*/
+                col_rel = curve_x[line + line_rel] - curve_x[line] - col;
+            }
+
+            /*Add the value of the 1D blur on 'col_rel' position*/
+            if(col_rel < -swidth) { /*Outside of the blurred area. */
+                if(line_rel == -swidth)
+                    line_ready = true; /*If no data even on the very first line then it wont't
+                                          be anything else in this line*/
+                break;                 /*Break anyway because only smaller 'col_rel' values will come */
+            } else if(col_rel > swidth)
+                px_opa_sum += line_1d_blur[0]; /*Inside the not blurred area*/
+            else
+                px_opa_sum += line_1d_blur[swidth - col_rel]; /*On the 1D blur (+ swidth to align to the center)*/
+        }
+
+        line_2d_blur[col] = px_opa_sum >> SHADOW_OPA_EXTRA_PRECISION;
+        if(line_ready) {
+            col++; /*To make this line to the last one ( drawing will go to '< col')*/
+            break;
+        }
+    }
+
+    return col;
+}
+
+#if LV_SHADOW_CACHE_SIZE
+/**
+ * Calculate the mask of a full shadow and add it to the shadow cache.
+ * The mask is the opacities of the straight edges and the map of the right bottom corner
+ * from the first line below the middle of the radius.
+ * @param key parameters of the shadow
+ * @return pointer to the cached mask or NULL if it can't be cached
+ */
+static const uint8_t * lv_draw_shadow_full_mask(const lv_shadow_cache_key_t * key)
+{
+    lv_coord_t radius = key->radius;
+    lv_coord_t swidth = key->width;
+
+    lv_coord_t * curve_x;
+    uint32_t * line_1d_blur;
+    lv_opa_t * line_2d_blur;
+    lv_draw_shadow_full_init(radius, swidth, key->opa, &curve_x, &line_1d_blur, &line_2d_blur);
+
+    /*Find the width of the corner map*/
+    int16_t line;
+    uint16_t col;
+    lv_coord_t corner_w = 0;
+    lv_coord_t corner_h = radius + swidth;
+    for(line = 1; line <= radius + swidth; line++) {
+        col      = lv_draw_shadow_full_blur_line(line, radius, swidth, curve_x, line_1d_blur, line_2d_blur);
+        corner_w = LV_MATH_MAX(corner_w, curve_x[line] + col - 1);
+    }
+
+    uint32_t corner_size = (uint32_t)corner_w * corner_h;
+    uint8_t * mask_data  = lv_mask_cache_add(&lv_shadow_cache, key, sizeof(shadow_mask_t) + swidth + 1 + corner_size);
+    if(mask_data == NULL) return NULL;
+
+    shadow_mask_t * m = (shadow_mask_t *)mask_data;
+    lv_opa_t * edge   = &mask_data[sizeof(shadow_mask_t)];
+    lv_opa_t * corner = &edge[swidth + 1];
+    m->corner_w       = corner_w;
+    m->corner_h       = corner_h;
+    memset(corner, 0, corner_size);
+
+    for(line = 0; line <= radius + swidth; line++) {
+        col = lv_draw_shadow_full_blur_line(line, radius, swidth, curve_x, line_1d_blur, line_2d_blur);
+
+        /*The first line is used for the straight edges*/
+        if(line == 0) {
+            memcpy(edge, line_2d_blur, swidth + 1);
+            continue;
+        }
+
+        /*The pixels 1..col of the line starts after the curve*/
+        if(col > 1) memcpy(&corner[(line - 1) * corner_w + curve_x[line]], &line_2d_blur[1], col - 1);
+    }
+
+    return mask_data;
+}
+#endif
+
 static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                   lv_opa_t opa_scale)
 {
@@ -1281,6 +2112,112 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
     radius += aa * SHADOW_BOTTOM_AA_EXTRA_RADIUS;
     swidth += aa;
 
+    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
+
+    lv_point_t ofs_l;
+    lv_point_t ofs_r;
+
+    ofs_l.x = coords->x1 + radius;
+    ofs_l.y = coords->y2 - radius + 1 - aa;
+
+    ofs_r.x = coords->x2 - radius;
+    ofs_r.y = coords->y2 - radius + 1 - aa;
+
+    lv_area_t area_mid;
+    area_mid.x1 = ofs_l.x + 1;
+    area_mid.y1 = ofs_l.y + radius;
+    area_mid.x2 = ofs_r.x - 1;
+    area_mid.y2 = area_mid.y1;
+
+    const lv_opa_t * line_1d_blur;
+
+#if LV_SHADOW_CACHE_SIZE
+    lv_shadow_cache_key_t key;
+    memset(&key, 0, sizeof(key));
+    key.radius = radius;
+    key.width  = swidth;
+    key.opa    = opa;
+    key.type   = LV_SHADOW_BOTTOM;
+
+    const uint8_t * mask_data = lv_mask_cache_get(&lv_shadow_cache, &key);
+    if(mask_data == NULL) mask_data = lv_draw_shadow_bottom_mask(&key);
+
+    if(mask_data) {
+        const shadow_mask_t * m = (const shadow_mask_t *)mask_data;
+        const lv_opa_t * corner = &mask_data[sizeof(shadow_mask_t) + swidth];
+        line_1d_blur            = &mask_data[sizeof(shadow_mask_t)];
+
+        lv_area_t corner_area;
+        corner_area.x2 = ofs_l.x;
+        corner_area.y1 = ofs_l.y;
+        corner_area.x1 = corner_area.x2 - m->corner_w + 1;
+        corner_area.y2 = corner_area.y1 + m->corner_h - 1;
+        lv_draw_opa_map(&corner_area, mask, corner, LV_DRAW_MIRROR_X, style->body.shadow.color);
+
+        /*Don't overdraw the pixels of the left corner*/
+        lv_area_t mask_r;
+        lv_area_copy(&mask_r, mask);
+        mask_r.x1 = LV_MATH_MAX(mask_r.x1, ofs_l.x + 1);
+
+        corner_area.x1 = ofs_r.x;
+        corner_area.y1 = ofs_r.y;
+        corner_area.x2 = corner_area.x1 + m->corner_w - 1;
+        corner_area.y2 = corner_area.y1 + m->corner_h - 1;
+        if(mask_r.x1 <= mask_r.x2) lv_draw_opa_map(&corner_area, &mask_r, corner, 0, style->body.shadow.color);
+    } else
+#endif
+    {
+        lv_coord_t * curve_x;
+        lv_opa_t * line_1d_blur_buf;
+        lv_draw_shadow_bottom_init(radius, swidth, opa, &curve_x, &line_1d_blur_buf);
+        line_1d_blur = line_1d_blur_buf;
+
+        lv_point_t point_l;
+        lv_point_t point_r;
+        int16_t col;
+        for(col = 0; col <= radius; col++) {
+            point_l.x = ofs_l.x - col;
+            point_l.y = ofs_l.y + curve_x[col];
+
+            point_r.x = ofs_r.x + col;
+            point_r.y = ofs_r.y + curve_x[col];
+
+            lv_opa_t px_opa;
+            int16_t diff = col == 0 ? 0 : curve_x[col - 1] - curve_x[col];
+            uint16_t d;
+            for(d = 0; d < swidth; d++) {
+                px_opa = lv_draw_shadow_bottom_get_opa(line_1d_blur, d, diff);
+                lv_draw_px(point_l.x, point_l.y, mask, style->body.shadow.color, px_opa);
+                point_l.y++;
+
+                /*Don't overdraw the pixel on the middle*/
+                if(point_r.x > ofs_l.x) {
+                    lv_draw_px(point_r.x, point_r.y, mask, style->body.shadow.color, px_opa);
+                }
+                point_r.y++;
+            }
+        }
+    }
+
+    uint16_t d;
+    for(d = 0; d < swidth; d++) {
+        lv_draw_fill(&area_mid, mask, style->body.shadow.color, line_1d_blur[d]);
+        area_mid.y1++;
+        area_mid.y2++;
+    }
+}
+
+/**
+ * Prepare the buffers to calculate a bottom shadow
+ * @param radius radius of the corners (corrected and increased with anti-aliasing)
+ * @param swidth width of the shadow (increased with anti-aliasing)
+ * @param opa opacity of the shadow
+ * @param curve_x store the 'x' coordinates of a quarter circle here
+ * @param line_1d_blur store the 1D blur here
+ */
+static void lv_draw_shadow_bottom_init(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, lv_coord_t ** curve_x,
+                                       lv_opa_t ** line_1d_blur)
+{
     uint32_t curve_x_size = ((radius + 1) + 3) & ~0x3; /*Round to 4*/
     curve_x_size *= sizeof(lv_coord_t);
     lv_opa_t line_1d_blur_size = (swidth + 3) & ~0x3;     /*Round to 4*/
@@ -1289,78 +2226,84 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
     uint8_t * draw_buf = lv_draw_get_buf(curve_x_size + line_1d_blur_size);
 
     /*Divide the draw buffer*/
-    lv_coord_t  * curve_x = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
-    lv_opa_t * line_1d_blur = (lv_opa_t *)&draw_buf[curve_x_size];
+    *curve_x      = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
+    *line_1d_blur = (lv_opa_t *)&draw_buf[curve_x_size];
 
     lv_point_t circ;
     lv_coord_t circ_tmp;
     lv_circ_init(&circ, &circ_tmp, radius);
     while(lv_circ_cont(&circ)) {
-        curve_x[LV_CIRC_OCT1_Y(circ)] = LV_CIRC_OCT1_X(circ);
-        curve_x[LV_CIRC_OCT2_Y(circ)] = LV_CIRC_OCT2_X(circ);
+        (*curve_x)[LV_CIRC_OCT1_Y(circ)] = LV_CIRC_OCT1_X(circ);
+        (*curve_x)[LV_CIRC_OCT2_Y(circ)] = LV_CIRC_OCT2_X(circ);
         lv_circ_next(&circ, &circ_tmp);
     }
 
     int16_t col;
-
-    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
     for(col = 0; col < swidth; col++) {
-        line_1d_blur[col] = (uint32_t)((uint32_t)(swidth - col) * opa / 2) / (swidth);
+        (*line_1d_blur)[col] = (uint32_t)((uint32_t)(swidth - col) * opa / 2) / (swidth);
     }
+}
 
-    lv_point_t point_l;
-    lv_point_t point_r;
-    lv_area_t area_mid;
-    lv_point_t ofs_l;
-    lv_point_t ofs_r;
-
-    ofs_l.x = coords->x1 + radius;
-    ofs_l.y = coords->y2 - radius + 1 - aa;
+/**
+ * Get the opacity of a pixel of a bottom shadow's corner.
+ * When stepping a pixel in y calculate the average with the pixel from the prev. column to make a blur.
+ * @param line_1d_blur the 1D blur
+ * @param d index of the pixel in the column
+ * @param diff the column is this many pixels lower than the previous
+ * @return the opacity of the pixel
+ */
+static lv_opa_t lv_draw_shadow_bottom_get_opa(const lv_opa_t * line_1d_blur, uint16_t d, int16_t diff)
+{
+    if(diff == 0) return line_1d_blur[d];
 
-    ofs_r.x = coords->x2 - radius;
-    ofs_r.y = coords->y2 - radius + 1 - aa;
+    /*Above the blur of the previous column is the fully covered start of the blur*/
+    lv_opa_t prev = d >= diff ? line_1d_blur[d - diff] : line_1d_blur[0];
+    return (uint16_t)((uint16_t)line_1d_blur[d] + prev) >> 1;
+}
 
+#if LV_SHADOW_CACHE_SIZE
+/**
+ * Calculate the mask of a bottom shadow and add it to the shadow cache.
+ * The mask is the 1D blur and the map of the right corner.
+ * @param key parameters of the shadow
+ * @return pointer to the cached mask or NULL if it can't be cached
+ */
+static const uint8_t * lv_draw_shadow_bottom_mask(const lv_shadow_cache_key_t * key)
+{
+    lv_coord_t radius = key->radius;
+    lv_coord_t swidth = key->width;
+
+    lv_coord_t corner_w  = radius + 1;
+    lv_coord_t corner_h  = radius + swidth;
+    uint32_t corner_size = (uint32_t)corner_w * corner_h;
+    uint8_t * mask_data  = lv_mask_cache_add(&lv_shadow_cache, key, sizeof(shadow_mask_t) + swidth + corner_size);
+    if(mask_data == NULL) return NULL;
+
+    lv_coord_t * curve_x;
+    lv_opa_t * line_1d_blur;
+    lv_draw_shadow_bottom_init(radius, swidth, key->opa, &curve_x, &line_1d_blur);
+
+    shadow_mask_t * m = (shadow_mask_t *)mask_data;
+    lv_opa_t * blur   = &mask_data[sizeof(shadow_mask_t)];
+    lv_opa_t * corner = &blur[swidth];
+    m->corner_w       = corner_w;
+    m->corner_h       = corner_h;
+    memcpy(blur, line_1d_blur, swidth);
+    memset(corner, 0, corner_size);
+
+    /*The column `col` starts `curve_x[col]` pixels below the top of the map*/
+    int16_t col;
     for(col = 0; col <= radius; col++) {
-        point_l.x = ofs_l.x - col;
-        point_l.y = ofs_l.y + curve_x[col];
-
-        point_r.x = ofs_r.x + col;
-        point_r.y = ofs_r.y + curve_x[col];
-
-        lv_opa_t px_opa;
         int16_t diff = col == 0 ? 0 : curve_x[col - 1] - curve_x[col];
         uint16_t d;
         for(d = 0; d < swidth; d++) {
-            /*When stepping a pixel in y calculate the average with the pixel from the prev. column
-             * to make a blur */
-            if(diff == 0) {
-                px_opa = line_1d_blur[d];
-            } else {
-                px_opa = (uint16_t)((uint16_t)line_1d_blur[d] + line_1d_blur[d - diff]) >> 1;
-            }
-            lv_draw_px(point_l.x, point_l.y, mask, style->body.shadow.color, px_opa);
-            point_l.y++;
-
-            /*Don't overdraw the pixel on the middle*/
-            if(point_r.x > ofs_l.x) {
-                lv_draw_px(point_r.x, point_r.y, mask, style->body.shadow.color, px_opa);
-            }
-            point_r.y++;
+            corner[(curve_x[col] + d) * corner_w + col] = lv_draw_shadow_bottom_get_opa(line_1d_blur, d, diff);
         }
     }
 
-    area_mid.x1 = ofs_l.x + 1;
-    area_mid.y1 = ofs_l.y + radius;
-    area_mid.x2 = ofs_r.x - 1;
-    area_mid.y2 = area_mid.y1;
-
-    uint16_t d;
-    for(d = 0; d < swidth; d++) {
-        lv_draw_fill(&area_mid, mask, style->body.shadow.color, line_1d_blur[d]);
-        area_mid.y1++;
-        area_mid.y2++;
-    }
+    return mask_data;
 }
+#endif
 
 static void lv_draw_shadow_full_straight(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                          const lv_opa_t * map)
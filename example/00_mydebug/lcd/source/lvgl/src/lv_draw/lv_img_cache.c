@@ -19,16 +19,21 @@
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value in every open*/
-#define LV_IMG_CACHE_AGING 1
-
 /*Boost life by this factor (multiply time_to_open with this value)*/
 #define LV_IMG_CACHE_LIFE_GAIN 1
 
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values */
+/*Don't let the time to open protect an image for more than this number of opens*/
 #define LV_IMG_CACHE_LIFE_LIMIT 1000
 
+/*Number of hash buckets. Must be a power of 2*/
+#define HASH_NUM 16
+
+/*End of a hash chain*/
+#define NO_ENTRY 0
+
+/*Alignment of the surfaces in the memory of the cache*/
+#define SURFACE_ALIGN 4
+
 #if LV_IMG_CACHE_DEF_SIZE < 1
 #error "LV_IMG_CACHE_DEF_SIZE must be >= 1. See lv_conf.h"
 #endif
@@ -40,11 +45,25 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static uint32_t get_hash(const void * src, lv_img_src_t src_type);
+static bool src_match(const lv_img_cache_entry_t * entry, const void * src, lv_img_src_t src_type,
+                      const lv_style_t * style);
+static lv_img_cache_entry_t * get_free_entry(void);
+static bool evict_entry(const lv_img_cache_entry_t * keep);
+static void close_entry(lv_img_cache_entry_t * entry);
+static void surface_create(lv_img_cache_entry_t * entry);
+static bool surface_decode(lv_img_cache_entry_t * entry);
+static bool surface_find_gap(uint32_t size, uint32_t * ofs);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint16_t entry_cnt;
+static uint16_t buckets[HASH_NUM];
+static uint32_t use_cnt;
+static uint8_t * surface_mem;
+static uint32_t surface_mem_size;
+static lv_img_cache_stat_t stat;
 
 /**********************
  *      MACROS
@@ -70,80 +89,81 @@ lv_img_cache_entry_t * lv_img_cache_open(const void * src, const lv_style_t * st
     }
 
     lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    uint32_t hash = get_hash(src, src_type);
 
     /*Is the image cached?*/
-    lv_img_cache_entry_t * cached_src = NULL;
-    for(i = 0; i < entry_cnt; i++) {
-        bool match = false;
-        lv_img_src_t src_type = lv_img_src_get_type(cache[i].dec_dsc.src);
-        if(src_type == LV_IMG_SRC_VARIABLE) {
-            if(cache[i].dec_dsc.src == src && cache[i].dec_dsc.style == style) match = true;
-        } else if(src_type == LV_IMG_SRC_FILE) {
-            if(strcmp(cache[i].dec_dsc.src, src) == 0) match = true;
-        }
+    uint16_t link = buckets[hash & (HASH_NUM - 1)];
+    while(link != NO_ENTRY) {
+        lv_img_cache_entry_t * entry = &cache[link - 1];
+        if(entry->hash == hash && src_match(entry, src, src_type, style)) {
+            /*The surface of an alpha only image is colored by the style*/
+            if(entry->surface_size != 0 && style != NULL && entry->surface_color.full != style->image.color.full &&
+               entry->dec_dsc.header.cf >= LV_IMG_CF_ALPHA_1BIT && entry->dec_dsc.header.cf <= LV_IMG_CF_ALPHA_8BIT) {
+                if(surface_decode(entry) == false) {
+                    lv_img_cache_invalidate_src(src);
+                    return NULL;
+                }
+            }
 
-        if(match) {
-            /* If opened increment its life.
-             * Image difficult to open should live longer to keep avoid frequent their recaching.
-             * Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
+            use_cnt++;
+            entry->life = use_cnt;
+            stat.hit_cnt++;
             LV_LOG_TRACE("image draw: image found in the cache");
-            break;
+            return entry;
         }
+        link = entry->next;
     }
 
-    /*The image is not cached then cache it now*/
-    if(cached_src == NULL) {
-        /*Find an entry to reuse. Select the entry with the least life*/
-        cached_src = &cache[0];
-        for(i = 1; i < entry_cnt; i++) {
-            if(cache[i].life < cached_src->life) {
-                cached_src = &cache[i];
-            }
-        }
+    stat.miss_cnt++;
 
-        /*Close the decoder to reuse if it was opened (has a valid source)*/
-        if(cached_src->dec_dsc.src) {
-            lv_img_decoder_close(&cached_src->dec_dsc);
-            LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-        } else {
-            LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
-        }
+    /*The image is not cached then cache it now.
+     * Use a free entry or close the least valuable image*/
+    lv_img_cache_entry_t * cached_src = get_free_entry();
+    if(cached_src == NULL) {
+        evict_entry(NULL);
+        cached_src = get_free_entry();
+        LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
+    } else {
+        LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
+    }
 
-        /*Open the image and measure the time to open*/
-        uint32_t t_start;
-        t_start                          = lv_tick_get();
-        cached_src->dec_dsc.time_to_open = 0;
-        lv_res_t open_res                = lv_img_decoder_open(&cached_src->dec_dsc, src, style);
-        if(open_res == LV_RES_INV) {
-            LV_LOG_WARN("Image draw cannot open the image resource");
-            lv_img_decoder_close(&cached_src->dec_dsc);
-            memset(&cached_src->dec_dsc, 0, sizeof(lv_img_decoder_dsc_t));
-            memset(cached_src, 0, sizeof(lv_img_cache_entry_t));
-            cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its use  */
-            return NULL;
-        }
+    /*Open the image and measure the time to open*/
+    uint32_t t_start;
+    t_start                          = lv_tick_get();
+    cached_src->dec_dsc.time_to_open = 0;
+    lv_res_t open_res                = lv_img_decoder_open(&cached_src->dec_dsc, src, style);
+    if(open_res == LV_RES_INV) {
+        LV_LOG_WARN("Image draw cannot open the image resource");
+        lv_img_decoder_close(&cached_src->dec_dsc);
+        memset(cached_src, 0, sizeof(lv_img_cache_entry_t));
+        return NULL;
+    }
 
-        cached_src->life = 0;
+    /*If `time_to_open` was not set in the open function set it here*/
+    if(cached_src->dec_dsc.time_to_open == 0) {
+        cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
+    }
 
-        /*If `time_to_open` was not set in the open function set it here*/
-        if(cached_src->dec_dsc.time_to_open == 0) {
-            cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
-        }
+    uint16_t * bucket  = &buckets[hash & (HASH_NUM - 1)];
+    cached_src->hash = hash;
+    cached_src->next = *bucket;
+    *bucket          = (uint16_t)(cached_src - cache) + 1;
+    stat.entry_cnt++;
 
-        if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+    /*The image can't give all of its pixels. Decode it once to a surface and count the decoding
+     * to the time to open too.*/
+    if(cached_src->dec_dsc.img_data == NULL && cached_src->dec_dsc.error_msg == NULL && surface_mem != NULL) {
+        t_start = lv_tick_get();
+        surface_create(cached_src);
+        cached_src->dec_dsc.time_to_open += lv_tick_elaps(t_start);
     }
 
+    if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+
+    use_cnt++;
+    cached_src->life = use_cnt;
+
     return cached_src;
 }
 
@@ -161,6 +181,8 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
         lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
     }
 
+    memset(buckets, 0, sizeof(buckets));
+
     /*Reallocate the cache*/
     LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(lv_img_cache_entry_t) * new_entry_cnt);
     LV_ASSERT_MEM(LV_GC_ROOT(_lv_img_cache_array));
@@ -171,11 +193,21 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
     entry_cnt = new_entry_cnt;
 
     /*Clean the cache*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        memset(&LV_GC_ROOT(_lv_img_cache_array)[i].dec_dsc, 0, sizeof(lv_img_decoder_dsc_t));
-        memset(&LV_GC_ROOT(_lv_img_cache_array)[i], 0, sizeof(lv_img_cache_entry_t));
-    }
+    memset(LV_GC_ROOT(_lv_img_cache_array), 0, sizeof(lv_img_cache_entry_t) * entry_cnt);
+}
+
+/**
+ * Set the memory of the decoded images (surfaces). Its size is the budget of the surfaces.
+ * It can be a part of an external SDRAM. Every cached image is closed.
+ * @param mem pointer to the memory or NULL to not store decoded images
+ * @param size size of the memory in bytes
+ */
+void lv_img_cache_set_mem(void * mem, uint32_t size)
+{
+    lv_img_cache_invalidate_src(NULL);
+
+    surface_mem      = mem;
+    surface_mem_size = mem ? size : 0;
 }
 
 /**
@@ -185,22 +217,260 @@ void lv_img_cache_set_size(uint16_t new_entry_cnt)
  */
 void lv_img_cache_invalidate_src(const void * src)
 {
-
     lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    lv_img_src_t src_type = src ? lv_img_src_get_type(src) : LV_IMG_SRC_UNKNOWN;
 
     uint16_t i;
     for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].dec_dsc.src == src || src == NULL) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
+        if(cache[i].dec_dsc.src == NULL) continue;
 
-            memset(&cache[i].dec_dsc, 0, sizeof(lv_img_decoder_dsc_t));
-            memset(&cache[i], 0, sizeof(lv_img_cache_entry_t));
+        /*Match every style of a variable*/
+        if(src == NULL || src_match(&cache[i], src, src_type, cache[i].dec_dsc.style)) {
+            close_entry(&cache[i]);
         }
     }
 }
 
+/**
+ * Get the counters of the image cache
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_img_cache_get_stat(lv_img_cache_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**
+ * Clear the hit, miss and evict counters
+ */
+void lv_img_cache_reset_stat(void)
+{
+    stat.hit_cnt   = 0;
+    stat.miss_cnt  = 0;
+    stat.evict_cnt = 0;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+/**
+ * Hash an image source: the address of a variable or the path of a file
+ * @param src the image source
+ * @param src_type type of `src`
+ * @return the hash
+ */
+static uint32_t get_hash(const void * src, lv_img_src_t src_type)
+{
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        uint32_t h = (uint32_t)((lv_uintptr_t)src >> 2);
+        return h ^ (h >> 4) ^ (h >> 8);
+    }
+
+    /*djb2 of the path (or symbol)*/
+    const uint8_t * s = src;
+    uint32_t h = 5381;
+    while(*s != '\0') {
+        h = (h << 5) + h + *s;
+        s++;
+    }
+
+    return h;
+}
+
+/**
+ * Tell whether a cache entry holds an image source
+ * @param entry pointer to a used entry
+ * @param src the image source
+ * @param src_type type of `src`
+ * @param style the style the image is opened with. (Variables are cached per style.)
+ * @return true: `entry` holds `src`
+ */
+static bool src_match(const lv_img_cache_entry_t * entry, const void * src, lv_img_src_t src_type,
+                      const lv_style_t * style)
+{
+    if(entry->dec_dsc.src_type != src_type) return false;
+
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        return entry->dec_dsc.src == src && entry->dec_dsc.style == style;
+    }
+
+    return strcmp(entry->dec_dsc.src, src) == 0;
+}
+
+/**
+ * Get an entry which doesn't hold an image
+ * @return pointer to a free entry or NULL if all entries are used
+ */
+static lv_img_cache_entry_t * get_free_entry(void)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        if(cache[i].dec_dsc.src == NULL) return &cache[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Close the least valuable image.
+ * The value is the last use plus the weighted time to open, so images slow to decode live longer.
+ * @param keep don't close this entry (can be NULL)
+ * @return true: an image was closed; false: there is no image to close
+ */
+static bool evict_entry(const lv_img_cache_entry_t * keep)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    lv_img_cache_entry_t * victim = NULL;
+    uint32_t victim_value = 0;
+
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        if(cache[i].dec_dsc.src == NULL || &cache[i] == keep) continue;
+
+        uint32_t bonus = cache[i].dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
+        if(bonus > LV_IMG_CACHE_LIFE_LIMIT) bonus = LV_IMG_CACHE_LIFE_LIMIT;
+
+        /*Compare the distances from the current time to be safe at the overflow of `use_cnt`*/
+        uint32_t value = LV_IMG_CACHE_LIFE_LIMIT - bonus + (use_cnt - cache[i].life);
+        if(victim == NULL || value > victim_value) {
+            victim       = &cache[i];
+            victim_value = value;
+        }
+    }
+
+    if(victim == NULL) return false;
+
+    close_entry(victim);
+    stat.evict_cnt++;
+
+    return true;
+}
+
+/**
+ * Close the image of an entry, free its surface and remove it from its hash chain
+ * @param entry pointer to a used entry
+ */
+static void close_entry(lv_img_cache_entry_t * entry)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    uint16_t * link = &buckets[entry->hash & (HASH_NUM - 1)];
+    uint16_t id = (uint16_t)(entry - cache) + 1;
+    while(*link != NO_ENTRY) {
+        if(*link == id) {
+            *link = entry->next;
+            break;
+        }
+        link = &cache[*link - 1].next;
+    }
+
+    /*The decoder doesn't know about the surface*/
+    if(entry->surface_size != 0) {
+        entry->dec_dsc.img_data = NULL;
+        stat.used -= entry->surface_size;
+    }
+
+    lv_img_decoder_close(&entry->dec_dsc);
+    memset(entry, 0, sizeof(lv_img_cache_entry_t));
+    stat.entry_cnt--;
+}
+
+/**
+ * Decode the whole image of an entry to a surface and give it to the drawing as `img_data`.
+ * Close other images if there is no room for it.
+ * @param entry pointer to an opened entry
+ */
+static void surface_create(lv_img_cache_entry_t * entry)
+{
+    const lv_img_header_t * header = &entry->dec_dsc.header;
+    uint32_t px_size = lv_img_color_format_has_alpha(header->cf) ? LV_IMG_PX_SIZE_ALPHA_BYTE : LV_COLOR_SIZE / 8;
+    uint32_t size = (uint32_t)header->w * header->h * px_size;
+    size = (size + SURFACE_ALIGN - 1) & ~(uint32_t)(SURFACE_ALIGN - 1);
+    if(size == 0 || size > surface_mem_size) return;
+
+    uint32_t ofs;
+    while(surface_find_gap(size, &ofs) == false) {
+        if(evict_entry(entry) == false) return;
+    }
+
+    entry->surface_ofs  = ofs;
+    entry->surface_size = size;
+    if(surface_decode(entry) == false) {
+        LV_LOG_WARN("image cache: can't decode the image to a surface");
+        entry->surface_size = 0;
+        return;
+    }
+
+    entry->dec_dsc.img_data = &surface_mem[ofs];
+    stat.used += size;
+}
+
+/**
+ * Read every line of an image to its surface
+ * @param entry pointer to an entry with a surface
+ * @return true: the image is decoded; false: a line can't be read
+ */
+static bool surface_decode(lv_img_cache_entry_t * entry)
+{
+    lv_img_decoder_dsc_t * dsc = &entry->dec_dsc;
+    uint32_t px_size = lv_img_color_format_has_alpha(dsc->header.cf) ? LV_IMG_PX_SIZE_ALPHA_BYTE : LV_COLOR_SIZE / 8;
+    uint32_t line_size = dsc->header.w * px_size;
+    uint8_t * buf = &surface_mem[entry->surface_ofs];
+
+    /*`read_line` of the decoders gives the lines in the drawing's format*/
+    const uint8_t * img_data = dsc->img_data;
+    dsc->img_data = NULL;
+
+    lv_coord_t y;
+    for(y = 0; y < dsc->header.h; y++) {
+        if(lv_img_decoder_read_line(dsc, 0, y, dsc->header.w, buf) != LV_RES_OK) {
+            dsc->img_data = img_data;
+            return false;
+        }
+        buf += line_size;
+    }
+
+    dsc->img_data = img_data;
+    if(dsc->style) entry->surface_color = dsc->style->image.color;
+
+    return true;
+}
+
+/**
+ * Find the lowest free range in the memory of the surfaces (first fit)
+ * @param size size of the range
+ * @param ofs store the offset of the range here
+ * @return true: a range is found; false: there is no free range with this size
+ */
+static bool surface_find_gap(uint32_t size, uint32_t * ofs)
+{
+    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    bool found = false;
+    uint32_t best = 0;
+
+    /*The range can start at the beginning of the memory or after a surface*/
+    int32_t i;
+    for(i = -1; i < entry_cnt; i++) {
+        if(i >= 0 && cache[i].surface_size == 0) continue;
+
+        uint32_t start = i < 0 ? 0 : cache[i].surface_ofs + cache[i].surface_size;
+        if(start + size > surface_mem_size) continue;
+        if(found && start >= best) continue;
+
+        uint16_t j;
+        for(j = 0; j < entry_cnt; j++) {
+            if(cache[j].surface_size == 0) continue;
+            if(start < cache[j].surface_ofs + cache[j].surface_size && cache[j].surface_ofs < start + size) break;
+        }
+
+        if(j == entry_cnt) {
+            best  = start;
+            found = true;
+        }
+    }
+
+    *ofs = best;
+    return found;
+}
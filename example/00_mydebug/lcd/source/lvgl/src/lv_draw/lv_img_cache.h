@@ -27,17 +27,35 @@ extern "C" {
  * When loading images from the network it can take a long time to download and decode the image.
  * 
  * To avoid repeating this heavy load images can be cached.
+ * The images which can't give all of their pixels at open (files, indexed and alpha images, etc.)
+ * are decoded once to a surface in the memory given with `lv_img_cache_set_mem` and drawn from there.
  */
 typedef struct
 {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information */
 
-    /** Count the cache entries's life. Add `time_tio_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused */
-    int32_t life;
+    /** Value of the open counter when the entry was used the last time.
+     * The entry with the least `life` + weighted `time_to_open` is reused first */
+    uint32_t life;
+    uint32_t hash;          /**< Hash of the source*/
+    uint32_t surface_ofs;   /**< Offset of the decoded image in the memory of the cache*/
+    uint32_t surface_size;  /**< Size of the decoded image. 0: the image has no surface*/
+    lv_color_t surface_color; /**< `image.color` of the style when the surface was decoded*/
+    uint16_t next;          /**< Next entry with the same hash (index + 1, 0: end of the chain)*/
 } lv_img_cache_entry_t;
 
+/**
+ * Counters of the image cache
+ */
+typedef struct
+{
+    uint32_t hit_cnt;   /**< Images found in the cache*/
+    uint32_t miss_cnt;  /**< Images opened again*/
+    uint32_t evict_cnt; /**< Images closed to make room*/
+    uint32_t used;      /**< Bytes used by the surfaces*/
+    uint16_t entry_cnt; /**< Number of opened images*/
+} lv_img_cache_stat_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -60,6 +78,14 @@ lv_img_cache_entry_t * lv_img_cache_open(const void * src, const lv_style_t * st
  */
 void lv_img_cache_set_size(uint16_t new_slot_num);
 
+/**
+ * Set the memory of the decoded images (surfaces). Its size is the budget of the surfaces.
+ * It can be a part of an external SDRAM. Every cached image is closed.
+ * @param mem pointer to the memory or NULL to not store decoded images
+ * @param size size of the memory in bytes
+ */
+void lv_img_cache_set_mem(void * mem, uint32_t size);
+
 /**
  * Invalidate an image source in the cache.
  * Useful if the image source is updated therefore it needs to be cached again.
@@ -67,6 +93,17 @@ void lv_img_cache_set_size(uint16_t new_slot_num);
  */
 void lv_img_cache_invalidate_src(const void * src);
 
+/**
+ * Get the counters of the image cache
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_img_cache_get_stat(lv_img_cache_stat_t * stat);
+
+/**
+ * Clear the hit, miss and evict counters
+ */
+void lv_img_cache_reset_stat(void);
+
 /**********************
  *      MACROS
  **********************/
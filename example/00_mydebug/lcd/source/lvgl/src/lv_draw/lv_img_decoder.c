@@ -7,6 +7,7 @@
  *      INCLUDES
  *********************/
 #include "lv_img_decoder.h"
+#include "lv_img_qli.h"
 #include "../lv_core/lv_debug.h"
 #include "../lv_draw/lv_draw_img.h"
 #include "../lv_misc/lv_ll.h"
@@ -78,6 +79,10 @@ void lv_img_decoder_init(void)
     lv_img_decoder_set_open_cb(decoder, lv_img_decoder_built_in_open);
     lv_img_decoder_set_read_line_cb(decoder, lv_img_decoder_built_in_read_line);
     lv_img_decoder_set_close_cb(decoder, lv_img_decoder_built_in_close);
+
+#if LV_USE_IMG_QLI
+    lv_img_qli_init();
+#endif
 }
 
 /**
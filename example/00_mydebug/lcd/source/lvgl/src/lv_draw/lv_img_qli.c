@@ -0,0 +1,360 @@
+/**
+ * @file lv_img_qli.c
+ * Line indexed compressed images (QLI)
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_img_qli.h"
+#if LV_USE_IMG_QLI
+
+#include <string.h>
+#include "../lv_core/lv_debug.h"
+#include "../lv_misc/lv_math.h"
+#include "lv_draw_img.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define QLI_OP_INDEX    0x00
+#define QLI_OP_DIFF     0x40
+#define QLI_OP_LUMA     0x80
+#define QLI_OP_RUN      0xC0
+#define QLI_OP_RGB      0xFE
+#define QLI_OP_MASK     0xC0
+
+#define QLI_RUN_MAX     62
+#define QLI_INDEX_NUM   64
+
+/*Largest code: the RGB565 color*/
+#define QLI_CODE_MAX    3
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header);
+static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc);
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                  lv_coord_t y, lv_coord_t len, uint8_t * buf);
+static uint32_t encode_line(const uint16_t * px, lv_coord_t w, uint8_t * out, uint32_t out_size);
+static uint32_t get_u32(const uint8_t * p);
+static void put_u32(uint8_t * p, uint32_t v);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_img_qli_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+#define QLI_R(c)            ((int32_t)((c) >> 11))
+#define QLI_G(c)            ((int32_t)(((c) >> 5) & 0x3F))
+#define QLI_B(c)            ((int32_t)((c) & 0x1F))
+#define QLI_RGB(r, g, b)    ((uint16_t)((((r) & 0x1F) << 11) | (((g) & 0x3F) << 5) | ((b) & 0x1F)))
+#define QLI_HASH(c)         ((QLI_R(c) * 3 + QLI_G(c) * 5 + QLI_B(c) * 7) % QLI_INDEX_NUM)
+
+/*Wrap a difference of two channels to [-bits/2, bits/2 - 1]*/
+#define QLI_WRAP(d, bits)   ((((d) + (1 << ((bits) - 1))) & ((1 << (bits)) - 1)) - (1 << ((bits) - 1)))
+
+/*Floor of `dg / 2` for the green differences of [-32, 31]*/
+#define QLI_HALF(dg)        (((dg) + 32) / 2 - 16)
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Add the decoder of the QLI images. Called by `lv_img_decoder_init`.
+ */
+void lv_img_qli_init(void)
+{
+    lv_img_decoder_t * decoder = lv_img_decoder_create();
+    if(decoder == NULL) {
+        LV_LOG_WARN("lv_img_qli_init: out of memory");
+        return;
+    }
+
+    lv_img_decoder_set_info_cb(decoder, decoder_info);
+    lv_img_decoder_set_open_cb(decoder, decoder_open);
+    lv_img_decoder_set_read_line_cb(decoder, decoder_read_line);
+}
+
+/**
+ * Code an RGB565 image to QLI data
+ * @param px the pixels of the image line by line
+ * @param w width of the image
+ * @param h height of the image
+ * @param out buffer of the coded data
+ * @param out_size size of `out`. `LV_IMG_QLI_MAX_SIZE(w, h)` is always enough.
+ * @return size of the coded data or 0 if it doesn't fit into `out`
+ */
+uint32_t lv_img_qli_encode(const uint16_t * px, lv_coord_t w, lv_coord_t h, uint8_t * out, uint32_t out_size)
+{
+    uint32_t table_size = LV_IMG_QLI_TABLE_SIZE(h);
+    if(w <= 0 || h <= 0 || out_size < table_size) return 0;
+
+    uint8_t * lines = out + table_size;
+    uint32_t lines_size = out_size - table_size;
+    uint32_t ofs = 0;
+
+    lv_coord_t y;
+    for(y = 0; y < h; y++) {
+        put_u32(&out[y * 4], ofs);
+
+        uint32_t line_size = encode_line(&px[(uint32_t)y * w], w, &lines[ofs], lines_size - ofs);
+        if(line_size == 0) return 0;
+        ofs += line_size;
+    }
+
+    put_u32(&out[h * 4], ofs);
+
+    return table_size + ofs;
+}
+
+/**
+ * Decode a part of a line of a QLI image
+ * @param dsc pointer to a QLI image
+ * @param x first pixel to decode
+ * @param y the line to decode
+ * @param len number of pixels to decode
+ * @param buf store the pixels here
+ * @return LV_RES_OK: the pixels are decoded; LV_RES_INV: the line is out of the image or corrupted
+ */
+lv_res_t lv_img_qli_read_line(const lv_img_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                              lv_color_t * buf)
+{
+    if(x < 0 || y < 0 || len <= 0 || y >= dsc->header.h || x + len > dsc->header.w) return LV_RES_INV;
+
+    /*Find the line in the table*/
+    const uint8_t * table = dsc->data;
+    uint32_t table_size = LV_IMG_QLI_TABLE_SIZE(dsc->header.h);
+    uint32_t start = get_u32(&table[y * 4]);
+    uint32_t end = get_u32(&table[(y + 1) * 4]);
+    if(start > end || table_size + end > dsc->data_size) return LV_RES_INV;
+
+    const uint8_t * line = &table[table_size + start];
+    const uint8_t * p = line;
+    const uint8_t * p_end = &table[table_size + end];
+
+    /*The pixels before `x` are decoded too but not stored*/
+    uint16_t index[QLI_INDEX_NUM];
+    memset(index, 0, sizeof(index));
+    uint16_t c = 0;
+    lv_coord_t pos = 0;
+    lv_coord_t x_end = x + len;
+    while(pos < x_end) {
+        if(p >= p_end) return LV_RES_INV;
+
+        uint8_t code = *p;
+        p++;
+        lv_coord_t n = 1;
+        if(code == QLI_OP_RGB) {
+            if(p + 2 > p_end) return LV_RES_INV;
+            c = (uint16_t)(p[0] | (p[1] << 8));
+            p += 2;
+            index[QLI_HASH(c)] = c;
+        } else if((code & QLI_OP_MASK) == QLI_OP_RUN) {
+            if(code > QLI_OP_RUN + QLI_RUN_MAX - 1) return LV_RES_INV;
+            n = (code & 0x3F) + 1;
+        } else if((code & QLI_OP_MASK) == QLI_OP_LUMA) {
+            if(p >= p_end) return LV_RES_INV;
+            int32_t dg = (code & 0x3F) - 32;
+            int32_t dr = (*p >> 4) - 8 + QLI_HALF(dg);
+            int32_t db = (*p & 0x0F) - 8 + QLI_HALF(dg);
+            p++;
+            c = QLI_RGB(QLI_R(c) + dr, QLI_G(c) + dg, QLI_B(c) + db);
+            index[QLI_HASH(c)] = c;
+        } else if((code & QLI_OP_MASK) == QLI_OP_DIFF) {
+            int32_t dr = ((code >> 4) & 0x03) - 2;
+            int32_t dg = ((code >> 2) & 0x03) - 2;
+            int32_t db = (code & 0x03) - 2;
+            c = QLI_RGB(QLI_R(c) + dr, QLI_G(c) + dg, QLI_B(c) + db);
+            index[QLI_HASH(c)] = c;
+        } else {
+            c = index[code];
+        }
+
+        /*Store the pixels in [x, x_end)*/
+        if(pos + n > x) {
+            lv_color_t color;
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0
+            color.full = c;
+#else
+            color = LV_COLOR_MAKE((QLI_R(c) << 3) | (QLI_R(c) >> 2), (QLI_G(c) << 2) | (QLI_G(c) >> 4),
+                                  (QLI_B(c) << 3) | (QLI_B(c) >> 2));
+#endif
+            lv_coord_t i     = pos < x ? x : pos;
+            lv_coord_t i_end = LV_MATH_MIN(pos + n, x_end);
+            for(; i < i_end; i++) buf[i - x] = color;
+        }
+        pos += n;
+    }
+
+    stat.line_cnt++;
+    stat.px_cnt += len;
+    stat.src_size += (uint32_t)(p - line);
+
+    return LV_RES_OK;
+}
+
+/**
+ * Describe a QLI image stored as a blob (e.g. in a memory mapped flash)
+ * @param blob pointer to the blob
+ * @param dsc store the descriptor of the image here. Its `data` points into `blob`.
+ * @return LV_RES_OK: `blob` is a QLI image; LV_RES_INV: it's not
+ */
+lv_res_t lv_img_qli_parse_blob(const void * blob, lv_img_dsc_t * dsc)
+{
+    const uint8_t * p = blob;
+    memcpy(&dsc->header, p, sizeof(lv_img_header_t));
+    dsc->data_size = get_u32(&p[4]);
+    dsc->data      = &p[LV_IMG_QLI_BLOB_HEADER_SIZE];
+
+    if(dsc->header.cf != LV_IMG_CF_QLI || dsc->header.always_zero != 0) return LV_RES_INV;
+    if(dsc->header.w == 0 || dsc->header.h == 0) return LV_RES_INV;
+    if(dsc->data_size < LV_IMG_QLI_TABLE_SIZE(dsc->header.h)) return LV_RES_INV;
+
+    return LV_RES_OK;
+}
+
+/**
+ * Get the counters of the QLI decoder
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_img_qli_get_stat(lv_img_qli_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**
+ * Clear the counters of the QLI decoder
+ */
+void lv_img_qli_reset_stat(void)
+{
+    memset(&stat, 0, sizeof(stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_res_t decoder_info(lv_img_decoder_t * decoder, const void * src, lv_img_header_t * header)
+{
+    (void)decoder; /*Unused*/
+
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+
+    const lv_img_dsc_t * img = src;
+    if(img->header.cf != LV_IMG_CF_QLI) return LV_RES_INV;
+
+    *header = img->header;
+
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_open(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc)
+{
+    (void)decoder; /*Unused*/
+
+    /*Nothing to prepare: the lines are decoded directly from the image data*/
+    dsc->img_data = NULL;
+
+    return LV_RES_OK;
+}
+
+static lv_res_t decoder_read_line(lv_img_decoder_t * decoder, lv_img_decoder_dsc_t * dsc, lv_coord_t x,
+                                  lv_coord_t y, lv_coord_t len, uint8_t * buf)
+{
+    (void)decoder; /*Unused*/
+
+    return lv_img_qli_read_line(dsc->src, x, y, len, (lv_color_t *)buf);
+}
+
+/**
+ * Code a line
+ * @param px the pixels of the line
+ * @param w number of pixels
+ * @param out buffer of the coded line
+ * @param out_size size of `out`
+ * @return size of the coded line or 0 if it doesn't fit into `out`
+ */
+static uint32_t encode_line(const uint16_t * px, lv_coord_t w, uint8_t * out, uint32_t out_size)
+{
+    uint16_t index[QLI_INDEX_NUM];
+    memset(index, 0, sizeof(index));
+    uint16_t prev = 0;
+    uint32_t run = 0;
+    uint32_t size = 0;
+
+    lv_coord_t i;
+    for(i = 0; i < w; i++) {
+        uint16_t c = px[i];
+
+        /*There is room for one more code of every remaining pixel if the size is enough for the worst case*/
+        if(out_size - size < QLI_CODE_MAX) return 0;
+
+        if(c == prev) {
+            run++;
+            if(run == QLI_RUN_MAX || i == w - 1) {
+                out[size++] = (uint8_t)(QLI_OP_RUN | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+
+        if(run > 0) {
+            out[size++] = (uint8_t)(QLI_OP_RUN | (run - 1));
+            run = 0;
+            if(out_size - size < QLI_CODE_MAX) return 0;
+        }
+
+        uint32_t h = QLI_HASH(c);
+        if(index[h] == c) {
+            out[size++] = (uint8_t)(QLI_OP_INDEX | h);
+        } else {
+            index[h] = c;
+
+            int32_t dr = QLI_WRAP(QLI_R(c) - QLI_R(prev), 5);
+            int32_t dg = QLI_WRAP(QLI_G(c) - QLI_G(prev), 6);
+            int32_t db = QLI_WRAP(QLI_B(c) - QLI_B(prev), 5);
+            int32_t dr_g = dr - QLI_HALF(dg);
+            int32_t db_g = db - QLI_HALF(dg);
+
+            if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                out[size++] = (uint8_t)(QLI_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+            } else if(dr_g >= -8 && dr_g <= 7 && db_g >= -8 && db_g <= 7) {
+                out[size++] = (uint8_t)(QLI_OP_LUMA | (dg + 32));
+                out[size++] = (uint8_t)(((dr_g + 8) << 4) | (db_g + 8));
+            } else {
+                out[size++] = QLI_OP_RGB;
+                out[size++] = (uint8_t)(c & 0xFF);
+                out[size++] = (uint8_t)(c >> 8);
+            }
+        }
+
+        prev = c;
+    }
+
+    return size;
+}
+
+static uint32_t get_u32(const uint8_t * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void put_u32(uint8_t * p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+#endif /*LV_USE_IMG_QLI*/
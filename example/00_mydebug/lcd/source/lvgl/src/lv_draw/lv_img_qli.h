@@ -0,0 +1,131 @@
+/**
+ * @file lv_img_qli.h
+ * Line indexed compressed images (QLI): a QOI like RGB565 coding restarted on every line
+ * and a table of the line offsets, so any line can be decoded alone.
+ */
+
+#ifndef LV_IMG_QLI_H
+#define LV_IMG_QLI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include "lv_img_decoder.h"
+
+#if LV_USE_IMG_QLI
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Color format of the QLI images in `lv_img_header_t`*/
+#define LV_IMG_CF_QLI               LV_IMG_CF_USER_ENCODED_0
+
+/* Layout of the data of a QLI image (every number is little endian):
+ * - `uint32_t` offsets of the `h` lines and the end of the last line, counted from the end of this table
+ * - the coded lines. Every line starts with black as previous pixel and an empty color index.
+ *
+ * Codes of a line:
+ * - 00iiiiii:              the color of the index `i` (index of a color: (r * 3 + g * 5 + b * 7) % 64)
+ * - 01rrggbb:              the previous color + r, g, b - 2
+ * - 10gggggg rrrrbbbb:     the previous color + g - 32 on green, r - 8 + (g - 32) / 2 on red and
+ *                          b - 8 + (g - 32) / 2 on blue
+ * - 11nnnnnn (n < 62):     the previous color n + 1 times
+ * - 11111110 LL HH:        an RGB565 color
+ * - 11111111:              reserved*/
+
+/*Size of the line table of an image with `h` lines*/
+#define LV_IMG_QLI_TABLE_SIZE(h)    (((uint32_t)(h) + 1) * 4)
+
+/*Largest size of a coded image: every pixel is an RGB565 code*/
+#define LV_IMG_QLI_MAX_SIZE(w, h)   (LV_IMG_QLI_TABLE_SIZE(h) + (uint32_t)(w) * (uint32_t)(h) * 3)
+
+/*A blob to store an image e.g. in an external flash: `lv_img_header_t`, the data size and the data*/
+#define LV_IMG_QLI_BLOB_HEADER_SIZE 8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Counters of the QLI decoder
+ */
+typedef struct
+{
+    uint32_t line_cnt;  /**< Decoded lines*/
+    uint32_t px_cnt;    /**< Pixels given to the drawing*/
+    uint32_t src_size;  /**< Bytes read from the images*/
+} lv_img_qli_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Add the decoder of the QLI images. Called by `lv_img_decoder_init`.
+ */
+void lv_img_qli_init(void);
+
+/**
+ * Code an RGB565 image to QLI data
+ * @param px the pixels of the image line by line
+ * @param w width of the image
+ * @param h height of the image
+ * @param out buffer of the coded data
+ * @param out_size size of `out`. `LV_IMG_QLI_MAX_SIZE(w, h)` is always enough.
+ * @return size of the coded data or 0 if it doesn't fit into `out`
+ */
+uint32_t lv_img_qli_encode(const uint16_t * px, lv_coord_t w, lv_coord_t h, uint8_t * out, uint32_t out_size);
+
+/**
+ * Decode a part of a line of a QLI image
+ * @param dsc pointer to a QLI image
+ * @param x first pixel to decode
+ * @param y the line to decode
+ * @param len number of pixels to decode
+ * @param buf store the pixels here
+ * @return LV_RES_OK: the pixels are decoded; LV_RES_INV: the line is out of the image or corrupted
+ */
+lv_res_t lv_img_qli_read_line(const lv_img_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                              lv_color_t * buf);
+
+/**
+ * Describe a QLI image stored as a blob (e.g. in a memory mapped flash)
+ * @param blob pointer to the blob
+ * @param dsc store the descriptor of the image here. Its `data` points into `blob`.
+ * @return LV_RES_OK: `blob` is a QLI image; LV_RES_INV: it's not
+ */
+lv_res_t lv_img_qli_parse_blob(const void * blob, lv_img_dsc_t * dsc);
+
+/**
+ * Get the counters of the QLI decoder
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_img_qli_get_stat(lv_img_qli_stat_t * stat);
+
+/**
+ * Clear the counters of the QLI decoder
+ */
+void lv_img_qli_reset_stat(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_IMG_QLI*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_IMG_QLI_H*/
@@ -0,0 +1,168 @@
+/**
+ * @file lv_mask_cache.c
+ * Least recently used cache of masks calculated for the drawing.
+ * The masks are allocated with `lv_mem_alloc`, their total size is limited to the `size` of the cache
+ * and they are dropped in least recently used order.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_mask_cache.h"
+#include "../lv_misc/lv_mem.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint8_t * entry_key(lv_mask_cache_t * cache, uint16_t id);
+static bool evict_lru(lv_mask_cache_t * cache);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Get a cached mask.
+ * The keys are compared byte by byte: clear the padding of the key (e.g. with `memset`) before setting its fields.
+ * @param cache pointer to a cache
+ * @param key pointer to `key_size` bytes identifying the mask
+ * @return pointer to the mask or NULL if it's not cached
+ */
+const uint8_t * lv_mask_cache_get(lv_mask_cache_t * cache, const void * key)
+{
+    uint16_t i;
+    for(i = 0; i < cache->entry_num; i++) {
+        lv_mask_cache_entry_t * e = &cache->entries[i];
+        if(e->data && memcmp(entry_key(cache, i), key, cache->key_size) == 0) {
+            cache->use_cnt++;
+            e->life = cache->use_cnt;
+            cache->stat.hit_cnt++;
+            return e->data;
+        }
+    }
+
+    cache->stat.miss_cnt++;
+    return NULL;
+}
+
+/**
+ * Add a mask to the cache. The least recently used masks are dropped if there is no room.
+ * The masks are allocated with `lv_mem_alloc` (so they are seen by `lv_mem_monitor`).
+ * @param cache pointer to a cache
+ * @param key pointer to `key_size` bytes identifying the mask
+ * @param size size of the mask in bytes
+ * @return pointer to `size` bytes where the mask should be written
+ *         or NULL if it can't be cached (e.g. it's larger than the half of the cache)
+ */
+uint8_t * lv_mask_cache_add(lv_mask_cache_t * cache, const void * key, uint32_t size)
+{
+    /*Don't let a huge mask drop the whole cache*/
+    if(size == 0 || size > cache->size / 2) return NULL;
+
+    /*Make room for the mask and get a free entry*/
+    while(cache->stat.used + size > cache->size || cache->stat.entry_cnt >= cache->entry_num) {
+        if(evict_lru(cache) == false) return NULL;
+    }
+
+    uint16_t id;
+    for(id = 0; id < cache->entry_num; id++) {
+        if(cache->entries[id].data == NULL) break;
+    }
+
+    lv_mask_cache_entry_t * e = &cache->entries[id];
+    e->data                   = lv_mem_alloc(size);
+    if(e->data == NULL) return NULL;
+
+    cache->use_cnt++;
+    memcpy(entry_key(cache, id), key, cache->key_size);
+    e->size = size;
+    e->life = cache->use_cnt;
+
+    cache->stat.used += size;
+    cache->stat.entry_cnt++;
+
+    return e->data;
+}
+
+/**
+ * Drop every cached mask. The counters are not cleared.
+ * @param cache pointer to a cache
+ */
+void lv_mask_cache_clear(lv_mask_cache_t * cache)
+{
+    while(evict_lru(cache));
+    cache->stat.evict_cnt = 0;
+}
+
+/**
+ * Get the counters of a cache
+ * @param cache pointer to a cache
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_mask_cache_get_stat(const lv_mask_cache_t * cache, lv_mask_cache_stat_t * stat)
+{
+    *stat = cache->stat;
+}
+
+/**
+ * Clear the hit, miss and evict counters
+ * @param cache pointer to a cache
+ */
+void lv_mask_cache_reset_stat(lv_mask_cache_t * cache)
+{
+    cache->stat.hit_cnt   = 0;
+    cache->stat.miss_cnt  = 0;
+    cache->stat.evict_cnt = 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint8_t * entry_key(lv_mask_cache_t * cache, uint16_t id)
+{
+    return (uint8_t *)cache->keys + (uint32_t)id * cache->key_size;
+}
+
+/**
+ * Drop the least recently used mask
+ * @param cache pointer to a cache
+ * @return true: a mask was dropped; false: the cache is empty
+ */
+static bool evict_lru(lv_mask_cache_t * cache)
+{
+    lv_mask_cache_entry_t * lru = NULL;
+    uint16_t i;
+    for(i = 0; i < cache->entry_num; i++) {
+        lv_mask_cache_entry_t * e = &cache->entries[i];
+        if(e->data == NULL) continue;
+        if(lru == NULL || e->life < lru->life) lru = e;
+    }
+
+    if(lru == NULL) return false;
+
+    lv_mem_free(lru->data);
+    lru->data = NULL;
+    cache->stat.used -= lru->size;
+    cache->stat.entry_cnt--;
+    cache->stat.evict_cnt++;
+
+    return true;
+}
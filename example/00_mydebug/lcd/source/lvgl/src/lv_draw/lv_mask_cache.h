@@ -0,0 +1,121 @@
+/**
+ * @file lv_mask_cache.h
+ * Least recently used cache of masks calculated for the drawing (e.g. the corners of the shadows)
+ */
+
+#ifndef LV_MASK_CACHE_H
+#define LV_MASK_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Counters of a mask cache
+ */
+typedef struct
+{
+    uint32_t hit_cnt;   /**< Masks found in the cache*/
+    uint32_t miss_cnt;  /**< Masks not found in the cache*/
+    uint32_t evict_cnt; /**< Masks dropped to make room*/
+    uint32_t used;      /**< Bytes allocated for the cached masks*/
+    uint16_t entry_cnt; /**< Number of cached masks*/
+} lv_mask_cache_stat_t;
+
+/**
+ * A cached mask
+ */
+typedef struct
+{
+    uint8_t * data;     /**< The mask. NULL: the entry is free*/
+    uint32_t size;      /**< Size of the mask*/
+    uint32_t life;      /**< Value of `use_cnt` at the last use*/
+} lv_mask_cache_entry_t;
+
+/**
+ * A mask cache. Set the first five fields when it's defined, the rest have to be zero, e.g.
+ * `lv_mask_cache_t c = {entries, keys, sizeof(my_key_t), ENTRY_NUM, BYTE_NUM};`
+ */
+typedef struct
+{
+    lv_mask_cache_entry_t * entries; /**< `entry_num` entries*/
+    void * keys;                     /**< `entry_num` keys of `key_size` bytes*/
+    uint16_t key_size;               /**< Size of a key in bytes*/
+    uint16_t entry_num;              /**< Maximal number of cached masks*/
+    uint32_t size;                   /**< Maximal size of the cached masks in bytes*/
+    uint32_t use_cnt;                /**< Incremented on every use to order the entries*/
+    lv_mask_cache_stat_t stat;
+} lv_mask_cache_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Get a cached mask.
+ * The keys are compared byte by byte: clear the padding of the key (e.g. with `memset`) before setting its fields.
+ * @param cache pointer to a cache
+ * @param key pointer to `key_size` bytes identifying the mask
+ * @return pointer to the mask or NULL if it's not cached
+ */
+const uint8_t * lv_mask_cache_get(lv_mask_cache_t * cache, const void * key);
+
+/**
+ * Add a mask to the cache. The least recently used masks are dropped if there is no room.
+ * The masks are allocated with `lv_mem_alloc` (so they are seen by `lv_mem_monitor`).
+ * @param cache pointer to a cache
+ * @param key pointer to `key_size` bytes identifying the mask
+ * @param size size of the mask in bytes
+ * @return pointer to `size` bytes where the mask should be written
+ *         or NULL if it can't be cached (e.g. it's larger than the half of the cache)
+ */
+uint8_t * lv_mask_cache_add(lv_mask_cache_t * cache, const void * key, uint32_t size);
+
+/**
+ * Drop every cached mask. The counters are not cleared.
+ * @param cache pointer to a cache
+ */
+void lv_mask_cache_clear(lv_mask_cache_t * cache);
+
+/**
+ * Get the counters of a cache
+ * @param cache pointer to a cache
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_mask_cache_get_stat(const lv_mask_cache_t * cache, lv_mask_cache_stat_t * stat);
+
+/**
+ * Clear the hit, miss and evict counters
+ * @param cache pointer to a cache
+ */
+void lv_mask_cache_reset_stat(lv_mask_cache_t * cache);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_MASK_CACHE_H*/
@@ -0,0 +1,26 @@
+/**
+ * @file lv_shadow_cache.c
+ * Cache of the opacity masks of the shadows.
+ * An instance of `lv_mask_cache` with its own keys and budget.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_shadow_cache.h"
+
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_mask_cache_entry_t entries[LV_SHADOW_CACHE_ENTRY_NUM];
+static lv_shadow_cache_key_t keys[LV_SHADOW_CACHE_ENTRY_NUM];
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+lv_mask_cache_t lv_shadow_cache = {entries, keys, sizeof(lv_shadow_cache_key_t), LV_SHADOW_CACHE_ENTRY_NUM,
+                                 LV_SHADOW_CACHE_SIZE};
+
+#endif /*LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE*/
@@ -0,0 +1,69 @@
+/**
+ * @file lv_shadow_cache.h
+ * Cache of the opacity masks of the shadows
+ */
+
+#ifndef LV_SHADOW_CACHE_H
+#define LV_SHADOW_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include "../lv_misc/lv_area.h"
+#include "../lv_misc/lv_color.h"
+#include "lv_mask_cache.h"
+
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * The parameters a shadow mask depends on.
+ * The keys are compared byte by byte, clear them with `memset` before setting the fields.
+ */
+typedef struct
+{
+    lv_coord_t radius;  /**< Radius of the corners after the correction with the size and the anti-aliasing*/
+    lv_coord_t width;   /**< Width of the shadow*/
+    lv_opa_t opa;       /**< Opacity of the shadow*/
+    uint8_t type;       /**< Type of the shadow from `lv_shadow_type_t`*/
+} lv_shadow_cache_key_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * The cache of the shadow masks (`LV_SHADOW_CACHE_SIZE` bytes, `LV_SHADOW_CACHE_ENTRY_NUM` masks)
+ * with `lv_shadow_cache_key_t` keys. Use it with the `lv_mask_cache_...` functions.
+ */
+extern lv_mask_cache_t lv_shadow_cache;
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_SHADOW_CACHE_H*/
@@ -0,0 +1,249 @@
+/**
+ * @file lv_font_cache.c
+ * Cache of decompressed glyph bitmaps.
+ * The bitmaps are stored in a pool of `LV_FONT_CACHE_SIZE` bytes (first fit),
+ * found by a hash of the font and the letter and dropped in least recently used order.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_font_cache.h"
+#include "../lv_misc/lv_types.h"
+
+#if LV_FONT_CACHE_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Number of hash buckets. Must be a power of 2.*/
+#define HASH_NUM    64
+
+/*Marks the end of a chain (the links store the entry index + 1)*/
+#define NO_ENTRY    0
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const lv_font_t * font;
+    uint32_t letter;
+    uint32_t ofs;       /*Offset of the bitmap in the pool*/
+    uint32_t size;      /*Size of the bitmap. 0: the entry is free*/
+    uint32_t life;      /*Value of `use_cnt` at the last use*/
+    uint16_t next;      /*Next entry in the same bucket*/
+} entry_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t get_hash(const lv_font_t * font, uint32_t letter);
+static bool find_gap(uint32_t size, uint32_t * ofs, uint16_t * pos);
+static bool evict_lru(void);
+static void remove_entry(uint16_t id);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_FONT_CACHE_ADR == 0
+static LV_FONT_CACHE_ATTR uint8_t pool_int[LV_FONT_CACHE_SIZE];
+static uint8_t * const pool = pool_int;
+#else
+static uint8_t * const pool = (uint8_t *)LV_FONT_CACHE_ADR;
+#endif
+
+static entry_t entries[LV_FONT_CACHE_ENTRY_NUM];
+static uint16_t buckets[HASH_NUM];
+
+/*Indices of the used entries in the order of their offset*/
+static uint16_t order[LV_FONT_CACHE_ENTRY_NUM];
+static uint16_t order_cnt;
+
+static uint32_t use_cnt;
+static lv_font_cache_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Get the cached bitmap of a letter
+ * @param font pointer to a font
+ * @param letter an unicode letter
+ * @return pointer to the bitmap or NULL if it's not cached
+ */
+const uint8_t * lv_font_cache_get(const lv_font_t * font, uint32_t letter)
+{
+    uint16_t link = buckets[get_hash(font, letter)];
+    while(link != NO_ENTRY) {
+        entry_t * e = &entries[link - 1];
+        if(e->letter == letter && e->font == font) {
+            use_cnt++;
+            e->life = use_cnt;
+            stat.hit_cnt++;
+            return &pool[e->ofs];
+        }
+        link = e->next;
+    }
+
+    stat.miss_cnt++;
+    return NULL;
+}
+
+/**
+ * Add a bitmap to the cache. The least recently used bitmaps are dropped if there is no room.
+ * @param font pointer to a font
+ * @param letter an unicode letter
+ * @param size size of the bitmap in bytes
+ * @return pointer to `size` bytes where the bitmap should be written or NULL if it can't be cached
+ */
+uint8_t * lv_font_cache_add(const lv_font_t * font, uint32_t letter, uint32_t size)
+{
+    /*Don't let a huge glyph drop the whole cache*/
+    if(size == 0 || size > LV_FONT_CACHE_SIZE / 4) return NULL;
+
+    /*Get room in the pool and a free entry*/
+    uint32_t ofs;
+    uint16_t pos;
+    while(order_cnt >= LV_FONT_CACHE_ENTRY_NUM || find_gap(size, &ofs, &pos) == false) {
+        if(evict_lru() == false) return NULL;
+    }
+
+    uint16_t id;
+    for(id = 0; id < LV_FONT_CACHE_ENTRY_NUM; id++) {
+        if(entries[id].size == 0) break;
+    }
+
+    uint32_t hash = get_hash(font, letter);
+    entry_t * e   = &entries[id];
+    use_cnt++;
+    e->font       = font;
+    e->letter     = letter;
+    e->ofs        = ofs;
+    e->size       = size;
+    e->life       = use_cnt;
+    e->next       = buckets[hash];
+    buckets[hash] = id + 1;
+
+    memmove(&order[pos + 1], &order[pos], (order_cnt - pos) * sizeof(order[0]));
+    order[pos] = id;
+    order_cnt++;
+
+    stat.used += size;
+    stat.entry_cnt++;
+
+    return &pool[ofs];
+}
+
+/**
+ * Drop every cached bitmap. The counters are not cleared.
+ */
+void lv_font_cache_clear(void)
+{
+    memset(entries, 0, sizeof(entries));
+    memset(buckets, 0, sizeof(buckets));
+    order_cnt      = 0;
+    stat.used      = 0;
+    stat.entry_cnt = 0;
+}
+
+/**
+ * Get the counters of the glyph cache
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_font_cache_get_stat(lv_font_cache_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**
+ * Clear the hit, miss and evict counters
+ */
+void lv_font_cache_reset_stat(void)
+{
+    stat.hit_cnt   = 0;
+    stat.miss_cnt  = 0;
+    stat.evict_cnt = 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t get_hash(const lv_font_t * font, uint32_t letter)
+{
+    return (letter ^ ((lv_uintptr_t)font >> 4)) & (HASH_NUM - 1);
+}
+
+/**
+ * Find the first free range in the pool which is large enough
+ * @param size the required size
+ * @param ofs store the offset of the range here
+ * @param pos store the position of the new entry in `order` here
+ * @return true: found; false: there is no such range
+ */
+static bool find_gap(uint32_t size, uint32_t * ofs, uint16_t * pos)
+{
+    uint32_t end = 0;
+    uint16_t i;
+    for(i = 0; i < order_cnt; i++) {
+        const entry_t * e = &entries[order[i]];
+        if(e->ofs - end >= size) break;
+        end = e->ofs + e->size;
+    }
+
+    if(i == order_cnt && LV_FONT_CACHE_SIZE - end < size) return false;
+
+    *ofs = end;
+    *pos = i;
+    return true;
+}
+
+/**
+ * Drop the least recently used bitmap
+ * @return true: a bitmap was dropped; false: the cache is empty
+ */
+static bool evict_lru(void)
+{
+    if(order_cnt == 0) return false;
+
+    uint16_t lru = order[0];
+    uint16_t i;
+    for(i = 1; i < order_cnt; i++) {
+        if(entries[order[i]].life < entries[lru].life) lru = order[i];
+    }
+
+    remove_entry(lru);
+    stat.evict_cnt++;
+
+    return true;
+}
+
+/**
+ * Remove an entry from its bucket and from `order`
+ * @param id index of the entry
+ */
+static void remove_entry(uint16_t id)
+{
+    entry_t * e     = &entries[id];
+    uint16_t * link = &buckets[get_hash(e->font, e->letter)];
+    while(*link != id + 1) link = &entries[*link - 1].next;
+    *link = e->next;
+
+    uint16_t i;
+    for(i = 0; order[i] != id; i++);
+    memmove(&order[i], &order[i + 1], (order_cnt - i - 1) * sizeof(order[0]));
+    order_cnt--;
+
+    stat.used -= e->size;
+    stat.entry_cnt--;
+    e->size = 0;
+}
+
+#endif /*LV_FONT_CACHE_SIZE*/
@@ -0,0 +1,94 @@
+/**
+ * @file lv_font_cache.h
+ * Cache of decompressed glyph bitmaps
+ */
+
+#ifndef LV_FONT_CACHE_H
+#define LV_FONT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include "lv_font.h"
+
+#if LV_FONT_CACHE_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Counters of the glyph cache
+ */
+typedef struct
+{
+    uint32_t hit_cnt;   /**< Bitmaps found in the cache*/
+    uint32_t miss_cnt;  /**< Bitmaps not found in the cache*/
+    uint32_t evict_cnt; /**< Bitmaps dropped to make room*/
+    uint32_t used;      /**< Bytes used by the cached bitmaps*/
+    uint16_t entry_cnt; /**< Number of cached bitmaps*/
+} lv_font_cache_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Get the cached bitmap of a letter
+ * @param font pointer to a font
+ * @param letter an unicode letter
+ * @return pointer to the bitmap or NULL if it's not cached
+ */
+const uint8_t * lv_font_cache_get(const lv_font_t * font, uint32_t letter);
+
+/**
+ * Add a bitmap to the cache. The least recently used bitmaps are dropped if there is no room.
+ * @param font pointer to a font
+ * @param letter an unicode letter
+ * @param size size of the bitmap in bytes
+ * @return pointer to `size` bytes where the bitmap should be written or NULL if it can't be cached
+ */
+uint8_t * lv_font_cache_add(const lv_font_t * font, uint32_t letter, uint32_t size);
+
+/**
+ * Drop every cached bitmap. The counters are not cleared.
+ */
+void lv_font_cache_clear(void);
+
+/**
+ * Get the counters of the glyph cache
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_font_cache_get_stat(lv_font_cache_stat_t * stat);
+
+/**
+ * Clear the hit, miss and evict counters
+ */
+void lv_font_cache_reset_stat(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_FONT_CACHE_SIZE*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_FONT_CACHE_H*/
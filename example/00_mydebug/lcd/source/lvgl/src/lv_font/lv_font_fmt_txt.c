@@ -8,16 +8,26 @@
  *********************/
 #include "lv_font.h"
 #include "lv_font_fmt_txt.h"
+#include "lv_font_cache.h"
 #include "../lv_core/lv_debug.h"
 #include "../lv_draw/lv_draw.h"
 #include "../lv_misc/lv_types.h"
 #include "../lv_misc/lv_log.h"
 #include "../lv_misc/lv_utils.h"
 #include "../lv_misc/lv_mem.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
  *********************/
+/*Letters with a direct glyph id table: ASCII and Latin-1*/
+#define LUT_LETTER_NUM  256
+
+/*Glyph id in the table of a letter which wasn't searched yet*/
+#define LUT_UNKNOWN     0xFFFF
+
+/*Remembered letters above the table per font (e.g. the symbols of a screen)*/
+#define LUT_RECENT_NUM  8
 
 /**********************
  *      TYPEDEFS
@@ -28,11 +38,38 @@ typedef enum {
     RLE_STATE_COUNTER,
 }rle_state_t;
 
+#if LV_FONT_FMT_TXT_LUT_NUM
+/*Glyph ids of the first letters of a font*/
+typedef struct {
+    const lv_font_t * font;
+    uint32_t life;                      /*Value of `lut_use_cnt` when the font was last used*/
+    uint16_t gid[LUT_LETTER_NUM];
+    uint32_t recent_letter[LUT_RECENT_NUM]; /*0: empty*/
+    uint32_t recent_gid[LUT_RECENT_NUM];
+    uint8_t recent_next;                /*Replace this one next*/
+}glyph_lut_t;
+#endif
+
+#if LV_FONT_FMT_TXT_KERN_MEMO
+/*A remembered kerning value*/
+typedef struct {
+    const lv_font_t * font;             /*NULL: the slot is empty*/
+    uint16_t gid_left;
+    uint16_t gid_right;
+    int8_t value;
+}kern_memo_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static uint32_t search_glyph_dsc_id(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
+static int8_t search_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
+#if LV_FONT_FMT_TXT_LUT_NUM
+static glyph_lut_t * get_lut(const lv_font_t * font);
+#endif
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
@@ -56,6 +93,18 @@ static uint8_t rle_prev_v;
 static uint8_t rle_cnt;
 static rle_state_t rle_state;
 
+#if LV_FONT_FMT_TXT_LUT_NUM
+static glyph_lut_t luts[LV_FONT_FMT_TXT_LUT_NUM];
+static glyph_lut_t * lut_last;
+static uint32_t lut_use_cnt;
+#endif
+
+#if LV_FONT_FMT_TXT_KERN_MEMO
+static kern_memo_t kern_memo[LV_FONT_FMT_TXT_KERN_MEMO];
+#endif
+
+static lv_font_fmt_txt_stat_t stat;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -93,6 +142,11 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
         uint32_t gsize = gdsc->box_w * gdsc->box_h;
         if(gsize == 0) return NULL;
 
+#if LV_FONT_CACHE_SIZE
+        const uint8_t * cached = lv_font_cache_get(font, unicode_letter);
+        if(cached) return cached;
+#endif
+
         uint32_t buf_size = gsize;
         /*Compute memory size needed to hold decompressed glyph, rounding up*/
         switch(fdsc->bpp) {
@@ -102,6 +156,15 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
         case 4: buf_size = (gsize + 1) >> 1;  break;
         }
 
+#if LV_FONT_CACHE_SIZE
+        /*Decompress directly into the cache*/
+        uint8_t * cache_buf = lv_font_cache_add(font, unicode_letter, buf_size);
+        if(cache_buf) {
+            decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], cache_buf, gdsc->box_w , gdsc->box_h, (uint8_t)fdsc->bpp);
+            return cache_buf;
+        }
+#endif
+
         if(lv_mem_get_size(buf) < buf_size) {
             buf = lv_mem_realloc(buf, buf_size);
             LV_ASSERT_MEM(buf);
@@ -156,6 +219,39 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     return true;
 }
 
+/**
+ * Forget the glyph id tables and the remembered kerning values.
+ * Call it before a font in RAM is freed or modified.
+ */
+void lv_font_fmt_txt_clear_lookup(void)
+{
+#if LV_FONT_FMT_TXT_LUT_NUM
+    memset(luts, 0, sizeof(luts));
+    lut_last = NULL;
+#endif
+
+#if LV_FONT_FMT_TXT_KERN_MEMO
+    memset(kern_memo, 0, sizeof(kern_memo));
+#endif
+}
+
+/**
+ * Get the counters of the glyph id and kerning lookups
+ * @param stat_p pointer to a variable to store the counters
+ */
+void lv_font_fmt_txt_get_stat(lv_font_fmt_txt_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**
+ * Clear the counters of the glyph id and kerning lookups
+ */
+void lv_font_fmt_txt_reset_stat(void)
+{
+    memset(&stat, 0, sizeof(stat));
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -166,8 +262,60 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
 
+#if LV_FONT_FMT_TXT_LUT_NUM
+    glyph_lut_t * lut = get_lut(font);
+    uint32_t glyph_id;
+
+    /*The first letters are searched only once and then read from the table*/
+    if(letter < LUT_LETTER_NUM) {
+        uint16_t * gid_p = &lut->gid[letter];
+        if(*gid_p != LUT_UNKNOWN) {
+            stat.lut_hit_cnt++;
+            return *gid_p;
+        }
+
+        glyph_id = search_glyph_dsc_id(fdsc, letter);
+        if(glyph_id < LUT_UNKNOWN) *gid_p = (uint16_t)glyph_id;
+        return glyph_id;
+    }
+
+    /*Check the last letters above the table*/
+    uint8_t i;
+    for(i = 0; i < LUT_RECENT_NUM; i++) {
+        if(lut->recent_letter[i] == letter) {
+            stat.last_hit_cnt++;
+            return lut->recent_gid[i];
+        }
+    }
+
+    glyph_id = search_glyph_dsc_id(fdsc, letter);
+    lut->recent_letter[lut->recent_next] = letter;
+    lut->recent_gid[lut->recent_next]    = glyph_id;
+    lut->recent_next = (lut->recent_next + 1) % LUT_RECENT_NUM;
+    return glyph_id;
+#else
     /*Check the cache first*/
-    if(letter == fdsc->last_letter) return fdsc->last_glyph_id;
+    if(letter == fdsc->last_letter) {
+        stat.last_hit_cnt++;
+        return fdsc->last_glyph_id;
+    }
+
+    /*Update the cache*/
+    fdsc->last_letter = letter;
+    fdsc->last_glyph_id = search_glyph_dsc_id(fdsc, letter);
+    return fdsc->last_glyph_id;
+#endif
+}
+
+/**
+ * Find the glyph id of a letter in the cmaps
+ * @param fdsc pointer to the font descriptor
+ * @param letter an unicode letter
+ * @return the glyph id or 0 if the letter is not in the font
+ */
+static uint32_t search_glyph_dsc_id(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter)
+{
+    stat.glyph_search_cnt++;
 
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
@@ -203,19 +351,38 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
             }
         }
 
-        /*Update the cache*/
-        fdsc->last_letter = letter;
-        fdsc->last_glyph_id = glyph_id;
         return glyph_id;
     }
 
-    fdsc->last_letter = letter;
-    fdsc->last_glyph_id = 0;
     return 0;
-
 }
 
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
+{
+#if LV_FONT_FMT_TXT_KERN_MEMO
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+
+    /*The kern classes are only two table reads, remember only the searched pairs*/
+    if(fdsc->kern_classes == 0 && gid_left <= UINT16_MAX && gid_right <= UINT16_MAX) {
+        uint32_t h = (gid_left * 31 + gid_right + ((lv_uintptr_t)font >> 4)) & (LV_FONT_FMT_TXT_KERN_MEMO - 1);
+        kern_memo_t * m = &kern_memo[h];
+        if(m->font == font && m->gid_left == gid_left && m->gid_right == gid_right) {
+            stat.kern_hit_cnt++;
+            return m->value;
+        }
+
+        m->font      = font;
+        m->gid_left  = (uint16_t)gid_left;
+        m->gid_right = (uint16_t)gid_right;
+        m->value     = search_kern_value(font, gid_left, gid_right);
+        return m->value;
+    }
+#endif
+
+    return search_kern_value(font, gid_left, gid_right);
+}
+
+static int8_t search_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
 
@@ -223,6 +390,7 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
 
     if(fdsc->kern_classes == 0) {
         /*Kern pairs*/
+        stat.kern_search_cnt++;
         const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
         if(kdsc->glyph_ids_size == 0) {
             /* Use binary search to find the kern value.
@@ -270,6 +438,40 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
     return value;
 }
 
+#if LV_FONT_FMT_TXT_LUT_NUM
+/**
+ * Get the glyph id table of a font. The least recently used table is cleared for a new font.
+ * @param font pointer to a font
+ * @return pointer to the table of the font
+ */
+static glyph_lut_t * get_lut(const lv_font_t * font)
+{
+    if(lut_last && lut_last->font == font) return lut_last;
+
+    glyph_lut_t * lut = &luts[0];
+    uint16_t i;
+    for(i = 0; i < LV_FONT_FMT_TXT_LUT_NUM; i++) {
+        if(luts[i].font == font) {
+            lut = &luts[i];
+            break;
+        }
+        if(luts[i].life < lut->life) lut = &luts[i];
+    }
+
+    if(lut->font != font) {
+        memset(lut, 0, sizeof(glyph_lut_t));
+        memset(lut->gid, 0xFF, sizeof(lut->gid));
+        lut->font = font;
+    }
+
+    lut_use_cnt++;
+    lut->life = lut_use_cnt;
+    lut_last  = lut;
+
+    return lut;
+}
+#endif
+
 static int32_t kern_pair_8_compare(const void * ref, const void * element)
 {
     const uint8_t * ref8_p = ref;
@@ -198,6 +198,15 @@ typedef struct {
 
 }lv_font_fmt_txt_dsc_t;
 
+/** Counters of the glyph id and kerning lookups*/
+typedef struct {
+    uint32_t glyph_search_cnt;      /**< Glyph ids searched in the cmaps*/
+    uint32_t lut_hit_cnt;           /**< Glyph ids read from the table of the first letters*/
+    uint32_t last_hit_cnt;          /**< Glyph ids found as the last letter of the font*/
+    uint32_t kern_search_cnt;       /**< Kerning values searched in the kern pairs*/
+    uint32_t kern_hit_cnt;          /**< Kerning values remembered from an earlier search*/
+}lv_font_fmt_txt_stat_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -220,6 +229,23 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t lett
  */
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter, uint32_t unicode_letter_next);
 
+/**
+ * Forget the glyph id tables and the remembered kerning values.
+ * Call it before a font in RAM is freed or modified.
+ */
+void lv_font_fmt_txt_clear_lookup(void);
+
+/**
+ * Get the counters of the glyph id and kerning lookups
+ * @param stat pointer to a variable to store the counters
+ */
+void lv_font_fmt_txt_get_stat(lv_font_fmt_txt_stat_t * stat);
+
+/**
+ * Clear the counters of the glyph id and kerning lookups
+ */
+void lv_font_fmt_txt_reset_stat(void);
+
 /**********************
  *      MACROS
  **********************/
@@ -63,6 +63,9 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
     driver->buffer           = NULL;
     driver->rotated          = 0;
     driver->color_chroma_key = LV_COLOR_TRANSP;
+    driver->render_start_cb  = NULL;
+    driver->wait_cb          = NULL;
+    driver->sync_cb          = NULL;
 
 #if LV_ANTIALIAS
     driver->antialiasing = true;
@@ -75,6 +78,7 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
 #if LV_USE_GPU
     driver->gpu_blend_cb = NULL;
     driver->gpu_fill_cb  = NULL;
+    driver->gpu_copy_cb  = NULL;
 #endif
 
 #if LV_USE_USER_DATA
@@ -124,8 +128,7 @@ lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
     }
 
     memcpy(&disp->driver, driver, sizeof(lv_disp_drv_t));
-    memset(&disp->inv_area_joined, 0, sizeof(disp->inv_area_joined));
-    memset(&disp->inv_areas, 0, sizeof(disp->inv_areas));
+    memset(&disp->inv_tile_map, 0, sizeof(disp->inv_tile_map));
     lv_ll_init(&disp->scr_ll, sizeof(lv_obj_t));
     disp->last_activity_time = 0;
 
@@ -303,8 +306,8 @@ lv_disp_buf_t * lv_disp_get_buf(lv_disp_t * disp)
 }
 
 /**
- * Get the number of areas in the buffer
- * @return number of invalid areas
+ * Get the number of invalidations since the last refresh
+ * @return number of invalidated areas
  */
 uint16_t lv_disp_get_inv_buf_size(lv_disp_t * disp)
 {
@@ -312,16 +315,20 @@ uint16_t lv_disp_get_inv_buf_size(lv_disp_t * disp)
 }
 
 /**
- * Pop (delete) the last 'num' invalidated areas from the buffer
+ * Pop (delete) the last 'num' invalidated areas from the buffer.
+ * The invalidated areas are merged on the tile map so they are really deleted only
+ * if no other areas remain. Else they are kept and redrawn needlessly.
  * @param num number of areas to delete
  */
 void lv_disp_pop_from_inv_buf(lv_disp_t * disp, uint16_t num)
 {
 
-    if(disp->inv_p < num)
+    if(disp->inv_p <= num) {
+        memset(&disp->inv_tile_map, 0, sizeof(disp->inv_tile_map));
         disp->inv_p = 0;
-    else
+    } else {
         disp->inv_p -= num;
+    }
 }
 
 /**
@@ -26,10 +26,19 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
-#ifndef LV_INV_BUF_SIZE
-#define LV_INV_BUF_SIZE 32 /*Buffer size for invalid areas */
+#ifndef LV_INV_TILE_SIZE
+#define LV_INV_TILE_SIZE 32 /*Size of the tiles to track the invalid areas [px] (max. 256)*/
 #endif
 
+#ifndef LV_INV_JOIN_COST
+#define LV_INV_JOIN_COST 256 /*Cost of an extra flush (address window, DMA start) in pixels. Invalid areas are
+                               joined if less pixels than this are redrawn needlessly.*/
+#endif
+
+#define LV_INV_TILE_COL_NUM ((LV_HOR_RES_MAX + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE)
+#define LV_INV_TILE_ROW_NUM ((LV_VER_RES_MAX + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE)
+#define LV_INV_TILE_WORD_NUM ((LV_INV_TILE_COL_NUM + 31) / 32)
+
 #ifndef LV_ATTRIBUTE_FLUSH_READY
 #define LV_ATTRIBUTE_FLUSH_READY
 #endif
@@ -98,6 +107,17 @@ typedef struct _disp_drv_t
      * number of flushed pixels */
     void (*monitor_cb)(struct _disp_drv_t * disp_drv, uint32_t time, uint32_t px);
 
+    /** OPTIONAL: Called when the rendering of the invalidated areas starts in a refresh cycle*/
+    void (*render_start_cb)(struct _disp_drv_t * disp_drv);
+
+    /** OPTIONAL: Called periodically while LittlevGL waits for the end of a flush.
+     * Can be used to do something useful in the meantime or to measure the waiting.*/
+    void (*wait_cb)(struct _disp_drv_t * disp_drv);
+
+    /** OPTIONAL: Copy a refreshed area from the flushed frame buffer to the new active one in true double buffering
+     * (e.g. with a 2D DMA). `dest` and `src` are the screen sized buffers. Without it the lines are copied by `memcpy`.*/
+    void (*sync_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, const lv_area_t * area);
+
 #if LV_USE_GPU
     /** OPTIONAL: Blend two memories using opacity (GPU only)*/
     void (*gpu_blend_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length,
@@ -106,6 +126,10 @@ typedef struct _disp_drv_t
     /** OPTIONAL: Fill a memory with a color (GPU only)*/
     void (*gpu_fill_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest_buf, lv_coord_t dest_width,
                         const lv_area_t * fill_area, lv_color_t color);
+
+    /** OPTIONAL: Copy a rectangle of pixels (GPU only). The strides are the widths of the memories in pixels.*/
+    void (*gpu_copy_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest, lv_coord_t dest_stride,
+                        const lv_color_t * src, lv_coord_t src_stride, lv_coord_t w, lv_coord_t h);
 #endif
 
     /** On CHROMA_KEYED images this color will be transparent.
@@ -118,6 +142,17 @@ typedef struct _disp_drv_t
 
 } lv_disp_drv_t;
 
+/**
+ * Invalid part of a tile. The coordinates are relative to the top left corner of the tile.
+ */
+typedef struct
+{
+    uint8_t x1;
+    uint8_t y1;
+    uint8_t x2;
+    uint8_t y2;
+} lv_disp_inv_tile_t;
+
 struct _lv_obj_t;
 
 /**
@@ -138,10 +173,10 @@ typedef struct _disp_t
     struct _lv_obj_t * top_layer; /**< @see lv_disp_get_layer_top */
     struct _lv_obj_t * sys_layer; /**< @see lv_disp_get_layer_sys */
 
-    /** Invalidated (marked to redraw) areas*/
-    lv_area_t inv_areas[LV_INV_BUF_SIZE];
-    uint8_t inv_area_joined[LV_INV_BUF_SIZE];
-    uint32_t inv_p : 10;
+    /** Invalidated (marked to redraw) areas on a grid of `LV_INV_TILE_SIZE` sized tiles*/
+    uint32_t inv_tile_map[LV_INV_TILE_ROW_NUM][LV_INV_TILE_WORD_NUM]; /**< A bit for every tile: 1 if invalid*/
+    lv_disp_inv_tile_t inv_tiles[LV_INV_TILE_ROW_NUM][LV_INV_TILE_COL_NUM]; /**< Invalid part of the tiles*/
+    uint16_t inv_p; /**< Number of invalidations since the last refresh*/
 
     /*Miscellaneous data*/
     uint32_t last_activity_time; /**< Last time there was activity on this display */
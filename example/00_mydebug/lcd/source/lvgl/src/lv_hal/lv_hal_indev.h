@@ -81,6 +81,10 @@ typedef struct _lv_indev_drv_t
      * The second parameter is the event from `lv_event_t`*/
     void (*feedback_cb)(struct _lv_indev_drv_t *, uint8_t);
 
+    /** OPTIONAL: called after every read with the time of processing the data [ms]
+     * and the number of objects tested to find the pressed one*/
+    void (*monitor_cb)(struct _lv_indev_drv_t * indev_drv, uint32_t time, uint32_t obj_cnt);
+
 #if LV_USE_USER_DATA
     lv_indev_drv_user_data_t user_data;
 #endif
@@ -1,6 +1,7 @@
 /**
  * @file anim.c
- *
+ * The easing curves are evaluated from fixed-point tables. The animations on the same timeline
+ * (path, time and elapsed time) share the step of the path and their invalidations are joined in every period.
  */
 
 /*********************
@@ -16,6 +17,7 @@
 #include "lv_task.h"
 #include "lv_math.h"
 #include "lv_gc.h"
+#include "../lv_core/lv_refr.h"
 
 #if defined(LV_GC_INCLUDE)
 #include LV_GC_INCLUDE
@@ -27,6 +29,10 @@
 #define LV_ANIM_RESOLUTION 1024
 #define LV_ANIM_RES_SHIFT 10
 
+/*The easing curves are sampled in every 16th step of the [0..1024] time range and interpolated linearly*/
+#define PATH_TABLE_SHIFT 4
+#define PATH_TABLE_SIZE ((LV_ANIM_RESOLUTION >> PATH_TABLE_SHIFT) + 1)
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -36,6 +42,10 @@
  **********************/
 static void anim_task(lv_task_t * param);
 static bool anim_ready_handler(lv_anim_t * a);
+static uint32_t anim_get_t(const lv_anim_t * a);
+static lv_anim_value_t anim_map(const lv_anim_t * a, int32_t step);
+static int32_t path_table_get(const int16_t * table, uint32_t t);
+static const int16_t * path_get_table(lv_anim_path_cb_t path_cb);
 
 /**********************
  *  STATIC VARIABLES
@@ -43,6 +53,49 @@ static bool anim_ready_handler(lv_anim_t * a);
 static uint32_t last_task_run;
 static bool anim_list_changed;
 
+/* Cubic Bezier curves in the [0..1024] range at 65 points of the time.
+ * The interpolated values differ from the exact curves by less than 1.5 (`lv_bezier3` by up to 6.5)*/
+static const int16_t path_ease_in_table[PATH_TABLE_SIZE] = {
+       0,    0,    0,    0,    0,    1,    1,    2,    2,    3,    4,    6,    7,
+       9,   11,   14,   17,   20,   23,   27,   32,   37,   42,   48,   55,   62,
+      69,   78,   86,   96,  106,  117,  129,  141,  154,  168,  183,  199,  215,
+     232,  251,  270,  290,  311,  333,  357,  381,  406,  433,  460,  489,  519,
+     550,  582,  615,  650,  686,  724,  762,  802,  844,  887,  931,  977, 1024
+};
+
+static const int16_t path_ease_out_table[PATH_TABLE_SIZE] = {
+       0,   47,   93,  137,  180,  222,  262,  300,  338,  374,  409,  442,  474,
+     505,  535,  564,  591,  618,  643,  667,  691,  713,  734,  754,  773,  792,
+     809,  825,  841,  856,  870,  883,  895,  907,  918,  928,  938,  946,  955,
+     962,  969,  976,  982,  987,  992,  997, 1001, 1004, 1007, 1010, 1013, 1015,
+    1017, 1018, 1020, 1021, 1022, 1022, 1023, 1023, 1024, 1024, 1024, 1024, 1024
+};
+
+static const int16_t path_ease_in_out_table[PATH_TABLE_SIZE] = {
+       0,    5,   11,   19,   27,   36,   46,   57,   69,   81,   94,  108,  123,
+     138,  154,  171,  188,  206,  224,  243,  262,  281,  301,  321,  342,  362,
+     383,  404,  426,  447,  469,  490,  512,  534,  555,  577,  598,  620,  641,
+     662,  682,  703,  723,  743,  762,  781,  800,  818,  836,  853,  870,  886,
+     901,  916,  930,  943,  955,  967,  978,  988,  997, 1005, 1013, 1019, 1024
+};
+
+static const int16_t path_overshoot_table[PATH_TABLE_SIZE] = {
+       0,   28,   57,   85,  113,  142,  171,  199,  228,  256,  284,  313,  341,
+     369,  397,  425,  452,  479,  506,  533,  559,  585,  610,  636,  660,  685,
+     709,  732,  755,  777,  799,  820,  840,  860,  880,  898,  916,  933,  949,
+     965,  979,  993, 1006, 1018, 1030, 1040, 1049, 1058, 1065, 1071, 1076, 1080,
+    1083, 1085, 1086, 1086, 1084, 1081, 1077, 1071, 1065, 1056, 1047, 1036, 1024
+};
+
+/*The falling part of the bounces*/
+static const int16_t path_bounce_table[PATH_TABLE_SIZE] = {
+    1024, 1024, 1023, 1022, 1021, 1020, 1018, 1016, 1013, 1010, 1006, 1002,  998,
+     993,  988,  983,  976,  970,  963,  956,  948,  939,  930,  921,  911,  900,
+     889,  878,  866,  853,  840,  826,  812,  797,  782,  765,  749,  731,  713,
+     695,  676,  656,  635,  614,  592,  569,  546,  522,  498,  472,  446,  419,
+     392,  363,  334,  304,  274,  242,  210,  177,  143,  109,   73,   37,    0
+};
+
 /**********************
  *      MACROS
  **********************/
@@ -172,6 +225,15 @@ uint16_t lv_anim_speed_to_time(uint16_t speed, lv_anim_value_t start, lv_anim_va
     return time;
 }
 
+/**
+ * Handle the animations immediately, independently from the period of the animation task.
+ * The elapsed time is measured from the last handling as usual.
+ */
+void lv_anim_refr_now(void)
+{
+    anim_task(NULL);
+}
+
 /**
  * Calculate the current value of an animation applying linear characteristic
  * @param a pointer to an animation
@@ -179,22 +241,7 @@ uint16_t lv_anim_speed_to_time(uint16_t speed, lv_anim_value_t start, lv_anim_va
  */
 lv_anim_value_t lv_anim_path_linear(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    uint32_t step;
-    if(a->time == a->act_time) {
-        step = LV_ANIM_RESOLUTION; /*Use the last value if the time fully elapsed*/
-    } else {
-        step = ((int32_t)a->act_time * LV_ANIM_RESOLUTION) / a->time;
-    }
-
-    /* Get the new value which will be proportional to `step`
-     * and the `start` and `end` values*/
-    int32_t new_value;
-    new_value = (int32_t)step * (a->end - a->start);
-    new_value = new_value >> LV_ANIM_RES_SHIFT;
-    new_value += a->start;
-
-    return (lv_anim_value_t)new_value;
+    return anim_map(a, anim_get_t(a));
 }
 
 /**
@@ -204,21 +251,7 @@ lv_anim_value_t lv_anim_path_linear(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_ease_in(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-    uint32_t t;
-    if(a->time == a->act_time)
-        t = 1024;
-    else
-        t = (uint32_t)((uint32_t)a->act_time * 1024) / a->time;
-
-    int32_t step = lv_bezier3(t, 0, 1, 1, 1024);
-
-    int32_t new_value;
-    new_value = (int32_t)step * (a->end - a->start);
-    new_value = new_value >> 10;
-    new_value += a->start;
-
-    return (lv_anim_value_t)new_value;
+    return anim_map(a, path_table_get(path_ease_in_table, anim_get_t(a)));
 }
 
 /**
@@ -228,22 +261,7 @@ lv_anim_value_t lv_anim_path_ease_in(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_ease_out(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-
-    uint32_t t;
-    if(a->time == a->act_time)
-        t = 1024;
-    else
-        t = (uint32_t)((uint32_t)a->act_time * 1024) / a->time;
-
-    int32_t step = lv_bezier3(t, 0, 1023, 1023, 1024);
-
-    int32_t new_value;
-    new_value = (int32_t)step * (a->end - a->start);
-    new_value = new_value >> 10;
-    new_value += a->start;
-
-    return (lv_anim_value_t)new_value;
+    return anim_map(a, path_table_get(path_ease_out_table, anim_get_t(a)));
 }
 
 /**
@@ -253,22 +271,7 @@ lv_anim_value_t lv_anim_path_ease_out(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_ease_in_out(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-
-    uint32_t t;
-    if(a->time == a->act_time)
-        t = 1024;
-    else
-        t = (uint32_t)((uint32_t)a->act_time * 1024) / a->time;
-
-    int32_t step = lv_bezier3(t, 0, 100, 924, 1024);
-
-    int32_t new_value;
-    new_value = (int32_t)step * (a->end - a->start);
-    new_value = new_value >> 10;
-    new_value += a->start;
-
-    return (lv_anim_value_t)new_value;
+    return anim_map(a, path_table_get(path_ease_in_out_table, anim_get_t(a)));
 }
 
 /**
@@ -278,22 +281,7 @@ lv_anim_value_t lv_anim_path_ease_in_out(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_overshoot(const lv_anim_t * a)
 {
-    /*Calculate the current step*/
-
-    uint32_t t;
-    if(a->time == a->act_time)
-        t = 1024;
-    else
-        t = (uint32_t)((uint32_t)a->act_time * 1024) / a->time;
-
-    int32_t step = lv_bezier3(t, 0, 600, 1300, 1024);
-
-    int32_t new_value;
-    new_value = (int32_t)step * (a->end - a->start);
-    new_value = new_value >> 10;
-    new_value += a->start;
-
-    return (lv_anim_value_t)new_value;
+    return anim_map(a, path_table_get(path_overshoot_table, anim_get_t(a)));
 }
 
 /**
@@ -304,11 +292,7 @@ lv_anim_value_t lv_anim_path_overshoot(const lv_anim_t * a)
 lv_anim_value_t lv_anim_path_bounce(const lv_anim_t * a)
 {
     /*Calculate the current step*/
-    uint32_t t;
-    if(a->time == a->act_time)
-        t = 1024;
-    else
-        t = (uint32_t)((uint32_t)a->act_time * 1024) / a->time;
+    uint32_t t = anim_get_t(a);
 
     int32_t diff = (a->end - a->start);
 
@@ -343,7 +327,7 @@ lv_anim_value_t lv_anim_path_bounce(const lv_anim_t * a)
 
     if(t > 1024) t = 1024;
 
-    int32_t step = lv_bezier3(t, 1024, 1024, 800, 0);
+    int32_t step = path_table_get(path_bounce_table, t);
 
     int32_t new_value;
     new_value = (int32_t)step * diff;
@@ -379,6 +363,15 @@ static void anim_task(lv_task_t * param)
 {
     (void)param;
 
+    /*The step of the path on the timeline of the previous animation*/
+    lv_anim_path_cb_t tl_path = NULL;
+    uint16_t tl_time          = 0;
+    int16_t tl_act_time       = 0;
+    int32_t tl_step           = 0;
+
+    /*An object is typically moved by more animations: join their invalidations*/
+    lv_inv_batch_start();
+
     lv_anim_t * a;
     LV_LL_READ(LV_GC_ROOT(_lv_anim_ll), a)
     {
@@ -403,7 +396,19 @@ static void anim_task(lv_task_t * param)
                 if(a->act_time > a->time) a->act_time = a->time;
 
                 int32_t new_value;
-                new_value = a->path_cb(a);
+                const int16_t * table = path_get_table(a->path_cb);
+                if(table != NULL || a->path_cb == lv_anim_path_linear) {
+                    /*The animations created together share their timeline*/
+                    if(a->path_cb != tl_path || a->time != tl_time || a->act_time != tl_act_time) {
+                        tl_path     = a->path_cb;
+                        tl_time     = a->time;
+                        tl_act_time = a->act_time;
+                        tl_step     = table ? path_table_get(table, anim_get_t(a)) : (int32_t)anim_get_t(a);
+                    }
+                    new_value = anim_map(a, tl_step);
+                } else {
+                    new_value = a->path_cb(a);
+                }
 
                 /*Apply the calculated value*/
                 if(a->exec_cb) a->exec_cb(a->var, new_value);
@@ -423,6 +428,8 @@ static void anim_task(lv_task_t * param)
             a = lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
     }
 
+    lv_inv_batch_end();
+
     last_task_run = lv_tick_get();
 }
 
@@ -471,4 +478,63 @@ static bool anim_ready_handler(lv_anim_t * a)
 
     return anim_list_changed;
 }
+
+/**
+ * Get the elapsed part of an animation's time
+ * @param a pointer to an animation
+ * @return the time in [0..LV_ANIM_RESOLUTION] range
+ */
+static uint32_t anim_get_t(const lv_anim_t * a)
+{
+    if(a->time == a->act_time) return LV_ANIM_RESOLUTION; /*Use the last value if the time fully elapsed*/
+
+    return ((int32_t)a->act_time * LV_ANIM_RESOLUTION) / a->time;
+}
+
+/**
+ * Get the value of an animation at a step of its path
+ * @param a pointer to an animation
+ * @param step step of the path: `LV_ANIM_RESOLUTION` means the end value
+ * @return the value between the start and end values (out of them on overshoot)
+ */
+static lv_anim_value_t anim_map(const lv_anim_t * a, int32_t step)
+{
+    int32_t new_value;
+    new_value = step * (a->end - a->start);
+    new_value = new_value >> LV_ANIM_RES_SHIFT;
+    new_value += a->start;
+
+    return (lv_anim_value_t)new_value;
+}
+
+/**
+ * Get a value of an easing curve from its table
+ * @param table pointer to a `PATH_TABLE_SIZE` long table
+ * @param t time in [0..LV_ANIM_RESOLUTION] range
+ * @return the value of the curve interpolated between the neighbour points
+ */
+static int32_t path_table_get(const int16_t * table, uint32_t t)
+{
+    uint32_t i    = t >> PATH_TABLE_SHIFT;
+    uint32_t frac = t & ((1 << PATH_TABLE_SHIFT) - 1);
+    int32_t v     = table[i];
+    if(frac) v += ((table[i + 1] - v) * (int32_t)frac) >> PATH_TABLE_SHIFT;
+
+    return v;
+}
+
+/**
+ * Get the table of a built-in easing path
+ * @param path_cb a path callback
+ * @return pointer to the table or NULL if it's not an eased path
+ */
+static const int16_t * path_get_table(lv_anim_path_cb_t path_cb)
+{
+    if(path_cb == lv_anim_path_ease_in_out) return path_ease_in_out_table;
+    if(path_cb == lv_anim_path_ease_in) return path_ease_in_table;
+    if(path_cb == lv_anim_path_ease_out) return path_ease_out_table;
+    if(path_cb == lv_anim_path_overshoot) return path_overshoot_table;
+
+    return NULL;
+}
 #endif
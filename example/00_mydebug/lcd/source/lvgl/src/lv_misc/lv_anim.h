@@ -268,6 +268,12 @@ uint16_t lv_anim_count_running(void);
  */
 uint16_t lv_anim_speed_to_time(uint16_t speed, lv_anim_value_t start, lv_anim_value_t end);
 
+/**
+ * Handle the animations immediately, independently from the period of the animation task.
+ * The elapsed time is measured from the last handling as usual.
+ */
+void lv_anim_refr_now(void);
+
 /**
  * Calculate the current value of an animation applying linear characteristic
  * @param a pointer to an animation
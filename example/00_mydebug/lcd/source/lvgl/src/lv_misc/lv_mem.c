@@ -1,6 +1,8 @@
 /**
  * @file lv_mem.c
  * General and portable implementation of malloc and free.
+ * The built-in allocator is a two level segregated fit (TLSF) allocator: the free blocks are kept in
+ * lists by size classes and two bitmaps tell the non-empty lists, so alloc and free take constant time.
  * The dynamic memory monitoring is also supported.
  */
 
@@ -9,6 +11,7 @@
  *********************/
 #include "lv_mem.h"
 #include "lv_math.h"
+#include <stdbool.h>
 #include <string.h>
 
 #if LV_MEM_CUSTOM != 0
@@ -25,15 +28,68 @@
 
 #ifdef LV_ARCH_64
 #define MEM_UNIT uint64_t
+#define MEM_ALIGN_LOG2  3
 #else
 #define MEM_UNIT uint32_t
+#define MEM_ALIGN_LOG2  2
+#endif
+
+#if LV_MEM_CUSTOM == 0
+#define MEM_ALIGN       (1U << MEM_ALIGN_LOG2)
+
+/*Every power of two size range (first level) is divided to this many lists (second level)*/
+#define MEM_SL_LOG2     4
+#define MEM_SL_CNT      (1U << MEM_SL_LOG2)
+
+/*The blocks smaller than `MEM_SMALL_SIZE` are in the first first level list in `MEM_ALIGN` steps*/
+#define MEM_FL_SHIFT    (MEM_SL_LOG2 + MEM_ALIGN_LOG2)
+#define MEM_SMALL_SIZE  (1U << MEM_FL_SHIFT)
+
+/*Blocks up to 64 MB*/
+#define MEM_FL_MAX      26
+#define MEM_FL_CNT      (MEM_FL_MAX - MEM_FL_SHIFT + 1)
+#define MEM_BLK_MAX     ((size_t)1 << MEM_FL_MAX)
+
+/*Flags in the low bits of the size of the blocks*/
+#define MEM_BLK_FREE        0x1U
+#define MEM_BLK_PREV_FREE   0x2U
+
+/*Only the size of a used block is before its data*/
+#define MEM_BLK_OVERHEAD    sizeof(size_t)
+#define MEM_BLK_DATA_OFS    (offsetof(mem_blk_t, size) + sizeof(size_t))
+
+/*A free block has to store the list pointers. The `prev_phys` of the next block is in its data too.*/
+#define MEM_BLK_MIN         (sizeof(mem_blk_t) - sizeof(mem_blk_t *))
 #endif
 
 /**********************
  *      TYPEDEFS
  **********************/
 
-#if LV_ENABLE_GC == 0 /*gc custom allocations must not include header*/
+#if LV_MEM_CUSTOM == 0
+
+/**
+ * Header of a block of the pools. A block's data begins at `next_free`.
+ * `prev_phys` is the last pointer of the previous block's data: it's valid only if that block is free.
+ */
+typedef struct _mem_blk_t
+{
+    struct _mem_blk_t * prev_phys;  /**< Previous block in the memory if it's free*/
+    size_t size;                    /**< Size of the data and the `MEM_BLK_...` flags*/
+    struct _mem_blk_t * next_free;  /**< Next block in the same free list (only in free blocks)*/
+    struct _mem_blk_t * prev_free;  /**< Previous block in the same free list (only in free blocks)*/
+} mem_blk_t;
+
+/**
+ * A memory region given to the allocator
+ */
+typedef struct
+{
+    mem_blk_t * first;  /**< The first block of the pool*/
+    size_t size;        /**< Size of the region in bytes*/
+} mem_pool_t;
+
+#elif LV_ENABLE_GC == 0 /*gc custom allocations must not include header*/
 
 /*The size of this union must be 4 bytes (uint32_t)*/
 typedef union
@@ -52,15 +108,25 @@ typedef struct
     uint8_t first_data; /*First data byte in the allocated data (Just for easily create a pointer)*/
 } lv_mem_ent_t;
 
-#endif /* LV_ENABLE_GC */
+#endif /* LV_MEM_CUSTOM */
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_MEM_CUSTOM == 0
-static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e);
-static void * ent_alloc(lv_mem_ent_t * e, size_t size);
-static void ent_trunc(lv_mem_ent_t * e, size_t size);
+static void ctrl_init(void);
+static void * blk_alloc(size_t size);
+static void blk_free(void * data);
+static bool blk_resize(void * data, size_t size);
+static void blk_remove(mem_blk_t * b);
+static void blk_insert(mem_blk_t * b);
+static mem_blk_t * blk_locate_free(size_t size);
+static void blk_trim_used(mem_blk_t * b, size_t size);
+static mem_blk_t * blk_merge_prev(mem_blk_t * b);
+static mem_blk_t * blk_merge_next(mem_blk_t * b);
+static size_t adjust_size(size_t size);
+static void mapping_insert(size_t size, uint32_t * fl, uint32_t * sl);
+static uint32_t fls_u32(uint32_t x);
 #endif
 
 /**********************
@@ -68,6 +134,20 @@ static void ent_trunc(lv_mem_ent_t * e, size_t size);
  **********************/
 #if LV_MEM_CUSTOM == 0
 static uint8_t * work_mem;
+static mem_pool_t pools[LV_MEM_POOL_MAX];
+static uint32_t pool_cnt;
+
+/*Bit `fl` is set if `sl_bitmap[fl]` is not 0. Bit `sl` of `sl_bitmap[fl]` is set if `free_lists[fl][sl]` is not empty*/
+static uint32_t fl_bitmap;
+static uint32_t sl_bitmap[MEM_FL_CNT];
+static mem_blk_t * free_lists[MEM_FL_CNT][MEM_SL_CNT];
+
+static size_t used_size;
+static size_t max_used;
+#endif
+
+#if LV_MEM_TRACE
+static lv_mem_trace_cb_t trace_cb;
 #endif
 
 static uint32_t zero_mem; /*Give the address of this variable if 0 byte should be allocated*/
@@ -75,6 +155,24 @@ static uint32_t zero_mem; /*Give the address of this variable if 0 byte should b
 /**********************
  *      MACROS
  **********************/
+#if LV_MEM_CUSTOM == 0
+#define BLK_SIZE(b)         ((b)->size & ~(size_t)(MEM_BLK_FREE | MEM_BLK_PREV_FREE))
+#define BLK_IS_FREE(b)      (((b)->size & MEM_BLK_FREE) != 0)
+#define BLK_IS_PREV_FREE(b) (((b)->size & MEM_BLK_PREV_FREE) != 0)
+#define BLK_DATA(b)         ((void *)((uint8_t *)(b) + MEM_BLK_DATA_OFS))
+#define BLK_FROM_DATA(p)    ((mem_blk_t *)((uint8_t *)(p) - MEM_BLK_DATA_OFS))
+#define BLK_NEXT(b)         ((mem_blk_t *)((uint8_t *)BLK_DATA(b) + BLK_SIZE(b) - MEM_BLK_OVERHEAD))
+#define BLK_SET_SIZE(b, s)  ((b)->size = (s) | ((b)->size & (MEM_BLK_FREE | MEM_BLK_PREV_FREE)))
+#endif
+
+#if LV_MEM_TRACE
+#define MEM_TRACE(op, old_p, new_p, size)                                                                              \
+    do {                                                                                                               \
+        if(trace_cb) trace_cb(op, old_p, new_p, size);                                                                 \
+    } while(0)
+#else
+#define MEM_TRACE(op, old_p, new_p, size)
+#endif
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -95,25 +193,60 @@ void lv_mem_init(void)
     work_mem = (uint8_t *)LV_MEM_ADR;
 #endif
 
-    lv_mem_ent_t * full = (lv_mem_ent_t *)work_mem;
-    full->header.s.used = 0;
-    /*The total mem size id reduced by the first header and the close patterns */
-    full->header.s.d_size = LV_MEM_SIZE - sizeof(lv_mem_header_t);
+    ctrl_init();
 #endif
 }
 
 /**
  * Clean up the memory buffer which frees all the allocated memories.
+ * The pools added by `lv_mem_add_pool` are removed.
  * @note It work only if `LV_MEM_CUSTOM == 0`
  */
 void lv_mem_deinit(void)
 {
 #if LV_MEM_CUSTOM == 0
     memset(work_mem, 0x00, (LV_MEM_SIZE / sizeof(MEM_UNIT)) * sizeof(MEM_UNIT));
-    lv_mem_ent_t * full = (lv_mem_ent_t *)work_mem;
-    full->header.s.used = 0;
-    /*The total mem size id reduced by the first header and the close patterns */
-    full->header.s.d_size = LV_MEM_SIZE - sizeof(lv_mem_header_t);
+    ctrl_init();
+#endif
+}
+
+/**
+ * Give one more memory region to `lv_mem_alloc` (e.g. a part of an external SDRAM)
+ * @param mem start of the region
+ * @param size size of the region in bytes
+ * @return LV_RES_OK: the region is added; LV_RES_INV: too many regions or the size is invalid
+ * @note It work only if `LV_MEM_CUSTOM == 0`
+ */
+lv_res_t lv_mem_add_pool(void * mem, size_t size)
+{
+#if LV_MEM_CUSTOM == 0
+    if(pool_cnt >= LV_MEM_POOL_MAX) return LV_RES_INV;
+
+    /*Align the start and keep room for the first header and the closing block*/
+    size_t ofs = (MEM_ALIGN - ((lv_uintptr_t)mem & (MEM_ALIGN - 1))) & (MEM_ALIGN - 1);
+    if(size < ofs + 2 * MEM_BLK_OVERHEAD) return LV_RES_INV;
+    size_t blk_size = (size - ofs - 2 * MEM_BLK_OVERHEAD) & ~(size_t)(MEM_ALIGN - 1);
+    if(blk_size < MEM_BLK_MIN || blk_size >= MEM_BLK_MAX) return LV_RES_INV;
+
+    /*The `prev_phys` of the first block is before the region but it's never used*/
+    mem_blk_t * b = (mem_blk_t *)((uint8_t *)mem + ofs - MEM_BLK_OVERHEAD);
+    b->size       = blk_size | MEM_BLK_FREE;
+    blk_insert(b);
+
+    /*A used block of 0 size closes the pool so no block is merged over the end*/
+    mem_blk_t * end = BLK_NEXT(b);
+    end->prev_phys  = b;
+    end->size       = MEM_BLK_PREV_FREE;
+
+    pools[pool_cnt].first = b;
+    pools[pool_cnt].size  = size;
+    pool_cnt++;
+
+    return LV_RES_OK;
+#else
+    (void)mem;  /*Unused*/
+    (void)size; /*Unused*/
+    return LV_RES_INV;
 #endif
 }
 
@@ -125,6 +258,7 @@ void lv_mem_deinit(void)
 void * lv_mem_alloc(size_t size)
 {
     if(size == 0) {
+        MEM_TRACE(LV_MEM_TRACE_ALLOC, NULL, &zero_mem, 0);
         return &zero_mem;
     }
 
@@ -145,20 +279,7 @@ void * lv_mem_alloc(size_t size)
 
 #if LV_MEM_CUSTOM == 0
     /*Use the built-in allocators*/
-    lv_mem_ent_t * e = NULL;
-
-    /* Search for a appropriate entry*/
-    do {
-        /* Get the next entry*/
-        e = ent_get_next(e);
-
-        /*If there is next entry then try to allocate there*/
-        if(e != NULL) {
-            alloc = ent_alloc(e, size);
-        }
-        /* End if there is not next entry OR the alloc. is successful*/
-    } while(e != NULL && alloc == NULL);
-
+    alloc = blk_alloc(size);
 #else
 /*Use custom, user defined malloc function*/
 #if LV_ENABLE_GC == 1 /*gc must not include header*/
@@ -181,6 +302,8 @@ void * lv_mem_alloc(size_t size)
 
     if(alloc == NULL) LV_LOG_WARN("Couldn't allocate memory");
 
+    MEM_TRACE(LV_MEM_TRACE_ALLOC, NULL, alloc, size);
+
     return alloc;
 }
 
@@ -193,33 +316,19 @@ void lv_mem_free(const void * data)
     if(data == &zero_mem) return;
     if(data == NULL) return;
 
+    MEM_TRACE(LV_MEM_TRACE_FREE, data, NULL, 0);
+
 #if LV_MEM_ADD_JUNK
     memset((void *)data, 0xbb, lv_mem_get_size(data));
 #endif
 
+#if LV_MEM_CUSTOM == 0
+    blk_free((void *)data);
+#else /*Use custom, user defined free function*/
 #if LV_ENABLE_GC == 0
     /*e points to the header*/
     lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
     e->header.s.used = 0;
-#endif
-
-#if LV_MEM_CUSTOM == 0
-#if LV_MEM_AUTO_DEFRAG
-    /* Make a simple defrag.
-     * Join the following free entries after this*/
-    lv_mem_ent_t * e_next;
-    e_next = ent_get_next(e);
-    while(e_next != NULL) {
-        if(e_next->header.s.used == 0) {
-            e->header.s.d_size += e_next->header.s.d_size + sizeof(e->header);
-        } else {
-            break;
-        }
-        e_next = ent_get_next(e_next);
-    }
-#endif
-#else /*Use custom, user defined free function*/
-#if LV_ENABLE_GC == 0
     LV_MEM_CUSTOM_FREE(e);
 #else
     LV_MEM_CUSTOM_FREE((void *)data);
@@ -240,25 +349,36 @@ void lv_mem_free(const void * data)
 void * lv_mem_realloc(void * data_p, size_t new_size)
 {
     /*data_p could be previously freed pointer (in this case it is invalid)*/
-    if(data_p != NULL) {
+    if(data_p != NULL && data_p != &zero_mem) {
+#if LV_MEM_CUSTOM == 0
+        if(BLK_IS_FREE(BLK_FROM_DATA(data_p))) {
+            data_p = NULL;
+        }
+#else
         lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
         if(e->header.s.used == 0) {
             data_p = NULL;
         }
+#endif
     }
 
     uint32_t old_size = lv_mem_get_size(data_p);
     if(old_size == new_size) return data_p; /*Also avoid reallocating the same memory*/
 
 #if LV_MEM_CUSTOM == 0
-    /* Truncate the memory if the new size is smaller. */
-    if(new_size < old_size) {
-        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
-        ent_trunc(e, new_size);
-        return &e->first_data;
+    /*Truncate the block or extend it into the next free block*/
+    if(data_p != NULL && data_p != &zero_mem && new_size != 0 && blk_resize(data_p, new_size)) {
+        MEM_TRACE(LV_MEM_TRACE_REALLOC, data_p, data_p, new_size);
+        return data_p;
     }
 #endif
 
+#if LV_MEM_TRACE
+    /*Trace only the realloc, not the alloc and free it's made of*/
+    lv_mem_trace_cb_t cb = trace_cb;
+    trace_cb             = NULL;
+#endif
+
     void * new_p;
     new_p = lv_mem_alloc(new_size);
 
@@ -270,6 +390,11 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
         }
     }
 
+#if LV_MEM_TRACE
+    trace_cb = cb;
+#endif
+    MEM_TRACE(LV_MEM_TRACE_REALLOC, data_p, new_p, new_size);
+
     if(new_p == NULL) LV_LOG_WARN("Couldn't allocate memory");
 
     return new_p;
@@ -287,45 +412,11 @@ void * lv_mem_realloc(void * data_p, size_t new_size)
 #endif /* lv_enable_gc */
 
 /**
- * Join the adjacent free memory blocks
+ * Join the adjacent free memory blocks.
+ * Nothing to do with the built-in allocator: the free blocks are joined when they are freed.
  */
 void lv_mem_defrag(void)
 {
-#if LV_MEM_CUSTOM == 0
-    lv_mem_ent_t * e_free;
-    lv_mem_ent_t * e_next;
-    e_free = ent_get_next(NULL);
-
-    while(1) {
-        /*Search the next free entry*/
-        while(e_free != NULL) {
-            if(e_free->header.s.used != 0) {
-                e_free = ent_get_next(e_free);
-            } else {
-                break;
-            }
-        }
-
-        if(e_free == NULL) return;
-
-        /*Joint the following free entries to the free*/
-        e_next = ent_get_next(e_free);
-        while(e_next != NULL) {
-            if(e_next->header.s.used == 0) {
-                e_free->header.s.d_size += e_next->header.s.d_size + sizeof(e_next->header);
-            } else {
-                break;
-            }
-
-            e_next = ent_get_next(e_next);
-        }
-
-        if(e_next == NULL) return;
-
-        /*Continue from the lastly checked entry*/
-        e_free = e_next;
-    }
-#endif
 }
 
 /**
@@ -338,26 +429,26 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
     /*Init the data*/
     memset(mon_p, 0, sizeof(lv_mem_monitor_t));
 #if LV_MEM_CUSTOM == 0
-    lv_mem_ent_t * e;
-    e = NULL;
-
-    e = ent_get_next(e);
-
-    while(e != NULL) {
-        if(e->header.s.used == 0) {
-            mon_p->free_cnt++;
-            mon_p->free_size += e->header.s.d_size;
-            if(e->header.s.d_size > mon_p->free_biggest_size) {
-                mon_p->free_biggest_size = e->header.s.d_size;
+    uint32_t i;
+    for(i = 0; i < pool_cnt; i++) {
+        mem_blk_t * b;
+        for(b = pools[i].first; BLK_SIZE(b) != 0; b = BLK_NEXT(b)) {
+            if(BLK_IS_FREE(b)) {
+                mon_p->free_cnt++;
+                mon_p->free_size += BLK_SIZE(b);
+                if(BLK_SIZE(b) > mon_p->free_biggest_size) {
+                    mon_p->free_biggest_size = BLK_SIZE(b);
+                }
+            } else {
+                mon_p->used_cnt++;
             }
-        } else {
-            mon_p->used_cnt++;
         }
 
-        e = ent_get_next(e);
+        mon_p->total_size += pools[i].size;
     }
-    mon_p->total_size = LV_MEM_SIZE;
-    mon_p->used_pct   = 100 - (100U * mon_p->free_size) / mon_p->total_size;
+
+    mon_p->max_used = max_used;
+    mon_p->used_pct = 100 - (100U * mon_p->free_size) / mon_p->total_size;
     if(mon_p->free_size > 0) {
         mon_p->frag_pct   = (uint32_t)mon_p->free_biggest_size * 100U / mon_p->free_size;
         mon_p->frag_pct   = 100 - mon_p->frag_pct;
@@ -380,9 +471,13 @@ uint32_t lv_mem_get_size(const void * data)
     if(data == NULL) return 0;
     if(data == &zero_mem) return 0;
 
+#if LV_MEM_CUSTOM == 0
+    return BLK_SIZE(BLK_FROM_DATA(data));
+#else
     lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
 
     return e->header.s.d_size;
+#endif
 }
 
 #else /* LV_ENABLE_GC */
@@ -394,92 +489,294 @@ uint32_t lv_mem_get_size(const void * data)
 
 #endif /*LV_ENABLE_GC*/
 
+#if LV_MEM_TRACE
+/**
+ * Set a function to call on every `lv_mem_alloc`, `lv_mem_free` and `lv_mem_realloc` (e.g. to record traces)
+ * @param cb the function or NULL to stop tracing
+ */
+void lv_mem_set_trace_cb(lv_mem_trace_cb_t cb)
+{
+    trace_cb = cb;
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
 #if LV_MEM_CUSTOM == 0
 /**
- * Give the next entry after 'act_e'
- * @param act_e pointer to an entry
- * @return pointer to an entry after 'act_e'
+ * Clear the free lists and the pools and add the built-in pool
  */
-static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e)
+static void ctrl_init(void)
 {
-    lv_mem_ent_t * next_e = NULL;
+    fl_bitmap = 0;
+    memset(sl_bitmap, 0, sizeof(sl_bitmap));
+    memset(free_lists, 0, sizeof(free_lists));
+    pool_cnt  = 0;
+    used_size = 0;
+    max_used  = 0;
+
+    lv_mem_add_pool(work_mem, (LV_MEM_SIZE / sizeof(MEM_UNIT)) * sizeof(MEM_UNIT));
+}
+
+/**
+ * Allocate a block from the smallest free list which surely has a large enough block
+ * @param size size of the data (already aligned)
+ * @return pointer to the data or NULL if there is no large enough free block
+ */
+static void * blk_alloc(size_t size)
+{
+    size = adjust_size(size);
+    if(size == 0) return NULL;
 
-    if(act_e == NULL) { /*NULL means: get the first entry*/
-        next_e = (lv_mem_ent_t *)work_mem;
-    } else { /*Get the next entry */
-        uint8_t * data = &act_e->first_data;
-        next_e         = (lv_mem_ent_t *)&data[act_e->header.s.d_size];
+    mem_blk_t * b = blk_locate_free(size);
+    if(b == NULL) return NULL;
 
-        if(&next_e->first_data >= &work_mem[LV_MEM_SIZE]) next_e = NULL;
-    }
+    /*Give back the unused end of the block*/
+    mem_blk_t * next = BLK_NEXT(b);
+    b->size &= ~(size_t)MEM_BLK_FREE;
+    next->size &= ~(size_t)MEM_BLK_PREV_FREE;
+    blk_trim_used(b, size);
 
-    return next_e;
+    used_size += BLK_SIZE(b) + MEM_BLK_OVERHEAD;
+    if(used_size > max_used) max_used = used_size;
+
+    return BLK_DATA(b);
 }
 
 /**
- * Try to do the real allocation with a given size
- * @param e try to allocate to this entry
- * @param size size of the new memory in bytes
- * @return pointer to the allocated memory or NULL if not enough memory in the entry
+ * Free a block and join it with the free neighbours
+ * @param data pointer to the data of a used block
  */
-static void * ent_alloc(lv_mem_ent_t * e, size_t size)
+static void blk_free(void * data)
 {
-    void * alloc = NULL;
+    mem_blk_t * b = BLK_FROM_DATA(data);
+    used_size -= BLK_SIZE(b) + MEM_BLK_OVERHEAD;
 
-    /*If the memory is free and big enough then use it */
-    if(e->header.s.used == 0 && e->header.s.d_size >= size) {
-        /*Truncate the entry to the desired size */
-        ent_trunc(e, size),
+    mem_blk_t * next = BLK_NEXT(b);
+    b->size |= MEM_BLK_FREE;
+    next->prev_phys = b;
+    next->size |= MEM_BLK_PREV_FREE;
 
-            e->header.s.used = 1;
+    b = blk_merge_prev(b);
+    b = blk_merge_next(b);
+    blk_insert(b);
+}
 
-        /*Save the allocated data*/
-        alloc = &e->first_data;
+/**
+ * Change the size of a used block in place
+ * @param data pointer to the data of a used block
+ * @param size the new size
+ * @return true: the size is changed; false: the block can't be extended
+ */
+static bool blk_resize(void * data, size_t size)
+{
+    size = adjust_size(size);
+    if(size == 0) return false;
+
+    mem_blk_t * b = BLK_FROM_DATA(data);
+    mem_blk_t * next = BLK_NEXT(b);
+    size_t old_size = BLK_SIZE(b);
+
+    if(size > old_size) {
+        /*Extend into the next block if it's free and large enough*/
+        if(BLK_IS_FREE(next) == false || old_size + BLK_SIZE(next) + MEM_BLK_OVERHEAD < size) return false;
+
+        blk_remove(next);
+        BLK_SET_SIZE(b, old_size + BLK_SIZE(next) + MEM_BLK_OVERHEAD);
+        BLK_NEXT(b)->size &= ~(size_t)MEM_BLK_PREV_FREE;
     }
 
-    return alloc;
+    blk_trim_used(b, size);
+
+    used_size = used_size - old_size + BLK_SIZE(b);
+    if(used_size > max_used) max_used = used_size;
+
+    return true;
 }
 
 /**
- * Truncate the data of entry to the given size
- * @param e Pointer to an entry
- * @param size new size in bytes
+ * Remove a free block from its free list
+ * @param b pointer to a free block
  */
-static void ent_trunc(lv_mem_ent_t * e, size_t size)
+static void blk_remove(mem_blk_t * b)
 {
-#ifdef LV_ARCH_64
-    /*Round the size up to 8*/
-    if(size & 0x7) {
-        size = size & (~0x7);
-        size += 8;
+    uint32_t fl;
+    uint32_t sl;
+    mapping_insert(BLK_SIZE(b), &fl, &sl);
+
+    if(b->next_free) b->next_free->prev_free = b->prev_free;
+    if(b->prev_free) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        /*It was the head of the list*/
+        free_lists[fl][sl] = b->next_free;
+        if(b->next_free == NULL) {
+            sl_bitmap[fl] &= ~(1U << sl);
+            if(sl_bitmap[fl] == 0) fl_bitmap &= ~(1U << fl);
+        }
     }
-#else
-    /*Round the size up to 4*/
-    if(size & 0x3) {
-        size = size & (~0x3);
-        size += 4;
+}
+
+/**
+ * Add a free block to the head of its free list
+ * @param b pointer to a free block
+ */
+static void blk_insert(mem_blk_t * b)
+{
+    uint32_t fl;
+    uint32_t sl;
+    mapping_insert(BLK_SIZE(b), &fl, &sl);
+
+    mem_blk_t * head = free_lists[fl][sl];
+    b->next_free     = head;
+    b->prev_free     = NULL;
+    if(head) head->prev_free = b;
+
+    free_lists[fl][sl] = b;
+    sl_bitmap[fl] |= 1U << sl;
+    fl_bitmap |= 1U << fl;
+}
+
+/**
+ * Find and remove a free block of at least `size` bytes.
+ * The size is rounded up to the next list so any block of the list is large enough.
+ * @param size the required size
+ * @return pointer to a free block or NULL
+ */
+static mem_blk_t * blk_locate_free(size_t size)
+{
+    if(size >= MEM_SMALL_SIZE) {
+        size += ((size_t)1 << (fls_u32((uint32_t)size) - MEM_SL_LOG2)) - 1;
     }
-#endif
 
-    /*Don't let empty space only for a header without data*/
-    if(e->header.s.d_size == size + sizeof(lv_mem_header_t)) {
-        size = e->header.s.d_size;
+    uint32_t fl;
+    uint32_t sl;
+    mapping_insert(size, &fl, &sl);
+    if(fl >= MEM_FL_CNT) return NULL;
+
+    /*A list in the same first level range or the first non-empty larger range*/
+    uint32_t sl_map = sl_bitmap[fl] & (~0U << sl);
+    if(sl_map == 0) {
+        uint32_t fl_map = fl_bitmap & (~0U << (fl + 1));
+        if(fl_map == 0) return NULL;
+
+        fl     = fls_u32(fl_map & (~fl_map + 1));
+        sl_map = sl_bitmap[fl];
     }
+    sl = fls_u32(sl_map & (~sl_map + 1));
+
+    mem_blk_t * b = free_lists[fl][sl];
+    blk_remove(b);
+
+    return b;
+}
+
+/**
+ * Truncate a used block and give back the remaining part if it can be a free block
+ * @param b pointer to a used block
+ * @param size the new size of its data
+ */
+static void blk_trim_used(mem_blk_t * b, size_t size)
+{
+    if(BLK_SIZE(b) < size + sizeof(mem_blk_t)) return;
+
+    mem_blk_t * rem = (mem_blk_t *)((uint8_t *)BLK_DATA(b) + size - MEM_BLK_OVERHEAD);
+    rem->size       = (BLK_SIZE(b) - size - MEM_BLK_OVERHEAD) | MEM_BLK_FREE;
+    BLK_SET_SIZE(b, size);
 
-    /* Create the new entry after the current if there is space for it */
-    if(e->header.s.d_size != size) {
-        uint8_t * e_data             = &e->first_data;
-        lv_mem_ent_t * after_new_e   = (lv_mem_ent_t *)&e_data[size];
-        after_new_e->header.s.used   = 0;
-        after_new_e->header.s.d_size = (uint32_t)e->header.s.d_size - size - sizeof(lv_mem_header_t);
+    mem_blk_t * next = BLK_NEXT(rem);
+    next->prev_phys  = rem;
+    next->size |= MEM_BLK_PREV_FREE;
+
+    rem = blk_merge_next(rem);
+    blk_insert(rem);
+}
+
+/**
+ * Join a free block with the previous block if it's free
+ * @param b pointer to a free block (not in a free list)
+ * @return pointer to the joined block
+ */
+static mem_blk_t * blk_merge_prev(mem_blk_t * b)
+{
+    if(BLK_IS_PREV_FREE(b) == false) return b;
+
+    mem_blk_t * prev = b->prev_phys;
+    blk_remove(prev);
+    BLK_SET_SIZE(prev, BLK_SIZE(prev) + BLK_SIZE(b) + MEM_BLK_OVERHEAD);
+    BLK_NEXT(prev)->prev_phys = prev;
+
+    return prev;
+}
+
+/**
+ * Join a free block with the next block if it's free
+ * @param b pointer to a free block (not in a free list)
+ * @return `b`
+ */
+static mem_blk_t * blk_merge_next(mem_blk_t * b)
+{
+    mem_blk_t * next = BLK_NEXT(b);
+    if(BLK_IS_FREE(next) == false) return b;
+
+    blk_remove(next);
+    BLK_SET_SIZE(b, BLK_SIZE(b) + BLK_SIZE(next) + MEM_BLK_OVERHEAD);
+    BLK_NEXT(b)->prev_phys = b;
+
+    return b;
+}
+
+/**
+ * Give the data size of a block for a request
+ * @param size the requested size
+ * @return the aligned size, at least the size of a free block or 0 if it's too large
+ */
+static size_t adjust_size(size_t size)
+{
+    size = (size + MEM_ALIGN - 1) & ~(size_t)(MEM_ALIGN - 1);
+    if(size < MEM_BLK_MIN) size = MEM_BLK_MIN;
+
+    return size < MEM_BLK_MAX ? size : 0;
+}
+
+/**
+ * Give the free list of a size
+ * @param size size of a block's data
+ * @param fl store the first level index here
+ * @param sl store the second level index here
+ */
+static void mapping_insert(size_t size, uint32_t * fl, uint32_t * sl)
+{
+    if(size < MEM_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)size / (MEM_SMALL_SIZE / MEM_SL_CNT);
+    } else {
+        uint32_t msb = fls_u32((uint32_t)size);
+        *sl          = (uint32_t)(size >> (msb - MEM_SL_LOG2)) ^ MEM_SL_CNT;
+        *fl          = msb - (MEM_FL_SHIFT - 1);
     }
+}
 
-    /* Set the new size for the original entry */
-    e->header.s.d_size = (uint32_t)size;
+/**
+ * Give the index of the most significant set bit
+ * @param x a non-zero number
+ * @return the index of the highest 1 bit
+ */
+static uint32_t fls_u32(uint32_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - (uint32_t)__builtin_clz(x);
+#else
+    uint32_t bit = 0;
+    if(x & 0xFFFF0000) { bit += 16; x >>= 16; }
+    if(x & 0xFF00) { bit += 8; x >>= 8; }
+    if(x & 0xF0) { bit += 4; x >>= 4; }
+    if(x & 0xC) { bit += 2; x >>= 2; }
+    if(x & 0x2) { bit += 1; }
+    return bit;
+#endif
 }
 
 #endif
@@ -27,6 +27,10 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/*1: `lv_mem_set_trace_cb` can be used to record the allocations (e.g. for benchmarks)*/
+#ifndef LV_MEM_TRACE
+#define LV_MEM_TRACE    0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -42,10 +46,32 @@ typedef struct
     uint32_t free_size; /**< Size of available memory */
     uint32_t free_biggest_size;
     uint32_t used_cnt;
+    uint32_t max_used; /**< Largest used size since `lv_mem_init` (with the block headers) */
     uint8_t used_pct; /**< Percentage used */
-    uint8_t frag_pct; /**< Amount of fragmentation */
+    uint8_t frag_pct; /**< Amount of fragmentation: 100 - the biggest free block in the percent of the free size */
 } lv_mem_monitor_t;
 
+#if LV_MEM_TRACE
+/**
+ * Operations passed to the trace callback
+ */
+enum {
+    LV_MEM_TRACE_ALLOC,
+    LV_MEM_TRACE_FREE,
+    LV_MEM_TRACE_REALLOC,
+};
+typedef uint8_t lv_mem_trace_op_t;
+
+/**
+ * Called after `lv_mem_alloc` and `lv_mem_realloc` and before `lv_mem_free`
+ * @param op the operation
+ * @param old_p the freed or reallocated memory (NULL for alloc)
+ * @param new_p the allocated or reallocated memory (NULL for free or if the allocation failed)
+ * @param size the requested size
+ */
+typedef void (*lv_mem_trace_cb_t)(lv_mem_trace_op_t op, const void * old_p, const void * new_p, size_t size);
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -57,10 +83,20 @@ void lv_mem_init(void);
 
 /**
  * Clean up the memory buffer which frees all the allocated memories.
+ * The pools added by `lv_mem_add_pool` are removed.
  * @note It work only if `LV_MEM_CUSTOM == 0`
  */
 void lv_mem_deinit(void);
 
+/**
+ * Give one more memory region to `lv_mem_alloc` (e.g. a part of an external SDRAM)
+ * @param mem start of the region
+ * @param size size of the region in bytes
+ * @return LV_RES_OK: the region is added; LV_RES_INV: too many regions or the size is invalid
+ * @note It work only if `LV_MEM_CUSTOM == 0`
+ */
+lv_res_t lv_mem_add_pool(void * mem, size_t size);
+
 /**
  * Allocate a memory dynamically
  * @param size size of the memory to allocate in bytes
@@ -84,7 +120,8 @@ void lv_mem_free(const void * data);
 void * lv_mem_realloc(void * data_p, size_t new_size);
 
 /**
- * Join the adjacent free memory blocks
+ * Join the adjacent free memory blocks.
+ * Nothing to do with the built-in allocator: the free blocks are joined when they are freed.
  */
 void lv_mem_defrag(void);
 
@@ -102,6 +139,14 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p);
  */
 uint32_t lv_mem_get_size(const void * data);
 
+#if LV_MEM_TRACE
+/**
+ * Set a function to call on every `lv_mem_alloc`, `lv_mem_free` and `lv_mem_realloc` (e.g. to record traces)
+ * @param cb the function or NULL to stop tracing
+ */
+void lv_mem_set_trace_cb(lv_mem_trace_cb_t cb);
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -7,6 +7,7 @@ CSRCS += lv_mem.c
 CSRCS += lv_ll.c
 CSRCS += lv_color.c
 CSRCS += lv_txt.c
+CSRCS += lv_txt_layout.c
 CSRCS += lv_math.c
 CSRCS += lv_log.c
 CSRCS += lv_gc.c
@@ -2,12 +2,15 @@
  * @file lv_task.c
  * An 'lv_task'  is a void (*fp) (void* param) type function which will be called periodically.
  * A priority (5 levels + disable) can be assigned to lv_tasks.
+ * The tasks wait in a min-heap ordered by their next run so a call of `lv_task_handler` checks only the due tasks
+ * and tells when the next one will be due.
  */
 
 /*********************
  *      INCLUDES
  *********************/
 #include <stddef.h>
+#include <string.h>
 #include "lv_task.h"
 #include "../lv_core/lv_debug.h"
 #include "../lv_hal/lv_hal_tick.h"
@@ -23,15 +26,38 @@
 #define IDLE_MEAS_PERIOD 500 /*[ms]*/
 #define DEF_PRIO LV_TASK_PRIO_MID
 #define DEF_PERIOD 500
+#define QUEUE_SIZE_MIN 8
+#define QUEUE_IDX_NONE 0xFFFF /*The task is not queued because it's turned off*/
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/**
+ * Parts of the task queue. They follow each other in the same array:
+ * the waiting tasks as a min-heap, the due tasks in this `lv_task_handler` call and the tasks which already ran in it.
+ */
+enum {
+    QUEUE_WAIT = 0,
+    QUEUE_READY,
+    QUEUE_DONE,
+    _QUEUE_NUM,
+};
+typedef uint8_t queue_part_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static bool lv_task_exec(lv_task_t * task);
+static void lv_task_exec(lv_task_t * task);
+static bool task_is_due(const lv_task_t * task);
+static bool task_is_before(const lv_task_t * a, const lv_task_t * b);
+static bool queue_add(lv_task_t * task);
+static void queue_rem(lv_task_t * task);
+static void queue_ins(lv_task_t * task, queue_part_t part);
+static void queue_update(lv_task_t * task);
+static void queue_set(uint32_t idx, lv_task_t * task);
+static void queue_sift_up(uint32_t idx);
+static void queue_sift_down(uint32_t idx);
 
 /**********************
  *  STATIC VARIABLES
@@ -39,7 +65,11 @@ static bool lv_task_exec(lv_task_t * task);
 static bool lv_task_run  = false;
 static uint8_t idle_last = 0;
 static bool task_deleted;
-static bool task_created;
+
+/*End of the parts of the queue (`QUEUE_...`) and the size of the array*/
+static uint16_t queue_end[_QUEUE_NUM];
+static uint16_t queue_size;
+static uint32_t create_cnt;
 
 /**********************
  *      MACROS
@@ -56,20 +86,27 @@ void lv_task_core_init(void)
 {
     lv_ll_init(&LV_GC_ROOT(_lv_task_ll), sizeof(lv_task_t));
 
+    LV_GC_ROOT(_lv_task_queue) = NULL;
+    memset(queue_end, 0, sizeof(queue_end));
+    queue_size = 0;
+    create_cnt = 0;
+
     /*Initially enable the lv_task handling*/
     lv_task_enable(true);
 }
 
 /**
  * Call it  periodically to handle lv_tasks.
+ * @return time until the next task is due in milliseconds (0: call it again now)
+ *         or `LV_NO_TASK_READY` if there are no tasks to run
  */
-LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
+LV_ATTRIBUTE_TASK_HANDLER uint32_t lv_task_handler(void)
 {
     LV_LOG_TRACE("lv_task_handler started");
 
     /*Avoid concurrent running of the task handler*/
     static bool already_running = false;
-    if(already_running) return;
+    if(already_running) return 0;
     already_running = true;
 
     static uint32_t idle_period_start = 0;
@@ -78,85 +115,53 @@ LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
 
     if(lv_task_run == false) {
         already_running = false; /*Release mutex*/
-        return;
+        return lv_task_get_next_run();
     }
 
     handler_start = lv_tick_get();
 
-    /* Run all task from the highest to the lowest priority
-     * If a lower priority task is executed check task again from the highest priority
-     * but on the priority of executed tasks don't run tasks before the executed*/
-    lv_task_t * task_interrupter = NULL;
-    lv_task_t * next;
-    bool end_flag;
-    do {
-        end_flag                 = true;
-        task_deleted             = false;
-        task_created             = false;
-        LV_GC_ROOT(_lv_task_act) = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
-        while(LV_GC_ROOT(_lv_task_act)) {
-            /* The task might be deleted if it runs only once ('once = 1')
-             * So get next element until the current is surely valid*/
-            next = lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), LV_GC_ROOT(_lv_task_act));
-
-            /*We reach priority of the turned off task. There is nothing more to do.*/
-            if(((lv_task_t *)LV_GC_ROOT(_lv_task_act))->prio == LV_TASK_PRIO_OFF) {
-                break;
-            }
+    /* Run the due tasks from the highest to the lowest priority.
+     * The tasks which became due meanwhile (e.g. created by an other task) are also run
+     * but every task runs at most once in a call.*/
+    lv_task_t ** queue;
+    while(1) {
+        queue = LV_GC_ROOT(_lv_task_queue); /*It's reallocated if a created task doesn't fit*/
+        while(queue_end[QUEUE_WAIT] > 0 && task_is_due(queue[0])) {
+            lv_task_t * due = queue[0];
+            queue_rem(due);
+            queue_ins(due, QUEUE_READY);
+        }
 
-            /*Here is the interrupter task. Don't execute it again.*/
-            if(LV_GC_ROOT(_lv_task_act) == task_interrupter) {
-                task_interrupter = NULL; /*From this point only task after the interrupter comes, so
-                                            the interrupter is not interesting anymore*/
-                LV_GC_ROOT(_lv_task_act) = next;
-                continue; /*Load the next task*/
-            }
+        if(queue_end[QUEUE_READY] == queue_end[QUEUE_WAIT]) break;
 
-            /*Just try to run the tasks with highest priority.*/
-            if(((lv_task_t *)LV_GC_ROOT(_lv_task_act))->prio == LV_TASK_PRIO_HIGHEST) {
-                lv_task_exec(LV_GC_ROOT(_lv_task_act));
-            }
-            /*Tasks with higher priority than the interrupted shall be run in every case*/
-            else if(task_interrupter) {
-                if(((lv_task_t *)LV_GC_ROOT(_lv_task_act))->prio > task_interrupter->prio) {
-                    if(lv_task_exec(LV_GC_ROOT(_lv_task_act))) {
-                        if(!task_created && !task_deleted) {
-                            /*Check all tasks again from the highest priority */
-                            task_interrupter = LV_GC_ROOT(_lv_task_act);
-                            end_flag = false;
-                            break;
-                        }
-                    }
-                }
-            }
-            /* It is no interrupter task or we already reached it earlier.
-             * Just run the remaining tasks*/
-            else {
-                if(lv_task_exec(LV_GC_ROOT(_lv_task_act))) {
-                    if(!task_created && !task_deleted) {
-                        task_interrupter = LV_GC_ROOT(_lv_task_act); /*Check all tasks again from the highest priority */
-                        end_flag         = false;
-                        break;
-                    }
-                }
+        /*The highest priority first, the newer task first on equal priorities*/
+        lv_task_t * task = queue[queue_end[QUEUE_WAIT]];
+        uint32_t i;
+        for(i = queue_end[QUEUE_WAIT] + 1; i < queue_end[QUEUE_READY]; i++) {
+            lv_task_t * ready = queue[i];
+            if(ready->prio > task->prio || (ready->prio == task->prio && ready->create_id > task->create_id)) {
+                task = ready;
             }
+        }
 
-            /*If a task was created or deleted then this or the next item might be corrupted*/
-            if(task_created || task_deleted) {
-                task_interrupter = NULL;
-                break;
-            }
+        queue_rem(task);
+        queue_ins(task, QUEUE_DONE);
+        lv_task_exec(task);
+    }
 
-            LV_GC_ROOT(_lv_task_act) = next; /*Load the next task*/
-        }
-    } while(!end_flag);
+    /*The tasks which ran wait for their next run again*/
+    queue = LV_GC_ROOT(_lv_task_queue);
+    while(queue_end[QUEUE_DONE] > queue_end[QUEUE_READY]) {
+        lv_task_t * done = queue[queue_end[QUEUE_READY]];
+        queue_rem(done);
+        queue_ins(done, QUEUE_WAIT);
+    }
 
+    /*The time between the calls is idle, e.g. the CPU sleeps until the next task is due*/
     busy_time += lv_tick_elaps(handler_start);
     uint32_t idle_period_time = lv_tick_elaps(idle_period_start);
     if(idle_period_time >= IDLE_MEAS_PERIOD) {
-
-        idle_last         = (uint32_t)((uint32_t)busy_time * 100) / IDLE_MEAS_PERIOD; /*Calculate the busy percentage*/
-        idle_last         = idle_last > 100 ? 0 : 100 - idle_last;                    /*But we need idle time*/
+        idle_last         = busy_time >= idle_period_time ? 0 : 100 - (busy_time * 100) / idle_period_time;
         busy_time         = 0;
         idle_period_start = lv_tick_get();
     }
@@ -164,7 +169,10 @@ LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
     already_running = false; /*Release the mutex*/
 
     LV_LOG_TRACE("lv_task_handler ready");
+
+    return lv_task_get_next_run();
 }
+
 /**
  * Create an "empty" task. It needs to initialzed with at least
  * `lv_task_set_cb` and `lv_task_set_period`
@@ -172,37 +180,9 @@ LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
  */
 lv_task_t * lv_task_create_basic(void)
 {
-    lv_task_t * new_task = NULL;
-    lv_task_t * tmp;
-
-    /*Create task lists in order of priority from high to low*/
-    tmp = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
-
-    /*It's the first task*/
-    if(NULL == tmp) {
-        new_task = lv_ll_ins_head(&LV_GC_ROOT(_lv_task_ll));
-        LV_ASSERT_MEM(new_task);
-        if(new_task == NULL) return NULL;
-    }
-    /*Insert the new task to proper place according to its priority*/
-    else {
-        do {
-            if(tmp->prio <= DEF_PRIO) {
-                new_task = lv_ll_ins_prev(&LV_GC_ROOT(_lv_task_ll), tmp);
-                LV_ASSERT_MEM(new_task);
-                if(new_task == NULL) return NULL;
-                break;
-            }
-            tmp = lv_ll_get_next(&LV_GC_ROOT(_lv_task_ll), tmp);
-        } while(tmp != NULL);
-
-        /*Only too high priority tasks were found. Add the task to the end*/
-        if(tmp == NULL) {
-            new_task = lv_ll_ins_tail(&LV_GC_ROOT(_lv_task_ll));
-            LV_ASSERT_MEM(new_task);
-            if(new_task == NULL) return NULL;
-        }
-    }
+    lv_task_t * new_task = lv_ll_ins_head(&LV_GC_ROOT(_lv_task_ll));
+    LV_ASSERT_MEM(new_task);
+    if(new_task == NULL) return NULL;
 
     new_task->period  = DEF_PERIOD;
     new_task->task_cb = NULL;
@@ -212,8 +192,14 @@ lv_task_t * lv_task_create_basic(void)
     new_task->last_run = lv_tick_get();
 
     new_task->user_data = NULL;
+    new_task->create_id = create_cnt++;
 
-    task_created = true;
+    if(queue_add(new_task) == false) {
+        lv_ll_rem(&LV_GC_ROOT(_lv_task_ll), new_task);
+        lv_mem_free(new_task);
+        LV_ASSERT_MEM(NULL);
+        return NULL;
+    }
 
     return new_task;
 }
@@ -258,6 +244,7 @@ void lv_task_set_cb(lv_task_t * task, lv_task_cb_t task_cb)
  */
 void lv_task_del(lv_task_t * task)
 {
+    if(task->queue_idx != QUEUE_IDX_NONE) queue_rem(task);
     lv_ll_rem(&LV_GC_ROOT(_lv_task_ll), task);
 
     lv_mem_free(task);
@@ -274,22 +261,20 @@ void lv_task_set_prio(lv_task_t * task, lv_task_prio_t prio)
 {
     if(task->prio == prio) return;
 
-    /*Find the tasks with new priority*/
-    lv_task_t * i;
-    LV_LL_READ(LV_GC_ROOT(_lv_task_ll), i)
-    {
-        if(i->prio <= prio) {
-            if(i != task) lv_ll_move_before(&LV_GC_ROOT(_lv_task_ll), task, i);
-            break;
+    /*The turned off tasks are not queued*/
+    if(prio == LV_TASK_PRIO_OFF) {
+        queue_rem(task);
+        task->prio = prio;
+    } else if(task->prio == LV_TASK_PRIO_OFF) {
+        task->prio = prio;
+        if(queue_add(task) == false) {
+            LV_LOG_WARN("lv_task_set_prio: couldn't queue the task");
+            task->prio = LV_TASK_PRIO_OFF;
         }
+    } else {
+        task->prio = prio;
+        queue_update(task);
     }
-
-    /*There was no such a low priority so far then add the node to the tail*/
-    if(i == NULL) {
-        lv_ll_move_before(&LV_GC_ROOT(_lv_task_ll), task, NULL);
-    }
-
-    task->prio = prio;
 }
 
 /**
@@ -300,6 +285,7 @@ void lv_task_set_prio(lv_task_t * task, lv_task_prio_t prio)
 void lv_task_set_period(lv_task_t * task, uint32_t period)
 {
     task->period = period;
+    queue_update(task);
 }
 
 /**
@@ -309,6 +295,7 @@ void lv_task_set_period(lv_task_t * task, uint32_t period)
 void lv_task_ready(lv_task_t * task)
 {
     task->last_run = lv_tick_get() - task->period - 1;
+    queue_update(task);
 }
 
 /**
@@ -328,6 +315,7 @@ void lv_task_once(lv_task_t * task)
 void lv_task_reset(lv_task_t * task)
 {
     task->last_run = lv_tick_get();
+    queue_update(task);
 }
 
 /**
@@ -348,35 +336,212 @@ uint8_t lv_task_get_idle(void)
     return idle_last;
 }
 
+/**
+ * Get the time until the next task is due. The CPU can sleep meanwhile.
+ * @return time in milliseconds (0: a task is due now) or `LV_NO_TASK_READY` if there are no tasks to run
+ */
+uint32_t lv_task_get_next_run(void)
+{
+    if(queue_end[QUEUE_WAIT] == 0) return LV_NO_TASK_READY;
+
+    const lv_task_t * next = LV_GC_ROOT(_lv_task_queue)[0];
+    uint32_t elp           = lv_tick_elaps(next->last_run);
+
+    return elp >= next->period ? 0 : next->period - elp;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
 /**
- * Execute task if its the priority is appropriate
+ * Execute a task and delete it if it's a one shot task
  * @param task pointer to lv_task
- * @return true: execute, false: not executed
  */
-static bool lv_task_exec(lv_task_t * task)
+static void lv_task_exec(lv_task_t * task)
 {
-    bool exec = false;
-
-    /*Execute if at least 'period' time elapsed*/
-    uint32_t elp = lv_tick_elaps(task->last_run);
-    if(elp >= task->period) {
-        task->last_run = lv_tick_get();
-        task_deleted   = false;
-        task_created   = false;
-        if(task->task_cb) task->task_cb(task);
-
-        /*Delete if it was a one shot lv_task*/
-        if(task_deleted == false) { /*The task might be deleted by itself as well*/
-            if(task->once != 0) {
-                lv_task_del(task);
-            }
+    LV_GC_ROOT(_lv_task_act) = task;
+
+    task->last_run = lv_tick_get();
+    task_deleted   = false;
+    if(task->task_cb) task->task_cb(task);
+
+    /*Delete if it was a one shot lv_task*/
+    if(task_deleted == false) { /*The task might be deleted by itself as well*/
+        if(task->once != 0) {
+            lv_task_del(task);
         }
-        exec = true;
     }
 
-    return exec;
+    LV_GC_ROOT(_lv_task_act) = NULL;
+}
+
+/**
+ * Tell whether at least `period` time elapsed since the last run of a task
+ * @param task pointer to lv_task
+ * @return true: the task should run now
+ */
+static bool task_is_due(const lv_task_t * task)
+{
+    return lv_tick_elaps(task->last_run) >= task->period;
+}
+
+/**
+ * Compare the order of two tasks in the heap: the earlier next run first, the higher priority on equal times
+ * @param a pointer to lv_task
+ * @param b pointer to an other lv_task
+ * @return true: `a` should run before `b`
+ */
+static bool task_is_before(const lv_task_t * a, const lv_task_t * b)
+{
+    int32_t diff = (int32_t)((a->last_run + a->period) - (b->last_run + b->period));
+    if(diff != 0) return diff < 0;
+
+    return a->prio > b->prio;
+}
+
+/**
+ * Add a task to the waiting tasks. Enlarge the queue if required.
+ * @param task pointer to lv_task
+ * @return true: queued; false: out of memory
+ */
+static bool queue_add(lv_task_t * task)
+{
+    if(queue_end[_QUEUE_NUM - 1] >= queue_size) {
+        uint32_t new_size = queue_size ? queue_size * 2 : QUEUE_SIZE_MIN;
+        if(new_size >= QUEUE_IDX_NONE) return false;
+
+        lv_task_t ** queue = lv_mem_realloc(LV_GC_ROOT(_lv_task_queue), new_size * sizeof(lv_task_t *));
+        if(queue == NULL) return false;
+
+        LV_GC_ROOT(_lv_task_queue) = queue;
+        queue_size                 = (uint16_t)new_size;
+    }
+
+    queue_ins(task, QUEUE_WAIT);
+
+    return true;
+}
+
+/**
+ * Remove a task from its part of the queue. The parts after it are shifted back by one.
+ * @param task pointer to a queued lv_task
+ */
+static void queue_rem(lv_task_t * task)
+{
+    lv_task_t ** queue = LV_GC_ROOT(_lv_task_queue);
+    uint32_t idx       = task->queue_idx;
+
+    queue_part_t part = 0;
+    while(idx >= queue_end[part]) part++;
+
+    /*Fill the place with the last task of the part*/
+    uint32_t hole = queue_end[part] - 1;
+    queue_end[part]--;
+    if(idx != hole) {
+        lv_task_t * last = queue[hole];
+        queue_set(idx, last);
+        if(part == QUEUE_WAIT) {
+            queue_sift_up(idx);
+            queue_sift_down(last->queue_idx);
+        }
+    }
+
+    /*The next parts fill the hole with their last task*/
+    for(part++; part < _QUEUE_NUM; part++) {
+        uint32_t tail = queue_end[part] - 1U;
+        if(tail != hole) queue_set(hole, queue[tail]);
+        queue_end[part]--;
+        hole = queue_end[part];
+    }
+
+    task->queue_idx = QUEUE_IDX_NONE;
+}
+
+/**
+ * Add a task to the end of a part of the queue. The parts after it are shifted forward by one.
+ * The queue needs to have place for it.
+ * @param task pointer to an lv_task which is not queued
+ * @param part `QUEUE_...`
+ */
+static void queue_ins(lv_task_t * task, queue_part_t part)
+{
+    lv_task_t ** queue = LV_GC_ROOT(_lv_task_queue);
+
+    /*The next parts move their first task to their end*/
+    queue_part_t i;
+    for(i = _QUEUE_NUM - 1; i > part; i--) {
+        uint32_t first = queue_end[i - 1];
+        if(first != queue_end[i]) queue_set(queue_end[i], queue[first]);
+        queue_end[i]++;
+    }
+
+    queue_set(queue_end[part], task);
+    queue_end[part]++;
+
+    if(part == QUEUE_WAIT) queue_sift_up(task->queue_idx);
+}
+
+/**
+ * Restore the place of a task in the heap after its next run or priority has changed
+ * @param task pointer to lv_task
+ */
+static void queue_update(lv_task_t * task)
+{
+    if(task->queue_idx >= queue_end[QUEUE_WAIT]) return; /*Not waiting. It returns to the heap later.*/
+
+    queue_sift_up(task->queue_idx);
+    queue_sift_down(task->queue_idx);
+}
+
+/**
+ * Put a task to a place of the queue
+ * @param idx index in the queue
+ * @param task pointer to lv_task
+ */
+static void queue_set(uint32_t idx, lv_task_t * task)
+{
+    LV_GC_ROOT(_lv_task_queue)[idx] = task;
+    task->queue_idx                 = (uint16_t)idx;
+}
+
+/**
+ * Move a task up in the heap while it should run before its parent
+ * @param idx index of the task in the heap
+ */
+static void queue_sift_up(uint32_t idx)
+{
+    lv_task_t ** queue = LV_GC_ROOT(_lv_task_queue);
+    lv_task_t * task   = queue[idx];
+
+    while(idx > 0) {
+        uint32_t parent = (idx - 1) / 2;
+        if(!task_is_before(task, queue[parent])) break;
+        queue_set(idx, queue[parent]);
+        idx = parent;
+    }
+
+    queue_set(idx, task);
+}
+
+/**
+ * Move a task down in the heap while one of its children should run before it
+ * @param idx index of the task in the heap
+ */
+static void queue_sift_down(uint32_t idx)
+{
+    lv_task_t ** queue = LV_GC_ROOT(_lv_task_queue);
+    lv_task_t * task   = queue[idx];
+    uint32_t cnt       = queue_end[QUEUE_WAIT];
+
+    while(1) {
+        uint32_t child = idx * 2 + 1;
+        if(child >= cnt) break;
+        if(child + 1 < cnt && task_is_before(queue[child + 1], queue[child])) child++;
+        if(!task_is_before(queue[child], task)) break;
+        queue_set(idx, queue[child]);
+        idx = child;
+    }
+
+    queue_set(idx, task);
 }
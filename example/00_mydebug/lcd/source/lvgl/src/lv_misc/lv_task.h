@@ -31,6 +31,8 @@ extern "C" {
 #ifndef LV_ATTRIBUTE_TASK_HANDLER
 #define LV_ATTRIBUTE_TASK_HANDLER
 #endif
+
+#define LV_NO_TASK_READY 0xFFFFFFFF
 /**********************
  *      TYPEDEFS
  **********************/
@@ -69,6 +71,8 @@ typedef struct _lv_task_t
 
     uint8_t prio : 3; /**< Task priority */
     uint8_t once : 1; /**< 1: one shot task */
+    uint16_t queue_idx; /**< Index in the queue of the scheduler (internal)*/
+    uint32_t create_id; /**< Order of creation. The newer runs first on equal priorities (internal)*/
 } lv_task_t;
 
 /**********************
@@ -84,8 +88,10 @@ void lv_task_core_init(void);
 
 /**
  * Call it  periodically to handle lv_tasks.
+ * @return time until the next task is due in milliseconds (0: call it again now)
+ *         or `LV_NO_TASK_READY` if there are no tasks to run
  */
-LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void);
+LV_ATTRIBUTE_TASK_HANDLER uint32_t lv_task_handler(void);
 
 //! @endcond
 
@@ -166,6 +172,12 @@ void lv_task_enable(bool en);
  */
 uint8_t lv_task_get_idle(void);
 
+/**
+ * Get the time until the next task is due. The CPU can sleep meanwhile.
+ * @return time in milliseconds (0: a task is due now) or `LV_NO_TASK_READY` if there are no tasks to run
+ */
+uint32_t lv_task_get_next_run(void);
+
 /**********************
  *      MACROS
  **********************/
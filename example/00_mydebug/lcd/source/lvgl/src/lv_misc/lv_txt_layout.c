@@ -0,0 +1,246 @@
+/**
+ * @file lv_txt_layout.c
+ * Cache of the line breaks of a text.
+ * The lines are laid out only until the requested one so drawing the top of a long text
+ * doesn't measure the rest of it.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <string.h>
+#include "lv_txt_layout.h"
+#include "lv_mem.h"
+#include "lv_math.h"
+#include "lv_log.h"
+#include "../lv_core/lv_debug.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Lines allocated first*/
+#define LINE_ALLOC_MIN  8
+
+/*Flags which change the line breaks or the widths*/
+#define LAYOUT_FLAGS    (LV_TXT_FLAG_RECOLOR | LV_TXT_FLAG_EXPAND)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool lay_out_next(lv_txt_layout_t * layout);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize an empty layout
+ * @param layout pointer to a layout
+ */
+void lv_txt_layout_init(lv_txt_layout_t * layout)
+{
+    memset(layout, 0, sizeof(lv_txt_layout_t));
+}
+
+/**
+ * Free the memory of a layout. It can be used again without `lv_txt_layout_init`.
+ * @param layout pointer to a layout
+ */
+void lv_txt_layout_free(lv_txt_layout_t * layout)
+{
+    if(layout->lines) lv_mem_free(layout->lines);
+    lv_txt_layout_init(layout);
+}
+
+/**
+ * Forget the lines from the one before a changed position of the text.
+ * (A changed word can move the previous line's break too.)
+ * @param layout pointer to a layout
+ * @param txt the changed text. Can be different from the earlier if the text was reallocated.
+ * @param byte_id the first changed byte of the text. 0: forget every line
+ */
+void lv_txt_layout_invalidate(lv_txt_layout_t * layout, const char * txt, uint32_t byte_id)
+{
+    layout->txt = txt;
+    if(layout->lines == NULL) return;
+
+    /*Keep the lines which end before the line of `byte_id`*/
+    uint32_t keep = 0;
+    while(keep < layout->line_cnt && layout->lines[keep + 1].start <= byte_id) keep++;
+    if(keep > 0) keep--;
+
+    layout->line_cnt = keep;
+    layout->done     = 0;
+
+    layout->w_max = 0;
+    uint32_t i;
+    for(i = 0; i < keep; i++) layout->w_max = LV_MATH_MAX(layout->w_max, layout->lines[i].w);
+}
+
+/**
+ * Select the text and the parameters of the layout. The lines are kept if nothing has changed.
+ * @param layout pointer to a layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param max_w max. width of the lines. `LV_COORD_MAX` to break only at new lines.
+ * @param flag settings for the text from 'txt_flag_t' enum
+ */
+void lv_txt_layout_set(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font, lv_coord_t letter_space,
+                       lv_coord_t max_w, lv_txt_flag_t flag)
+{
+    /*The alignment doesn't change the lines*/
+    flag &= LAYOUT_FLAGS;
+    if(flag & LV_TXT_FLAG_EXPAND) max_w = LV_COORD_MAX;
+
+    if(layout->txt == txt && layout->font == font && layout->letter_space == letter_space &&
+       layout->max_w == max_w && layout->flag == flag) {
+        return;
+    }
+
+    layout->txt          = txt;
+    layout->font         = font;
+    layout->letter_space = letter_space;
+    layout->max_w        = max_w;
+    layout->flag         = flag;
+    lv_txt_layout_invalidate(layout, txt, 0);
+}
+
+/**
+ * Get a line of the text. The lines until it are laid out if required.
+ * @param layout pointer to a layout prepared with `lv_txt_layout_set`
+ * @param line_id index of the line
+ * @param start store the byte index of the line's first letter here
+ * @param end store the byte index of the next line's first letter here
+ * @param w store the width of the line here (can be NULL)
+ * @return true: the line exists; false: the text has less lines
+ */
+bool lv_txt_layout_get_line(lv_txt_layout_t * layout, uint32_t line_id, uint32_t * start, uint32_t * end,
+                            lv_coord_t * w)
+{
+    while(line_id >= layout->line_cnt) {
+        if(lay_out_next(layout) == false) return false;
+    }
+
+    *start = layout->lines[line_id].start;
+    *end   = layout->lines[line_id + 1].start;
+    if(w) *w = layout->lines[line_id].w;
+
+    return true;
+}
+
+/**
+ * Get the line of a letter
+ * @param layout pointer to a layout prepared with `lv_txt_layout_set`
+ * @param byte_id byte index of a letter
+ * @return index of the line of the letter or the last line if `byte_id` is at the end of the text
+ */
+uint32_t lv_txt_layout_find_line(lv_txt_layout_t * layout, uint32_t byte_id)
+{
+    /*Lay out until the letter*/
+    while(layout->line_cnt == 0 || layout->lines[layout->line_cnt].start <= byte_id) {
+        if(lay_out_next(layout) == false) break;
+    }
+
+    if(layout->line_cnt == 0) return 0;
+
+    /*Binary search for the last line starting before the letter*/
+    uint32_t first = 0;
+    uint32_t last  = layout->line_cnt - 1;
+    while(first < last) {
+        uint32_t mid = (first + last + 1) / 2;
+        if(layout->lines[mid].start <= byte_id) first = mid;
+        else last = mid - 1;
+    }
+
+    return first;
+}
+
+/**
+ * Get the size of the text like `lv_txt_get_size`
+ * @param layout pointer to a layout prepared with `lv_txt_layout_set`
+ * @param size_res pointer to a 'point_t' variable to store the result
+ * @param line_space line space of the text
+ */
+void lv_txt_layout_get_size(lv_txt_layout_t * layout, lv_point_t * size_res, lv_coord_t line_space)
+{
+    size_res->x = 0;
+    size_res->y = 0;
+
+    if(layout->txt == NULL || layout->font == NULL) return;
+
+    while(lay_out_next(layout));
+
+    uint8_t letter_height = lv_font_get_line_height(layout->font);
+    uint32_t line_cnt     = layout->line_cnt;
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    uint32_t end = layout->lines ? layout->lines[line_cnt].start : 0;
+    if(end != 0 && (layout->txt[end - 1] == '\n' || layout->txt[end - 1] == '\r')) line_cnt++;
+
+    int32_t h = (int32_t)line_cnt * (letter_height + line_space);
+    if(h > LV_COORD_MAX) {
+        LV_LOG_WARN("lv_txt_layout_get_size: integer overflow while calculating text height");
+        return;
+    }
+
+    size_res->x = layout->w_max;
+
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(line_cnt == 0) size_res->y = letter_height;
+    else size_res->y = (lv_coord_t)(h - line_space);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Lay out the next line of the text
+ * @param layout pointer to a layout
+ * @return true: a line was laid out; false: the end of the text is reached or out of memory
+ */
+static bool lay_out_next(lv_txt_layout_t * layout)
+{
+    if(layout->done || layout->txt == NULL || layout->font == NULL) return false;
+
+    if(layout->line_cnt + 2 > layout->line_alloc) {
+        uint32_t alloc = layout->line_alloc ? layout->line_alloc * 2 : LINE_ALLOC_MIN;
+        lv_txt_layout_line_t * lines = lv_mem_realloc(layout->lines, alloc * sizeof(lv_txt_layout_line_t));
+        LV_ASSERT_MEM(lines);
+        if(lines == NULL) return false;
+
+        /*The end of the laid out lines is the start of the text in a new layout*/
+        if(layout->lines == NULL) lines[0].start = 0;
+        layout->lines      = lines;
+        layout->line_alloc = alloc;
+    }
+
+    lv_txt_layout_line_t * line = &layout->lines[layout->line_cnt];
+    const char * txt            = &layout->txt[line->start];
+    if(txt[0] == '\0') {
+        layout->done = 1;
+        return false;
+    }
+
+    uint32_t len = lv_txt_get_next_line(txt, layout->font, layout->letter_space, layout->max_w, layout->flag);
+    line->w      = lv_txt_get_width(txt, len, layout->font, layout->letter_space, layout->flag);
+    line[1].start = line->start + len;
+
+    layout->w_max = LV_MATH_MAX(layout->w_max, line->w);
+    layout->line_cnt++;
+
+    return true;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file lv_txt_layout.h
+ * Cache of the line breaks of a text
+ */
+
+#ifndef LV_TXT_LAYOUT_H
+#define LV_TXT_LAYOUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lv_area.h"
+#include "lv_txt.h"
+#include "../lv_font/lv_font.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** A laid out line*/
+typedef struct
+{
+    uint32_t start;     /**< Byte index of the first letter of the line*/
+    lv_coord_t w;       /**< Width of the line*/
+} lv_txt_layout_line_t;
+
+/** Line breaks of a text with a given font, letter space, width and flags*/
+typedef struct
+{
+    const char * txt;               /**< The text. NULL: nothing is laid out*/
+    const lv_font_t * font;
+    lv_coord_t letter_space;
+    lv_coord_t max_w;
+    lv_txt_flag_t flag;             /**< Only the flags which change the line breaks and widths*/
+
+    /** `line_cnt + 1` lines: the start of the last one is the end of the laid out lines*/
+    lv_txt_layout_line_t * lines;
+    uint32_t line_cnt;              /**< Number of laid out lines*/
+    uint32_t line_alloc;            /**< Number of allocated lines*/
+    lv_coord_t w_max;               /**< Width of the longest laid out line*/
+    uint8_t done : 1;               /**< 1: every line is laid out*/
+} lv_txt_layout_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize an empty layout
+ * @param layout pointer to a layout
+ */
+void lv_txt_layout_init(lv_txt_layout_t * layout);
+
+/**
+ * Free the memory of a layout. It can be used again without `lv_txt_layout_init`.
+ * @param layout pointer to a layout
+ */
+void lv_txt_layout_free(lv_txt_layout_t * layout);
+
+/**
+ * Forget the lines from the one before a changed position of the text.
+ * (A changed word can move the previous line's break too.)
+ * @param layout pointer to a layout
+ * @param txt the changed text. Can be different from the earlier if the text was reallocated.
+ * @param byte_id the first changed byte of the text. 0: forget every line
+ */
+void lv_txt_layout_invalidate(lv_txt_layout_t * layout, const char * txt, uint32_t byte_id);
+
+/**
+ * Select the text and the parameters of the layout. The lines are kept if nothing has changed.
+ * @param layout pointer to a layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param max_w max. width of the lines. `LV_COORD_MAX` to break only at new lines.
+ * @param flag settings for the text from 'txt_flag_t' enum
+ */
+void lv_txt_layout_set(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font, lv_coord_t letter_space,
+                       lv_coord_t max_w, lv_txt_flag_t flag);
+
+/**
+ * Get a line of the text. The lines until it are laid out if required.
+ * @param layout pointer to a layout prepared with `lv_txt_layout_set`
+ * @param line_id index of the line
+ * @param start store the byte index of the line's first letter here
+ * @param end store the byte index of the next line's first letter here
+ * @param w store the width of the line here (can be NULL)
+ * @return true: the line exists; false: the text has less lines
+ */
+bool lv_txt_layout_get_line(lv_txt_layout_t * layout, uint32_t line_id, uint32_t * start, uint32_t * end,
+                            lv_coord_t * w);
+
+/**
+ * Get the line of a letter
+ * @param layout pointer to a layout prepared with `lv_txt_layout_set`
+ * @param byte_id byte index of a letter
+ * @return index of the line of the letter or the last line if `byte_id` is at the end of the text
+ */
+uint32_t lv_txt_layout_find_line(lv_txt_layout_t * layout, uint32_t byte_id);
+
+/**
+ * Get the size of the text like `lv_txt_get_size`
+ * @param layout pointer to a layout prepared with `lv_txt_layout_set`
+ * @param size_res pointer to a 'point_t' variable to store the result
+ * @param line_space line space of the text
+ */
+void lv_txt_layout_get_size(lv_txt_layout_t * layout, lv_point_t * size_res, lv_coord_t line_space);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_TXT_LAYOUT_H*/
@@ -15,6 +15,7 @@
 #include <string.h>
 
 #include "../lv_core/lv_debug.h"
+#include "../lv_core/lv_indev.h"
 #include "../lv_draw/lv_draw.h"
 #include "../lv_draw/lv_draw_basic.h"
 #include "../lv_themes/lv_theme.h"
@@ -675,6 +676,10 @@ static void lv_cont_refr_autofit(lv_obj_t * cont)
         lv_area_copy(&cont->coords, &new_area);
         lv_obj_invalidate(cont);
 
+        /*The children are not moved with the container*/
+        lv_indev_hit_invalidate(par);
+        lv_indev_hit_invalidate(cont);
+
         /*Notify the object about its new coordinates*/
         cont->signal_cb(cont, LV_SIGNAL_CORD_CHG, &ori);
 
@@ -42,6 +42,10 @@ static lv_res_t lv_label_signal(lv_obj_t * label, lv_signal_t sign, void * param
 static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_mode_t mode);
 static void lv_label_refr_text(lv_obj_t * label);
 static void lv_label_revert_dots(lv_obj_t * label);
+static void lv_label_inv_layout(lv_obj_t * label, uint32_t byte_id);
+#if LV_LABEL_LAYOUT_CACHE
+static lv_txt_layout_t * lv_label_get_layout(const lv_obj_t * label, lv_coord_t max_w, lv_txt_flag_t flag);
+#endif
 
 #if LV_USE_ANIMATION
 static void lv_label_set_offset_x(lv_obj_t * label, lv_coord_t x);
@@ -108,6 +112,10 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->hint.y          = 0;
 #endif
 
+#if LV_LABEL_LAYOUT_CACHE
+    lv_txt_layout_init(&ext->layout);
+#endif
+
 #if LV_LABEL_TEXT_SEL
     ext->txt_sel_start = LV_DRAW_LABEL_NO_TXT_SEL;
     ext->txt_sel_end   = LV_DRAW_LABEL_NO_TXT_SEL;
@@ -143,6 +151,7 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
             LV_ASSERT_MEM(ext->text);
             if(ext->text == NULL) return NULL;
             memcpy(ext->text, copy_ext->text, lv_mem_get_size(copy_ext->text));
+            lv_label_inv_layout(new_label, 0);
         }
 
         if(copy_ext->dot_tmp_alloc && copy_ext->dot.tmp_ptr) {
@@ -179,6 +188,7 @@ void lv_label_set_text(lv_obj_t * label, const char * text)
     lv_obj_invalidate(label);
 
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    lv_label_inv_layout(label, 0);
 
     /*If text is NULL then refresh */
     if(text == NULL) {
@@ -227,6 +237,7 @@ void lv_label_set_text_fmt(lv_obj_t * label, const char * fmt, ...)
     lv_obj_invalidate(label);
 
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    lv_label_inv_layout(label, 0);
 
     /*If text is NULL then refresh */
     if(fmt == NULL) {
@@ -276,6 +287,7 @@ void lv_label_set_array_text(lv_obj_t * label, const char * array, uint16_t size
     lv_obj_invalidate(label);
 
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    lv_label_inv_layout(label, 0);
 
     /*If trying to set its own text or the array is NULL then refresh */
     if(array == ext->text || array == NULL) {
@@ -310,6 +322,7 @@ void lv_label_set_static_text(lv_obj_t * label, const char * text)
     LV_ASSERT_OBJ(label, LV_OBJX_NAME);
 
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    lv_label_inv_layout(label, 0);
     if(ext->static_txt == 0 && ext->text != NULL) {
         lv_mem_free(ext->text);
         ext->text = NULL;
@@ -606,7 +619,18 @@ void lv_label_get_letter_pos(const lv_obj_t * label, uint16_t char_id, lv_point_
     }
 
     uint16_t byte_id = lv_txt_encoded_get_byte_id(txt, char_id);
-
+    lv_coord_t line_w;
+
+#if LV_LABEL_LAYOUT_CACHE
+    /*Find the line of the index letter in the layout*/
+    lv_txt_layout_t * layout = lv_label_get_layout(label, max_w, flag);
+    uint32_t line_id         = lv_txt_layout_find_line(layout, byte_id);
+    if(lv_txt_layout_get_line(layout, line_id, &line_start, &new_line_start, &line_w)) {
+        y = (lv_coord_t)(line_id * (letter_height + style->text.line_space));
+    } else {
+        line_w = 0;
+    }
+#else
     /*Search the line of the index letter */;
     while(txt[new_line_start] != '\0') {
         new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
@@ -616,12 +640,14 @@ void lv_label_get_letter_pos(const lv_obj_t * label, uint16_t char_id, lv_point_
         y += letter_height + style->text.line_space;
         line_start = new_line_start;
     }
+#endif
 
     /*If the last character is line break then go to the next line*/
     if(byte_id > 0) {
         if((txt[byte_id - 1] == '\n' || txt[byte_id - 1] == '\r') && txt[byte_id] == '\0') {
             y += letter_height + style->text.line_space;
             line_start = byte_id;
+            line_w     = 0;
         }
     }
 
@@ -654,15 +680,16 @@ void lv_label_get_letter_pos(const lv_obj_t * label, uint16_t char_id, lv_point_
 
     if(char_id != line_start) x += style->text.letter_space;
 
-    if(align == LV_LABEL_ALIGN_CENTER) {
-        lv_coord_t line_w;
+#if LV_LABEL_LAYOUT_CACHE == 0 || LV_USE_BIDI
+    /*The width of the (reordered) line is not known yet*/
+    if(align == LV_LABEL_ALIGN_CENTER || align == LV_LABEL_ALIGN_RIGHT) {
         line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, style->text.letter_space, flag);
-        x += lv_obj_get_width(label) / 2 - line_w / 2;
+    }
+#endif
 
+    if(align == LV_LABEL_ALIGN_CENTER) {
+        x += lv_obj_get_width(label) / 2 - line_w / 2;
     } else if(align == LV_LABEL_ALIGN_RIGHT) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(bidi_txt, new_line_start - line_start, font, style->text.letter_space, flag);
-
         x += lv_obj_get_width(label) - line_w;
     }
     pos->x = x;
@@ -707,8 +734,14 @@ uint16_t lv_label_get_letter_on(const lv_obj_t * label, lv_point_t * pos)
     }
 
     /*Search the line of the index letter */;
+#if LV_LABEL_LAYOUT_CACHE
+    lv_txt_layout_t * layout = lv_label_get_layout(label, max_w, flag);
+    uint32_t line_id         = 0;
+    while(lv_txt_layout_get_line(layout, line_id, &line_start, &new_line_start, NULL)) {
+#else
     while(txt[line_start] != '\0') {
         new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
+#endif
 
         if(pos->y <= y + letter_height) {
             /*The line is found (stored in 'line_start')*/
@@ -721,6 +754,9 @@ uint16_t lv_label_get_letter_on(const lv_obj_t * label, lv_point_t * pos)
         }
         y += letter_height + style->text.line_space;
 
+#if LV_LABEL_LAYOUT_CACHE
+        line_id++;
+#endif
         line_start = new_line_start;
     }
 
@@ -862,12 +898,21 @@ bool lv_label_is_char_under_pos(const lv_obj_t * label, lv_point_t * pos)
     }
 
     /*Search the line of the index letter */;
+#if LV_LABEL_LAYOUT_CACHE
+    lv_txt_layout_t * layout = lv_label_get_layout(label, max_w, flag);
+    uint32_t line_id         = 0;
+    while(lv_txt_layout_get_line(layout, line_id, &line_start, &new_line_start, NULL)) {
+#else
     while(txt[line_start] != '\0') {
         new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
+#endif
 
         if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
         y += letter_height + style->text.line_space;
 
+#if LV_LABEL_LAYOUT_CACHE
+        line_id++;
+#endif
         line_start = new_line_start;
     }
 
@@ -957,6 +1002,9 @@ void lv_label_ins_text(lv_obj_t * label, uint32_t pos, const char * txt)
         pos = lv_txt_get_encoded_length(ext->text);
     }
 
+    /*Only the lines from the inserted text have to be laid out again*/
+    lv_label_inv_layout(label, lv_txt_encoded_get_byte_id(ext->text, pos));
+
     lv_txt_ins(ext->text, pos, txt);
     lv_label_refr_text(label);
 }
@@ -980,6 +1028,8 @@ void lv_label_cut_text(lv_obj_t * label, uint32_t pos, uint32_t cnt)
     lv_obj_invalidate(label);
 
     char * label_txt = lv_label_get_text(label);
+    lv_label_inv_layout(label, lv_txt_encoded_get_byte_id(label_txt, pos));
+
     /*Delete the characters*/
     lv_txt_cut(label_txt, pos, cnt);
 
@@ -1052,7 +1102,9 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
                 flag &= ~LV_TXT_FLAG_CENTER;
             }
         }
-#if LV_LABEL_LONG_TXT_HINT
+#if LV_LABEL_LAYOUT_CACHE
+        /*The lines are cached in the layout so no hint is required*/
+#elif LV_LABEL_LONG_TXT_HINT
         lv_draw_label_hint_t * hint = &ext->hint;
         if(ext->long_mode == LV_LABEL_LONG_SROLL_CIRC || lv_obj_get_height(label) < LV_LABEL_HINT_HEIGHT_LIMIT)
             hint = NULL;
@@ -1071,7 +1123,12 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
         has_common = lv_area_intersect(&mask2, &coords, mask);
         if(!has_common) return false;
 
+#if LV_LABEL_LAYOUT_CACHE
+        lv_draw_label_layout(&coords, &mask2, style, opa_scale, ext->text, flag, &ext->offset, &sel, &ext->layout,
+                             lv_obj_get_base_dir(label));
+#else
         lv_draw_label(&coords, &mask2, style, opa_scale, ext->text, flag, &ext->offset, &sel, hint, lv_obj_get_base_dir(label));
+#endif
 
 
         if(ext->long_mode == LV_LABEL_LONG_SROLL_CIRC) {
@@ -1124,6 +1181,9 @@ static lv_res_t lv_label_signal(lv_obj_t * label, lv_signal_t sign, void * param
             ext->text = NULL;
         }
         lv_label_dot_tmp_free(label);
+#if LV_LABEL_LAYOUT_CACHE
+        lv_txt_layout_free(&ext->layout);
+#endif
     } else if(sign == LV_SIGNAL_STYLE_CHG) {
         /*Revert dots for proper refresh*/
         lv_label_revert_dots(label);
@@ -1188,7 +1248,11 @@ static void lv_label_refr_text(lv_obj_t * label)
     lv_txt_flag_t flag = LV_TXT_FLAG_NONE;
     if(ext->recolor != 0) flag |= LV_TXT_FLAG_RECOLOR;
     if(ext->expand != 0) flag |= LV_TXT_FLAG_EXPAND;
+#if LV_LABEL_LAYOUT_CACHE
+    lv_txt_layout_get_size(lv_label_get_layout(label, max_w, flag), &size, style->text.line_space);
+#else
     lv_txt_get_size(&size, ext->text, font, style->text.letter_space, style->text.line_space, max_w, flag);
+#endif
 
     /*Set the full size in expand mode*/
     if(ext->long_mode == LV_LABEL_LONG_EXPAND) {
@@ -1332,6 +1396,7 @@ static void lv_label_refr_text(lv_obj_t * label)
                 }
                 ext->text[byte_id_ori + LV_LABEL_DOT_NUM] = '\0';
                 ext->dot_end                              = letter_id + LV_LABEL_DOT_NUM;
+                lv_label_inv_layout(label, byte_id_ori);
             }
         }
     }
@@ -1364,10 +1429,45 @@ static void lv_label_revert_dots(lv_obj_t * label)
     }
     ext->text[byte_i + i] = dot_tmp[i];
     lv_label_dot_tmp_free(label);
+    lv_label_inv_layout(label, byte_i);
 
     ext->dot_end = LV_LABEL_DOT_END_INV;
 }
 
+/**
+ * Forget the line breaks of the text from a changed position
+ * @param label pointer to a label object
+ * @param byte_id the first changed byte of the text. 0: the whole text has changed
+ */
+static void lv_label_inv_layout(lv_obj_t * label, uint32_t byte_id)
+{
+#if LV_LABEL_LAYOUT_CACHE
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    lv_txt_layout_invalidate(&ext->layout, ext->text, byte_id);
+#else
+    (void)label;    /*Unused*/
+    (void)byte_id;  /*Unused*/
+#endif
+}
+
+#if LV_LABEL_LAYOUT_CACHE
+/**
+ * Get the layout of the label's text. The lines are kept if the text, the style, `max_w` and `flag` are the same.
+ * @param label pointer to a label object
+ * @param max_w max. width of the lines
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @return pointer to the layout of the label
+ */
+static lv_txt_layout_t * lv_label_get_layout(const lv_obj_t * label, lv_coord_t max_w, lv_txt_flag_t flag)
+{
+    lv_label_ext_t * ext     = lv_obj_get_ext_attr(label);
+    const lv_style_t * style = lv_obj_get_style(label);
+
+    lv_txt_layout_set(&ext->layout, ext->text, style->text.font, style->text.letter_space, max_w, flag);
+    return &ext->layout;
+}
+#endif
+
 #if LV_USE_ANIMATION
 static void lv_label_set_offset_x(lv_obj_t * label, lv_coord_t x)
 {
@@ -55,8 +55,10 @@
  ******************************************************************************/
 #include "hc32_ddl_lcd.h"
 #include "lvgl.h"
-#include "RGB565_480x272.h"
-#include "RGB565_480x208.h"
+#include "porting/lv_port_disp_template.h"
+#include "porting/lv_port_flush.h"
+#include "porting/lv_port_comp.h"
+#include "lv_examples/lv_apps/benchmark/benchmark_suite.h"
 
 /**
  * @addtogroup HC32F4A0_DDL_Examples
@@ -84,6 +86,57 @@
 #define LCD_BKL_PORT            (GPIO_PORT_I)
 #define LCD_BKL_PIN             (GPIO_PIN_00)
 
+/* Measured frames of every benchmark scene */
+#define BENCH_FRAME_NUM         (20UL)
+
+/* Shadow of the panel (480x800 RGB565) for the differential flush in the lower half of the SDRAM */
+#define DISP_SHADOW_SDRAM_OFS   (0UL)
+#define DISP_SHADOW_SDRAM_SIZE  (480UL * 800UL * 2UL)
+/* 1MB..2.5MB: the two frame buffers of lv_port_disp_template.c if LV_PORT_DISP_SDRAM_FB is 1 in lv_conf.h */
+/* 2.5MB..4MB: the two camera surfaces of the compositor (DISP_CAM_SDRAM_ADDR in lv_port_disp_template.c) */
+
+/* Decoded images of the LVGL image cache in the upper half of the SDRAM */
+#define IMG_CACHE_SDRAM_OFS     (4UL * 1024UL * 1024UL)
+#define IMG_CACHE_SDRAM_SIZE    (3584UL * 1024UL)
+
+/* Second region of lv_mem_alloc at the end of the SDRAM, after the image cache */
+#define LV_MEM_SDRAM_OFS        (IMG_CACHE_SDRAM_OFS + IMG_CACHE_SDRAM_SIZE)
+#define LV_MEM_SDRAM_SIZE       (512UL * 1024UL)
+
+/* QSPI NOR flash (W25Q64) of the images, read in XIP mode with quad I/O */
+#define QSPI_CS_PORT            (GPIO_PORT_C)
+#define QSPI_CS_PIN             (GPIO_PIN_07)
+#define QSPI_SCK_PORT           (GPIO_PORT_C)
+#define QSPI_SCK_PIN            (GPIO_PIN_06)
+#define QSPI_IO_PORT            (GPIO_PORT_B)
+#define QSPI_IO0_PIN            (GPIO_PIN_13)
+#define QSPI_IO1_PIN            (GPIO_PIN_12)
+#define QSPI_IO2_PIN            (GPIO_PIN_10)
+#define QSPI_IO3_PIN            (GPIO_PIN_02)
+#define QSPI_PIN_FUNC           (GPIO_FUNC_18_QSPI)
+
+#define QSPI_W25Q64_FAST_READ_QUAD_IO   (0xEBU)
+#define QSPI_W25Q64_QUAD_IO_DUMMY_CYCLES (6UL)
+
+/* The flash is mapped here by the ROM access */
+#define QSPI_ROM_BASE           (0x98000000UL)
+
+/* QLI images in the QSPI flash. Made by `make imgs` of the host build. */
+#define IMG_QSPI_TITLE_ADDR     (0x000000UL)    /* 480x208 */
+#define IMG_QSPI_PHOTO_0_ADDR   (0x040000UL)    /* 480x272 */
+#define IMG_QSPI_PHOTO_1_ADDR   (0x080000UL)    /* 480x272 */
+
+#define BMP_TITLE_Y             (592U)
+#define BMP_PHOTO_Y             (320U)
+
+/* Longest sleep of the main loop between the LVGL tasks. The keys are polled after it. */
+#define GUI_SLEEP_MAX_MS        (20UL)
+
+/* Update of the frame rates in the status bar over the camera */
+#define CAM_STAT_PERIOD_MS      (1000UL)
+#define CAM_BAR_HEIGHT          (30)
+#define CAM_CROSS_SIZE          (80)
+
 /*******************************************************************************
  * Global variable definitions (declared in header file with 'extern')
  ******************************************************************************/
@@ -98,29 +151,36 @@ uint32_t dvp_frame_cnt=0;
 uint32_t dvp_line_cnt=0;
 uint8_t dis_title = 0;
 
-/*
-    0: cam idle
-    1: cam busy
-*/
-uint8_t cam_state = 0;;
-
 /*
     0: gui idle
     1: gui busy
 */
 uint8_t gui_state = 0;
 
-/*
-    0: gui
-    1: dvp
-*/
-uint8_t lcd_state = 0;
+/* The camera surface of the compositor, the next line to write into it and the number of its lines */
+static lv_color_t * volatile pCamSurf = NULL;
+static volatile uint32_t u32CamArmLine = 0UL;
+static uint32_t u32CamLines = 0UL;
+
+/* The screen over the camera: a crosshair and a status bar with the frame rates */
+static lv_obj_t *pCamScr = NULL;
+static lv_obj_t *pGuiScr = NULL;
+static lv_obj_t *pCamLabel = NULL;
+static lv_task_t *pCamTask = NULL;
+static lv_style_t stcCamScrStyle;
+static lv_style_t stcCamBarStyle;
+static lv_style_t stcCamCrossStyle;
+static lv_port_comp_stat_t stcCamStatLast;
+static uint32_t u32CamStatTick;
 
 /*******************************************************************************
  * Local function prototypes ('static')
  ******************************************************************************/
 void DVP_CaptureOn(void);
 void DVP_CaptureOff(void);
+static void cam_overlay_start(void);
+static void cam_overlay_stop(void);
+static uint32_t DVP_LineDest(void);
 
 
 
@@ -133,6 +193,154 @@ void slider_event_cb(lv_obj_t * slider, lv_event_t event)
     }
 }
 
+/**
+ * @brief  Time stamp of the benchmark from the DWT cycle counter
+ * @param  None
+ * @retval uint32_t microseconds
+ * @note   Must be called at least once per 2^32 CPU cycles to follow the wrap of CYCCNT.
+ */
+static uint32_t bench_time_us(void)
+{
+    static uint32_t u32LastCyc = 0UL;
+    static uint32_t u32CycRem = 0UL;
+    static uint32_t u32Us = 0UL;
+    const uint32_t u32CycPerUs = SystemCoreClock / 1000000UL;
+    uint32_t u32Cyc = DWT->CYCCNT;
+
+    u32CycRem += u32Cyc - u32LastCyc;
+    u32LastCyc = u32Cyc;
+    u32Us += u32CycRem / u32CycPerUs;
+    u32CycRem %= u32CycPerUs;
+
+    return u32Us;
+}
+
+/**
+ * @brief  Output a CSV line of the benchmark on the debug UART
+ * @param  [in] line            The line without line ending
+ * @retval None
+ */
+static void bench_print(const char * line)
+{
+    printf("%s\r\n", line);
+}
+
+/**
+ * @brief  Run the render benchmark suite and print the results as CSV
+ * @param  None
+ * @retval None
+ */
+static void bench_run(void)
+{
+    /* Enable the cycle counter */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0UL;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    benchmark_suite_init(bench_time_us, bench_print);
+    benchmark_suite_run(BENCH_FRAME_NUM);
+}
+
+/**
+ * @brief  Show the frame rates of the camera and of the compositor in the status bar
+ * @param  [in] task            The LVGL task
+ * @retval None
+ */
+static void cam_stat_task(lv_task_t * task)
+{
+    lv_port_comp_stat_t stcStat;
+    uint32_t u32Ms = lv_tick_elaps(u32CamStatTick);
+
+    (void)task;
+    if (0UL == u32Ms)
+    {
+        return;
+    }
+
+    lv_port_comp_get_stat(&stcStat);
+    lv_label_set_text_fmt(pCamLabel, "CAM %u fps   LCD %u fps   drop %u   comp %u us",
+                          (unsigned)((stcStat.cam_cnt - stcCamStatLast.cam_cnt) * 1000UL / u32Ms),
+                          (unsigned)((stcStat.frame_cnt - stcCamStatLast.frame_cnt) * 1000UL / u32Ms),
+                          (unsigned)(stcStat.drop_cnt - stcCamStatLast.drop_cnt),
+                          (unsigned)stcStat.comp_us);
+
+    stcCamStatLast = stcStat;
+    u32CamStatTick = lv_tick_get();
+}
+
+/**
+ * @brief  Show the camera behind a screen with a crosshair and a status bar
+ * @param  None
+ * @retval None
+ */
+static void cam_overlay_start(void)
+{
+    lv_obj_t *pObj;
+
+    pCamSurf = lv_port_comp_get_cam_buf();
+    if ((NULL == pCamSurf) || lv_port_comp_is_enabled())
+    {
+        return;
+    }
+    u32CamLines = (uint32_t)lv_disp_get_ver_res(NULL);
+
+    /* The screen has the colour key: the video is visible through it */
+    lv_style_copy(&stcCamScrStyle, &lv_style_scr);
+    stcCamScrStyle.body.main_color = lv_port_comp_get_key();
+    stcCamScrStyle.body.grad_color = lv_port_comp_get_key();
+    pCamScr = lv_obj_create(NULL, NULL);
+    lv_obj_set_style(pCamScr, &stcCamScrStyle);
+
+    lv_style_copy(&stcCamCrossStyle, &lv_style_plain);
+    stcCamCrossStyle.body.main_color = LV_COLOR_RED;
+    stcCamCrossStyle.body.grad_color = LV_COLOR_RED;
+    pObj = lv_obj_create(pCamScr, NULL);
+    lv_obj_set_style(pObj, &stcCamCrossStyle);
+    lv_obj_set_size(pObj, CAM_CROSS_SIZE, 2);
+    lv_obj_align(pObj, NULL, LV_ALIGN_CENTER, 0, 0);
+    pObj = lv_obj_create(pCamScr, NULL);
+    lv_obj_set_style(pObj, &stcCamCrossStyle);
+    lv_obj_set_size(pObj, 2, CAM_CROSS_SIZE);
+    lv_obj_align(pObj, NULL, LV_ALIGN_CENTER, 0, 0);
+
+    lv_style_copy(&stcCamBarStyle, &lv_style_plain);
+    stcCamBarStyle.body.main_color = LV_COLOR_NAVY;
+    stcCamBarStyle.body.grad_color = LV_COLOR_NAVY;
+    stcCamBarStyle.text.color = LV_COLOR_WHITE;
+    pObj = lv_obj_create(pCamScr, NULL);
+    lv_obj_set_style(pObj, &stcCamBarStyle);
+    lv_obj_set_size(pObj, lv_disp_get_hor_res(NULL), CAM_BAR_HEIGHT);
+    pCamLabel = lv_label_create(pObj, NULL);
+    lv_label_set_text(pCamLabel, "CAM");
+    lv_obj_align(pCamLabel, NULL, LV_ALIGN_IN_LEFT_MID, 8, 0);
+
+    pGuiScr = lv_disp_get_scr_act(NULL);
+    lv_disp_load_scr(pCamScr);
+
+    lv_port_comp_get_stat(&stcCamStatLast);
+    u32CamStatTick = lv_tick_get();
+    pCamTask = lv_task_create(cam_stat_task, CAM_STAT_PERIOD_MS, LV_TASK_PRIO_LOW, NULL);
+
+    lv_port_comp_enable(true);
+    DVP_CaptureOn();
+}
+
+/**
+ * @brief  Stop the camera and show the GUI again
+ * @param  None
+ * @retval None
+ */
+static void cam_overlay_stop(void)
+{
+    DVP_CaptureOff();
+    lv_port_comp_enable(false);
+
+    lv_task_del(pCamTask);
+    lv_disp_load_scr(pGuiScr);
+    lv_obj_del(pCamScr);
+    pCamScr = NULL;
+}
+
 void key_serve(void)
 {
         if (Set == BSP_KEY_GetStatus(BSP_KEY_1))
@@ -170,21 +378,27 @@ void key_serve(void)
         if (Set == BSP_KEY_GetStatus(BSP_KEY_7))
         {
 //            BSP_LED_Toggle(LED_RED);
-            DVP_CaptureOff();
-            demo_create();
-            lcd_state = 0;
+            if (lv_port_comp_is_enabled())
+            {
+                cam_overlay_stop();
+            }
+            else
+            {
+                demo_create();
+            }
             dis_title = 0;
         }
         if (Set == BSP_KEY_GetStatus(BSP_KEY_8))
         {
             BSP_LED_Toggle(LED_BLUE);
+            if (false == lv_port_comp_is_enabled())
+            {
+                bench_run();
+            }
         }
         if (Set == BSP_KEY_GetStatus(BSP_KEY_9))
         {
-            DVP_CaptureOn();
-            lcd_state = 1;
-            NT35510_SetCursor(0, 0);
-
+            cam_overlay_start();
         }
 }
 
@@ -199,103 +413,114 @@ void SysTick_IrqHandler(void)
     draw_cnt++;
 }
 
-void draw_bmp(void)
+/**
+ * @brief  Map the QSPI flash of the images to QSPI_ROM_BASE in XIP mode
+ * @param  None
+ * @retval None
+ * @note   The W25Q64 of the board has the QE bit set, quad I/O reads need no configuration.
+ */
+static void QSPI_XIP_Init(void)
 {
-    stc_dma_init_t stcDmaInit;
-    static uint8_t i = 0;
-
-
-//    PWC_Fcg0PeriphClockCmd(PWC_FCG0_DMA1 | PWC_FCG0_AOS, Enable);
+    stc_gpio_init_t stcGpioInit;
+    stc_qspi_init_t stcQspiInit;
+
+    GPIO_StructInit(&stcGpioInit);
+    stcGpioInit.u16PullUp = PIN_PU_ON;
+    stcGpioInit.u16PinDrv = PIN_DRV_HIGH;
+    GPIO_Init(QSPI_IO_PORT, (QSPI_IO0_PIN | QSPI_IO1_PIN | QSPI_IO2_PIN | QSPI_IO3_PIN), &stcGpioInit);
+
+    GPIO_SetFunc(QSPI_CS_PORT, QSPI_CS_PIN, QSPI_PIN_FUNC, PIN_SUBFUNC_DISABLE);
+    GPIO_SetFunc(QSPI_SCK_PORT, QSPI_SCK_PIN, QSPI_PIN_FUNC, PIN_SUBFUNC_DISABLE);
+    GPIO_SetFunc(QSPI_IO_PORT, (QSPI_IO0_PIN | QSPI_IO1_PIN | QSPI_IO2_PIN | QSPI_IO3_PIN), \
+                 QSPI_PIN_FUNC, PIN_SUBFUNC_DISABLE);
+
+    PWC_Fcg1PeriphClockCmd(PWC_FCG1_QSPI, Enable);
+
+    QSPI_StructInit(&stcQspiInit);
+    stcQspiInit.u32ClkDiv        = 3UL;
+    stcQspiInit.u32PrefetchCmd   = QSPI_PREFETCH_ENABLE;
+    stcQspiInit.u32ReadMode      = QSPI_READ_FAST_READ_QUAD_IO;
+    stcQspiInit.u8RomAccessInstr = QSPI_W25Q64_FAST_READ_QUAD_IO;
+    stcQspiInit.u32DummyCycles   = QSPI_W25Q64_QUAD_IO_DUMMY_CYCLES;
+    QSPI_Init(&stcQspiInit);
+
+    /* The read instruction is sent only once, the next reads send only the addresses */
+    QSPI_XIPModeCmd(Enable);
+}
 
-    DMA_StructInit(&stcDmaInit);
-    if(i%2)
-    {
-        stcDmaInit.u32SrcAddr   = (uint32_t)&RGB565_480x272[0];
-    }
-    else
-    {
-        stcDmaInit.u32SrcAddr   = (uint32_t)&_acnew_york_480x272[0];
-    }
-    i++;
-    stcDmaInit.u32DestAddr  = 0x60002000;
-    stcDmaInit.u32DataWidth = DMA_DATAWIDTH_16BIT;
-    stcDmaInit.u32DestInc   = DMA_DEST_ADDR_FIX;
-    stcDmaInit.u32SrcInc    = DMA_SRC_ADDR_INC;
-    stcDmaInit.u32IntEn     = DMA_INT_DISABLE;//DMA_INT_ENABLE;
-    stcDmaInit.u32TransCnt  = 480*272/4;
-    stcDmaInit.u32BlockSize = 4;
-    DMA_Init(M4_DMA1, DMA_CH2, &stcDmaInit);
-    DMA_SetTriggerSrc(M4_DMA1, DMA_CH2, EVT_AOS_STRG);
-    DMA_Cmd(M4_DMA1, Enable);
+/**
+ * @brief  Write a QLI image of the QSPI flash to the LCD line by line
+ * @param  [in] u32FlashAddr        Address of the image in the QSPI flash
+ * @param  [in] u16Y                First LCD row of the image
+ * @retval An en_result_t enumeration value:
+ *           - Ok: The image is drawn
+ *           - Error: No valid QLI image at the address
+ * @note   Only the coded lines are read from the flash, no copy of the image is needed in the RAM.
+ */
+static en_result_t draw_qli(uint32_t u32FlashAddr, uint16_t u16Y)
+{
+    static lv_color_t line[LV_HOR_RES_MAX];
+    lv_img_dsc_t img;
+    lv_coord_t y;
 
-    if (0 == dis_title)
+    /* The flash is not programmed with the image of `make imgs` (see Readme.txt) */
+    if ((LV_RES_OK != lv_img_qli_parse_blob((const void *)(QSPI_ROM_BASE + u32FlashAddr), &img)) || \
+        (img.header.w > LV_HOR_RES_MAX))
     {
-        dis_title = 1;
-        NT35510_SetCursor(0, 592);
-
-        /* Prepare to write to LCD RAM */
-        LCD_WriteReg(lcddev.wramcmd);
-
-        LCD_WriteMultipleData((uint16_t*)&gImage_RGB480x208[0], 480*208);
-
+        return Error;
     }
 
-#if 0
-    //for RGB565_480x272
-    /* Set cursor */
-    NT35510_SetCursor(0, 320);
+    NT35510_SetCursor(0, u16Y);
 
     /* Prepare to write to LCD RAM */
     LCD_WriteReg(lcddev.wramcmd);
 
-//    for(uint32_t bmp_cnt = 0; bmp_cnt < 480x272; bmp_cnt++)
-//    {
-//         = RGB565_480x272[bmp_cnt];
-//    }
-//    LCD_WriteMultipleData((uint16_t*)&RGB565_480x272[0], 480*272);
-    DMA_ChannelCmd(M4_DMA1, DMA_CH2, Enable);
-    AOS_SW_Trigger();
-    while(Reset == DMA_GetTransIntStatus(M4_DMA1, DMA_TC_INT2))
+    for (y = 0; y < (lv_coord_t)img.header.h; y++)
     {
-        AOS_SW_Trigger();
+        if (LV_RES_OK != lv_img_qli_read_line(&img, 0, y, (lv_coord_t)img.header.w, line))
+        {
+            break;
+        }
+        LCD_WriteMultipleData((uint16_t *)line, img.header.w);
     }
-    DMA_ClearTransIntStatus(M4_DMA1, DMA_TC_INT2);
-#endif
+
+    return Ok;
 }
 
-void Draw_bmp_init(void)
+/**
+ * @brief  Draw the title once and the photos alternately
+ * @param  None
+ * @retval None
+ */
+void draw_bmp(void)
 {
-    static uint8_t i = 0;
-//    uint32_t k=0;
-//    for (uint32_t j = 0; j < 240*100; j++)
-//    {
-//        u32buf[j] = RGB565_480x272[k] | (((uint32_t)RGB565_480x272[k+1]) << 16);
-//        k+=2;
-//    }
-    if(i%2)
+    static uint8_t i = 0U;
+    static uint8_t u8ErrLogged = 0U;
+    const uint32_t au32PhotoAddr[2U] = {IMG_QSPI_PHOTO_1_ADDR, IMG_QSPI_PHOTO_0_ADDR};
+    uint32_t u32ErrAddr = 0xFFFFFFFFUL;
+
+    if (0U == dis_title)
     {
-        DMA_SetSrcAddr(M4_DMA1, DMA_CH2, (uint32_t)&RGB565_480x272[0]);
-//        DMA_SetSrcAddr(M4_DMA1, DMA_CH2, (uint32_t)&u32buf[0]);
+        dis_title = 1U;
+        if (Ok != draw_qli(IMG_QSPI_TITLE_ADDR, BMP_TITLE_Y))
+        {
+            u32ErrAddr = IMG_QSPI_TITLE_ADDR;
+        }
     }
-    else
-    {
-        DMA_SetSrcAddr(M4_DMA1, DMA_CH2, (uint32_t)&_acnew_york_480x272[0]);
-//        DMA_SetSrcAddr(M4K_DMA1, DMA_CH2, (uint32_t)&gImage_RGB480x208[0]);
 
+    if (Ok != draw_qli(au32PhotoAddr[i % 2U], BMP_PHOTO_Y))
+    {
+        u32ErrAddr = au32PhotoAddr[i % 2U];
     }
     i++;
-    DMA_SetTransCnt(M4_DMA1, DMA_CH2, 480*272/4);
-    NT35510_SetCursor(0, 320);
 
-    /* Prepare to write to LCD RAM */
-    LCD_WriteReg(lcddev.wramcmd);
-    DMA_ChannelCmd(M4_DMA1, DMA_CH2, Enable);
-    AOS_SW_Trigger();
-    while(Reset == DMA_GetTransIntStatus(M4_DMA1, DMA_TC_INT_CH2))
+    /* Tell it once: the images are drawn again and again */
+    if ((0xFFFFFFFFUL != u32ErrAddr) && (0U == u8ErrLogged))
     {
-        AOS_SW_Trigger();
+        u8ErrLogged = 1U;
+        printf("draw_bmp: no QLI image at %08lXH, program qspi_imgs.bin of `make imgs` (see Readme.txt)\r\n",
+               (unsigned long)(QSPI_ROM_BASE + u32ErrAddr));
     }
-    DMA_ClearTransIntStatus(M4_DMA1, DMA_TC_INT_CH2);
 }
 
 void DVP_Init(void)
@@ -349,34 +574,38 @@ void DVP_CaptureOff(void)
     DDL_DelayMS(1UL);
 }
 
-void DVP_FrameStart_IrqCallback(void)
+/**
+ * @brief  Destination of the next line in the camera surface
+ * @param  None
+ * @retval uint32_t address of the line
+ * @note   The lines below the surface overwrite its last line.
+ */
+static uint32_t DVP_LineDest(void)
 {
-    dvp_frame_cnt++;
-    if (dvp_frame_cnt>=4)
+    uint32_t u32Line = u32CamArmLine;
+
+    if (u32CamArmLine < (u32CamLines - 1UL))
     {
-//        __asm("nop");
-        NT35510_SetCursor(0U, 0U);
-        /* Prepare to write to LCD RAM */
-        LCD_WriteReg(lcddev.wramcmd);
-//        dvp_frame_cnt=0;
-        cam_state=1;
+        u32CamArmLine++;
     }
+
+    return (uint32_t)&pCamSurf[u32Line * DVP_BUF_SIZE];
+}
+
+void DVP_FrameStart_IrqCallback(void)
+{
+    dvp_frame_cnt++;
+
+    /* Either channel can be armed for the first line of the frame */
+    u32CamArmLine = 1UL;
+    DMA_SetDestAddr(M4_DMA2, DMA_CH0, (uint32_t)pCamSurf);
+    DMA_SetDestAddr(M4_DMA2, DMA_CH1, (uint32_t)pCamSurf);
 }
 
 void DVP_FrameEnd_IrqCallback(void)
 {
-//    bM4_DVP->STR_b.FEF = 0;
-////    DMA_ChannelCmd(M4_DMA1, DMA_CH0, Enable);
-//    dvp_frame_cnt++;
-    if (dvp_frame_cnt>=4)
-    {
-////        __asm("nop");
-//        NT35510_SetCursor(0U, 320U);
-//        /* Prepare to write to LCD RAM */
-//        LCD_WriteReg(NT35510_WRITE_RAM);
-        dvp_frame_cnt=0;
-        cam_state=0;
-    }
+    /* The compositor shows the frame, the next one goes to its other surface */
+    pCamSurf = lv_port_comp_cam_frame_end();
 //    GPIO_TogglePins(TEST_PORT, TEST_PIN);
 }
 
@@ -391,7 +620,8 @@ void DVP_DMA1_CH0_IrqCallback(void)
 //    DMA_SetDestAddr(M4_DMA1, DMA_CH1, (uint32_t)&DVP_Buf2[0]);
     DMA_ChannelCmd(M4_DMA1, DMA_CH1, Enable);
 
-    /* Set DMA2_1 for LCD */
+    /* Set DMA2_1 for the camera surface */
+    DMA_SetDestAddr(M4_DMA2, DMA_CH1, DVP_LineDest());
     DMA_SetBlockSize(M4_DMA2, DMA_CH1, DVP_BUF_SIZE);
 //    while(gui_state);
     DMA_ChannelCmd(M4_DMA2, DMA_CH1, Enable);
@@ -400,7 +630,6 @@ void DVP_DMA1_CH0_IrqCallback(void)
 
 void DVP_DMA1_CH0_BTC_IrqCallback(void)
 {
-    cam_state = 1;
 //    if(0==dvp_line_cnt)
 //    {
 //        NT35510_SetCursor(0U, 320U);
@@ -423,7 +652,8 @@ void DVP_DMA1_CH1_IrqCallback(void)
 //    DMA_SetDestAddr(M4_DMA1, DMA_CH0, (uint32_t)&DVP_Buf1[0]);
     DMA_ChannelCmd(M4_DMA1, DMA_CH0, Enable);
 
-    /* Set DMA2_0 for LCD */
+    /* Set DMA2_0 for the camera surface */
+    DMA_SetDestAddr(M4_DMA2, DMA_CH0, DVP_LineDest());
     DMA_SetBlockSize(M4_DMA2, DMA_CH0, DVP_BUF_SIZE);
 //    while(gui_state);
     DMA_ChannelCmd(M4_DMA2, DMA_CH0, Enable);
@@ -483,11 +713,11 @@ void DVP_DMA_Init(void)
     DMA_RepeatInit(M4_DMA1, DMA_CH1, &stcDmaRptInit);
     DMA_SetTriggerSrc(M4_DMA1, DMA_CH1, EVT_TMRA_1_OVF);
 
-    /* DMA2_0 for LCD DVP_Buf1 */
+    /* DMA2_0 for the camera surface from DVP_Buf1. The line is set before every transfer. */
     stcDmaInit.u32SrcAddr   = (uint32_t)&DVP_Buf1[0];
-    stcDmaInit.u32DestAddr  = 0x60002000UL;
+    stcDmaInit.u32DestAddr  = (uint32_t)pCamSurf;
     stcDmaInit.u32DataWidth = DMA_DATAWIDTH_16BIT;
-    stcDmaInit.u32DestInc   = DMA_DEST_ADDR_FIX;
+    stcDmaInit.u32DestInc   = DMA_DEST_ADDR_INC;
     stcDmaInit.u32SrcInc    = DMA_SRC_ADDR_INC;
     stcDmaInit.u32IntEn     = DMA_INT_ENABLE;
     stcDmaInit.u32TransCnt  = 1UL;
@@ -498,7 +728,7 @@ void DVP_DMA_Init(void)
     DMA_RepeatInit(M4_DMA2, DMA_CH0, &stcDmaRptInit);
     DMA_SetTriggerSrc(M4_DMA2, DMA_CH0, EVT_DMA1_TC0);
 
-    /* DMA2_1 for LCD DVP_Buf2 */
+    /* DMA2_1 for the camera surface from DVP_Buf2 */
     stcDmaInit.u32SrcAddr   = (uint32_t)&DVP_Buf2[0];
 //    stcDmaInit.u32DestAddr  = 0UL;// test
     DMA_Init(M4_DMA2, DMA_CH1, &stcDmaInit);
@@ -609,6 +839,10 @@ void DVP_Int_Init(void)
  */
 int32_t main(void)
 {
+    uint32_t u32SleepMs;
+    uint32_t u32SleepStart;
+    lv_color_t *pDispShadow = NULL;
+
     GPIO_Unlock();
     PWC_Unlock(0xA50B);
     PWC_FCG0_Unlock();
@@ -679,8 +913,36 @@ int32_t main(void)
 
     lv_init();
 
+    QSPI_XIP_Init();
+
+    if (Ok == BSP_DMC_IS42S16400J7TLI_Init())
+    {
+        uint32_t u32SdramAddr;
+        uint32_t u32SdramSize;
+
+        BSP_DMC_IS42S16400J7TLI_GetMemInfo(&u32SdramAddr, &u32SdramSize);
+        if (u32SdramSize >= (DISP_SHADOW_SDRAM_OFS + DISP_SHADOW_SDRAM_SIZE))
+        {
+            pDispShadow = (lv_color_t *)(u32SdramAddr + DISP_SHADOW_SDRAM_OFS);
+        }
+        if (u32SdramSize >= (IMG_CACHE_SDRAM_OFS + IMG_CACHE_SDRAM_SIZE))
+        {
+            lv_img_cache_set_mem((void *)(u32SdramAddr + IMG_CACHE_SDRAM_OFS), IMG_CACHE_SDRAM_SIZE);
+        }
+        if (u32SdramSize >= (LV_MEM_SDRAM_OFS + LV_MEM_SDRAM_SIZE))
+        {
+            (void)lv_mem_add_pool((void *)(u32SdramAddr + LV_MEM_SDRAM_OFS), LV_MEM_SDRAM_SIZE);
+        }
+    }
+
     lv_port_disp_init();
 
+    /* Send only the changed pixels of the strips on the slow 8080 bus */
+    if (NULL != pDispShadow)
+    {
+        lv_port_flush_shadow_init(pDispShadow, (lv_coord_t)lcddev.width, (lv_coord_t)lcddev.height);
+    }
+
     if (lcddev.id == 0x5510)
     {
         BSP_TS_Init();
@@ -746,16 +1008,26 @@ int32_t main(void)
 //    DVP_CaptureOn();
     while (1)
     {
-        if ((lcd_state==0))
+        /* Start the refresh on the TE pulse of the panel. A new camera frame invalidates the video. */
+        lv_port_flush_te_handler();
+        lv_port_comp_handler();
+        u32SleepMs = LV_MATH_MIN(lv_task_handler(), GUI_SLEEP_MAX_MS);
+        if ((draw_cnt>=1000) && (false == lv_port_comp_is_enabled()))
         {
-            lv_task_handler();
-            if (draw_cnt>=1000)
-            {
-                draw_bmp();
-                Draw_bmp_init();
-                draw_cnt = 0;
-            }
+            lv_port_disp_full_window();
+            draw_bmp();
+            draw_cnt = 0;
         }
+
+        /* Sleep until the next LVGL task is due, the next TE pulse or the next camera frame.
+           The SysTick wakes up the core in every ms. */
+        u32SleepStart = lv_tick_get();
+        while ((lv_tick_elaps(u32SleepStart) < u32SleepMs) && (false == lv_port_flush_te_pending()) &&
+               (false == lv_port_comp_frame_pending()))
+        {
+            PWC_EnterSleepMode();
+        }
+
         key_serve();
 
 //        DVP_data = M4_DVP->DTR;